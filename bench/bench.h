@@ -0,0 +1,79 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <vector>
+
+// ==================== 主机微基准框架 ====================
+// 仿照Google Benchmark的用法和JSON输出格式，不引入外部依赖 (native环境只有sim/提供的平台接口)：
+//   static void benchScore(BenchState& state) {
+//     while (state.keepRunning()) { ... }
+//   }
+//   BENCHMARK("sensor/score", benchScore);
+// 迭代次数自动增加，直到单次测量达到最短时间。计时用主机单调时钟和进程CPU时间，
+// 与仿真的虚拟时钟无关。
+class BenchState {
+private:
+  uint64_t maxIterations;
+  uint64_t remaining;
+  uint64_t itemsProcessed = 0;
+  uint64_t realStartNs = 0, cpuStartNs = 0;
+  uint64_t realNs = 0, cpuNs = 0;  // 只统计循环本身，循环前的准备工作不计入
+
+  void start();
+  void stop();
+
+public:
+  explicit BenchState(uint64_t iterations);
+
+  // 每轮调用一次，返回false时测量结束
+  bool keepRunning() {
+    if (remaining > 0) {
+      if (remaining-- == maxIterations) {
+        start();
+      }
+      return true;
+    }
+    stop();
+    return false;
+  }
+
+  uint64_t getIterations() const { return maxIterations; }
+  uint64_t getRealNs() const { return realNs; }
+  uint64_t getCpuNs() const { return cpuNs; }
+
+  // 每轮处理多个元素时设置，输出items_per_second
+  void setItemsProcessed(uint64_t items) { itemsProcessed = items; }
+  uint64_t getItemsProcessed() const { return itemsProcessed; }
+};
+
+typedef void (*BenchFunction)(BenchState& state);
+
+struct BenchEntry {
+  const char* name;
+  BenchFunction function;
+};
+
+class BenchRegistry {
+public:
+  static std::vector<BenchEntry>& entries();
+  static int add(const char* name, BenchFunction function);
+};
+
+// 阻止编译器把结果未被使用的计算优化掉
+template <typename T>
+inline void benchKeep(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// 阻止编译器假设内存内容不变 (例如把循环不变的计算提到循环外)
+inline void benchClobber() {
+  asm volatile("" : : : "memory");
+}
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK(name, function) \
+  static int BENCH_CONCAT(benchRegistered, __LINE__) __attribute__((unused)) = BenchRegistry::add(name, function)
+
+#endif // BENCH_H
@@ -0,0 +1,344 @@
+// 固件热路径的微基准：评分与滤波、窗口统计、历史聚合、日期运算、文本格式化
+//
+// 输入数据由固定种子生成，每次运行相同。测的是主机上的耗时，只用于比较同一台机器上
+// 不同提交的相对变化，不代表ESP32-C3上的绝对耗时。
+// 私有的评分/滤波/方差函数通过SensorManager::readSensorData()测量，同时给出
+// 仿真IMU读取本身的开销 (sim/mpu6050_read)，便于扣除。
+
+#include <Arduino.h>
+#include "bench.h"
+#include "config.h"
+#include "data_manager.h"
+#include "data_types.h"
+#include "diagnostic_utils.h"
+#include "display_manager.h"
+#include "rolling_stats.h"
+#include "sensor_manager.h"
+#include "settings_menu.h"
+#include "sim_devices.h"
+#include "stability_stats.h"
+#include "time_manager.h"
+
+// 显示页面引用的全局对象 (固件中定义在main.cpp，基准不链接main.cpp)
+DataManager dataManager;
+TimeManager* timeManager = nullptr;
+
+// 固定种子的xorshift，与仿真的随机源分开，基准之间互不影响
+static uint32_t benchRandomState = 12345;
+
+static uint32_t benchRandom() {
+  benchRandomState ^= benchRandomState << 13;
+  benchRandomState ^= benchRandomState >> 17;
+  benchRandomState ^= benchRandomState << 5;
+  return benchRandomState;
+}
+
+static float benchScore() {
+  // 大部分时间稳定，偶尔破定
+  return benchRandom() % 10 == 0 ? 40.0f + benchRandom() % 400 / 10.0f : 85.0f + benchRandom() % 150 / 10.0f;
+}
+
+static DailyStats makeDay(uint16_t year, uint8_t month, uint8_t day) {
+  DailyStats stats = {};
+  stats.year = year;
+  stats.month = month;
+  stats.day = day;
+  stats.sessionCount = 1 + benchRandom() % 4;
+  stats.totalTime = stats.sessionCount * (300000 + benchRandom() % 600000);
+  stats.avgStability = benchScore();
+  stats.bestStability = min(100.0f, stats.avgStability + 5.0f);
+  stats.totalBreaks = benchRandom() % 20;
+  return stats;
+}
+
+// ==================== 传感器评分 ====================
+static SensorManager& benchSensor() {
+  static SensorManager sensor;
+  static bool initialized = false;
+  if (!initialized) {
+    sensor.initialize();
+    initialized = true;
+  }
+  return sensor;
+}
+
+// 读取 + 校准 + 低通滤波 + calculateStabilityScore + 窗口均值/方差 + 事件发布
+static void benchReadStill(BenchState& state) {
+  SensorManager& sensor = benchSensor();
+  SimImu::setStill();
+  while (state.keepRunning()) {
+    sensor.readSensorData();
+  }
+  benchKeep(sensor.getCurrentScore());
+}
+BENCHMARK("sensor/readSensorData/still", benchReadStill);
+
+// 晃动时评分低于阈值，多走破定判断和事件分支
+static void benchReadShake(BenchState& state) {
+  SensorManager& sensor = benchSensor();
+  SimImu::setShake(0.3f);
+  while (state.keepRunning()) {
+    sensor.readSensorData();
+  }
+  SimImu::setStill();
+  benchKeep(sensor.getCurrentScore());
+}
+BENCHMARK("sensor/readSensorData/shake", benchReadShake);
+
+// 仿真IMU产生一次读数的开销 (噪声模型 + I2C读取)，不属于固件
+static void benchSimImuRead(BenchState& state) {
+  MPU6050 mpu;
+  int16_t ax, ay, az, gx, gy, gz;
+  SimImu::setStill();
+  while (state.keepRunning()) {
+    mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
+    benchKeep(ax);
+  }
+}
+BENCHMARK("sim/mpu6050_read", benchSimImuRead);
+
+static void benchAverageScore(BenchState& state) {
+  SensorManager& sensor = benchSensor();
+  while (state.keepRunning()) {
+    benchClobber();
+    benchKeep(sensor.getAverageScore());
+  }
+}
+BENCHMARK("sensor/getAverageScore", benchAverageScore);
+
+// ==================== 会话统计 ====================
+static void benchAggregatorAdd(BenchState& state) {
+  const int SAMPLES = 1024;
+  float scores[SAMPLES];
+  for (int i = 0; i < SAMPLES; i++) {
+    scores[i] = benchScore();
+  }
+  StabilityAggregator aggregator;
+  aggregator.reset(STABILITY_THRESHOLD);
+  uint32_t timestamp = 0;
+  int i = 0;
+  while (state.keepRunning()) {
+    timestamp += SENSOR_READ_INTERVAL;
+    aggregator.addSample(scores[i], timestamp);
+    i = (i + 1) % SAMPLES;
+  }
+  benchKeep(aggregator.getMean());
+}
+BENCHMARK("stats/StabilityAggregator/addSample", benchAggregatorAdd);
+
+static void benchAggregatorPercentiles(BenchState& state) {
+  StabilityAggregator aggregator;
+  aggregator.reset(STABILITY_THRESHOLD);
+  for (uint32_t i = 0; i < 6000; i++) {
+    aggregator.addSample(benchScore(), i * SENSOR_READ_INTERVAL);
+  }
+  while (state.keepRunning()) {
+    benchClobber();
+    benchKeep(aggregator.getMedian());
+    benchKeep(aggregator.getPercentile(0.1f));
+    benchKeep(aggregator.getPercentile(0.9f));
+  }
+}
+BENCHMARK("stats/StabilityAggregator/percentiles", benchAggregatorPercentiles);
+
+static void benchHistogramMerge(BenchState& state) {
+  StabilityHistogram sessions[8];
+  for (StabilityHistogram& session : sessions) {
+    StabilityAggregator::clearHistogram(session);
+    for (int i = 0; i < 200; i++) {
+      StabilityAggregator::addToHistogram(session, benchScore(), SENSOR_READ_INTERVAL);
+    }
+  }
+  StabilityHistogram day;
+  while (state.keepRunning()) {
+    StabilityAggregator::clearHistogram(day);
+    for (const StabilityHistogram& session : sessions) {
+      StabilityAggregator::mergeHistogram(day, session);
+    }
+    benchKeep(StabilityAggregator::percentileOf(day, 0.5f));
+  }
+  state.setItemsProcessed(state.getIterations() * 8);
+}
+BENCHMARK("stats/histogram/merge8_median", benchHistogramMerge);
+
+// ==================== 历史聚合 ====================
+// 日切换：加入新的一天，减去滑出窗口的一天，并重新扫描最佳值
+static void benchRollingPush(BenchState& state) {
+  const int DAYS = 64;
+  DaySummary days[DAYS];
+  for (int i = 0; i < DAYS; i++) {
+    DailyStats day = makeDay(2025, 1 + i / 28, 1 + i % 28);
+    days[i] = RollingStats::summarize(day, day.totalTime);
+  }
+  RollingStats rolling;
+  int i = 0;
+  while (state.keepRunning()) {
+    rolling.pushDay(days[i]);
+    i = (i + 1) % DAYS;
+  }
+  benchKeep(rolling.getDayCount());
+}
+BENCHMARK("history/RollingStats/pushDay", benchRollingPush);
+
+static void benchRollingQuery(BenchState& state) {
+  RollingStats rolling;
+  for (int i = 0; i < ROLLING_MONTH_DAYS; i++) {
+    DailyStats day = makeDay(2025, 6, 1 + i);
+    rolling.pushDay(RollingStats::summarize(day, day.totalTime));
+  }
+  DailyStats today = makeDay(2025, 7, 1);
+  while (state.keepRunning()) {
+    benchClobber();
+    PeriodStats week = rolling.getWeekStats(today, today.totalTime);
+    PeriodStats month = rolling.getMonthStats(today, today.totalTime);
+    benchKeep(week.avgStability);
+    benchKeep(month.avgStability);
+  }
+}
+BENCHMARK("history/RollingStats/week_month", benchRollingQuery);
+
+static void benchSummarize(BenchState& state) {
+  DailyStats day = makeDay(2025, 7, 1);
+  while (state.keepRunning()) {
+    benchClobber();
+    benchKeep(RollingStats::summarize(day, day.totalTime).avgCenti);
+  }
+}
+BENCHMARK("history/RollingStats/summarize", benchSummarize);
+
+// ==================== 日期运算 ====================
+static DateTime makeDate(uint16_t year, uint8_t month, uint8_t day) {
+  DateTime dt = {};
+  dt.year = year;
+  dt.month = month;
+  dt.day = day;
+  dt.hour = 21;
+  dt.minute = 5;
+  dt.second = 9;
+  return dt;
+}
+
+// 使用主机libc的mktime，结果包含libc的差异
+static void benchDaysDifference(BenchState& state) {
+  TimeManager timeManager;
+  DateTime from = makeDate(2025, 1, 31);
+  DateTime to = makeDate(2025, 3, 1);
+  while (state.keepRunning()) {
+    benchClobber();
+    benchKeep(timeManager.getDaysDifference(from, to));
+  }
+}
+BENCHMARK("time/getDaysDifference", benchDaysDifference);
+
+static void benchSameDay(BenchState& state) {
+  TimeManager timeManager;
+  DateTime a = makeDate(2025, 7, 1);
+  DateTime b = makeDate(2025, 7, 2);
+  while (state.keepRunning()) {
+    benchClobber();
+    benchKeep(timeManager.isSameDay(a, b));
+  }
+}
+BENCHMARK("time/isSameDay", benchSameDay);
+
+// 设置页调整日期：改系统时间并重新读取，包含一条INFO日志的格式化
+static void benchAdjustDate(BenchState& state) {
+  TimeManager timeManager;
+  timeManager.initialize();
+  int direction = 1;
+  while (state.keepRunning()) {
+    timeManager.adjustDate(direction);
+    direction = -direction;
+  }
+}
+BENCHMARK("time/adjustDate", benchAdjustDate);
+
+static void benchCurrentDateTime(BenchState& state) {
+  TimeManager timeManager;
+  timeManager.initialize();
+  while (state.keepRunning()) {
+    benchKeep(timeManager.getCurrentDateTime().second);
+  }
+}
+BENCHMARK("time/getCurrentDateTime", benchCurrentDateTime);
+
+// ==================== 文本格式化 ====================
+static void benchFormatDateTime(BenchState& state) {
+  TimeManager timeManager;
+  DateTime dt = makeDate(2025, 7, 1);
+  while (state.keepRunning()) {
+    String text = timeManager.formatDateTime(dt);
+    benchKeep(text.length());
+  }
+}
+BENCHMARK("format/TimeManager/formatDateTime", benchFormatDateTime);
+
+static void benchFormatUptime(BenchState& state) {
+  unsigned long uptime = 3 * 3600000UL + 25 * 60000UL + 7000;
+  while (state.keepRunning()) {
+    String text = DiagnosticUtils::formatUptime(uptime);
+    benchKeep(text.length());
+  }
+}
+BENCHMARK("format/DiagnosticUtils/formatUptime", benchFormatUptime);
+
+static void benchFormatBytes(BenchState& state) {
+  size_t bytes = 245760;
+  while (state.keepRunning()) {
+    String text = DiagnosticUtils::formatBytes(bytes);
+    benchKeep(text.length());
+  }
+}
+BENCHMARK("format/DiagnosticUtils/formatBytes", benchFormatBytes);
+
+// 设置页每帧为每个可见项生成一次数值文本
+static void benchSettingsValues(BenchState& state) {
+  SystemSettings settings = {};
+  settings.stabilityThreshold = STABILITY_THRESHOLD;
+  settings.soundEnabled = true;
+  settings.autoSleep = true;
+  settings.practiceTime = DEFAULT_PRACTICE_TIME;
+  while (state.keepRunning()) {
+    for (int item = 0; item < SETTINGS_ITEM_COUNT; item++) {
+      String text = getSettingsValueText((SettingsMenuItem)item, settings);
+      benchKeep(text.length());
+    }
+  }
+  state.setItemsProcessed(state.getIterations() * SETTINGS_ITEM_COUNT);
+}
+BENCHMARK("format/settings/getSettingsValueText", benchSettingsValues);
+
+static void benchDateTimeValues(BenchState& state) {
+  DateTime dt = makeDate(2025, 7, 1);
+  while (state.keepRunning()) {
+    for (int item = 0; item < DATETIME_ITEM_COUNT; item++) {
+      String text = getDateTimeValueText((DateTimeEditItem)item, dt);
+      benchKeep(text.length());
+    }
+  }
+  state.setItemsProcessed(state.getIterations() * DATETIME_ITEM_COUNT);
+}
+BENCHMARK("format/settings/getDateTimeValueText", benchDateTimeValues);
+
+// ==================== 页面绘制 ====================
+// 一帧练习页面：评分/时长格式化、文字测宽和布局。帧缓冲发送由仿真显示记录，不占主机时间
+static void benchPracticePage(BenchState& state) {
+  static DisplayManager display;
+  static bool initialized = false;
+  if (!initialized) {
+    display.initialize(true);
+    initialized = true;
+  }
+  ZenMotionData data = {};
+  data.status.currentState = STATE_PRACTICING;
+  data.stability.score = 93.5f;
+  data.stability.isStable = true;
+  data.currentSession.duration = 754000;
+  data.todayStats.totalTime = 1800000;
+  display.setPage(PAGE_MAIN);
+  while (state.keepRunning()) {
+    display.forceUpdate();
+    display.update(data);
+  }
+}
+BENCHMARK("display/practicePage", benchPracticePage);
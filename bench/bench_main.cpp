@@ -0,0 +1,302 @@
+// 主机微基准入口：运行bench/中注册的基准，输出表格，并可以写入Google Benchmark格式的JSON
+//
+// 用法: bench [--filter 子串] [--min-time 秒] [--repetitions N] [--json 文件] [--list]
+//
+// JSON与Google Benchmark的 --benchmark_out_format=json 兼容，可以直接用它的tools/compare.py，
+// 也可以用 scripts/compare_bench.py 对比两次结果并在性能回退时返回非零退出码。
+
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <unistd.h>
+#include "bench.h"
+#include "sim_clock.h"
+#include "sim_devices.h"
+
+#define BENCH_DEFAULT_MIN_TIME 0.2    // 单次测量的最短时间 (s)
+#define BENCH_MAX_ITERATIONS ((uint64_t)1000000000)
+#define BENCH_MAX_GROWTH 10.0         // 每次试探最多把迭代次数放大10倍
+
+struct BenchOptions {
+  const char* filter = nullptr;
+  double minTime = BENCH_DEFAULT_MIN_TIME;
+  int repetitions = 1;
+  const char* jsonPath = nullptr;
+  bool list = false;
+};
+
+struct BenchResult {
+  std::string name;
+  std::string runName;
+  bool aggregate;
+  int repetitionIndex;
+  uint64_t iterations;
+  double realNs;                     // 每轮
+  double cpuNs;
+  double itemsPerSecond;             // 未设置时为0
+};
+
+// ==================== BenchState / BenchRegistry ====================
+static uint64_t clockNs(clockid_t clock) {
+  timespec ts;
+  clock_gettime(clock, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+BenchState::BenchState(uint64_t iterations) : maxIterations(iterations), remaining(iterations) {
+}
+
+void BenchState::start() {
+  realStartNs = clockNs(CLOCK_MONOTONIC);
+  cpuStartNs = clockNs(CLOCK_PROCESS_CPUTIME_ID);
+}
+
+void BenchState::stop() {
+  realNs = clockNs(CLOCK_MONOTONIC) - realStartNs;
+  cpuNs = clockNs(CLOCK_PROCESS_CPUTIME_ID) - cpuStartNs;
+}
+
+std::vector<BenchEntry>& BenchRegistry::entries() {
+  static std::vector<BenchEntry> list;
+  return list;
+}
+
+int BenchRegistry::add(const char* name, BenchFunction function) {
+  entries().push_back({name, function});
+  return (int)entries().size();
+}
+
+// ==================== 运行 ====================
+static BenchResult measure(const BenchEntry& entry, uint64_t iterations, int repetition) {
+  BenchState state(iterations);
+  entry.function(state);
+
+  BenchResult result;
+  result.name = entry.name;
+  result.runName = entry.name;
+  result.aggregate = false;
+  result.repetitionIndex = repetition;
+  result.iterations = iterations;
+  result.realNs = (double)state.getRealNs() / iterations;
+  result.cpuNs = (double)state.getCpuNs() / iterations;
+  result.itemsPerSecond = state.getItemsProcessed() > 0 && state.getCpuNs() > 0
+                              ? state.getItemsProcessed() * 1e9 / state.getCpuNs()
+                              : 0.0;
+  return result;
+}
+
+// 从1轮开始按耗时估算放大迭代次数，直到一次测量达到最短时间
+static uint64_t calibrate(const BenchEntry& entry, double minTime, BenchResult& first) {
+  double minNs = minTime * 1e9;
+  uint64_t iterations = 1;
+  for (;;) {
+    first = measure(entry, iterations, 0);
+    double elapsedNs = first.realNs * iterations;
+    if (elapsedNs >= minNs || iterations >= BENCH_MAX_ITERATIONS) {
+      return iterations;
+    }
+    double growth = elapsedNs > 0 ? minNs * 1.4 / elapsedNs : BENCH_MAX_GROWTH;
+    growth = std::min(std::max(growth, 2.0), BENCH_MAX_GROWTH);
+    iterations = std::min((uint64_t)(iterations * growth), BENCH_MAX_ITERATIONS);
+  }
+}
+
+static BenchResult median(const std::vector<BenchResult>& runs) {
+  std::vector<double> real, cpu, items;
+  for (const BenchResult& run : runs) {
+    real.push_back(run.realNs);
+    cpu.push_back(run.cpuNs);
+    items.push_back(run.itemsPerSecond);
+  }
+  auto middle = [](std::vector<double>& values) {
+    std::sort(values.begin(), values.end());
+    size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+  };
+
+  BenchResult result = runs[0];
+  result.name = runs[0].runName + "_median";
+  result.aggregate = true;
+  result.repetitionIndex = 0;
+  result.realNs = middle(real);
+  result.cpuNs = middle(cpu);
+  result.itemsPerSecond = middle(items);
+  return result;
+}
+
+// ==================== 输出 ====================
+static std::string formatNs(double ns) {
+  char buffer[32];
+  if (ns >= 1e6) {
+    snprintf(buffer, sizeof(buffer), "%.2f ms", ns / 1e6);
+  } else if (ns >= 1e3) {
+    snprintf(buffer, sizeof(buffer), "%.2f us", ns / 1e3);
+  } else {
+    snprintf(buffer, sizeof(buffer), "%.1f ns", ns);
+  }
+  return buffer;
+}
+
+static void printResult(const BenchResult& result) {
+  char items[32] = "";
+  if (result.itemsPerSecond > 0) {
+    snprintf(items, sizeof(items), "%.2fM/s", result.itemsPerSecond / 1e6);
+  }
+  printf("%-44s %12llu %12s %12s %12s\n", result.name.c_str(), (unsigned long long)result.iterations,
+         formatNs(result.realNs).c_str(), formatNs(result.cpuNs).c_str(), items);
+  fflush(stdout);
+}
+
+static void writeJsonString(FILE* out, const char* text) {
+  fputc('"', out);
+  for (const char* p = text; *p; p++) {
+    if (*p == '"' || *p == '\\') {
+      fputc('\\', out);
+    }
+    fputc(*p, out);
+  }
+  fputc('"', out);
+}
+
+static bool writeJson(const char* path, const char* executable, const std::vector<BenchResult>& results,
+                      int repetitions) {
+  FILE* out = fopen(path, "w");
+  if (!out) {
+    fprintf(stderr, "无法写入 %s\n", path);
+    return false;
+  }
+
+  char date[32];
+  time_t now = time(nullptr);
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+  char host[64] = "";
+  gethostname(host, sizeof(host) - 1);
+
+  fprintf(out, "{\n  \"context\": {\n");
+  fprintf(out, "    \"date\": \"%s\",\n", date);
+  fprintf(out, "    \"host_name\": ");
+  writeJsonString(out, host);
+  fprintf(out, ",\n    \"executable\": ");
+  writeJsonString(out, executable);
+  fprintf(out, ",\n    \"num_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+#ifdef __OPTIMIZE__
+  fprintf(out, "    \"library_build_type\": \"release\"\n");
+#else
+  fprintf(out, "    \"library_build_type\": \"debug\"\n");
+#endif
+  fprintf(out, "  },\n  \"benchmarks\": [\n");
+
+  for (size_t i = 0; i < results.size(); i++) {
+    const BenchResult& result = results[i];
+    fprintf(out, "    {\n      \"name\": ");
+    writeJsonString(out, result.name.c_str());
+    fprintf(out, ",\n      \"run_name\": ");
+    writeJsonString(out, result.runName.c_str());
+    fprintf(out, ",\n      \"run_type\": \"%s\",\n", result.aggregate ? "aggregate" : "iteration");
+    fprintf(out, "      \"repetitions\": %d,\n", repetitions);
+    if (result.aggregate) {
+      fprintf(out, "      \"aggregate_name\": \"median\",\n");
+    } else {
+      fprintf(out, "      \"repetition_index\": %d,\n", result.repetitionIndex);
+    }
+    fprintf(out, "      \"threads\": 1,\n");
+    fprintf(out, "      \"iterations\": %llu,\n", (unsigned long long)result.iterations);
+    fprintf(out, "      \"real_time\": %.4f,\n", result.realNs);
+    fprintf(out, "      \"cpu_time\": %.4f,\n", result.cpuNs);
+    if (result.itemsPerSecond > 0) {
+      fprintf(out, "      \"items_per_second\": %.1f,\n", result.itemsPerSecond);
+    }
+    fprintf(out, "      \"time_unit\": \"ns\"\n    }%s\n", i + 1 < results.size() ? "," : "");
+  }
+  fprintf(out, "  ]\n}\n");
+  fclose(out);
+  return true;
+}
+
+// ==================== 命令行 ====================
+static void usage(const char* program) {
+  fprintf(stderr, "用法: %s [--filter 子串] [--min-time 秒] [--repetitions N] [--json 文件] [--list]\n", program);
+}
+
+static bool parseOptions(int argc, char** argv, BenchOptions& options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (strcmp(arg, "--filter") == 0 && hasValue) {
+      options.filter = argv[++i];
+    } else if (strcmp(arg, "--min-time") == 0 && hasValue) {
+      options.minTime = atof(argv[++i]);
+      if (options.minTime <= 0) {
+        return false;
+      }
+    } else if (strcmp(arg, "--repetitions") == 0 && hasValue) {
+      options.repetitions = atoi(argv[++i]);
+      if (options.repetitions < 1) {
+        return false;
+      }
+    } else if (strcmp(arg, "--json") == 0 && hasValue) {
+      options.jsonPath = argv[++i];
+    } else if (strcmp(arg, "--list") == 0) {
+      options.list = true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  // 固件日志不输出，但格式化开销照常计入
+  SimSerial::setOutput(nullptr);
+  SimClock::seed(1);
+
+  std::vector<BenchEntry> selected;
+  for (const BenchEntry& entry : BenchRegistry::entries()) {
+    if (!options.filter || strstr(entry.name, options.filter)) {
+      selected.push_back(entry);
+    }
+  }
+  if (options.list) {
+    for (const BenchEntry& entry : selected) {
+      printf("%s\n", entry.name);
+    }
+    return 0;
+  }
+  if (selected.empty()) {
+    fprintf(stderr, "没有匹配的基准\n");
+    return 2;
+  }
+
+  printf("%-44s %12s %12s %12s %12s\n", "benchmark", "iterations", "real", "cpu", "items");
+  std::vector<BenchResult> results;
+  for (const BenchEntry& entry : selected) {
+    std::vector<BenchResult> runs(1);
+    uint64_t iterations = calibrate(entry, options.minTime, runs[0]);
+    for (int i = 1; i < options.repetitions; i++) {
+      runs.push_back(measure(entry, iterations, i));
+    }
+    for (const BenchResult& run : runs) {
+      printResult(run);
+      results.push_back(run);
+    }
+    if (options.repetitions > 1) {
+      results.push_back(median(runs));
+      printResult(results.back());
+    }
+  }
+
+  if (options.jsonPath && !writeJson(options.jsonPath, argv[0], results, options.repetitions)) {
+    return 1;
+  }
+  return 0;
+}
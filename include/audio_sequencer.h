@@ -0,0 +1,54 @@
+#ifndef AUDIO_SEQUENCER_H
+#define AUDIO_SEQUENCER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "config.h"
+
+// ==================== 非阻塞提示音序列 ====================
+// 一个提示音由若干步组成，每步是"发声 + 间隔"。发声用tone()启动、noTone()停止，
+// 每一步的结束由esp_timer单次定时器回调推进，主循环调用play()后立即返回。
+// 预定义音序是常量表，存放在Flash中。
+struct ToneStep {
+  uint16_t frequency;              // Hz，0表示静音
+  uint16_t durationMs;             // 发声时长
+  uint16_t gapMs;                  // 发声结束后的间隔
+};
+
+class AudioSequencer {
+private:
+  static esp_timer_handle_t timer;
+  static SemaphoreHandle_t lock;   // 主任务与esp_timer任务互斥
+
+  // 当前播放位置
+  static const ToneStep* steps;
+  static uint8_t stepCount;
+  static uint8_t stepIndex;
+  static bool inGap;
+  static volatile bool playing;
+  static ToneStep customStep;      // playTone()使用的单步音序
+
+  static void timerCallback(void* arg);
+  static void startStep();
+  static bool start(const ToneStep* sequence, uint8_t count);
+
+public:
+  // 创建定时器，未调用时第一次播放会自动初始化
+  static bool begin();
+
+  // 播放预定义音序，打断正在播放的声音
+  static bool play(SoundPattern pattern);
+
+  // 播放单个音
+  static bool playTone(uint16_t frequency, uint16_t durationMs);
+
+  static void stop();
+  static bool isPlaying();
+
+  // 音序总时长 (ms，含间隔)
+  static uint32_t getPatternDuration(SoundPattern pattern);
+};
+
+#endif // AUDIO_SEQUENCER_H
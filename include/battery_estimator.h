@@ -0,0 +1,70 @@
+#ifndef BATTERY_ESTIMATOR_H
+#define BATTERY_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ==================== 电池电量估算 ====================
+// 库仑计数为主、电压校正为辅：
+//   - 各系统状态有一个平均电流 (初始为配置值)，按状态停留时间积分得到消耗的电量
+//   - 每次ADC采样先补偿负载压降 (电流 × 内阻) 得到开路电压，
+//     再查锂电池放电曲线得到电量，按固定比例修正库仑计数，抑制积分漂移
+//   - 同一状态持续足够久时，用这段时间内开路电压推算的电量变化反推该状态的实际电流
+// 设备没有电流检测电路，所以"实测电流"来自电压曲线，精度受ADC噪声和曲线平坦区限制。
+class BatteryEstimator {
+private:
+  static const float dischargeCurve[][2];      // {开路电压, 电量%}，电压由高到低
+  static const uint8_t curvePoints;
+
+  // 电压
+  float loadedVoltage = 0.0f;                  // 最近一次采样 (带负载)
+  float openCircuitVoltage = 0.0f;             // 补偿压降后的开路电压
+  float voltageSoc = 0.0f;                     // 按开路电压查表的电量 (%，已平滑)
+
+  // 库仑计数
+  float remainingMah = 0.0f;
+  uint32_t lastAccountMs = 0;
+
+  // 各状态平均电流与停留时间
+  float stateCurrentMa[SYSTEM_STATE_COUNT];
+  uint32_t stateTimeMs[SYSTEM_STATE_COUNT];
+  uint8_t state = STATE_BOOT_ANIMATION;
+
+  // 电流学习窗口 (状态切换时重新开始)
+  uint32_t learnStartMs = 0;
+  float learnStartSoc = 0.0f;
+
+  bool started = false;
+
+  void account(uint32_t nowMs);
+  void restartLearning(uint32_t nowMs);
+
+public:
+  BatteryEstimator();
+
+  // 首次采样：直接用电压推算的电量初始化库仑计数
+  void begin(float voltage, uint8_t systemState, uint32_t nowMs);
+
+  // 系统状态变化 (决定当前负载电流)
+  void setState(uint8_t systemState, uint32_t nowMs);
+
+  // 新的电压采样 (带负载的电池电压)
+  void addSample(float voltage, uint32_t nowMs);
+
+  bool isStarted() const;
+  float getLoadedVoltage() const;
+  float getOpenCircuitVoltage() const;
+  float getSagVoltage() const;                 // 当前状态下的负载压降 (V)
+  uint8_t getPercentage() const;
+  float getRemainingMah() const;
+  float getStateCurrent(uint8_t systemState) const;
+  uint32_t getStateTime(uint8_t systemState) const;
+
+  // 以指定状态的平均电流持续运行还能坚持多少分钟
+  uint32_t getRemainingMinutes(uint8_t systemState) const;
+
+  // 锂电池开路电压 -> 电量 (%)，分段线性插值
+  static float socFromVoltage(float voltage);
+};
+
+#endif // BATTERY_ESTIMATOR_H
@@ -0,0 +1,38 @@
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ==================== 启动阶段跟踪 ====================
+// 以esp_timer (上电后的微秒数) 为时间基准记录每个启动阶段的完成时刻，
+// 并把首个有效稳定性评分的时刻作为"启动到可用"指标(time-to-first-score)
+struct BootStage {
+  const char* name;                // 阶段名称 (字符串常量)
+  uint32_t timestampUs;            // 完成时刻 (us，自上电起)
+};
+
+class BootTrace {
+private:
+  static BootStage stages[BOOT_TRACE_MAX_STAGES];
+  static uint8_t stageCount;
+  static uint32_t firstScoreUs;
+  static bool fastResume;
+
+public:
+  // 记录一个阶段完成
+  static void mark(const char* name);
+
+  // 记录首个评分，只有第一次调用生效；返回是否为首次
+  static bool markFirstScore();
+
+  static void setFastResume(bool resumed);
+  static uint32_t getTimeToFirstScore();   // us，尚未产生评分时为0
+  static uint8_t getStageCount();
+  static const BootStage* getStage(uint8_t index);
+
+  // 输出各阶段耗时
+  static void printReport();
+};
+
+#endif // BOOT_TRACE_H
@@ -0,0 +1,59 @@
+#ifndef BUTTON_CAPTURE_H
+#define BUTTON_CAPTURE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ==================== 按钮边沿捕获 ====================
+// GPIO电平变化中断记录每个边沿的时间戳 (esp_timer微秒) 和电平，
+// 写入单生产者/单消费者环形队列 (中断只写head，主循环只写tail，无需加锁)，
+// 并唤醒主循环。主循环取出边沿后做锁定式防抖：
+// 改变稳定状态的第一个边沿立即生效并使用它自己的时间戳，
+// 之后INPUT_DEBOUNCE_INTERVAL内的抖动边沿被忽略，锁定期结束时再核对一次电平。
+// 因此按下/松开时刻与主循环的执行时机无关。
+struct ButtonEdge {
+  uint64_t timestampUs;            // 边沿时刻 (us，与millis()同一时基)
+  bool pressed;                    // 边沿之后按钮是否处于按下状态
+};
+
+class ButtonCapture {
+private:
+  static ButtonEdge queue[BUTTON_QUEUE_SIZE];
+  static volatile uint8_t head;    // 仅中断写
+  static volatile uint8_t tail;    // 仅主循环写
+  static volatile uint32_t overflowCount;
+
+  // 防抖状态 (仅主循环访问)
+  static bool stablePressed;
+  static bool rawPressed;
+  static uint64_t rawTimeUs;
+  static bool inLockout;
+  static uint64_t lockoutStartUs;
+  static uint32_t seenOverflows;
+
+  static void IRAM_ATTR edgeIsr();
+  static bool commit(bool pressed, uint64_t timestampUs, ButtonEdge& edge);
+
+public:
+  // 读取初始电平并挂接中断
+  static void begin();
+
+  // 写入一个原始边沿 (中断中调用；测试时可直接注入)
+  static void IRAM_ATTR pushEdge(uint64_t timestampUs, bool pressed);
+
+  // 取出下一个防抖后的边沿，没有时返回false；应循环调用直到返回false
+  static bool poll(ButtonEdge& edge, uint64_t nowUs);
+
+  // 防抖后的按钮状态
+  static bool isPressed();
+
+  // 锁定期剩余时间 (ms)，不在锁定期时返回UINT32_MAX
+  static uint32_t getNextDeadline(uint64_t nowUs);
+
+  static uint32_t getOverflowCount();
+
+  // 清空队列并以当前电平为稳定状态
+  static void reset();
+};
+
+#endif // BUTTON_CAPTURE_H
@@ -0,0 +1,43 @@
+#ifndef BYTE_CODEC_H
+#define BYTE_CODEC_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ==================== 小端字段读写 ====================
+// 导出记录和遥测包共用，多字节字段均为小端；put*返回写入后的位置
+static inline uint8_t* putU16(uint8_t* p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  return p + 2;
+}
+
+static inline uint8_t* putU32(uint8_t* p, uint32_t v) {
+  for (int i = 0; i < 4; i++) {
+    p[i] = (v >> (8 * i)) & 0xFF;
+  }
+  return p + 4;
+}
+
+static inline uint8_t* putF32(uint8_t* p, float v) {
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  return putU32(p, bits);
+}
+
+static inline uint16_t getU16(const uint8_t* p) {
+  return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static inline uint32_t getU32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline float getF32(const uint8_t* p) {
+  uint32_t bits = getU32(p);
+  float v;
+  memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+#endif // BYTE_CODEC_H
@@ -116,11 +116,20 @@
 #define MPU6050_SAMPLE_RATE 100  // Hz
 #define ACCEL_SCALE_FACTOR 16384.0  // ±2g
 #define GYRO_SCALE_FACTOR 131.0     // ±250°/s
+#ifndef MPU_INT_PIN
+  #define MPU_INT_PIN -1            // MPU6050 INT引脚 (数据就绪中断)，-1表示未连接，改用定时器节拍
+#endif
 
 // 稳定性评分配置
 #define STABILITY_THRESHOLD 50      // 破定提醒阈值
 #define STABILITY_WINDOW_SIZE 20    // 滑动窗口大小
 #define CALIBRATION_SAMPLES 100     // 校准样本数量
+// 会话评分直方图: 低分段每档5分，评分集中的高分段每档1分
+#define STABILITY_HISTOGRAM_COARSE_WIDTH 5   // 低分段每档宽度 (分)
+#define STABILITY_HISTOGRAM_FINE_START 80    // 此分数以上每档1分
+#define STABILITY_HISTOGRAM_BINS (STABILITY_HISTOGRAM_FINE_START / STABILITY_HISTOGRAM_COARSE_WIDTH + \
+                                  (100 - STABILITY_HISTOGRAM_FINE_START))
+#define STABILITY_MAX_SAMPLE_GAP 5000 // 单个采样点最大计入时长 (ms)
 
 // ==================== 显示配置 ====================
 // OLED显示屏配置
@@ -131,13 +140,59 @@
 
 // UI更新频率
 #define DISPLAY_UPDATE_INTERVAL 100  // ms
+#define DISPLAY_IDLE_REFRESH_INTERVAL 1000 // 页面内容没有变化也没有动画时的兜底刷新间隔 (ms)
 #define SENSOR_READ_INTERVAL 50      // ms
+#define SENSOR_WARMUP_TIME 30        // MPU6050唤醒后陀螺仪稳定时间 (ms)
+
+// ==================== 事件总线配置 ====================
+#define EVENT_BUS_MAX_SUBSCRIBERS 8  // 订阅表容量 (静态分配)
+
+// ==================== 主循环调度配置 ====================
+// 主循环阻塞等待事件 (按钮中断、传感器/刷新定时器)，没有事件时CPU空闲，可进入自动轻度睡眠
+#define LOOP_MAX_WAIT_MS 100         // 单次最长等待，保证串口命令和后台检查的响应
+#define LOOP_BUSY_POLL_INTERVAL 10   // 串口导出进行中时的轮询间隔 (ms)
+#define LOOP_FALLBACK_POLL_INTERVAL 10 // 定时器创建失败时退回固定轮询的间隔 (ms)
+
+// 主循环时序监控: 每轮耗时、传感器读取相对节拍的延迟、显示帧耗时
+#define LOOP_DEADLINE_US (SENSOR_READ_INTERVAL * 1000UL)          // 单轮超过一个传感器周期会错过读取
+#define LOOP_SENSOR_LATE_DEADLINE_US (SENSOR_READ_INTERVAL * 500UL) // 读取延迟超过半个周期
+#define LOOP_FRAME_DEADLINE_US (DISPLAY_UPDATE_INTERVAL * 1000UL)   // 一帧超过刷新间隔会掉帧
+#define INPUT_DEBOUNCE_INTERVAL 25   // 按钮防抖间隔 (ms)
+#define BUTTON_QUEUE_SIZE 16         // 按钮边沿队列长度 (中断写入，主循环读取)
+
+// ==================== 按钮手势配置 ====================
+#define GESTURE_MAX_PRESS_COUNT 3        // 最多识别三击
+#define GESTURE_MULTI_CLICK_WINDOW 300   // 连击时两次松开之间的最长间隔 (ms)
+#define GESTURE_LONG_PRESS_TIME 1000     // 长按阈值 (ms)，松开时判定
+#define GESTURE_LONG_LONG_PRESS_TIME 3000 // 超长按阈值 (ms)，按住到达时立即触发
+#define GESTURE_REPEAT_DELAY 500         // 连击后按住多久开始自动重复 (ms)
+#define GESTURE_REPEAT_INTERVAL 200      // 自动重复间隔 (ms)
+#define GESTURE_REPEAT_FAST_INTERVAL 60  // 加速后的自动重复间隔 (ms)
+#define GESTURE_REPEAT_ACCEL_COUNT 10    // 重复多少次后加速
+
+// ==================== 运动手势配置 ====================
+// 敲击/双敲/倾斜作为第二输入通道，练习和校准期间自动关闭，不影响评分
+#define MOTION_HW_THRESHOLD 100          // MPU6050运动检测阈值 (2mg/LSB)，经5Hz高通后比较
+#define MOTION_TAP_THRESHOLD_G 0.35f     // 软件判定: 加速度模长偏离1g超过该值视为冲击
+#define MOTION_TAP_MAX_DURATION 150      // 单次敲击冲击最长持续时间 (ms)，更长视为晃动
+#define MOTION_DOUBLE_TAP_WINDOW 500     // 两次敲击的最长间隔 (ms)
+#define MOTION_TILT_ANGLE 35             // 倾斜触发角度 (度，左右方向为X轴)
+#define MOTION_TILT_RELEASE_ANGLE 15     // 回到该角度以内视为回正
+#define MOTION_TILT_HOLD_TIME 400        // 倾斜保持多久触发 (ms)
+#define MOTION_TILT_REPEAT_INTERVAL 300  // 保持倾斜时的重复间隔 (ms)
+#define MOTION_TILT_MAX_REPEATS 20       // 不回正时最多重复次数 (防止斜放在桌上时持续触发)
+#define MOTION_BUTTON_GUARD_TIME 300     // 按钮边沿前后该时间内的冲击不算敲击 (按键本身会震动设备)
 
 // ==================== 开机动画配置 ====================
-#define BOOT_ANIMATION_DURATION 4000  // 开机动画持续时间 (ms)
+#define BOOT_ANIMATION_DURATION 4000  // 开机动画最长持续时间 (ms)
+#define BOOT_ANIMATION_MIN_DURATION 1200 // 初始化完成后动画最短显示时间 (ms)，按键可直接跳过
 #define BOOT_ANIMATION_FRAMES 8       // 动画帧数
 #define BOOT_ANIMATION_FRAME_DELAY 500 // 每帧延迟 (ms)
 
+// 启动流程
+#define BOOT_TRACE_MAX_STAGES 16      // 启动阶段记录上限
+#define BOOT_DATA_TASK_STACK 6144     // 数据加载任务栈大小 (字节)，与显示初始化并行执行
+
 // ==================== 主菜单配置 ====================
 // 主菜单布局配置 - 4个选项均匀分布在64像素高度屏幕上
 #define MENU_ITEM_HEIGHT 12          // 菜单项高度
@@ -236,15 +291,55 @@
 #define BUZZER_DURATION 200          // ms
 #define BUZZER_BREAK_FREQUENCY 1500  // 破定提醒频率
 #define BUZZER_SUCCESS_FREQUENCY 2500 // 成功提醒频率
+#define BUZZER_STEP_GAP 50           // 音序中相邻两个音之间的间隔 (ms)
 
 // ==================== 电源管理配置 ====================
 // 休眠配置
 #define SLEEP_TIMEOUT 300000         // 5分钟无操作进入休眠
 #define DEEP_SLEEP_TIMEOUT 1800000   // 30分钟进入深度休眠
 
+// 深度休眠状态保持 (RTC慢速内存)
+#define RTC_STATE_MAGIC 0x5A52544Du  // "MTRZ"
+#define RTC_STATE_VERSION 2          // 结构变化时递增，旧快照将被丢弃
+
+// 动态调频 (按主循环实测负载选择工作点)
+#define DFS_LEVEL_COUNT 3            // 工作点数量: 40/80/160MHz
+#define DFS_MIN_FREQ_MHZ 80          // 允许的最低频率 (低于80MHz时APB随之降低，影响I2C/串口时序)
+#define DFS_MAX_FREQ_MHZ 160         // 最高频率
+#define DFS_LOW_POWER_FREQ_MHZ 80    // 低电量模式下的频率上限
+#define DFS_WINDOW_MS 1000           // 负载统计窗口 (ms)
+#define DFS_TARGET_LOAD 50           // 预测负载超过此值 (%) 时升频
+#define DFS_DOWN_LOAD 35             // 预测负载低于此值 (%) 才降频，形成迟滞
+#define DFS_DEADLINE_BUDGET 50       // 单次循环忙碌时间占传感器周期的上限 (%)
+#define DFS_LIGHT_SLEEP_LOAD 20      // 最低工作点且负载低于此值 (%) 时允许自动轻度睡眠
+#define DFS_BOOST_TIME 2000          // 用户操作后保持最高频率的时间 (ms)
+
+// 功耗统计：各部件电流表 (mA)，按工作时间和亮度/负载加权估算能耗分布
+#define ENERGY_CPU_BASE_MA 6.0f      // CPU运行电流 = 基础值 + 频率 × 系数 (射频关闭)
+#define ENERGY_CPU_MA_PER_MHZ 0.1f
+#define ENERGY_CPU_IDLE_MA 5.0f      // 空闲任务等待中断 (未进入轻度睡眠)
+#define ENERGY_LIGHT_SLEEP_MA 0.3f   // 自动轻度睡眠
+#define ENERGY_DISPLAY_BASE_MA 2.0f  // OLED开启、最低亮度
+#define ENERGY_DISPLAY_FULL_MA 10.0f // OLED开启、最高亮度
+#define ENERGY_IMU_MA 3.9f           // MPU6050加速度计+陀螺仪
+#define ENERGY_BUZZER_MA 15.0f       // 无源蜂鸣器 (最大音量)
+#define ENERGY_BOARD_MA 1.0f         // 稳压器静态电流等常开部分
+
 // 电池监测
 #define BATTERY_LOW_VOLTAGE 3.3      // 低电量阈值 (V)
 #define BATTERY_CRITICAL_VOLTAGE 3.0 // 严重低电量阈值 (V)
+#ifndef BATTERY_ADC_PIN
+  #define BATTERY_ADC_PIN -1         // 电池分压采样引脚 (ADC1)，-1表示未连接，使用模拟电压
+#endif
+#define BATTERY_SIMULATED_VOLTAGE 3.85f // 未连接采样引脚时的模拟电压 (放电曲线中段，约55%)
+#define BATTERY_DIVIDER_RATIO 2.0f   // 分压比 (电池电压 / ADC引脚电压)
+#define BATTERY_ADC_OVERSAMPLE 64    // 每次测量的ADC过采样次数 (去掉最大最小值后取平均)
+#define BATTERY_CAPACITY_MAH 400     // 电池标称容量 (mAh)
+#define BATTERY_INTERNAL_RESISTANCE 0.15f // 电池内阻初始值 (Ω)，用于负载压降补偿
+#define BATTERY_NOMINAL_CURRENT_MA 35.0f  // 各状态平均电流的初始值 (mA)，运行中按实测修正
+#define BATTERY_SLEEP_CURRENT_MA 5.0f     // 休眠状态电流初始值 (mA)
+#define BATTERY_SOC_CORRECTION 0.05f // 每次采样用电压推算的电量修正库仑计数的比例
+#define BATTERY_LEARN_WINDOW_MS 600000 // 同一状态持续这么久后用电量变化修正该状态的平均电流
 
 // ==================== 数据存储配置 ====================
 // EEPROM地址分配
@@ -253,11 +348,47 @@
 #define EEPROM_SESSION_COUNT_ADDR 4  // 练习次数 (4字节)
 #define EEPROM_BEST_SCORE_ADDR 8     // 最佳评分 (4字节)
 #define EEPROM_SETTINGS_ADDR 12      // 设置数据起始地址
+#define EEPROM_CALIBRATION_ADDR 448  // 校准数据 (1字节有效标志 + CalibrationData)
+#define EEPROM_LAYOUT_MAGIC 0xAC     // 数据布局标志，结构变更时递增
+
+// 后台持久化配置
+#define PERSIST_COALESCE_MS 500      // 连续写入平息多久后提交 (ms)
+#define PERSIST_MAX_DELAY 5000       // 首次变更后最长延迟提交时间 (ms)
+#define PERSIST_FLUSH_TIMEOUT 2000   // 休眠/关机前等待落盘的超时 (ms)
+#define PERSIST_RETRY_MIN_MS 100     // 提交失败后首次重试的间隔 (ms)，之后每次加倍
+#define PERSIST_RETRY_MAX_MS 10000   // 重试间隔上限 (ms)
+#define PERSIST_TASK_STACK 3072      // 后台任务栈大小 (字节)
+#define PERSIST_TASK_PRIORITY 0      // 与空闲任务同级，只在主循环让出CPU时运行
 
 // 历史数据配置
 #define MAX_HISTORY_DAYS 7           // 保存7天历史数据
 #define DAILY_DATA_SIZE 16           // 每日数据大小 (字节)
 
+// 会话曲线记录配置 (LittleFS)
+#define SESSION_RECORD_DIR "/sessions"   // 会话记录目录
+#define SESSION_RECORD_INTERVAL 1000     // 降采样间隔 (ms)，1Hz
+#define SESSION_RECORD_BLOCK_SIZE 64     // RAM缓冲块大小 (点数)，满块后写入Flash
+#define SESSION_RECORD_MAX_FILES 16      // 最多保留的会话记录数
+
+// 滚动统计配置 (LittleFS)
+#define ROLLING_WEEK_DAYS 7              // 周统计窗口 (含今天)
+#define ROLLING_MONTH_DAYS 30            // 月统计窗口 (含今天)
+#define ROLLING_STATS_FILE "/rolling.bin" // 每日摘要环形缓冲文件
+
+// 数据导出配置 (串口)
+#define EXPORT_FORMAT_VERSION 1          // 导出格式版本
+#define EXPORT_CHUNK_SIZE 32             // 每行输出的数据字节数 (十六进制编码后翻倍)
+#define EXPORT_LINES_PER_UPDATE 2        // 每次主循环最多输出的行数
+#define EXPORT_LINE_MAX 96               // 导入时单行最大长度
+
+// 串口命令台配置
+#define CONSOLE_LINE_MAX 160             // 单次回复最大长度 (字节)，超出部分截断
+
+// 二进制遥测配置 (串口)
+#define TELEMETRY_VERSION 1              // 遥测包格式版本
+#define TELEMETRY_PACKET_MAX 64          // 单个遥测包最大字节数 (不含COBS编码和帧分隔)
+#define TELEMETRY_FRAME_MAX (TELEMETRY_PACKET_MAX + TELEMETRY_PACKET_MAX / 254 + 3)
+
 // ==================== 调试配置 ====================
 #define DEBUG 1
 
@@ -273,28 +404,88 @@
   #define DEBUG_LEVEL DEBUG_LEVEL_DEBUG
 #endif
 
+// 按模块覆盖日志级别 (编译期生效，未列出的模块使用DEBUG_LEVEL)
+// 每项格式 { "模块名", 级别 }, (末尾逗号不能省略)，例如：
+//   { "STATE", DEBUG_LEVEL_WARN }, { "OLED", DEBUG_LEVEL_NONE },
+// 也可以在platformio.ini中用 -DDEBUG_MODULE_LEVELS=... 覆盖
+#ifndef DEBUG_MODULE_LEVELS
+  #define DEBUG_MODULE_LEVELS
+#endif
+
 // 串口配置
 #define DEBUG_SERIAL_SPEED 115200
+#define DEBUG_SERIAL_WAIT_MS 200     // 启动时等待USB串口连接的最长时间 (ms)
 #define DEBUG_BUFFER_SIZE 256
 
+// 延迟二进制日志: 调用处只把格式串地址和原始参数写入环形缓冲，
+// 由低优先级任务编码为 @LG 行输出，主机上用 scripts/zen_log.py 配合固件ELF还原文本
+#ifndef DEBUG_DEFERRED_LOG
+  #define DEBUG_DEFERRED_LOG 1       // 0: 调用处直接格式化输出 (不需要解码工具)
+#endif
+#define DEFERRED_LOG_BUFFER_SIZE 4096  // 环形缓冲大小 (字节)，写满时丢弃新记录并计数
+#define DEFERRED_LOG_MAX_RECORD 96     // 单条记录上限 (字节)
+#define DEFERRED_LOG_MAX_STRING 40     // 字符串参数最多拷贝的字节数
+#define DEFERRED_LOG_DRAIN_INTERVAL 20 // 后台输出间隔 (ms)
+#define DEFERRED_LOG_TASK_STACK 3072
+#define DEFERRED_LOG_TASK_PRIORITY 1   // 与主循环同级，主循环阻塞等待事件时输出
+
+// 性能计时器 (PERF_SCOPE / PERFORMANCE_START): 按名称的编译期哈希开放寻址
+#define PERF_TIMER_SLOTS 16            // 计时器数量上限 (2的幂)
+#define PERF_HISTOGRAM_BUCKETS 20      // 按2的幂分桶: 桶i为 [2^i, 2^(i+1)) us，最后一桶包含更长的耗时
+
 // 调试宏定义
 #if DEBUG
-  #define DEBUG_INIT() Serial.begin(DEBUG_SERIAL_SPEED); delay(1000)
+  // 只在USB串口尚未连接时短暂等待，不再固定延迟1秒
+  #define DEBUG_INIT() do { \
+    Serial.begin(DEBUG_SERIAL_SPEED); \
+    for (unsigned long _start = millis(); !Serial && millis() - _start < DEBUG_SERIAL_WAIT_MS; ) delay(10); \
+    DEBUG_LOG_BEGIN(); \
+  } while (0)
   #define DEBUG_PRINT(x) Serial.print(x)
   #define DEBUG_PRINTLN(x) Serial.println(x)
   #define DEBUG_PRINTF(format, ...) Serial.printf(format, ##__VA_ARGS__)
 
+  // 级别和模块名都是常量，是否输出在编译期确定，关闭的语句连同参数求值一起被删除
+  #include "log_filter.h"
+  #define DEBUG_LOG_ENABLED(level, module) LogFilter::Enabled<LogFilter::enabled(level, module)>::value
+
+  #if DEBUG_DEFERRED_LOG
+  #include "deferred_log.h"
+  // 只记录模块名/格式串地址和参数，格式化在主机上完成，两者都必须是字符串常量；
+  // "" format 让非字面量格式串在编译时报错
+  #define DEBUG_LOG_WRITE(level, module, format, ...) \
+    DeferredLog::log(level, module, "" format, ##__VA_ARGS__)
+  #define DEBUG_LOG_BEGIN() DeferredLog::begin()
+  #define DEBUG_FLUSH() DeferredLog::flush()
+  #else
   // 带时间戳的调试输出
+  #define DEBUG_LOG_WRITE(level, module, format, ...) \
+    do { \
+      Serial.printf("[%08lu][%s][%s] ", millis(), module, \
+        (level == DEBUG_LEVEL_ERROR) ? "ERROR" : \
+        (level == DEBUG_LEVEL_WARN) ? "WARN" : \
+        (level == DEBUG_LEVEL_INFO) ? "INFO" : \
+        (level == DEBUG_LEVEL_DEBUG) ? "DEBUG" : "VERBOSE"); \
+      Serial.printf(format, ##__VA_ARGS__); \
+      Serial.println(); \
+    } while(0)
+  #define DEBUG_LOG_BEGIN()
+  #define DEBUG_FLUSH() Serial.flush()
+  #endif
+
   #define DEBUG_LOG(level, module, format, ...) \
     do { \
-      if (level <= DEBUG_LEVEL) { \
-        Serial.printf("[%08lu][%s][%s] ", millis(), module, \
-          (level == DEBUG_LEVEL_ERROR) ? "ERROR" : \
-          (level == DEBUG_LEVEL_WARN) ? "WARN" : \
-          (level == DEBUG_LEVEL_INFO) ? "INFO" : \
-          (level == DEBUG_LEVEL_DEBUG) ? "DEBUG" : "VERBOSE"); \
-        Serial.printf(format, ##__VA_ARGS__); \
-        Serial.println(); \
+      if (DEBUG_LOG_ENABLED(level, module)) { \
+        DEBUG_LOG_WRITE(level, module, format, ##__VA_ARGS__); \
+      } \
+    } while(0)
+
+  // 模块名在运行时才确定 (例如DiagnosticUtils::reportError转发调用者的模块名)，
+  // 按同一张表在运行时判断
+  #define DEBUG_LOG_DYNAMIC(level, module, format, ...) \
+    do { \
+      if (LogFilter::enabled(level, module)) { \
+        DEBUG_LOG_WRITE(level, module, format, ##__VA_ARGS__); \
       } \
     } while(0)
 
@@ -328,6 +519,8 @@
   #define DEBUG_PRINTLN(x)
   #define DEBUG_PRINTF(format, ...)
   #define DEBUG_LOG(level, module, format, ...)
+  #define DEBUG_LOG_DYNAMIC(level, module, format, ...)
+  #define DEBUG_FLUSH()
   #define DEBUG_ERROR(module, format, ...)
   #define DEBUG_WARN(module, format, ...)
   #define DEBUG_INFO(module, format, ...)
@@ -360,6 +553,17 @@ extern const uint32_t I2C_CLOCK_SPEEDS[I2C_CLOCK_SPEEDS_COUNT];
 #define ERROR_TONE_COUNT 3
 #define ERROR_TONE_INTERVAL 300
 
+// 内存监控配置
+// HEAP_TRACKING需要链接参数 -Wl,--wrap=malloc,--wrap=free,--wrap=realloc,--wrap=calloc
+// (platformio.ini的调试构建中已配置)，否则只统计堆碎片和任务栈
+#ifndef HEAP_TRACKING
+  #define HEAP_TRACKING 0
+#endif
+#define HEAP_TRACK_SLOTS 128           // 按模块统计的分配块数量上限 (2的幂)
+#define MEMORY_HISTORY_SIZE 12         // 堆碎片采样历史 (每次定期报告一个)
+#define MEMORY_MAX_TASKS 6             // 记录栈高水位的任务数量上限
+#define MEMORY_STACK_WARN_BYTES 512    // 任务栈剩余低于该值时告警
+
 // ==================== 系统状态定义 ====================
 enum SystemState {
   STATE_BOOT_ANIMATION, // 开机动画状态
@@ -373,13 +577,79 @@ enum SystemState {
   STATE_HISTORY,        // 历史数据状态
   STATE_SLEEP           // 休眠状态
 };
+#define SYSTEM_STATE_COUNT (STATE_SLEEP + 1)
+
+// ==================== 提示音定义 ====================
+enum SoundPattern {
+  SOUND_BREAK_WARNING,  // 破定提醒
+  SOUND_SUCCESS,        // 成功
+  SOUND_ERROR,          // 操作错误 (两声下降)
+  SOUND_START,          // 开始 (三声上升)
+  SOUND_STOP,           // 停止 (三声下降)
+  SOUND_ERROR_ALERT,    // 系统错误报警 (诊断模块)
+  SOUND_PATTERN_COUNT
+};
+
+// ==================== 功耗部件定义 ====================
+enum EnergyConsumer {
+  ENERGY_CPU,           // CPU (按负载和工作点计算)
+  ENERGY_DISPLAY,       // OLED显示屏 (按亮度计算)
+  ENERGY_IMU,           // MPU6050
+  ENERGY_BUZZER,        // 蜂鸣器 (按音量计算)
+  ENERGY_BOARD,         // 常开部分
+  ENERGY_CONSUMER_COUNT
+};
+
+// ==================== 堆内存归属模块定义 ====================
+enum HeapTag {
+  HEAP_TAG_OTHER,       // 未标记 (不逐块跟踪)
+  HEAP_TAG_DISPLAY,     // 显示字符串
+  HEAP_TAG_EXPORT,      // 数据导出/导入缓冲、文件句柄
+  HEAP_TAG_LOG,         // 日志与诊断报告的格式化字符串
+  HEAP_TAG_COUNT
+};
+
+// ==================== 事件总线事件定义 ====================
+enum BusEventType {
+  BUS_EVENT_SCORE = 0,             // 每次传感器读取得到新的稳定性评分
+  BUS_EVENT_BREAK,                 // 检测到一次破定
+  BUS_EVENT_SESSION_START,         // 练习会话开始 (或休眠唤醒后恢复)
+  BUS_EVENT_SESSION_STOP,          // 练习会话结束
+  BUS_EVENT_STATS,                 // 今日/近7天/近30天统计已变化
+  BUS_EVENT_BATTERY,               // 电量、剩余时间、充电或低电量状态变化
+  BUS_EVENT_SETTINGS,              // 系统设置已修改
+  BUS_EVENT_COUNT
+};
+
+// ==================== 主循环阶段定义 ====================
+enum LoopStage {
+  LOOP_STAGE_SENSOR,    // 传感器读取与评分
+  LOOP_STAGE_INPUT,     // 按钮/运动手势处理
+  LOOP_STAGE_POWER,     // 电源管理
+  LOOP_STAGE_STATE,     // 系统状态机
+  LOOP_STAGE_DISPLAY,   // 显示刷新
+  LOOP_STAGE_SAVE,      // 数据保存
+  LOOP_STAGE_SERIAL,    // 串口导出/导入
+  LOOP_STAGE_REPORT,    // 定期系统报告
+  LOOP_STAGE_COUNT
+};
 
 // ==================== 按钮状态定义 ====================
 enum ButtonState {
   BUTTON_IDLE,
   BUTTON_PRESSED,
   BUTTON_LONG_PRESSED,
-  BUTTON_DOUBLE_PRESSED
+  BUTTON_DOUBLE_PRESSED,
+  BUTTON_TRIPLE_PRESSED,
+  BUTTON_LONG_LONG_PRESSED,    // 按住超过超长按阈值 (按住期间触发)
+  BUTTON_HOLD_REPEAT,          // 连击后按住的自动重复，pressCount为按住的是第几次按下
+  BUTTON_TILT_LEFT,            // 运动手势: 向左倾斜 (保持时重复)
+  BUTTON_TILT_RIGHT            // 运动手势: 向右倾斜 (保持时重复)
+};
+
+enum InputSource {
+  INPUT_SOURCE_BUTTON,
+  INPUT_SOURCE_MOTION
 };
 
 // ==================== 显示页面定义 ====================
@@ -390,7 +660,8 @@ enum DisplayPage {
   PAGE_STATS,           // 统计页面
   PAGE_SETTINGS,        // 设置页面
   PAGE_CALIBRATION,     // 校准页面
-  PAGE_HISTORY          // 历史页面
+  PAGE_HISTORY,         // 历史页面
+  PAGE_ENERGY           // 功耗统计页面
 };
 
 // ==================== 主菜单选项定义 ====================
@@ -0,0 +1,141 @@
+#ifndef DATA_EXPORTER_H
+#define DATA_EXPORTER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "config.h"
+#include "data_types.h"
+#include "rolling_stats.h"
+
+class DataManager;
+
+// ==================== 导出格式 ====================
+// 二进制流由若干记录组成: [类型1字节][长度1字节][负载]，多字节字段均为小端
+// 最后一条为EXPORT_REC_END，负载为之前所有字节的CRC32 (与zlib.crc32一致)
+// 串口上以文本行传输，避免与调试日志混在一起时损坏:
+//   二进制: "@EXB <4位十六进制序号> <十六进制数据>"
+//   CSV:    "@EXC <一行CSV>"，最后一行为 "@EXC #crc32=<8位十六进制>"
+// 主机端解码工具: scripts/zen_export.py
+enum ExportFormat {
+  EXPORT_BINARY = 0,
+  EXPORT_CSV
+};
+
+enum ExportRecordType {
+  EXPORT_REC_HEADER = 0x01,        // 魔数"ZEX1" + 版本
+  EXPORT_REC_SETTINGS = 0x02,      // 系统设置
+  EXPORT_REC_DAY = 0x10,           // 每日统计 (槽位0为今日，1..7为历史)
+  EXPORT_REC_ROLLING_DAY = 0x11,   // 滚动统计每日摘要 (按时间先后)
+  EXPORT_REC_SESSION = 0x20,       // 会话记录文件片段 [会话序号4字节][原始文件字节]
+  EXPORT_REC_END = 0xFF            // CRC32
+};
+
+// ==================== 导入结果 ====================
+struct ImportBundle {
+  bool hasSettings;
+  SystemSettings settings;
+  int dayCount;                                  // 已收到的槽位数
+  DailyStats days[MAX_HISTORY_DAYS + 1];         // 0为今日，之后为历史
+  int rollingCount;
+  DaySummary rollingDays[ROLLING_MONTH_DAYS - 1];
+};
+
+// ==================== 流式导出器 ====================
+// 每次update()只生成并输出少量数据行，且只在串口发送缓冲有空间时输出，
+// 不会阻塞主循环，也不需要一次性把全部数据放进内存
+class DataExporter {
+private:
+  enum Stage {
+    STAGE_IDLE = 0,
+    STAGE_HEADER,
+    STAGE_SETTINGS,
+    STAGE_DAYS,
+    STAGE_ROLLING,
+    STAGE_SESSIONS,
+    STAGE_END,
+    STAGE_FLUSH
+  };
+
+  const DataManager* source = nullptr;
+  ExportFormat format = EXPORT_BINARY;
+  Stage stage = STAGE_IDLE;
+  int cursor = 0;                  // 当前阶段内的索引
+  uint32_t sessionId = 0;          // 正在导出的会话
+  uint32_t lastSessionId = 0;
+  File sessionFile;
+
+  // 输出缓冲：二进制为待输出的记录字节 (一条记录最长257字节)，CSV为一整行已格式化的文本
+  uint8_t pending[EXPORT_CHUNK_SIZE + 260];
+  size_t pendingLength = 0;
+  uint16_t lineSequence = 0;
+  uint32_t crc = 0;
+  uint32_t bytesWritten = 0;
+
+  // 生成
+  bool produceNext();
+  bool produceSessionChunk();
+  void appendRecord(uint8_t type, const uint8_t* payload, uint8_t length);
+  void appendCsvLine(const char* line);
+  // 输出一行，串口发送缓冲放不下整行时返回false (不输出)
+  bool emitLine(size_t length);
+  bool emitCsvLine();
+
+public:
+  DataExporter();
+
+  bool begin(const DataManager& dataManager, ExportFormat exportFormat);
+  void update();
+  void cancel();
+  bool isActive() const;
+  uint32_t getBytesWritten() const;
+
+  // 字段编码（导入导出共用）
+  static uint8_t encodeSettings(const SystemSettings& settings, uint8_t* out);
+  static bool decodeSettings(const uint8_t* in, uint8_t length, SystemSettings& settings);
+  static uint8_t encodeDay(uint8_t slot, const DailyStats& stats, uint8_t* out);
+  static bool decodeDay(const uint8_t* in, uint8_t length, uint8_t& slot, DailyStats& stats);
+  static uint8_t encodeSummary(const DaySummary& day, uint8_t* out);
+  static bool decodeSummary(const uint8_t* in, uint8_t length, DaySummary& day);
+
+  static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t length);
+};
+
+// ==================== 流式导入器 ====================
+// 逐行接收"@EXB"文本行，边解析边校验，CRC通过后才交给DataManager应用
+class DataImporter {
+private:
+  enum State {
+    IMPORT_WAIT_TYPE = 0,
+    IMPORT_WAIT_LENGTH,
+    IMPORT_PAYLOAD
+  };
+
+  ImportBundle bundle;
+  State state = IMPORT_WAIT_TYPE;
+  uint8_t recordType = 0;
+  uint8_t recordLength = 0;
+  uint8_t payload[255];
+  uint8_t payloadCount = 0;
+  uint32_t crc = 0;
+  uint32_t recordStartCrc = 0;     // 当前记录之前所有字节的CRC
+  uint16_t expectedSequence = 0;
+  bool active = false;
+  bool complete = false;
+  bool failed = false;
+
+  void reset();
+  void feedByte(uint8_t value);
+  void handleRecord();
+  void fail(const char* reason);
+
+public:
+  DataImporter();
+
+  bool feedLine(const char* line);   // 返回该行是否属于导入数据
+  bool isComplete() const;
+  bool hasFailed() const;
+  const ImportBundle& getBundle() const;
+  void clear();
+};
+
+#endif // DATA_EXPORTER_H
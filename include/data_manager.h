@@ -2,19 +2,30 @@
 #define DATA_MANAGER_H
 
 #include <Arduino.h>
-#include <EEPROM.h>
 #include "config.h"
+#include "persistence_worker.h"
 #include "data_types.h"
 #include "time_manager.h"
+#include "session_recorder.h"
+#include "stability_stats.h"
+#include "rolling_stats.h"
+#include "data_exporter.h"
+#include "rtc_state.h"
+#include "event_bus.h"
 
 class DataManager {
 private:
   // 当前会话数据
   PracticeSession currentSession;
   
+  // 会话流式统计
+  StabilityAggregator sessionAggregator;
+  
   // 统计数据
   DailyStats todayStats;
   DailyStats historyStats[MAX_HISTORY_DAYS];
+  StabilityHistogram todayHistogram;   // 今日评分直方图，用于计算日分位数
+  RollingStats rollingStats;           // 滚动周/月统计
   
   // 系统设置
   SystemSettings settings;
@@ -23,12 +34,16 @@ private:
   unsigned long lastSaveTime = 0;
   bool dataChanged = false;
   
+  // 会话曲线记录
+  SessionRecorder recorder;
+  
   // 时间管理
   TimeManager* timeManager = nullptr;
   DateTime lastCheckDate;
   
   // 内部方法
   void initializeDefaultSettings();
+  void updateSessionAggregates();
   void updateTodayStats();
   void saveToEEPROM();
   void loadFromEEPROM();
@@ -36,14 +51,21 @@ private:
   void rotateHistoryData();
   void moveTodayToHistory();
   void resetTodayStats();
+  void loadRollingStats();
+  void saveRollingStats();
   uint8_t getCurrentDayOfWeek();
   void calculateWeeklyStats(unsigned long& totalTime, int& totalSessions, float& avgStability);
   
+  // 订阅传感器的评分和破定事件
+  static void onBusEvent(const BusEvent& event, void* context);
+  
 public:
   DataManager();
   
   // 初始化
   bool initialize(TimeManager* timeManager = nullptr);
+  // 订阅评分和破定事件；initialize()可能在启动数据任务中运行，订阅须在主循环任务中单独调用
+  void subscribeEvents();
   void reset();
   
   // 会话管理
@@ -59,6 +81,11 @@ public:
   unsigned long getSessionDuration() const;
   void updateSessionStability(float score);
   
+  // 会话曲线回放
+  uint32_t getLatestRecordedSession() const;
+  size_t loadSessionSeries(uint32_t sessionId, uint8_t* points, size_t maxPoints) const;
+  File openSessionRecord(uint32_t sessionId) const;
+  
   // 统计数据
   DailyStats getTodayStats() const;
   DailyStats getHistoryStats(int daysAgo) const;
@@ -82,13 +109,19 @@ public:
   float getBestStability() const;
   int getTotalBreaks() const;
   
-  // 历史数据
+  // 历史数据（滚动窗口，含今日）
+  PeriodStats getWeekStats() const;
+  PeriodStats getMonthStats() const;
   void getWeeklyStats(unsigned long& totalTime, int& totalSessions, float& avgStability);
   void getMonthlyStats(unsigned long& totalTime, int& totalSessions, float& avgStability);
+  const RollingStats& getRollingStats() const;
+  
+  // 深度休眠状态保持（保存时会暂停进行中的会话）
+  void captureResumeState(SessionResumeState& state);
+  void restoreResumeState(const SessionResumeState& state);
   
-  // 数据导出/导入
-  String exportData() const;
-  bool importData(const String& data);
+  // 数据导入（导出由DataExporter流式读取上面的查询接口完成）
+  bool importData(const ImportBundle& bundle);
   
   // 调试功能
   void printSessionInfo() const;
@@ -11,6 +11,14 @@ struct SensorData {
   unsigned long timestamp;         // 时间戳 (ms)
 };
 
+// ==================== 运动手势输入样本 ====================
+struct MotionSample {
+  float accelX, accelY, accelZ;    // 校准、滤波后的加速度 (g)，用于倾斜判定
+  float shock;                     // 未滤波加速度模长偏离1g的幅度 (g)，用于敲击判定
+  bool hwMotion;                   // 自上次读取以来MPU6050运动检测是否触发
+  unsigned long timestamp;         // 时间戳 (ms)
+};
+
 // ==================== 稳定性数据结构 ====================
 struct StabilityData {
   float score;                     // 当前稳定性评分 (0-100)
@@ -28,9 +36,13 @@ struct PracticeSession {
   unsigned long startTime;         // 开始时间 (ms)
   unsigned long endTime;           // 结束时间 (ms)
   unsigned long duration;          // 持续时间 (ms)
-  float avgStability;              // 平均稳定性
+  float avgStability;              // 平均稳定性 (按时间加权)
   float maxStability;              // 最高稳定性
   float minStability;              // 最低稳定性
+  float medianStability;           // 稳定性中位数
+  float p10Stability;              // 稳定性P10
+  float p90Stability;              // 稳定性P90
+  unsigned long stableTime;        // 高于阈值的累计时长 (ms)
   int breakCount;                  // 破定次数
   bool completed;                  // 是否完成
 };
@@ -40,11 +52,25 @@ struct DailyStats {
   uint16_t year;                   // 年份
   uint8_t month;                   // 月份
   uint8_t day;                     // 日期
-  unsigned long totalTime;         // 总练习时间 (ms)
+  uint32_t totalTime;              // 总练习时间 (ms)
+  int sessionCount;                // 练习次数
+  float avgStability;              // 平均稳定性 (按时间加权)
+  float bestStability;             // 最佳稳定性
+  int totalBreaks;                 // 总破定次数
+  uint32_t stableTime;             // 高于阈值的累计时长 (ms)
+  float medianStability;           // 稳定性中位数
+  float p10Stability;              // 稳定性P10
+  float p90Stability;              // 稳定性P90
+};
+
+// ==================== 周期统计数据结构 ====================
+struct PeriodStats {
+  uint32_t totalTime;              // 总练习时间 (ms)
   int sessionCount;                // 练习次数
-  float avgStability;              // 平均稳定性
+  float avgStability;              // 平均稳定性 (按时间加权)
   float bestStability;             // 最佳稳定性
   int totalBreaks;                 // 总破定次数
+  int activeDays;                  // 有练习的天数
 };
 
 // ==================== 系统设置数据结构 ====================
@@ -52,9 +78,9 @@ struct SystemSettings {
   float stabilityThreshold;        // 稳定性阈值
   bool soundEnabled;               // 声音开关
   uint8_t displayBrightness;       // 显示亮度 (0-255)
-  unsigned long practiceTime;      // 默认练习时间 (ms)
+  uint32_t practiceTime;           // 默认练习时间 (ms)
   bool autoSleep;                  // 自动休眠开关
-  unsigned long sleepTimeout;      // 休眠超时时间 (ms)
+  uint32_t sleepTimeout;           // 休眠超时时间 (ms)
   bool calibrationEnabled;         // 自动校准开关
   uint8_t language;                // 语言设置 (0: 中文, 1: 英文)
 };
@@ -64,7 +90,26 @@ struct CalibrationData {
   float accelOffsetX, accelOffsetY, accelOffsetZ;  // 加速度偏移
   float gyroOffsetX, gyroOffsetY, gyroOffsetZ;     // 陀螺仪偏移
   bool isCalibrated;                               // 是否已校准
-  unsigned long calibrationTime;                   // 校准时间
+  uint32_t calibrationTime;                        // 校准时间
+};
+
+// ==================== 功耗统计数据结构 ====================
+struct EnergyReport {
+  uint32_t totalMs;                              // 统计时长 (ms)
+  float totalMah;                                // 估算总耗电 (mAh)
+  uint32_t consumerOnMs[ENERGY_CONSUMER_COUNT];  // 各部件工作时间 (占空比 = 工作时间 / 统计时长)
+  float consumerMah[ENERGY_CONSUMER_COUNT];      // 各部件耗电 (mAh)
+  uint32_t stateMs[SYSTEM_STATE_COUNT];          // 各系统状态停留时间 (ms)
+  float stateMah[SYSTEM_STATE_COUNT];            // 各系统状态耗电 (mAh)
+};
+
+// ==================== 电池状态数据结构 ====================
+struct BatteryStatus {
+  float voltage;                   // 电池电压 (滤波后)
+  uint8_t percent;                 // 估算电量 (%)
+  uint32_t remainingMinutes;       // 估算剩余练习时间 (分钟)
+  bool isCharging;                 // 是否在充电
+  bool lowBattery;                 // 低电量标志
 };
 
 // ==================== 系统状态数据结构 ====================
@@ -73,6 +118,8 @@ struct SystemStatus {
   DisplayPage currentPage;         // 当前显示页面
   unsigned long lastActivity;      // 最后活动时间
   float batteryVoltage;            // 电池电压
+  uint8_t batteryPercent;          // 估算电量 (%)
+  uint32_t remainingMinutes;       // 估算剩余练习时间 (分钟)
   bool isCharging;                 // 是否在充电
   bool lowBattery;                 // 低电量标志
   unsigned long uptime;            // 运行时间
@@ -86,6 +133,9 @@ struct ButtonEvent {
   unsigned long pressTime;         // 按下时间
   unsigned long releaseTime;       // 释放时间
   unsigned long duration;          // 按下持续时间
+  uint8_t pressCount;              // 手势中的按下次数 (单击1，双击2...)
+  uint16_t repeatCount;            // 自动重复序号 (BUTTON_HOLD_REPEAT和倾斜事件)
+  InputSource source;              // 事件来源 (按钮/运动手势)
   bool processed;                  // 是否已处理
 };
 
@@ -113,12 +163,15 @@ struct ZenMotionData {
   StabilityData stability;         // 稳定性数据
   PracticeSession currentSession;  // 当前练习会话
   DailyStats todayStats;          // 今日统计
+  PeriodStats weekStats;           // 近7天统计
+  PeriodStats monthStats;          // 近30天统计
   SystemSettings settings;         // 系统设置
   CalibrationData calibration;     // 校准数据
   SystemStatus status;             // 系统状态
   ButtonEvent button;              // 按钮事件
   DisplayData display;             // 显示数据
   AudioData audio;                 // 音频数据
+  EnergyReport energy;             // 功耗统计
 };
 
 // ==================== 常用宏定义 ====================
@@ -0,0 +1,133 @@
+#ifndef DEFERRED_LOG_H
+#define DEFERRED_LOG_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "config.h"
+
+// ==================== 延迟二进制日志 ====================
+// 调用处不做任何字符串格式化：只把时间戳、级别、模块名和格式串的地址 (固件中的常量)
+// 以及原始参数写入一条记录，放入环形缓冲。低优先级任务把记录编码为
+//   @LG <十六进制记录>
+// 行输出到串口，主机上的 scripts/zen_log.py 根据固件ELF中的字符串还原为原来的文本格式。
+// 字符串参数 (%s) 的指针在输出时可能已失效，写入时直接拷贝内容。
+//
+// 记录格式 (小端):
+//   u8 总长度 | u8 级别 (bit7=参数被截断) | u32 时间戳ms | u32 模块名地址 | u32 格式串地址 | 参数...
+// 每个参数以类型标记开头:
+//   'i' u32整数  'q' u64整数  'd' double  's' u8长度+字符串内容  'p' u32指针
+#define LOG_TAG_INT     'i'
+#define LOG_TAG_INT64   'q'
+#define LOG_TAG_DOUBLE  'd'
+#define LOG_TAG_STRING  's'
+#define LOG_TAG_POINTER 'p'
+#define LOG_LEVEL_TRUNCATED 0x80
+#define LOG_RECORD_HEADER_SIZE 14
+
+class LogRecord {
+private:
+  uint8_t data[DEFERRED_LOG_MAX_RECORD];
+  uint8_t length;
+
+  bool reserve(uint8_t size);
+  void putU32(uint32_t value);
+
+public:
+  LogRecord(uint8_t level, const char* module, const char* format, uint32_t timestamp);
+
+  void addInt(uint32_t value);
+  void addInt64(uint64_t value);
+  void addDouble(double value);
+  void addString(const char* value);
+  void addPointer(const void* value);
+
+  // 按C++类型选择编码 (printf的默认参数提升规则：float按double，整数按其宽度)
+  void add(float value) { addDouble(value); }
+  void add(double value) { addDouble(value); }
+  void add(const char* value) { addString(value); }
+  void add(char* value) { addString(value); }
+  template <typename T>
+  void add(T* value) { addPointer(value); }
+  template <typename T>
+  void add(T value) {
+    // 整数、bool和枚举
+    if (sizeof(T) > 4) {
+      addInt64((uint64_t)value);
+    } else {
+      addInt((uint32_t)value);
+    }
+  }
+
+  const uint8_t* bytes() const { return data; }
+  uint8_t size() const { return length; }
+  bool isTruncated() const { return data[1] & LOG_LEVEL_TRUNCATED; }
+};
+
+// 多生产者 (任务/中断) 单消费者 (输出任务) 的字节环形缓冲
+// ESP32-C3没有原子指令，写入位置的预留和记录拷贝放在同一个很短的临界区内完成
+class LogRing {
+private:
+  uint8_t buffer[DEFERRED_LOG_BUFFER_SIZE];
+  volatile uint32_t head = 0;       // 写入位置 (持续递增，取模后为下标)
+  volatile uint32_t tail = 0;       // 读取位置 (仅消费者修改)
+  uint32_t pushed = 0;              // 写入的记录数
+  uint32_t dropped = 0;             // 缓冲满时丢弃的记录数
+  uint32_t reportedDropped = 0;     // 已经报告过的丢弃数 (仅消费者修改)
+  uint32_t highWater = 0;           // 最大占用 (字节)
+  portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+public:
+  // 写入一条记录，缓冲已满时丢弃并返回false
+  bool push(const uint8_t* record, uint8_t length);
+
+  // 取出一条记录，返回长度，没有记录时返回0
+  uint8_t pop(uint8_t* record);
+
+  // 上次调用以来新丢弃的记录数
+  uint32_t takeDropped();
+
+  uint32_t getUsed() const;
+  uint32_t getHighWater() const;
+  uint32_t getPushedCount() const;
+  uint32_t getDroppedCount() const;
+};
+
+class DeferredLog {
+private:
+  static LogRing ring;
+  static TaskHandle_t task;
+  static SemaphoreHandle_t drainLock;  // 输出任务和flush()互斥
+
+  static void taskMain(void* parameter);
+  static void drain(bool blocking);
+  static bool writeLine(const char* prefix, const uint8_t* data, uint8_t length, bool blocking);
+
+  static void encodeArgs(LogRecord&) {}
+  template <typename T, typename... Rest>
+  static void encodeArgs(LogRecord& record, T first, Rest... rest) {
+    record.add(first);
+    encodeArgs(record, rest...);
+  }
+
+public:
+  // 启动输出任务并输出格式串校验行 (串口初始化之后调用)
+  static bool begin();
+
+  // 记录一条日志：编码参数并写入环形缓冲，不做格式化也不等待串口
+  template <typename... Args>
+  static void log(uint8_t level, const char* module, const char* format, Args... args) {
+    LogRecord record(level, module, format, millis());
+    encodeArgs(record, args...);
+    ring.push(record.bytes(), record.size());
+  }
+
+  // 同步输出缓冲中的全部记录 (休眠、重启前调用)
+  static void flush();
+
+  static LogRing& getRing();
+  static void printStats();
+};
+
+#endif // DEFERRED_LOG_H
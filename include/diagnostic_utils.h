@@ -4,6 +4,7 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include "config.h"
+#include "perf_timer.h"
 
 class DiagnosticUtils {
 private:
@@ -17,7 +18,7 @@ public:
   static void printSystemInfo();
   static void printMemoryInfo();
   static void printChipInfo();
-  static void periodicSystemReport();
+  static bool periodicSystemReport();   // 本次输出了报告时返回true，便于追加各模块统计
   
   // I2C诊断
   static bool scanI2CBus();
@@ -58,19 +59,6 @@ public:
   static void printBuffer(const char* name, const uint8_t* buffer, size_t size);
   static String formatBytes(size_t bytes);
   static String formatUptime(unsigned long ms);
-  
-  // 性能监控
-  static void startPerformanceTimer(const char* name);
-  static void endPerformanceTimer(const char* name);
-  static void printPerformanceStats();
-};
-
-// 性能计时器结构
-struct PerformanceTimer {
-  const char* name;
-  unsigned long startTime;
-  unsigned long totalTime;
-  uint32_t callCount;
 };
 
 // 全局诊断状态
@@ -102,8 +90,8 @@ extern DiagnosticStatus g_diagnosticStatus;
     DiagnosticUtils::reportWarning(module, buffer); \
   } while(0)
 
-#define PERFORMANCE_START(name) DiagnosticUtils::startPerformanceTimer(name)
-#define PERFORMANCE_END(name) DiagnosticUtils::endPerformanceTimer(name)
+#define PERFORMANCE_START(name) PerfTimers::start(PERF_KEY(name), name)
+#define PERFORMANCE_END(name) PerfTimers::end(PERF_KEY(name), name)
 
 // 硬件测试按钮组合
 #define HARDWARE_TEST_BUTTON_COMBO_TIME 3000  // 长按3秒触发硬件测试
@@ -7,6 +7,7 @@
 #include "config.h"
 #include "data_types.h"
 #include "settings_menu.h"
+#include "event_bus.h"
 
 class DisplayManager {
 private:
@@ -18,6 +19,10 @@ private:
   bool isInitialized = false;
   bool needsUpdate = true;
   unsigned long lastUpdate = 0;
+  uint32_t busTimeUs = 0;          // 上次takeBusTimeUs()以来帧缓冲发送占用的时间
+  SystemState shownState = (SystemState)SYSTEM_STATE_COUNT;  // 上次绘制时的系统状态
+  int shownScore = -1;             // 最近一次评分事件的整数评分
+  bool shownStable = true;
 
   // 动画相关
   int animationFrame = 0;
@@ -31,6 +36,7 @@ private:
   unsigned long bootAnimationStartTime = 0;
   bool bootAnimationActive = false;
   int bootAnimationFrame = 0;
+  bool bootReady = false;          // 系统已初始化完成，动画可提前结束
 
   // 主菜单相关
   MainMenuOption currentMenuOption = MENU_START_PRACTICE;
@@ -40,6 +46,9 @@ private:
   SettingsMenuState settingsState;
   
   // 内部方法
+  static void onBusEvent(const BusEvent& event, void* context);
+  bool isAnimating(const ZenMotionData& data) const;
+  unsigned long getBootAnimationDuration() const;
   void drawBootAnimationPage(const ZenMotionData& data);
   void drawMainMenuPage(const ZenMotionData& data);
   void drawMainPage(const ZenMotionData& data);
@@ -47,13 +56,14 @@ private:
   void drawSettingsPage(const ZenMotionData& data);
   void drawCalibrationPage(const ZenMotionData& data);
   void drawHistoryPage(const ZenMotionData& data);
+  void drawEnergyPage(const ZenMotionData& data);
   void drawDateTimeEditPage(const ZenMotionData& data);
   
   // UI组件绘制方法
   void drawStabilityScore(int x, int y, float score, bool isStable);
   void drawTimeDisplay(int x, int y, unsigned long timeMs, bool showSeconds = true);
   void drawProgressBar(int x, int y, int width, int height, float percentage);
-  void drawBatteryIcon(int x, int y, float voltage, bool isCharging);
+  void drawBatteryIcon(int x, int y, uint8_t percentage, bool isCharging);
   void drawStatusIcons(const ZenMotionData& data);
   
   // 文本和图形辅助方法
@@ -76,7 +86,7 @@ public:
   DisplayManager();
   
   // 初始化和配置
-  bool initialize();
+  bool initialize(bool fastResume = false);  // fastResume: 休眠唤醒，跳过诊断和开机动画
   void reset();
   bool isReady() const;
   
@@ -90,6 +100,8 @@ public:
   void startBootAnimation();
   bool isBootAnimationActive() const;
   bool isBootAnimationComplete() const;
+  void setBootReady();             // 初始化完成，动画缩短到BOOT_ANIMATION_MIN_DURATION
+  void skipBootAnimation();        // 按键跳过 (仅在初始化完成后生效)
 
   // 主菜单管理
   void setMenuOption(MainMenuOption option);
@@ -109,6 +121,7 @@ public:
   void update(const ZenMotionData& data);
   void forceUpdate();
   bool needsRefresh() const;
+  uint32_t takeBusTimeUs();        // 返回帧发送 (I2C) 累计占用的时间 (us) 并清零，供调频区分CPU和总线耗时
   
   // 显示控制
   void setBrightness(uint8_t brightness);
@@ -0,0 +1,56 @@
+#ifndef ENERGY_PROFILER_H
+#define ENERGY_PROFILER_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "data_types.h"
+
+// ==================== 功耗统计 ====================
+// 记录各部件的开关状态和负载等级，按配置中的电流表积分出每个部件、
+// 每个系统状态的耗电量。部件状态或系统状态变化时先把之前的时间段结算掉，
+// 因此统计结果与调用频率无关。
+// CPU的电流按主循环忙碌时间在运行电流和空闲/轻度睡眠电流之间加权。
+class EnergyProfiler {
+private:
+  // 部件状态
+  bool active[ENERGY_CONSUMER_COUNT];
+  uint8_t level[ENERGY_CONSUMER_COUNT];         // 0-255，显示亮度、蜂鸣器音量等
+
+  // CPU工作点与本时间段内的忙碌时间
+  uint16_t cpuFreqMhz = DFS_MAX_FREQ_MHZ;
+  bool lightSleep = false;
+  uint64_t pendingBusyUs = 0;
+
+  uint8_t state = STATE_BOOT_ANIMATION;
+  uint32_t lastAccountMs = 0;
+  EnergyReport report = {};
+
+  void account(uint32_t nowMs);
+  float consumerCurrent(uint8_t consumer) const;
+
+public:
+  EnergyProfiler();
+
+  void begin(uint32_t nowMs);
+
+  // 系统状态变化
+  void setState(uint8_t systemState, uint32_t nowMs);
+
+  // 部件开关与负载等级 (255 = 满负载)
+  void setConsumer(EnergyConsumer consumer, bool on, uint8_t consumerLevel, uint32_t nowMs);
+
+  // CPU工作点变化，lightSleepEnabled表示空闲时会进入自动轻度睡眠
+  void setCpuOperatingPoint(uint16_t freqMhz, bool lightSleepEnabled, uint32_t nowMs);
+
+  // 主循环一次的忙碌时间
+  void addCpuBusy(uint32_t busyUs);
+
+  // 截至nowMs的统计结果
+  EnergyReport getReport(uint32_t nowMs);
+
+  // 统计结果换算为平均电流 (mA)
+  static float averageCurrent(float mah, uint32_t ms);
+  static const char* getConsumerName(uint8_t consumer);
+};
+
+#endif // ENERGY_PROFILER_H
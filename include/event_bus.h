@@ -0,0 +1,65 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "data_types.h"
+
+// ==================== 事件总线 ====================
+// 各管理器在数据变化时发布事件，关心的模块订阅后只在变化时更新自己的副本，
+// 不再每帧从各管理器复制整份数据。
+// 事件在发布者的调用中同步分发 (只在主循环任务中发布和订阅)，负载指向发布者内部的数据，
+// 只在处理函数执行期间有效，需要保留的内容由订阅者复制。处理函数中可以再发布其它事件。
+struct BusEvent {
+  BusEventType type;
+  union {
+    const StabilityData* stability;    // BUS_EVENT_SCORE, BUS_EVENT_BREAK
+    const PracticeSession* session;    // BUS_EVENT_SESSION_START, BUS_EVENT_SESSION_STOP
+    const BatteryStatus* battery;      // BUS_EVENT_BATTERY
+    const SystemSettings* settings;    // BUS_EVENT_SETTINGS
+    const void* payload;               // BUS_EVENT_STATS没有负载 (为nullptr)，从DataManager读取
+  };
+};
+
+typedef void (*BusHandler)(const BusEvent& event, void* context);
+
+class EventBus {
+private:
+  struct Subscriber {
+    uint16_t mask;                     // 订阅的事件位，0表示空槽
+    BusHandler handler;
+    void* context;
+  };
+
+  static Subscriber subscribers[EVENT_BUS_MAX_SUBSCRIBERS];
+  static uint8_t subscriberCount;
+  static uint32_t publishCount[BUS_EVENT_COUNT];
+  static uint32_t deliveryCount;
+
+  static void publish(BusEventType type, const void* payload);
+
+public:
+  static constexpr uint16_t mask(BusEventType type) {
+    return (uint16_t)(1u << type);
+  }
+
+  // 按订阅顺序调用处理函数，context原样传回 (通常为订阅者对象)；订阅表已满时返回false
+  static bool subscribe(uint16_t eventMask, BusHandler handler, void* context = nullptr);
+  static void unsubscribe(BusHandler handler, void* context = nullptr);
+
+  static void publishScore(const StabilityData& stability);
+  static void publishBreak(const StabilityData& stability);
+  static void publishSession(BusEventType type, const PracticeSession& session);
+  static void publishStats();
+  static void publishBattery(const BatteryStatus& battery);
+  static void publishSettings(const SystemSettings& settings);
+
+  static uint32_t getPublishCount(BusEventType type);
+  static uint32_t getDeliveryCount();
+  static void printStats();
+
+  // 清空订阅表和计数 (测试用)
+  static void reset();
+};
+
+#endif // EVENT_BUS_H
@@ -0,0 +1,73 @@
+#ifndef FREQUENCY_GOVERNOR_H
+#define FREQUENCY_GOVERNOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ==================== 动态调频策略 ====================
+// 主循环每次结束时上报本次的忙碌时间 (传感器 + 渲染 + 串口等，不含delay)，
+// 以及其中I2C传输 (传感器读取、显示帧发送) 占用的时间。
+// 每个统计窗口结束时，把实测负载换算到各工作点：只有CPU部分与频率成反比，
+// I2C传输按总线速率进行，换算时保持不变。选出满足以下条件的最低频率:
+//   - 平均负载不超过目标
+//   - 单次循环的CPU部分不超过预算，加上I2C传输后不超过传感器周期
+// 单次循环的CPU部分超出预算或用户操作时立即升到最高工作点。
+struct GovernorStats {
+  uint32_t residencyMs[DFS_LEVEL_COUNT];   // 各工作点累计停留时间
+  uint32_t lightSleepMs;                   // 允许自动轻度睡眠的累计时间
+  uint32_t switchCount;                    // 工作点切换次数
+  uint32_t deadlineMisses;                 // 单次循环超过传感器周期的次数
+  uint16_t loadPermille;                   // 最近一个窗口的负载 (‰，按当时频率)
+  uint32_t maxBusyUs;                      // 最近一个窗口内最长的单次循环 (us)
+};
+
+class FrequencyGovernor {
+private:
+  static const uint16_t levels[DFS_LEVEL_COUNT];
+
+  uint8_t minLevel = 0;
+  uint8_t ceiling = 0;             // 当前允许的最高工作点 (低电量时下调)
+  uint8_t level = 0;
+  bool lightSleep = false;
+
+  // 统计窗口
+  uint32_t windowStartMs = 0;
+  uint64_t windowBusyUs = 0;
+  uint64_t windowIoUs = 0;
+  uint32_t windowMaxBusyUs = 0;
+  uint32_t windowMaxCpuUs = 0;
+  uint32_t windowMaxIoUs = 0;
+  uint32_t lastAccountMs = 0;
+  uint32_t boostUntilMs = 0;
+
+  GovernorStats stats = {};
+
+  void account(uint32_t nowMs);
+  void resetWindow(uint32_t nowMs);
+  uint64_t projectBusy(uint64_t busyUs, uint64_t ioUs, uint8_t index) const;
+  uint8_t selectLevel(uint32_t windowUs) const;
+  static uint8_t levelForFrequency(uint16_t freqMhz);
+
+public:
+  FrequencyGovernor();
+
+  void begin(uint32_t nowMs);
+
+  // 上报一次循环的忙碌时间及其中的I2C传输时间，工作点或睡眠策略变化时返回true
+  bool update(uint32_t busyUs, uint32_t ioUs, uint32_t nowMs);
+
+  // 用户操作后短时间内保持最高频率，保证响应
+  void boost(uint32_t nowMs, uint32_t durationMs);
+
+  // 设置频率上限 (MHz)
+  void setCeiling(uint16_t maxFreqMhz);
+
+  // 当前工作点
+  uint16_t getFrequency() const;
+  bool isLightSleepAllowed() const;
+  GovernorStats getStats(uint32_t nowMs);
+
+  static uint16_t getLevelFrequency(uint8_t index);
+};
+
+#endif // FREQUENCY_GOVERNOR_H
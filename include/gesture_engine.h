@@ -0,0 +1,71 @@
+#ifndef GESTURE_ENGINE_H
+#define GESTURE_ENGINE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "data_types.h"
+
+// ==================== 按钮手势识别 ====================
+// 输入为防抖后的按下/松开边沿 (带边沿时间戳) 和定时检查，输出ButtonEvent。
+// 手势由规则表描述：以本次手势的按下次数为下标，每行给出
+// 松开时按持续时间分类 (短按/长按) 产生的事件、按住到超长按阈值时产生的事件，
+// 以及按住时是否自动重复。识别只需查表，与手势种类数无关。
+//   - 短按松开后，若规则表中还有更多连击的手势，等待GESTURE_MULTI_CLICK_WINDOW
+//     再决定；否则立即产生事件
+//   - 长按在松开时判定，超长按在按住到达阈值时立即触发
+//   - 允许自动重复时，连击的最后一次按住超过GESTURE_REPEAT_DELAY后周期性产生
+//     BUTTON_HOLD_REPEAT，重复若干次后加速；松开后不再产生其它事件
+enum GestureHoldClass {
+  GESTURE_HOLD_SHORT,
+  GESTURE_HOLD_LONG,
+  GESTURE_HOLD_LONG_LONG,
+  GESTURE_HOLD_CLASS_COUNT
+};
+
+struct GestureRule {
+  ButtonState events[GESTURE_HOLD_CLASS_COUNT];  // 按持续时间分类产生的事件，BUTTON_IDLE表示不识别
+  bool repeatOnHold;                             // 按住时自动重复
+};
+
+class GestureEngine {
+private:
+  bool pressed = false;
+  unsigned long pressTime = 0;
+  unsigned long lastReleaseTime = 0;
+  uint8_t pressCount = 0;           // 当前手势已经按下的次数
+  bool pendingRelease = false;      // 短按已松开，等待可能的下一次按下
+  bool holdConsumed = false;        // 本次按住已经产生过事件 (超长按/自动重复)，松开时不再产生
+
+  bool repeatEnabled = false;
+  bool repeatArmed = false;         // 本次按住会自动重复
+  uint16_t repeatCount = 0;
+  unsigned long nextRepeatTime = 0;
+
+  static const GestureRule& ruleFor(uint8_t count);
+  static GestureHoldClass classify(unsigned long duration);
+  bool hasLongerGesture() const;
+  bool emit(ButtonState state, unsigned long releaseTime, ButtonEvent& event);
+
+public:
+  void reset();
+
+  // 当前界面是否需要按住自动重复 (如设置项数值调整)；关闭时按住按长按/超长按处理
+  void setRepeatEnabled(bool enabled);
+  bool isRepeatEnabled() const;
+
+  // 输入一个防抖后的边沿，产生事件时返回true
+  bool onEdge(bool isPressed, unsigned long edgeTime, ButtonEvent& event);
+
+  // 定时检查 (连击等待超时、超长按、自动重复)，产生事件时返回true
+  bool onTick(unsigned long currentTime, ButtonEvent& event);
+
+  // 距离下一次需要调用onTick()的时间 (ms)，没有时返回UINT32_MAX
+  uint32_t getNextDeadline(unsigned long currentTime) const;
+
+  bool isPressed() const;
+  unsigned long getPressTime() const;
+  uint8_t getPressCount() const;
+  bool isWaitingForMore() const;
+};
+
+#endif // GESTURE_ENGINE_H
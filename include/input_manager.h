@@ -2,38 +2,30 @@
 #define INPUT_MANAGER_H
 
 #include <Arduino.h>
-#include <Bounce2.h>
 #include "config.h"
 #include "data_types.h"
+#include "gesture_engine.h"
+#include "motion_gesture.h"
 
 class InputManager {
 private:
-  // Bounce2按钮对象
-  Bounce button;
-
   // 按钮事件状态
   ButtonEvent buttonEvent;
   bool hasEvent = false;  // 事件标志
-  unsigned long buttonPressTime = 0;
 
-  // 长按和双击检测
-  unsigned long longPressThreshold = 1000;   // 长按阈值 (ms)
-  unsigned long doubleClickThreshold = 300;  // 双击阈值 (ms)
-  unsigned long lastClickTime = 0;
-  bool waitingForDoubleClick = false;
-  bool pendingSingleClick = false;           // 待处理的单击事件
-  unsigned long singleClickDelayTime = 0;    // 单击延迟处理时间
+  // 单击/连击/长按/自动重复等手势识别
+  GestureEngine gestures;
+
+  // 敲击/倾斜运动手势 (练习和校准期间关闭)
+  MotionGesture motion;
+  bool motionEnabled = false;
   
-  // 蜂鸣器状态
+  // 蜂鸣器状态 (播放由AudioSequencer完成)
   AudioData audioData;
-  unsigned long buzzerStartTime = 0;
-  bool buzzerActive = false;
   
   // 内部方法
-  void processButtonEvent();
-  void handleSingleClick();
-  void handleDoubleClick();
-  void handleLongPress();
+  void setButtonEvent(const ButtonEvent& event);
+  void playPattern(SoundPattern pattern);
   
 public:
   InputManager();
@@ -47,11 +39,23 @@ public:
   ButtonEvent getButtonEvent();
   bool hasButtonEvent() const;
   void clearButtonEvent();
+
+  // 按住自动重复 (设置界面调整数值时开启)
+  void setHoldRepeatEnabled(bool enabled);
+
+  // 运动手势输入：每次读取传感器后调用，产生的事件与按钮事件走同一流程
+  void updateMotion(const MotionSample& sample);
+  void setMotionInputEnabled(bool enabled);
+  bool isMotionInputEnabled() const;
   
   // 按钮状态查询
   bool isButtonPressed() const;
   bool isButtonReleased() const;
   unsigned long getPressDuration() const;
+
+  // 距离下一次必须调用update()的时间 (ms)，没有待处理的定时事件时返回UINT32_MAX
+  // 按钮边沿本身由中断唤醒主循环，这里只覆盖防抖、连击判定、超长按和自动重复
+  uint32_t getNextWakeDelay() const;
   
   // 蜂鸣器控制
   void playTone(uint16_t frequency, uint16_t duration);
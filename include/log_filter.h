@@ -0,0 +1,52 @@
+#ifndef LOG_FILTER_H
+#define LOG_FILTER_H
+
+#include <stdint.h>
+#include "config.h"
+
+// ==================== 编译期日志过滤 ====================
+// 每条日志的级别和模块名都是常量，是否输出在编译期确定：
+//   DEBUG_LOG展开为 if (LogFilter::Enabled<...>::value) { ... }，条件为false时
+//   整条语句 (包括参数求值、格式串常量) 不进入固件，也没有运行时级别比较。
+// 模块级别在config.h的DEBUG_MODULE_LEVELS中配置，未列出的模块使用DEBUG_LEVEL。
+// 函数写成单return的递归形式，保持C++11 constexpr兼容。
+namespace LogFilter {
+
+struct ModuleLevel {
+  const char* module;   // nullptr结束
+  uint8_t level;
+};
+
+constexpr ModuleLevel moduleLevels[] = {
+  DEBUG_MODULE_LEVELS
+  { nullptr, 0 }
+};
+
+constexpr bool sameName(const char* a, const char* b) {
+  return *a == *b && (*a == '\0' || sameName(a + 1, b + 1));
+}
+
+// 在以nullptr结束的表中查找模块级别，未找到时返回defaultLevel
+constexpr uint8_t levelIn(const ModuleLevel* table, const char* module, uint8_t defaultLevel) {
+  return table->module == nullptr ? defaultLevel :
+         sameName(table->module, module) ? table->level :
+         levelIn(table + 1, module, defaultLevel);
+}
+
+constexpr uint8_t levelFor(const char* module) {
+  return levelIn(moduleLevels, module, DEBUG_LEVEL);
+}
+
+constexpr bool enabled(uint8_t level, const char* module) {
+  return level <= levelFor(module);
+}
+
+// 强制在编译期求值：模块名不是常量时编译报错 (运行时模块名用DEBUG_LOG_DYNAMIC)
+template <bool value_>
+struct Enabled {
+  static constexpr bool value = value_;
+};
+
+} // namespace LogFilter
+
+#endif // LOG_FILTER_H
@@ -0,0 +1,85 @@
+#ifndef LOOP_MONITOR_H
+#define LOOP_MONITOR_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "perf_timer.h"
+
+// ==================== 主循环时序监控 ====================
+// 常开的轻量监控，每轮只有几次时间戳相减和直方图计数：
+//   - 每轮耗时 (从等待返回到下一次等待，不含等待时间)
+//   - 传感器读取延迟 (读取开始时刻 - 传感器节拍时刻) 和漏掉的节拍数
+//   - 显示帧耗时
+// 主循环按阶段打点，超过期限时记录当轮耗时最长的阶段作为原因。
+// 统计按报告窗口累计，printReport()输出后清零，便于在真机上对比版本间的变化。
+class LoopMonitor {
+private:
+  PerfTimerStats iterationStats;
+  PerfTimerStats sensorLateStats;
+  PerfTimerStats frameStats;
+
+  // 当前一轮
+  bool iterationActive = false;
+  uint32_t iterationEvents = 0;
+  uint32_t iterationStartUs = 0;
+  uint32_t stageStartUs = 0;
+  uint32_t stageUs[LOOP_STAGE_COUNT];
+
+  // 上一轮耗时最长的阶段 (传感器读取延迟通常是上一轮造成的)
+  uint8_t previousSlowStage = LOOP_STAGE_COUNT;
+  uint32_t previousSlowStageUs = 0;
+
+  // 传感器节拍计数，用于统计漏读
+  bool hasSensorTicks = false;
+  uint32_t lastSensorTicks = 0;
+
+  // 本窗口的超时统计
+  uint32_t iterationMisses = 0;
+  uint32_t sensorLateMisses = 0;
+  uint32_t frameMisses = 0;
+  uint32_t missedSensorTicks = 0;
+  uint32_t stageMisses[LOOP_STAGE_COUNT];
+
+  // 最近一次超时
+  uint8_t lastMissStage = LOOP_STAGE_COUNT;
+  uint32_t lastMissUs = 0;
+  uint32_t lastMissStageUs = 0;
+  uint32_t lastMissMs = 0;
+  bool missReported = false;        // 每个窗口只立即输出第一次超时
+
+  uint8_t slowestStage() const;
+  void recordMiss(uint8_t stage, uint32_t durationUs, uint32_t stageDurationUs);
+
+public:
+  LoopMonitor();
+
+  // 等待事件返回后调用，events为本轮的事件位
+  void beginIteration(uint32_t nowUs, uint32_t events);
+
+  // 本轮处理传感器节拍时调用 (读取开始时刻即本轮开始时刻)
+  void recordSensorTick(uint32_t tickUs, uint32_t ticks);
+
+  // 阶段结束时调用，耗时为上一次打点到现在；显示阶段在有显示事件时记为一帧
+  void endStage(LoopStage stage, uint32_t nowUs);
+
+  // 本轮结束，返回本轮耗时 (us)
+  uint32_t endIteration(uint32_t nowUs);
+
+  // 输出本窗口的统计并清零
+  void printReport(uint32_t nowMs);
+  void resetWindow();
+
+  const PerfTimerStats& getIterationStats() const;
+  const PerfTimerStats& getSensorLateStats() const;
+  const PerfTimerStats& getFrameStats() const;
+  uint32_t getIterationMisses() const;
+  uint32_t getSensorLateMisses() const;
+  uint32_t getFrameMisses() const;
+  uint32_t getMissedSensorTicks() const;
+  uint32_t getStageMisses(LoopStage stage) const;
+  uint8_t getLastMissStage() const;
+
+  static const char* getStageName(uint8_t stage);
+};
+
+#endif // LOOP_MONITOR_H
@@ -0,0 +1,67 @@
+#ifndef LOOP_SCHEDULER_H
+#define LOOP_SCHEDULER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "config.h"
+
+// ==================== 主循环事件调度 ====================
+// 主循环不再固定delay(10)轮询，而是阻塞在任务通知上等待事件：
+//   - 按钮GPIO电平变化中断 (ButtonCapture)
+//   - 传感器节拍 (MPU6050数据就绪中断，未接INT引脚时使用esp_timer周期定时器)
+//   - 显示刷新定时器
+// 等待超时由调用者按最近的截止时间给出 (双击判定、防抖锁定期结束等)。
+// 等待期间主任务阻塞，空闲任务运行，电源管理可以进入自动轻度睡眠。
+enum LoopEvent : uint32_t {
+  LOOP_EVENT_BUTTON  = 1 << 0,     // 按钮电平变化
+  LOOP_EVENT_SENSOR  = 1 << 1,     // 到达传感器读取时刻
+  LOOP_EVENT_DISPLAY = 1 << 2,     // 到达显示刷新时刻
+  LOOP_EVENT_WAKE    = 1 << 3      // 其它任务请求主循环处理
+};
+
+class LoopScheduler {
+private:
+  static TaskHandle_t loopTask;
+  static esp_timer_handle_t sensorTimer;
+  static esp_timer_handle_t displayTimer;
+  static bool eventDriven;
+
+  // 退回轮询模式时按时间合成事件
+  static uint32_t lastSensorMs;
+  static uint32_t lastDisplayMs;
+
+  // 统计
+  static uint32_t eventWakeups;
+  static uint32_t timeoutWakeups;
+
+  // 最近一次传感器节拍的时刻和累计节拍数 (中断/定时器任务写入)
+  static volatile uint32_t sensorTickUs;
+  static volatile uint32_t sensorTicks;
+
+  static void IRAM_ATTR sensorIsr();
+  static void timerCallback(void* arg);
+  static uint32_t pollFallback();
+
+public:
+  // 在主任务中调用：记录主任务句柄，挂接中断并启动定时器
+  // 定时器创建失败时返回false，之后退回固定间隔轮询
+  static bool begin();
+
+  // 通知主循环 (任务上下文 / 中断上下文)
+  static void post(uint32_t events);
+  static void IRAM_ATTR postFromIsr(uint32_t events);
+
+  // 等待事件或超时，返回发生的事件位 (超时返回0)
+  static uint32_t waitForEvents(uint32_t timeoutMs);
+
+  static bool isEventDriven();
+
+  // 最近一次传感器节拍的时刻 (us) 和累计节拍数，用于计算读取延迟和漏读
+  static uint32_t getSensorTickUs();
+  static uint32_t getSensorTicks();
+  static void printStats();
+};
+
+#endif // LOOP_SCHEDULER_H
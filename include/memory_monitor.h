@@ -0,0 +1,109 @@
+#ifndef MEMORY_MONITOR_H
+#define MEMORY_MONITOR_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "config.h"
+
+// ==================== 内存监控 ====================
+// 三类信息，在定期系统报告中输出：
+//   - 按模块的堆占用: 代码段用 HEAP_TAG_SCOPE(HEAP_TAG_DISPLAY) 标记归属，
+//     HEAP_TRACKING打开时malloc/free被链接器包装，标记范围内 (仅标记的任务) 的分配
+//     记入按指针哈希的表，释放时按表中的大小和模块扣除，因此跨范围释放也能正确归属
+//   - 堆碎片: 定期采样可用堆和最大可分配块，保留最近的历史，比较窗口首尾的变化
+//   - 任务栈高水位: 注册的任务的最小剩余栈
+// 包装函数中不能输出日志或分配内存，只做加锁的查表。
+struct MemorySample {
+  uint32_t timeMs;
+  uint32_t freeHeap;
+  uint32_t largestBlock;
+  uint32_t minFreeHeap;
+};
+
+struct HeapTagStats {
+  uint32_t currentBytes;
+  uint32_t peakBytes;
+  uint32_t allocCount;
+  uint32_t untrackedCount;       // 跟踪表已满未能记录的分配
+};
+
+class MemoryMonitor {
+private:
+  struct TrackedBlock {
+    void* ptr;                   // nullptr表示空槽
+    uint32_t size;
+    uint8_t tag;
+  };
+
+  struct TaskEntry {
+    TaskHandle_t handle;
+    const char* name;
+  };
+
+  static TrackedBlock blocks[HEAP_TRACK_SLOTS];
+  static HeapTagStats tagStats[HEAP_TAG_COUNT];
+  static volatile uint16_t trackedCount;   // 为0时free不需要查表
+  static portMUX_TYPE lock;
+
+  // 当前标记及设置标记的任务 (其它任务的分配不计入)
+  static volatile uint8_t currentTag;
+  static volatile TaskHandle_t tagTask;
+
+  static MemorySample history[MEMORY_HISTORY_SIZE];
+  static uint8_t historyCount;
+  static uint8_t historyNext;
+  static uint8_t worstFragmentation;
+
+  static TaskEntry tasks[MEMORY_MAX_TASKS];
+  static uint8_t taskCount;
+
+  static uint32_t slotFor(const void* ptr);
+  static void insertLocked(void* ptr, uint32_t size, uint8_t tag);
+  static bool removeLocked(void* ptr, uint32_t& size, uint8_t& tag);
+
+public:
+  // 分配记录 (由malloc包装函数调用，也用于测试)
+  static void noteAlloc(void* ptr, size_t size);
+  static void noteFree(void* ptr);
+  static void noteRealloc(void* oldPtr, void* newPtr, size_t size);
+
+  // 设置当前任务的归属模块，返回之前的模块
+  static uint8_t setTag(uint8_t tag);
+
+  static void registerTask(TaskHandle_t handle, const char* name);
+
+  // 采样堆碎片，在定期报告中调用
+  static void sample();
+
+  // 碎片率: 100 - 最大可分配块/可用堆 (%)
+  static uint8_t fragmentationOf(const MemorySample& sample);
+
+  static const HeapTagStats& getTagStats(uint8_t tag);
+  static uint8_t getHistoryCount();
+  static const MemorySample& getHistory(uint8_t age);    // 0为最近一次
+  static uint8_t getWorstFragmentation();
+  static void resetTagStats();
+
+  static void printReport();
+  static const char* getTagName(uint8_t tag);
+};
+
+// 作用域内的分配归属到指定模块
+class HeapTagScope {
+private:
+  uint8_t previousTag;
+
+public:
+  explicit HeapTagScope(uint8_t tag) : previousTag(MemoryMonitor::setTag(tag)) {}
+  ~HeapTagScope() { MemoryMonitor::setTag(previousTag); }
+
+  HeapTagScope(const HeapTagScope&) = delete;
+  HeapTagScope& operator=(const HeapTagScope&) = delete;
+};
+
+#define HEAP_TAG_CONCAT_INNER(a, b) a##b
+#define HEAP_TAG_CONCAT(a, b) HEAP_TAG_CONCAT_INNER(a, b)
+#define HEAP_TAG_SCOPE(tag) HeapTagScope HEAP_TAG_CONCAT(_heapTag, __LINE__)(tag)
+
+#endif // MEMORY_MONITOR_H
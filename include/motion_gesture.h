@@ -0,0 +1,55 @@
+#ifndef MOTION_GESTURE_H
+#define MOTION_GESTURE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "data_types.h"
+
+// ==================== 运动手势识别 ====================
+// 在现有传感器读取节拍上识别敲击/双敲/左右倾斜，产生与按钮相同的ButtonEvent：
+//   - 敲击 -> BUTTON_PRESSED，双敲 -> BUTTON_DOUBLE_PRESSED (source为INPUT_SOURCE_MOTION)
+//   - 倾斜保持 -> BUTTON_TILT_LEFT / BUTTON_TILT_RIGHT，不回正时周期性重复
+// 传感器读取间隔较长，短促的敲击冲击可能落在两次读取之间，
+// 因此冲击判定以MPU6050硬件运动检测 (1kHz内部采样、高通滤波后比较阈值) 为主，
+// 读取时的未滤波加速度超过阈值作为补充。
+// 每次调用只做常数次比较，不保存历史窗口。
+class MotionGesture {
+private:
+  // 敲击
+  bool shockActive = false;
+  unsigned long shockStart = 0;
+  unsigned long shockLast = 0;
+  uint8_t tapCount = 0;
+  unsigned long firstTapTime = 0;
+
+  // 按钮动作会让设备震动，附近的冲击不算敲击
+  bool hasButtonActivity = false;
+  unsigned long lastButtonActivity = 0;
+
+  // 倾斜
+  bool tiltArmed = false;           // 需要先回正才能触发 (开机时斜放不触发)
+  int8_t tiltDirection = 0;         // -1左 / 0无 / 1右
+  unsigned long tiltStart = 0;
+  unsigned long nextTiltTime = 0;
+  uint16_t tiltRepeats = 0;
+
+  bool nearButtonActivity(unsigned long time) const;
+  bool updateTap(const MotionSample& sample, ButtonEvent& event);
+  bool updateTilt(const MotionSample& sample, ButtonEvent& event);
+  static bool emit(ButtonState state, uint8_t count, uint16_t repeat,
+                   unsigned long startTime, unsigned long endTime, ButtonEvent& event);
+
+public:
+  void reset();
+
+  // 输入一次传感器读取，产生事件时返回true
+  bool update(const MotionSample& sample, ButtonEvent& event);
+
+  // 记录按钮边沿时刻
+  void noteButtonActivity(unsigned long time);
+
+  bool isTapPending() const;
+  int8_t getTiltDirection() const;
+};
+
+#endif // MOTION_GESTURE_H
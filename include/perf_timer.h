@@ -0,0 +1,95 @@
+#ifndef PERF_TIMER_H
+#define PERF_TIMER_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ==================== 性能计时器 ====================
+// 计时器以名称的FNV-1a哈希为键，哈希在编译期计算，运行时按键直接定位槽位
+// (冲突时线性探测)，不做字符串比较。每个计时器记录次数、总耗时、最小/最大值
+// 和按2的幂分桶的耗时直方图，由直方图估计p50/p99。
+//   PERF_SCOPE("DISPLAY_UPDATE");   // 作用域计时，可以嵌套
+//   PERFORMANCE_START("DATA_INIT") / PERFORMANCE_END("DATA_INIT")   // 跨作用域的成对计时
+// 嵌套的作用域计时会从外层的"自身耗时"中扣除，用于区分函数本身和被调函数的开销。
+// 作用域嵌套关系只有一条链，只在主任务中使用。
+struct PerfTimerStats {
+  uint32_t key;                  // 0表示空槽
+  const char* name;
+  uint32_t count;
+  uint64_t totalUs;
+  uint64_t selfUs;               // 扣除嵌套计时后的耗时
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint32_t startUs;              // PERFORMANCE_START的开始时刻
+  uint32_t histogram[PERF_HISTOGRAM_BUCKETS];
+};
+
+// 编译期名称哈希 (C++11 constexpr形式)，0保留给空槽
+constexpr uint32_t perfHashStep(const char* name, uint32_t hash) {
+  return *name == '\0' ? hash : perfHashStep(name + 1, (hash ^ (uint8_t)*name) * 16777619u);
+}
+
+constexpr uint32_t perfHash(const char* name) {
+  return perfHashStep(name, 2166136261u) == 0 ? 1 : perfHashStep(name, 2166136261u);
+}
+
+// 强制在编译期求值
+template <uint32_t key_>
+struct PerfKey {
+  static constexpr uint32_t value = key_;
+};
+
+#define PERF_KEY(name) PerfKey<perfHash(name)>::value
+
+class PerfTimers {
+private:
+  static PerfTimerStats slots[PERF_TIMER_SLOTS];
+  static bool overflowReported;
+
+public:
+  // 查找或创建计时器，槽位已满时返回nullptr
+  static PerfTimerStats* find(uint32_t key, const char* name);
+
+  // 清空统计 (也用于不放在计时器表中的独立统计，例如主循环监控)
+  static void clear(PerfTimerStats& stats, uint32_t key, const char* name);
+
+  // 记录一次耗时
+  static void record(PerfTimerStats* stats, uint32_t elapsedUs, uint32_t selfUs);
+
+  // 成对计时 (不能同名嵌套)
+  static void start(uint32_t key, const char* name);
+  static void end(uint32_t key, const char* name);
+
+  // 直方图估计的百分位耗时上界 (us)，不超过实测最大值
+  static uint32_t percentile(const PerfTimerStats& stats, uint8_t percent);
+  static uint8_t bucketFor(uint32_t us);
+
+  static const PerfTimerStats* get(uint32_t key);
+  static const PerfTimerStats& getSlot(uint8_t index);   // 按槽位遍历，key为0表示空槽
+  static void reset();
+  static void printStats();
+};
+
+// 作用域计时：构造时开始，析构时记录
+class ScopeTimer {
+private:
+  static ScopeTimer* current;    // 最内层的活动计时
+
+  PerfTimerStats* stats;
+  ScopeTimer* parent;
+  uint32_t startUs;
+  uint32_t childUs;
+
+public:
+  ScopeTimer(uint32_t key, const char* name);
+  ~ScopeTimer();
+
+  ScopeTimer(const ScopeTimer&) = delete;
+  ScopeTimer& operator=(const ScopeTimer&) = delete;
+};
+
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+#define PERF_SCOPE(name) ScopeTimer PERF_CONCAT(_perfScope, __LINE__)(PERF_KEY(name), name)
+
+#endif // PERF_TIMER_H
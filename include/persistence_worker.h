@@ -0,0 +1,80 @@
+#ifndef PERSISTENCE_WORKER_H
+#define PERSISTENCE_WORKER_H
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "config.h"
+
+// ==================== 后台持久化 ====================
+// 所有EEPROM访问都经过这里：
+// - 主循环只读写RAM中的前台镜像，耗时为微秒级
+// - 后台任务在变更平息后(合并连续写入)把镜像拷贝为快照，再执行EEPROM.commit()
+// - 提交失败时按退避间隔自动重试，不等下一次写入请求
+// - 休眠/关机前调用flush()确保数据已落盘，提交失败时立即返回false
+struct PersistenceStats {
+  uint32_t commitCount;            // 实际提交次数
+  uint32_t requestCount;           // 提交请求次数 (合并前)
+  uint32_t lastCommitUs;           // 最近一次提交耗时 (us)
+  uint32_t maxCommitUs;            // 最长提交耗时 (us)
+  uint32_t maxMirrorWriteUs;       // 写入RAM镜像的最长耗时 (us)，不含Flash写入
+  uint32_t maxCommitLoopUs;        // 提交进行中主循环单轮最长耗时 (us)，含Flash写入暂停缓存造成的停顿
+  uint32_t failedCount;            // 提交失败次数
+};
+
+class PersistenceWorker {
+private:
+  static uint8_t image[EEPROM_SIZE];       // 前台镜像 (主循环写入)
+  static uint8_t snapshot[EEPROM_SIZE];    // 后台快照 (提交期间使用)
+  static bool initialized;
+  static volatile bool dirty;
+  static volatile bool urgent;
+  static volatile bool committing;
+  static volatile uint32_t firstDirtyTime;
+  static volatile uint32_t lastWriteTime;
+  static volatile uint32_t commitSequence;     // 每开始一次提交加1
+  static uint32_t loopSeenSequence;            // 主循环上一轮结束时看到的commitSequence
+  static SemaphoreHandle_t mutex;
+  static TaskHandle_t task;
+  static PersistenceStats stats;
+
+  static void taskMain(void* parameter);
+  static bool commitSnapshot();
+  static void trackMirrorWrite(uint32_t startUs);
+
+public:
+  // 初始化（可重复调用）：加载EEPROM内容到镜像并启动后台任务
+  static bool begin();
+
+  // 镜像读写
+  static void write(int address, const void* data, size_t length);
+  static void read(int address, void* data, size_t length);
+  static void writeByte(int address, uint8_t value);
+  static uint8_t readByte(int address);
+
+  template <typename T>
+  static void put(int address, const T& value) {
+    write(address, &value, sizeof(T));
+  }
+
+  template <typename T>
+  static void get(int address, T& value) {
+    read(address, &value, sizeof(T));
+  }
+
+  // 提交控制
+  static void requestCommit();
+  static bool flush(uint32_t timeoutMs = PERSIST_FLUSH_TIMEOUT);
+  static bool isIdle();
+
+  // 统计
+  // 每轮主循环结束时调用：本轮与提交重叠时计入maxCommitLoopUs。
+  // 单核C3上Flash写入期间缓存暂停，主循环同样停顿，这里衡量实际影响
+  static void recordLoopIteration(uint32_t iterationUs);
+  static PersistenceStats getStats();
+  static void printStats();
+};
+
+#endif // PERSISTENCE_WORKER_H
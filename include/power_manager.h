@@ -6,6 +6,10 @@
 #include <esp_pm.h>
 #include "config.h"
 #include "data_types.h"
+#include "frequency_governor.h"
+#include "battery_estimator.h"
+#include "energy_profiler.h"
+#include <esp_adc_cal.h>
 
 class PowerManager {
 private:
@@ -14,6 +18,7 @@ private:
   bool isCharging = false;
   bool lowBattery = false;
   bool criticalBattery = false;
+  bool powerEventPending = false;  // 刚进入低电量/严重低电量，等待主循环提示一次
   
   // 休眠管理
   unsigned long lastActivity = 0;
@@ -24,12 +29,21 @@ private:
   // 电源监测
   unsigned long lastBatteryCheck = 0;
   const unsigned long batteryCheckInterval = 30000; // 30秒检查一次
+  BatteryEstimator battery;
+  BatteryStatus publishedBattery;  // 上次通过事件总线发布的电池状态
+  bool batteryPublished = false;
+  EnergyProfiler energy;
+  esp_adc_cal_characteristics_t adcChars;
   
   // 低功耗模式
   bool lowPowerMode = false;
   
   // 唤醒标志
   bool wakeupFlag = false;
+  
+  // 动态调频
+  FrequencyGovernor governor;
+  bool pmAvailable = false;        // esp_pm可用时由其负责调频和自动轻度睡眠
 
   // 根据芯片类型选择合适的电源管理配置
   #ifdef CONFIG_IDF_TARGET_ESP32C3
@@ -42,8 +56,11 @@ private:
   
   // 内部方法
   void readBatteryVoltage();
+  float sampleBatteryVoltage();
   void checkBatteryStatus();
+  void publishBatteryStatus();
   void configurePowerManagement();
+  void applyOperatingPoint();
   void enterLightSleep();
   void enterDeepSleep();
   void wakeupCallback();
@@ -62,6 +79,17 @@ public:
   bool isLowBattery() const;
   bool isCriticalBattery() const;
   bool isBatteryCharging() const;
+  uint32_t getRemainingPracticeMinutes() const;
+  BatteryStatus getBatteryStatus() const;
+  const BatteryEstimator& getBatteryEstimator() const;
+  
+  // 当前系统状态 (决定电量估算使用的负载电流，并用于功耗统计)
+  void setSystemState(SystemState state);
+  
+  // 功耗统计：上报部件开关和负载等级 (0-255)
+  void setConsumer(EnergyConsumer consumer, bool on, uint8_t level = 255);
+  EnergyReport getEnergyReport();
+  void printEnergyReport();
   
   // 活动管理
   void updateActivity();
@@ -80,6 +108,13 @@ public:
   bool isLowPowerMode() const;
   void optimizePowerConsumption();
   
+  // 动态调频：主循环每次结束时上报忙碌时间及其中的I2C传输时间 (us)
+  void recordLoopLoad(uint32_t busyUs, uint32_t ioUs);
+  uint16_t getCpuFrequency() const;
+  bool isAutoLightSleepEnabled() const;
+  GovernorStats getGovernorStats();
+  void printGovernorStats();
+  
   // 休眠模式
   void enterSleepMode();
   void wakeUp();
@@ -106,7 +141,7 @@ public:
   // 电源统计
   unsigned long getUptime() const;
   unsigned long getSleepTime() const;
-  float getAveragePowerConsumption() const;
+  float getAveragePowerConsumption() const;   // 按各状态停留时间加权的平均电流 (mA)
 };
 
 #endif // POWER_MANAGER_H
@@ -0,0 +1,72 @@
+#ifndef ROLLING_STATS_H
+#define ROLLING_STATS_H
+
+#include <stdint.h>
+#include "config.h"
+#include "data_types.h"
+
+// ==================== 每日摘要 ====================
+// 已结束的一天的紧凑摘要，用于月窗口（超出7天历史数组的部分）
+struct DaySummary {
+  uint16_t year;                   // 年份
+  uint8_t month;                   // 月份
+  uint8_t day;                     // 日期
+  uint32_t totalTime;              // 总练习时间 (ms)
+  uint16_t sessionCount;           // 练习次数
+  uint16_t totalBreaks;            // 破定次数
+  uint16_t avgCenti;               // 平均稳定性 (0.01分)
+  uint16_t bestCenti;              // 最佳稳定性 (0.01分)
+  uint32_t sampledTime;            // 有效采样时长 (ms)，平均稳定性的权重
+};
+
+// ==================== 窗口累计量 ====================
+struct WindowTotals {
+  uint32_t totalTime;              // 总练习时间 (ms)
+  uint32_t sessionCount;           // 练习次数
+  uint32_t totalBreaks;            // 破定次数
+  uint32_t sampledTime;            // 有效采样时长 (ms)
+  uint64_t weightedSum;            // Σ 平均稳定性(0.01分) × 采样时长(ms)
+  uint16_t bestCenti;              // 窗口内最佳稳定性 (0.01分)
+  uint16_t activeDays;             // 有练习的天数
+};
+
+// ==================== 滚动周/月统计 ====================
+// 以环形缓冲保存最近已结束的若干天，并维护周、月两个窗口的累计量：
+// - 日切换时加入新的一天、减去滑出窗口的一天，查询为O(1)
+// - 最佳值无法做减法，只在日切换时对窗口重新扫描一次
+// 查询结果 = 窗口累计量 + 今日实时统计
+class RollingStats {
+private:
+  static const int WEEK_SPAN = ROLLING_WEEK_DAYS - 1;    // 周窗口中已结束的天数
+  static const int MONTH_SPAN = ROLLING_MONTH_DAYS - 1;  // 月窗口中已结束的天数
+
+  DaySummary days[MONTH_SPAN];
+  int head = 0;                    // 下一个写入位置
+  int count = 0;                   // 已保存天数
+  WindowTotals week;
+  WindowTotals month;
+
+  static void clearTotals(WindowTotals& totals);
+  static void addDay(WindowTotals& totals, const DaySummary& day);
+  static void removeDay(WindowTotals& totals, const DaySummary& day);
+  uint16_t scanBest(int span) const;
+  static PeriodStats combine(const WindowTotals& totals, const DailyStats& today, uint32_t todaySampledTime);
+
+public:
+  RollingStats();
+
+  // 数据维护
+  void clear();
+  void pushDay(const DaySummary& day);
+
+  // 查询，todaySampledTime为今日有效采样时长，与窗口内各天一致地加权平均稳定性
+  PeriodStats getWeekStats(const DailyStats& today, uint32_t todaySampledTime) const;
+  PeriodStats getMonthStats(const DailyStats& today, uint32_t todaySampledTime) const;
+  int getDayCount() const;
+  const DaySummary& getDay(int daysAgo) const;   // 0 = 昨天
+
+  // 转换工具
+  static DaySummary summarize(const DailyStats& stats, uint32_t sampledTime);
+};
+
+#endif // ROLLING_STATS_H
@@ -0,0 +1,67 @@
+#ifndef RTC_STATE_H
+#define RTC_STATE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "data_types.h"
+#include "stability_stats.h"
+
+// ==================== 深度休眠状态保持 ====================
+// 深度休眠后主RAM清空，但RTC慢速内存保持供电。
+// 休眠前把关键状态写入RTC内存并附带CRC，唤醒后校验通过即可快速恢复，
+// 跳过开机动画和完整初始化。快照只在GPIO/定时器唤醒时使用，
+// 上电或异常复位时一律按冷启动处理。
+//
+// 注意: 深度休眠唤醒后millis()从0重新计时，快照中不保存绝对时间戳，
+// 会话只保存已累计的时长，恢复时以新的millis()为基准。
+
+// 传感器状态：校准、滤波器与稳定性窗口
+struct SensorResumeState {
+  CalibrationData calibration;
+  float accelFilter[3];
+  float gyroFilter[3];
+  float stabilityHistory[STABILITY_WINDOW_SIZE];
+  int historyIndex;
+  bool historyFull;
+  StabilityData stabilityData;
+};
+
+// 数据状态：进行中的会话与今日统计
+struct SessionResumeState {
+  bool sessionActive;                        // 休眠时有未结束的会话
+  PracticeSession session;                   // 时长已结算，时间戳无效
+  StabilityAggregatorState aggregator;       // 会话流式统计
+  uint32_t recordId;                         // 曲线记录文件
+  uint32_t recordPoints;
+  uint32_t recordBlocks;
+  DailyStats todayStats;
+  StabilityHistogram todayHistogram;
+};
+
+struct ResumeState {
+  uint8_t systemState;                       // 休眠前的SystemState
+  uint8_t reserved;
+  uint16_t sleepCount;                       // 连续快速恢复次数
+  SensorResumeState sensor;
+  SessionResumeState data;
+};
+
+class RtcStateStore {
+private:
+  static uint32_t checksum(const uint8_t* data, size_t length);
+
+public:
+  // 写入RTC内存 (休眠前调用)
+  static void save(const ResumeState& state);
+
+  // 读取并校验，成功后快照仍保留，由调用者决定何时作废
+  static bool load(ResumeState& state);
+
+  // 作废快照，避免同一份状态被重复恢复
+  static void invalidate();
+
+  // 当前唤醒原因是否允许使用快照
+  static bool isResumableWakeup();
+};
+
+#endif // RTC_STATE_H
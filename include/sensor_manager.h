@@ -6,13 +6,18 @@
 #include <MPU6050.h>
 #include "config.h"
 #include "data_types.h"
+#include "rtc_state.h"
 
 class SensorManager {
 private:
   MPU6050 mpu;
   CalibrationData calibration;
   SensorData rawData;
+  int16_t rawCounts[6];           // 最近一次读取的原始计数 (ax, ay, az, gx, gy, gz)，用于遥测
+  uint32_t busTimeUs = 0;         // 上次takeBusTimeUs()以来I2C读取占用的时间
   StabilityData stabilityData;
+  MotionSample motionSample;      // 运动手势输入 (敲击/倾斜)
+  bool motionDetectionEnabled = false;  // 硬件运动检测中断是否开启
   
   // 滤波相关
   float accelFilter[3];           // 加速度滤波器
@@ -24,12 +29,18 @@ private:
   int historyIndex = 0;           // 历史数据索引
   bool historyFull = false;       // 历史数据是否已满
   
+  // 启动预热
+  bool warmupStarted = false;
+  unsigned long warmupStartTime = 0;
+  
   // 校准相关
   bool isCalibrating = false;
   int calibrationSamples = 0;
   float calibrationSum[6] = {0};  // 累计值用于计算偏移
   
   // 内部方法
+  void readRawCounts();           // 读取原始计数到rawCounts
+  bool readIntMotionStatus();     // 读取并清除运动检测中断标志
   void applyCalibration(SensorData& data);
   void applyLowPassFilter(SensorData& data);
   float calculateStabilityScore(const SensorData& data);
@@ -40,6 +51,7 @@ public:
   SensorManager();
   
   // 初始化和配置
+  void beginWarmup();             // 尽早唤醒MPU6050，与其它外设初始化并行预热
   bool initialize();
   bool isConnected() const;
   void reset();
@@ -53,10 +65,19 @@ public:
   void loadCalibration();
   void saveCalibration();
   
+  // 深度休眠状态保持
+  void captureResumeState(SensorResumeState& state) const;
+  void restoreResumeState(const SensorResumeState& state);
+  
   // 数据读取
   bool readSensorData();
   SensorData getRawData() const;
   SensorData getFilteredData() const;
+  void getRawCounts(int16_t counts[6]) const;
+  uint32_t takeBusTimeUs();       // 返回I2C读取累计占用的时间 (us) 并清零，供调频区分CPU和总线耗时
+  MotionSample getMotionSample() const;
+  // 开关硬件运动检测中断，随运动手势输入一起切换 (练习和校准中关闭)
+  void setMotionDetectionEnabled(bool enabled);
   
   // 稳定性评分
   StabilityData getStabilityData() const;
@@ -0,0 +1,43 @@
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+#include "config.h"
+#include "data_types.h"
+
+// ==================== 串口命令台 ====================
+// 命令表由主程序提供 (处理函数需要访问各管理器)，这里只负责按首个单词查表分发。
+// 一行输入: "<命令> [参数...]"，处理函数收到命令之后的参数部分 (已去掉前导空格，可能为空串)
+// 命令回复一律经printf()直接写串口，与DataExporter/Telemetry一样不经过DEBUG_*日志宏:
+// 不受DEBUG开关、日志级别过滤和延迟日志编码的影响。DEBUG_*只用于诊断输出。
+typedef void (*ConsoleHandler)(const char* args);
+
+struct ConsoleCommand {
+  const char* name;
+  const char* usage;               // 参数说明，没有参数时为空串
+  const char* help;
+  ConsoleHandler handler;
+};
+
+class SerialConsole {
+private:
+  static const ConsoleCommand* commands;
+  static uint8_t commandCount;
+
+public:
+  static void begin(const ConsoleCommand* table, uint8_t count);
+
+  // 执行一行命令，未知命令返回false
+  static bool dispatch(const char* line);
+  static void printHelp();
+
+  // 输出命令回复 (格式同printf，需自带换行)
+  static void printf(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+  // "set"命令的参数 "<项> <值>"：修改settings中的一项，项名或取值无效时返回false且不修改
+  //   threshold 0-100 | sound on/off | brightness 0-255 | practice 1-60 (分钟)
+  //   autosleep on/off | sleep 1-60 (分钟) | calibration on/off | language zh/en
+  static bool applySetting(SystemSettings& settings, const char* args);
+};
+
+#endif // SERIAL_CONSOLE_H
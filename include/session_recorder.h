@@ -0,0 +1,89 @@
+#ifndef SESSION_RECORDER_H
+#define SESSION_RECORDER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "config.h"
+#include "time_manager.h"
+
+// ==================== 会话记录文件头 ====================
+// 文件布局: [SessionRecordHeader][块0][块1]...
+// 每个块: [点数N][首点绝对值][N-1个int8差分]，块之间相互独立，可单独解码
+struct SessionRecordHeader {
+  uint32_t magic;                  // 文件标识
+  uint8_t version;                 // 格式版本
+  uint8_t reserved;                // 保留
+  uint16_t sampleInterval;         // 采样间隔 (ms)
+  uint32_t sessionId;              // 会话序号
+  uint16_t year;                   // 开始日期
+  uint8_t month;
+  uint8_t day;
+  uint8_t hour;                    // 开始时间
+  uint8_t minute;
+};
+
+class SessionRecorder {
+private:
+  // 文件系统状态
+  bool fsReady = false;
+  bool recording = false;
+  uint32_t sessionId = 0;
+  uint32_t latestSessionId = 0;
+  String currentPath;
+
+  // 降采样累加器（一个采样间隔内的评分取平均）
+  float bucketSum = 0.0;
+  uint16_t bucketCount = 0;
+  unsigned long bucketStart = 0;
+
+  // RAM块缓冲（存放绝对值，写入时再差分编码）
+  uint8_t block[SESSION_RECORD_BLOCK_SIZE];
+  uint16_t blockCount = 0;
+  uint32_t totalPoints = 0;
+  uint32_t flushedBlocks = 0;
+
+  // 内部方法
+  void closeBucket();
+  void appendPoint(uint8_t value);
+  bool flushBlock();
+  void pruneOldRecords();
+  String pathForSession(uint32_t id) const;
+
+public:
+  SessionRecorder();
+
+  // 初始化
+  bool initialize();
+
+  // 记录控制
+  bool begin(const DateTime& startDate);
+  void addSample(float score, unsigned long timestamp);
+  void pause();
+  void resume(unsigned long timestamp);
+  void finish();
+
+  // 深度休眠：先把缓冲写入文件，唤醒后继续追加到同一文件
+  void suspend();
+  bool reattach(uint32_t id, uint32_t points, uint32_t blocks);
+
+  // 状态查询
+  bool isReady() const;
+  bool isRecording() const;
+  uint32_t getCurrentSessionId() const;
+  uint32_t getLatestSessionId() const;
+  uint32_t getPointCount() const;
+  uint32_t getBlockCount() const;
+
+  // 回放：将指定会话解码为1Hz评分序列，返回点数
+  size_t loadSeries(uint32_t id, uint8_t* points, size_t maxPoints, SessionRecordHeader* header = nullptr) const;
+  File openRecord(uint32_t id) const;   // 只读打开原始记录文件，供流式导出
+
+  // 块编解码
+  static size_t encodeBlock(const uint8_t* points, size_t count, uint8_t* out);
+  static size_t decodeBlock(const uint8_t* in, size_t length, uint8_t* points, size_t maxPoints);
+
+  // 调试功能
+  void printRecorderInfo() const;
+};
+
+#endif // SESSION_RECORDER_H
@@ -0,0 +1,78 @@
+#ifndef STABILITY_STATS_H
+#define STABILITY_STATS_H
+
+#include <stdint.h>
+#include <type_traits>
+#include "config.h"
+
+// ==================== 按时间加权的评分直方图 ====================
+// 记录落在各档的累计时长。STABILITY_HISTOGRAM_FINE_START以下每档
+// STABILITY_HISTOGRAM_COARSE_WIDTH分，以上每档1分，使高分段的分位数与精确平均值可比
+struct StabilityHistogram {
+  uint32_t bins[STABILITY_HISTOGRAM_BINS];  // 每档累计时长 (ms)
+};
+
+// ==================== 聚合器状态 ====================
+// 聚合器的全部数据。深度休眠快照按值保存，必须保持为平凡类型 (不加默认初始化和构造函数)，
+// 由reset()初始化
+struct StabilityAggregatorState {
+  StabilityHistogram histogram;
+  uint64_t weightedSum;            // Σ 评分(0.01分) × 时长(ms)
+  uint32_t sampledTime;            // 有效采样时长 (ms)
+  uint32_t stableTime;             // 高于阈值的时长 (ms)
+  float threshold;
+  float minScore;
+  float maxScore;
+  float lastScore;
+  uint32_t lastTimestamp;
+  bool hasLast;
+  uint32_t sampleCount;
+};
+
+static_assert(std::is_trivial<StabilityAggregatorState>::value, "聚合器状态必须是平凡类型");
+
+// ==================== 流式稳定性聚合器 ====================
+// 以固定内存维护一个会话的统计量：
+// - 精确的时间加权平均值（评分按0.01分定点累加）
+// - 基于直方图插值的中位数、P10、P90 (限制在会话最低/最高分之间)
+// - 高于阈值（稳定）的累计时长
+// 每个采样点的评分持续到下一个采样点（零阶保持），暂停期间不计入
+class StabilityAggregator {
+private:
+  StabilityAggregatorState state;
+
+  // 将上一个采样点的评分累计到指定时刻
+  void accumulate(uint32_t timestamp);
+
+public:
+  StabilityAggregator();
+
+  // 会话控制
+  void reset(float stabilityThreshold);
+  void addSample(float score, uint32_t timestamp);
+  void pause(uint32_t timestamp);
+
+  // 统计结果
+  float getMean() const;
+  float getMedian() const;
+  float getPercentile(float q) const;
+  float getMinScore() const;
+  float getMaxScore() const;
+  uint32_t getSampledTime() const;
+  uint32_t getStableTime() const;
+  uint32_t getSampleCount() const;
+  const StabilityHistogram& getHistogram() const;
+
+  // 深度休眠快照
+  const StabilityAggregatorState& getState() const;
+  void restoreState(const StabilityAggregatorState& saved);
+
+  // 直方图工具
+  static void clearHistogram(StabilityHistogram& hist);
+  static void addToHistogram(StabilityHistogram& hist, float score, uint32_t duration);
+  static void mergeHistogram(StabilityHistogram& into, const StabilityHistogram& from);
+  static uint32_t histogramTotal(const StabilityHistogram& hist);
+  static float percentileOf(const StabilityHistogram& hist, float q);
+};
+
+#endif // STABILITY_STATS_H
@@ -0,0 +1,114 @@
+#ifndef STATE_MACHINE_H
+#define STATE_MACHINE_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ==================== 表驱动状态机 ====================
+// 每个状态的行为集中在一行描述中 (由主程序按SystemState顺序定义)：
+//   进入/退出/每轮处理函数、进入时切换的显示页面、传感器读取分频和输入策略。
+// 允许的状态转换是编译期常量位矩阵，第from行的第to位表示允许from -> to，
+// 判定只需一次移位，并可以在编译期用static_assert检查。
+typedef void (*StateHandler)();
+
+#define STATE_PAGE_KEEP 0xFF             // 进入时不切换显示页面
+
+// 状态策略位
+#define STATE_POLICY_HOLD_REPEAT   0x01  // 连击后按住连续调整数值
+#define STATE_POLICY_MOTION_INPUT  0x02  // 敲击/倾斜手势输入
+
+struct StateDescriptor {
+  SystemState state;               // 必须与在表中的下标一致
+  const char* name;
+  uint8_t page;                    // DisplayPage，STATE_PAGE_KEEP保持当前页面
+  uint8_t sensorDivider;           // 每N个传感器节拍读取一次，0为不读取
+  uint8_t policies;                // STATE_POLICY_*
+  StateHandler onEnter;            // 可为nullptr
+  StateHandler onExit;
+  StateHandler onTick;
+};
+
+namespace StateTable {
+
+static_assert(SYSTEM_STATE_COUNT <= 16, "状态转换矩阵每行为16位");
+
+constexpr uint16_t bits() {
+  return 0;
+}
+
+template <typename... Rest>
+constexpr uint16_t bits(SystemState first, Rest... rest) {
+  return (uint16_t)((1u << first) | bits(rest...));
+}
+
+// 允许的状态转换 (行: 当前状态，位: 目标状态)
+constexpr uint16_t transitions[SYSTEM_STATE_COUNT] = {
+  /* BOOT_ANIMATION */ bits(STATE_MAIN_MENU),
+  /* MAIN_MENU      */ bits(STATE_PRACTICING, STATE_HISTORY, STATE_SETTINGS, STATE_CALIBRATING, STATE_SLEEP),
+  /* IDLE           */ bits(STATE_MAIN_MENU, STATE_PRACTICING, STATE_MENU, STATE_CALIBRATING, STATE_SLEEP),
+  /* CALIBRATING    */ bits(STATE_MAIN_MENU, STATE_IDLE),
+  /* PRACTICING     */ bits(STATE_PAUSED, STATE_MAIN_MENU, STATE_IDLE),
+  /* PAUSED         */ bits(STATE_PRACTICING, STATE_MAIN_MENU, STATE_IDLE),
+  /* MENU           */ bits(STATE_MAIN_MENU, STATE_IDLE, STATE_SETTINGS),
+  /* SETTINGS       */ bits(STATE_MAIN_MENU, STATE_MENU, STATE_IDLE),
+  /* HISTORY        */ bits(STATE_MAIN_MENU, STATE_IDLE),
+  /* SLEEP          */ bits(STATE_MAIN_MENU, STATE_IDLE)
+};
+
+constexpr bool canTransition(SystemState from, SystemState to) {
+  return from < SYSTEM_STATE_COUNT && to < SYSTEM_STATE_COUNT && ((transitions[from] >> to) & 1);
+}
+
+// 所有状态转换的并集，用于检查每个状态都能进入
+constexpr uint16_t reachable(uint8_t from = 0) {
+  return from >= SYSTEM_STATE_COUNT ? 0 : (uint16_t)(transitions[from] | reachable(from + 1));
+}
+
+// 描述表的第i行是否对应状态i
+constexpr bool ordered(const StateDescriptor* table, uint8_t count, uint8_t i = 0) {
+  return i >= count || (table[i].state == i && ordered(table, count, i + 1));
+}
+
+static_assert(!canTransition(STATE_BOOT_ANIMATION, STATE_BOOT_ANIMATION), "开机动画不能重新进入");
+static_assert((reachable() | bits(STATE_BOOT_ANIMATION)) == (1u << SYSTEM_STATE_COUNT) - 1,
+              "除开机动画外每个状态都必须可以进入");
+
+} // namespace StateTable
+
+class StateMachine {
+private:
+  const StateDescriptor* table;
+  SystemState state;
+  uint8_t sensorTickCount = 0;
+  uint32_t enteredMs = 0;
+  uint32_t transitionCount = 0;
+  uint32_t rejectedCount = 0;
+
+  void enter(SystemState to);
+
+public:
+  StateMachine(const StateDescriptor* stateTable, SystemState initial);
+
+  // 转换到新状态：依次调用旧状态的退出处理和新状态的进入处理
+  // 不允许的转换返回false，状态不变，也不调用任何处理函数
+  bool change(SystemState to);
+
+  // 深度休眠唤醒后直接恢复到指定状态 (不校验转换，只调用进入处理)
+  void restore(SystemState to);
+
+  // 每轮主循环调用当前状态的处理函数
+  void tick();
+
+  // 传感器节拍到达时调用，按当前状态的分频返回本节拍是否读取
+  bool takeSensorTick();
+
+  SystemState getState() const;
+  const StateDescriptor& getDescriptor() const;
+  bool hasPolicy(uint8_t policy) const;
+  const char* getName(SystemState s) const;
+  uint32_t getTimeInState(uint32_t nowMs) const;
+  uint32_t getTransitionCount() const;
+  uint32_t getRejectedCount() const;
+};
+
+#endif // STATE_MACHINE_H
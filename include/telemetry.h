@@ -0,0 +1,63 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// ==================== 二进制遥测 ====================
+// 以传感器读取频率输出原始和滤波后的IMU数据及评分，用于采集现场数据。
+// 每个包: [类型1字节][序号2字节][时间戳ms 4字节][负载][CRC32 4字节]，多字节字段均为小端，
+// CRC32覆盖之前的全部字节 (与zlib.crc32一致)。
+// 包经COBS编码后前后各加一个0x00作为帧分隔，文本日志中不会出现0x00，
+// 因此可以与日志共用串口：主机端按0x00切分，能通过COBS解码和CRC校验的是遥测包，其余为文本。
+// 串口发送缓冲放不下整帧时直接丢弃该包并计数，不等待串口。
+// 主机端读取工具: scripts/zen_telemetry.py
+enum TelemetryPacketType {
+  TELEMETRY_PKT_HELLO = 0x00,      // 开始输出: 版本、采样间隔、原始计数换算系数
+  TELEMETRY_PKT_SAMPLE = 0x01      // 一次传感器读取
+};
+
+#define TELEMETRY_FLAG_STABLE  0x01
+#define TELEMETRY_FLAG_SESSION 0x02      // 练习会话进行中
+
+struct TelemetrySample {
+  uint32_t timestampMs;
+  int16_t raw[6];                  // MPU6050原始计数: ax, ay, az, gx, gy, gz
+  float filtered[6];               // 校准、滤波后的加速度 (g) 和角速度 (°/s)
+  float score;
+  float avgScore;
+  uint8_t flags;                   // TELEMETRY_FLAG_*
+};
+
+class Telemetry {
+private:
+  static bool enabled;
+  static uint16_t sequence;
+  static uint32_t sentCount;
+  static uint32_t droppedCount;
+
+  static bool sendPacket(const uint8_t* packet, size_t length);
+
+public:
+  // 开始/停止输出，开始时先发送HELLO包
+  static void start();
+  static void stop();
+  static bool isEnabled();
+
+  // 发送一次传感器读取 (未开启时直接返回)
+  static void sendSample(const TelemetrySample& sample);
+
+  // 包编码，返回包长度 (含CRC)
+  static size_t encodeHello(uint16_t seq, uint32_t timestampMs, uint8_t* out);
+  static size_t encodeSample(const TelemetrySample& sample, uint16_t seq, uint8_t* out);
+
+  // COBS编码，返回编码后长度 (最多 length + length/254 + 1)；解码失败返回0
+  static size_t cobsEncode(const uint8_t* in, size_t length, uint8_t* out);
+  static size_t cobsDecode(const uint8_t* in, size_t length, uint8_t* out);
+
+  static uint32_t getSentCount();
+  static uint32_t getDroppedCount();
+  static void printStats();
+};
+
+#endif // TELEMETRY_H
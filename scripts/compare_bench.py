@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+气定神闲仪主机微基准对比工具
+
+比较两次 bench 的JSON结果 (Google Benchmark格式)，任一基准变慢超过阈值时返回退出码1，
+可以在每次提交后自动检查性能回退:
+
+  .pio/build/native-bench/program --repetitions 5 --json base.json      # 基准提交
+  .pio/build/native-bench/program --repetitions 5 --json new.json       # 当前提交
+  python compare_bench.py base.json new.json --threshold 10
+
+有重复测量时使用中位数 (*_median)，否则使用各次测量的中位数。默认比较CPU时间。
+主机耗时受负载和调频影响，两次结果应在同一台机器上、相近的条件下测得。
+"""
+
+import argparse
+import json
+import statistics
+import sys
+
+
+def load(path):
+    """读取JSON，返回 {基准名: 每轮耗时 (ns)}"""
+    try:
+        with open(path, encoding="utf-8") as f:
+            data = json.load(f)
+    except (OSError, ValueError) as e:
+        sys.exit(f"错误: 无法读取 {path}: {e}")
+
+    scale = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+    medians = {}
+    runs = {}
+    for bench in data.get("benchmarks", []):
+        name = bench.get("run_name", bench["name"])
+        factor = scale.get(bench.get("time_unit", "ns"), 1.0)
+        times = (bench["real_time"] * factor, bench["cpu_time"] * factor)
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[name] = times
+        else:
+            runs.setdefault(name, []).append(times)
+
+    results = {}
+    for name, values in runs.items():
+        results[name] = medians.get(name) or (statistics.median(v[0] for v in values),
+                                              statistics.median(v[1] for v in values))
+    return results
+
+
+def format_ns(ns):
+    if ns >= 1e6:
+        return f"{ns / 1e6:.2f} ms"
+    if ns >= 1e3:
+        return f"{ns / 1e3:.2f} us"
+    return f"{ns:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="气定神闲仪主机微基准对比工具")
+    parser.add_argument("baseline", help="基准结果 (JSON)")
+    parser.add_argument("current", help="当前结果 (JSON)")
+    parser.add_argument("--threshold", type=float, default=10.0, help="判定为回退的变慢比例 (%%)，默认10")
+    parser.add_argument("--real", action="store_true", help="比较实际时间而不是CPU时间")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    index = 0 if args.real else 1
+
+    regressions = []
+    print(f"{'基准':<44}{'基准耗时':>10}{'当前耗时':>10}{'变化':>7}")
+    for name in sorted(set(baseline) | set(current)):
+        if name not in baseline or name not in current:
+            status = "新增" if name in current else "已删除"
+            value = (current if name in current else baseline)[name][index]
+            print(f"{name:<46}{format_ns(value):>14}  {status}")
+            continue
+        before = baseline[name][index]
+        after = current[name][index]
+        change = (after - before) / before * 100 if before > 0 else 0.0
+        mark = ""
+        if change > args.threshold:
+            mark = "  ⚠ 回退"
+            regressions.append(name)
+        elif change < -args.threshold:
+            mark = "  ✓ 改善"
+        print(f"{name:<46}{format_ns(before):>14}{format_ns(after):>14}{change:>+8.1f}%{mark}")
+
+    if regressions:
+        print(f"\n{len(regressions)} 个基准变慢超过 {args.threshold:g}%: {', '.join(regressions)}")
+        sys.exit(1)
+    print(f"\n没有超过 {args.threshold:g}% 的回退")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""
+气定神闲仪构建配置对比工具
+
+比较不同PlatformIO环境 (调试级别、模块日志级别等) 的固件大小和主循环处理时间:
+
+  python compare_builds.py esp32-c3-devkitm-1 esp32-c3-quiet esp32-c3-release
+  python compare_builds.py esp32-c3-devkitm-1 esp32-c3-quiet --no-build \\
+      --log esp32-c3-devkitm-1=debug.log --log esp32-c3-quiet=quiet.log
+
+大小从 .pio/build/<环境>/firmware.elf 的节表统计。主循环处理时间取自设备周期报告中的
+"每轮耗时: 平均 X, ..., 最大 Y us" 行 (日志需要先用 zen_log.py 解码)，取最后一次报告。
+"""
+
+import argparse
+import re
+import struct
+import subprocess
+import sys
+from pathlib import Path
+
+SHF_WRITE = 0x1
+SHF_ALLOC = 0x2
+SHF_EXECINSTR = 0x4
+SHT_NOBITS = 8
+
+LOOP_REPORT = re.compile(r"每轮耗时: 平均 (\d+),.*最大 (\d+) us")
+
+
+def section_sizes(path):
+    """按节属性统计: 代码、只读数据、已初始化数据、零初始化数据 (字节)"""
+    data = Path(path).read_bytes()
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        raise ValueError(f"不是32位小端ELF文件: {path}")
+
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+    sizes = {"code": 0, "rodata": 0, "data": 0, "bss": 0}
+    for i in range(shnum):
+        (_, sh_type, flags, addr, _, size) = struct.unpack_from(
+            "<IIIIII", data, shoff + i * shentsize)
+        if not flags & SHF_ALLOC or not addr:
+            continue
+        if sh_type == SHT_NOBITS:
+            sizes["bss"] += size
+        elif flags & SHF_EXECINSTR:
+            sizes["code"] += size
+        elif flags & SHF_WRITE:
+            sizes["data"] += size
+        else:
+            sizes["rodata"] += size
+    sizes["flash"] = sizes["code"] + sizes["rodata"] + sizes["data"]
+    sizes["ram"] = sizes["data"] + sizes["bss"]
+    return sizes
+
+
+def loop_time(path):
+    """取日志中最后一次主循环处理时间报告 (平均, 最大)"""
+    result = None
+    with open(path, "rb") as f:
+        for raw in f:
+            match = LOOP_REPORT.search(raw.decode("utf-8", errors="replace"))
+            if match:
+                result = (int(match.group(1)), int(match.group(2)))
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="气定神闲仪构建配置对比工具")
+    parser.add_argument("envs", nargs="+", help="PlatformIO环境名，第一个作为比较基准")
+    parser.add_argument("--no-build", action="store_true", help="不重新编译，直接读取已有的firmware.elf")
+    parser.add_argument("--log", action="append", default=[], metavar="环境=文件",
+                        help="该环境运行时的已解码串口日志，用于比较主循环处理时间")
+    parser.add_argument("--project", default=Path(__file__).resolve().parent.parent, type=Path)
+    args = parser.parse_args()
+
+    logs = {}
+    for item in args.log:
+        env, _, path = item.partition("=")
+        if not path:
+            sys.exit(f"错误: --log 格式应为 环境=文件: {item}")
+        logs[env] = path
+
+    rows = []
+    for env in args.envs:
+        if not args.no_build:
+            subprocess.run(["pio", "run", "-e", env], cwd=args.project, check=True)
+        try:
+            sizes = section_sizes(args.project / ".pio" / "build" / env / "firmware.elf")
+        except (OSError, ValueError) as e:
+            sys.exit(f"错误: {e}")
+        rows.append((env, sizes, loop_time(logs[env]) if env in logs else None))
+
+    base = rows[0][1]
+    print(f"{'环境':<24}{'Flash':>10}{'差值':>9}{'代码':>10}{'只读':>10}{'RAM':>9}{'差值':>8}{'循环平均/最大us':>18}")
+    for env, sizes, loop in rows:
+        loop_text = f"{loop[0]}/{loop[1]}" if loop else "-"
+        print(f"{env:<24}{sizes['flash']:>10}{sizes['flash'] - base['flash']:>+9}"
+              f"{sizes['code']:>10}{sizes['rodata']:>10}"
+              f"{sizes['ram']:>9}{sizes['ram'] - base['ram']:>+8}{loop_text:>18}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,285 @@
+#!/usr/bin/env python3
+"""
+气定神闲仪数据导出解码工具
+
+设备串口输入 "export" 输出二进制导出 (@EXB 行)，输入 "export csv" 输出CSV (@EXC 行)。
+本工具从串口日志中提取这些行，校验CRC并解码:
+
+  python zen_export.py decode monitor.log            # 打印JSON
+  python zen_export.py decode monitor.log -o out/    # 另存为 export.bin、stats.json 及每个会话的曲线CSV
+  python zen_export.py csv monitor.log > stats.csv   # 提取并校验CSV导出
+  python zen_export.py send out/export.bin           # 将二进制导出重新编码为 @EXB 行，写入串口即可导入
+  python zen_export.py capture --port /dev/ttyACM0 -o monitor.log   # 需要pyserial
+"""
+
+import argparse
+import json
+import struct
+import sys
+import time
+import zlib
+from pathlib import Path
+
+REC_HEADER = 0x01
+REC_SETTINGS = 0x02
+REC_DAY = 0x10
+REC_ROLLING_DAY = 0x11
+REC_SESSION = 0x20
+REC_END = 0xFF
+
+EXPORT_MAGIC = b"ZEX1"
+EXPORT_VERSION = 1
+CHUNK_SIZE = 32
+
+SESSION_MAGIC = 0x3152535A
+SESSION_HEADER = struct.Struct("<IBBHIHBBBB")
+
+
+def read_lines(path):
+    """读取日志文件，兼容调试输出中的非UTF-8字节"""
+    with open(path, "rb") as f:
+        for raw in f:
+            yield raw.decode("utf-8", errors="replace").strip()
+
+
+def extract_binary(lines):
+    """拼接 @EXB 行，检查序号连续性，只保留最后一次完整导出"""
+    data = bytearray()
+    expected = 0
+    for line in lines:
+        if not line.startswith("@EXB "):
+            continue
+        parts = line.split()
+        if len(parts) < 3:
+            raise ValueError(f"行格式错误: {line}")
+        seq = int(parts[1], 16)
+        if seq == 0:
+            data = bytearray()
+            expected = 0
+        if seq != expected:
+            raise ValueError(f"行序号不连续: 期望 {expected:04x}, 实际 {seq:04x}")
+        data += bytes.fromhex(parts[2])
+        expected += 1
+    if not data:
+        raise ValueError("日志中没有找到 @EXB 导出数据")
+    return bytes(data)
+
+
+def iter_records(data):
+    pos = 0
+    while pos + 2 <= len(data):
+        rtype, length = data[pos], data[pos + 1]
+        payload = data[pos + 2:pos + 2 + length]
+        if len(payload) != length:
+            raise ValueError("记录被截断")
+        yield pos, rtype, payload
+        pos += 2 + length
+
+
+def decode_settings(p):
+    v = struct.unpack_from("<fBBIBIBB", p)
+    return {
+        "stability_threshold": v[0], "sound_enabled": bool(v[1]),
+        "display_brightness": v[2], "practice_time_ms": v[3],
+        "auto_sleep": bool(v[4]), "sleep_timeout_ms": v[5],
+        "calibration_enabled": bool(v[6]), "language": v[7],
+    }
+
+
+def decode_day(p):
+    v = struct.unpack_from("<BHBBIHHffIfff", p)
+    return {
+        "slot": v[0], "date": f"{v[1]:04d}-{v[2]:02d}-{v[3]:02d}",
+        "total_ms": v[4], "sessions": v[5], "breaks": v[6],
+        "avg": round(v[7], 2), "best": round(v[8], 2), "stable_ms": v[9],
+        "median": round(v[10], 2), "p10": round(v[11], 2), "p90": round(v[12], 2),
+    }
+
+
+def decode_summary(p):
+    v = struct.unpack_from("<HBBIHHHH", p)
+    # 早期导出不含采样时长，以总时长代替
+    sampled = struct.unpack_from("<I", p, 16)[0] if len(p) >= 20 else v[3]
+    return {
+        "date": f"{v[0]:04d}-{v[1]:02d}-{v[2]:02d}", "total_ms": v[3],
+        "sessions": v[4], "breaks": v[5], "avg": v[6] / 100.0, "best": v[7] / 100.0,
+        "sampled_ms": sampled,
+    }
+
+
+def decode_session_file(raw):
+    """解码会话记录文件: 文件头 + [点数][首点][int8差分...] 块"""
+    if len(raw) < SESSION_HEADER.size:
+        return None
+    magic, version, _, interval, sid, year, month, day, hour, minute = SESSION_HEADER.unpack_from(raw)
+    if magic != SESSION_MAGIC:
+        return None
+    points = []
+    pos = SESSION_HEADER.size
+    while pos < len(raw):
+        count = raw[pos]
+        if count == 0 or pos + 1 + count > len(raw):
+            break
+        value = raw[pos + 1]
+        points.append(value)
+        for delta in raw[pos + 2:pos + 1 + count]:
+            value = (value + (delta - 256 if delta > 127 else delta)) & 0xFF
+            points.append(value)
+        pos += 1 + count
+    return {
+        "session_id": sid, "version": version, "interval_ms": interval,
+        "start": f"{year:04d}-{month:02d}-{day:02d} {hour:02d}:{minute:02d}",
+        "points": points,
+    }
+
+
+def decode_export(data):
+    result = {"settings": None, "days": [], "rolling": [], "sessions": []}
+    session_raw = {}
+    crc_ok = False
+
+    for pos, rtype, payload in iter_records(data):
+        if rtype == REC_HEADER:
+            if payload[:4] != EXPORT_MAGIC:
+                raise ValueError("导出文件头无效")
+            if payload[4] != EXPORT_VERSION:
+                raise ValueError(f"不支持的格式版本: {payload[4]}")
+            result["version"] = payload[4]
+        elif rtype == REC_SETTINGS:
+            result["settings"] = decode_settings(payload)
+        elif rtype == REC_DAY:
+            result["days"].append(decode_day(payload))
+        elif rtype == REC_ROLLING_DAY:
+            result["rolling"].append(decode_summary(payload))
+        elif rtype == REC_SESSION:
+            sid = struct.unpack_from("<I", payload)[0]
+            session_raw.setdefault(sid, bytearray()).extend(payload[4:])
+        elif rtype == REC_END:
+            expected = struct.unpack_from("<I", payload)[0]
+            actual = zlib.crc32(data[:pos]) & 0xFFFFFFFF
+            if expected != actual:
+                raise ValueError(f"CRC校验失败: 期望 {expected:08x}, 实际 {actual:08x}")
+            crc_ok = True
+            break
+
+    if not crc_ok:
+        raise ValueError("导出数据不完整 (缺少结束记录)")
+
+    for sid in sorted(session_raw):
+        session = decode_session_file(bytes(session_raw[sid]))
+        if session:
+            result["sessions"].append(session)
+    return result
+
+
+def cmd_decode(args):
+    data = extract_binary(read_lines(args.log))
+    result = decode_export(data)
+
+    if not args.output:
+        json.dump(result, sys.stdout, ensure_ascii=False, indent=2)
+        print()
+        return
+
+    out = Path(args.output)
+    out.mkdir(parents=True, exist_ok=True)
+    (out / "export.bin").write_bytes(data)
+    summary = {k: v for k, v in result.items() if k != "sessions"}
+    summary["sessions"] = [{k: v for k, v in s.items() if k != "points"} | {"point_count": len(s["points"])}
+                           for s in result["sessions"]]
+    (out / "stats.json").write_text(json.dumps(summary, ensure_ascii=False, indent=2), encoding="utf-8")
+    for session in result["sessions"]:
+        with open(out / f"session_{session['session_id']}.csv", "w", encoding="utf-8") as f:
+            f.write("second,score\n")
+            step = session["interval_ms"] / 1000.0
+            for i, score in enumerate(session["points"]):
+                f.write(f"{i * step:g},{score}\n")
+    print(f"已解码: {len(result['days'])}个日统计, {len(result['rolling'])}天滚动统计, "
+          f"{len(result['sessions'])}个会话 -> {out}")
+
+
+def cmd_csv(args):
+    rows = []
+    expected = None
+    for line in read_lines(args.log):
+        if not line.startswith("@EXC "):
+            continue
+        content = line[5:]
+        if content.startswith("# zen-motion export"):
+            rows = []
+        if content.startswith("#crc32="):
+            expected = int(content[7:], 16)
+            break
+        rows.append(content)
+    if expected is None:
+        raise ValueError("CSV导出不完整 (缺少CRC行)")
+    actual = zlib.crc32("".join(r + "\n" for r in rows).encode("utf-8")) & 0xFFFFFFFF
+    if actual != expected:
+        raise ValueError(f"CRC校验失败: 期望 {expected:08x}, 实际 {actual:08x}")
+    for row in rows:
+        if not row.startswith("#"):
+            print(row)
+
+
+def cmd_send(args):
+    data = Path(args.file).read_bytes()
+    for seq, i in enumerate(range(0, len(data), CHUNK_SIZE)):
+        print(f"@EXB {seq:04x} {data[i:i + CHUNK_SIZE].hex()}")
+
+
+def cmd_capture(args):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("需要安装pyserial: pip install pyserial")
+
+    with serial.Serial(args.port, args.baud, timeout=1) as port, open(args.output, "wb") as log:
+        port.write(b"export csv\n" if args.csv else b"export\n")
+        marker = b"@EXC #crc32=" if args.csv else b"@EXB "
+        last_data = time.time()
+        while time.time() - last_data < args.idle:
+            line = port.readline()
+            if not line:
+                continue
+            log.write(line)
+            if line.startswith(b"@EX"):
+                last_data = time.time()
+            if args.csv and line.startswith(marker):
+                break
+    print(f"已保存串口日志: {args.output}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="气定神闲仪数据导出解码工具")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("decode", help="解码二进制导出")
+    p.add_argument("log", help="串口日志文件")
+    p.add_argument("-o", "--output", help="输出目录")
+    p.set_defaults(func=cmd_decode)
+
+    p = sub.add_parser("csv", help="提取并校验CSV导出")
+    p.add_argument("log", help="串口日志文件")
+    p.set_defaults(func=cmd_csv)
+
+    p = sub.add_parser("send", help="将二进制导出编码为可导入的 @EXB 行")
+    p.add_argument("file", help="export.bin")
+    p.set_defaults(func=cmd_send)
+
+    p = sub.add_parser("capture", help="从串口触发并保存导出")
+    p.add_argument("--port", required=True)
+    p.add_argument("--baud", type=int, default=115200)
+    p.add_argument("--csv", action="store_true", help="导出CSV")
+    p.add_argument("--idle", type=float, default=3.0, help="无数据超时 (秒)")
+    p.add_argument("-o", "--output", default="export.log")
+    p.set_defaults(func=cmd_capture)
+
+    args = parser.parse_args()
+    try:
+        args.func(args)
+    except ValueError as e:
+        sys.exit(f"错误: {e}")
+
+
+if __name__ == "__main__":
+    main()
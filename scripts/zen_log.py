@@ -0,0 +1,235 @@
+#!/usr/bin/env python3
+"""
+气定神闲仪延迟日志解码工具
+
+固件的 DEBUG_INFO/WARN/... 只输出 @LG 行 (二进制记录的十六进制)，记录中保存的是
+模块名和格式串在固件中的地址。本工具读取对应固件的ELF文件取出这些字符串，
+按printf规则还原为原来的文本格式: [时间戳][模块][级别] 内容
+其它行 (DEBUG_PRINTF输出、导出数据、命令回复) 原样输出。
+
+  python zen_log.py decode monitor.log --elf .pio/build/esp32-c3-devkitm-1/firmware.elf
+  python zen_log.py monitor --port /dev/ttyACM0 --elf firmware.elf     # 需要pyserial
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SENTINEL = "ZENLOG1"
+LEVEL_NAMES = {1: "ERROR", 2: "WARN", 3: "INFO", 4: "DEBUG", 5: "VERBOSE"}
+LEVEL_TRUNCATED = 0x80
+HEADER = struct.Struct("<BBIII")
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+# printf转换说明: 标志、宽度、精度、长度修饰、转换字符
+CONVERSION = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?(hh|h|ll|l|j|z|t|L|q)?([diouxXeEfFgGaAcspn%])")
+
+
+class FirmwareImage:
+    """从ELF中按地址读取常量字符串 (只解析节表，不依赖pyelftools)"""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1 or self.data[5] != 1:
+            raise ValueError(f"不是32位小端ELF文件: {path}")
+
+        shoff, = struct.unpack_from("<I", self.data, 0x20)
+        shentsize, shnum = struct.unpack_from("<HH", self.data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            (_, sh_type, flags, addr, offset, size) = struct.unpack_from(
+                "<IIIIII", self.data, shoff + i * shentsize)
+            if flags & SHF_ALLOC and sh_type != SHT_NOBITS and addr and size:
+                self.sections.append((addr, size, offset))
+        self.cache = {}
+
+    def string_at(self, address):
+        if address in self.cache:
+            return self.cache[address]
+        for addr, size, offset in self.sections:
+            if addr <= address < addr + size:
+                start = offset + address - addr
+                end = self.data.find(b"\0", start, offset + size)
+                text = self.data[start:end if end >= 0 else offset + size].decode("utf-8", errors="replace")
+                self.cache[address] = text
+                return text
+        return None
+
+
+def parse_args(payload, truncated):
+    """按类型标记取出参数"""
+    args = []
+    pos = 0
+    while pos < len(payload):
+        tag = chr(payload[pos])
+        pos += 1
+        if tag in "ip":
+            if pos + 4 > len(payload):
+                break
+            args.append((tag, struct.unpack_from("<I", payload, pos)[0]))
+            pos += 4
+        elif tag == "q":
+            if pos + 8 > len(payload):
+                break
+            args.append((tag, struct.unpack_from("<Q", payload, pos)[0]))
+            pos += 8
+        elif tag == "d":
+            if pos + 8 > len(payload):
+                break
+            args.append((tag, struct.unpack_from("<d", payload, pos)[0]))
+            pos += 8
+        elif tag == "s":
+            length = payload[pos]
+            text = payload[pos + 1:pos + 1 + length].decode("utf-8", errors="replace")
+            args.append((tag, text))
+            pos += 1 + length
+        else:
+            raise ValueError(f"未知参数类型标记: {tag!r}")
+    return args
+
+
+def as_signed(tag, value):
+    bits = 64 if tag == "q" else 32
+    return value - (1 << bits) if value >= 1 << (bits - 1) else value
+
+
+def format_printf(fmt, args):
+    """用记录中的参数按printf规则格式化"""
+    queue = list(args)
+
+    def take():
+        return queue.pop(0) if queue else ("s", "<缺少参数>")
+
+    def replace(match):
+        flags, width, precision, _, conv = match.groups()
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(as_signed(*take()))
+        if precision == "*":
+            precision = str(as_signed(*take()))
+        spec = "%" + flags + (width or "") + ("." + precision if precision is not None else "")
+
+        tag, value = take()
+        if conv == "s":
+            return (spec + "s") % (value if tag == "s" else str(value))
+        if tag == "s":
+            return value
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xFF)
+        if conv == "p":
+            return "0x%08x" % value
+        if conv in "di":
+            return (spec + "d") % as_signed(tag, int(value))
+        if conv in "ouxX":
+            return (spec + conv) % int(value)
+        if conv == "n":
+            return ""
+        if conv in "aA":
+            return float(value).hex()
+        return (spec + conv) % float(value)
+
+    return CONVERSION.sub(replace, fmt)
+
+
+def decode_record(raw, image):
+    if len(raw) < HEADER.size or raw[0] != len(raw):
+        raise ValueError("记录长度不一致")
+    _, level, timestamp, module_addr, format_addr = HEADER.unpack_from(raw)
+    truncated = bool(level & LEVEL_TRUNCATED)
+    level &= ~LEVEL_TRUNCATED
+
+    module = image.string_at(module_addr) or f"?{module_addr:08x}"
+    fmt = image.string_at(format_addr)
+    args = parse_args(raw[HEADER.size:], truncated)
+    if fmt is None:
+        text = f"<未知格式串 {format_addr:08x}> " + " ".join(str(v) for _, v in args)
+    else:
+        text = format_printf(fmt, args)
+    if truncated:
+        text += " <参数截断>"
+    return f"[{timestamp:08d}][{module}][{LEVEL_NAMES.get(level, 'VERBOSE')}] {text}"
+
+
+def decode_line(line, image):
+    """解码一行串口输出，非日志行原样返回"""
+    if line.startswith("@LG "):
+        try:
+            return decode_record(bytes.fromhex(line[4:].strip()), image)
+        except ValueError as e:
+            return f"<日志记录损坏: {e}> {line}"
+    if line.startswith("@LD "):
+        lost, = struct.unpack("<I", bytes.fromhex(line[4:].strip()))
+        return f"<日志缓冲已满，丢弃 {lost} 条>"
+    if line.startswith("@LS "):
+        address = int(line[4:].strip(), 16)
+        if image.string_at(address) != SENTINEL:
+            return "<警告: ELF与设备上的固件不匹配，日志文本可能错误>"
+        return None
+    return line
+
+
+def cmd_decode(args):
+    image = FirmwareImage(args.elf)
+    with open(args.log, "rb") as f:
+        for raw in f:
+            text = decode_line(raw.decode("utf-8", errors="replace").rstrip("\r\n"), image)
+            if text is not None:
+                print(text)
+
+
+def cmd_monitor(args):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("需要安装pyserial: pip install pyserial")
+
+    image = FirmwareImage(args.elf)
+    log = open(args.output, "wb") if args.output else None
+    with serial.Serial(args.port, args.baud, timeout=1) as port:
+        try:
+            while True:
+                raw = port.readline()
+                if not raw:
+                    continue
+                if log:
+                    log.write(raw)
+                text = decode_line(raw.decode("utf-8", errors="replace").rstrip("\r\n"), image)
+                if text is not None:
+                    print(text, flush=True)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            if log:
+                log.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="气定神闲仪延迟日志解码工具")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("decode", help="解码串口日志文件")
+    p.add_argument("log", help="串口日志文件")
+    p.add_argument("--elf", required=True, help="与设备上固件对应的firmware.elf")
+    p.set_defaults(func=cmd_decode)
+
+    p = sub.add_parser("monitor", help="实时读取串口并解码")
+    p.add_argument("--port", required=True)
+    p.add_argument("--baud", type=int, default=115200)
+    p.add_argument("--elf", required=True, help="与设备上固件对应的firmware.elf")
+    p.add_argument("-o", "--output", help="同时保存原始串口日志")
+    p.set_defaults(func=cmd_monitor)
+
+    args = parser.parse_args()
+    try:
+        args.func(args)
+    except ValueError as e:
+        sys.exit(f"错误: {e}")
+
+
+if __name__ == "__main__":
+    main()
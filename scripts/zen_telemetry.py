@@ -0,0 +1,227 @@
+#!/usr/bin/env python3
+"""
+气定神闲仪二进制遥测读取工具
+
+设备上执行串口命令 "telemetry on" 后，每次传感器读取输出一个遥测包:
+  0x00 | COBS( [类型][序号u16][时间戳ms u32][负载][CRC32] ) | 0x00
+遥测帧与文本日志共用串口。本工具按0x00切分串口数据，能通过COBS解码和CRC校验的
+作为遥测包写入CSV，其余作为文本行输出 (指定 --elf 时用 zen_log.py 解码延迟日志)。
+
+  python zen_telemetry.py capture --port /dev/ttyACM0 -o samples.csv --raw capture.bin
+  python zen_telemetry.py decode capture.bin -o samples.csv --elf firmware.elf
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import zlib
+from pathlib import Path
+
+PKT_HELLO = 0x00
+PKT_SAMPLE = 0x01
+SUPPORTED_VERSION = 1
+
+HEADER = struct.Struct("<BHI")
+HELLO = struct.Struct("<BHff")
+SAMPLE = struct.Struct("<6h6fffB")
+FLAG_STABLE = 0x01
+FLAG_SESSION = 0x02
+
+CSV_FIELDS = ["seq", "time_ms",
+              "ax_raw", "ay_raw", "az_raw", "gx_raw", "gy_raw", "gz_raw",
+              "ax_g", "ay_g", "az_g", "gx_dps", "gy_dps", "gz_dps",
+              "score", "avg_score", "stable", "session"]
+
+
+def cobs_decode(data):
+    """COBS解码，格式错误时返回None"""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        block = data[i:i + code - 1]
+        if 0 in block:
+            return None
+        out += block
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_packet(chunk):
+    """解码一帧，返回 (类型, 序号, 时间戳, 负载)；不是有效的遥测包时返回None"""
+    packet = cobs_decode(chunk)
+    if packet is None or len(packet) < HEADER.size + 4:
+        return None
+    body, crc = packet[:-4], struct.unpack("<I", packet[-4:])[0]
+    if zlib.crc32(body) != crc:
+        return None
+    kind, seq, timestamp = HEADER.unpack_from(body)
+    return kind, seq, timestamp, body[HEADER.size:]
+
+
+class TelemetryReader:
+    """把串口字节流拆分为遥测包和文本行"""
+
+    def __init__(self, writer, text_handler):
+        self.writer = writer
+        self.text_handler = text_handler
+        self.chunk = bytearray()
+        self.text = bytearray()
+        self.last_seq = None
+        self.samples = 0
+        self.lost = 0
+
+    def feed(self, data):
+        for byte in data:
+            if byte == 0:
+                self.finish_chunk()
+            else:
+                self.chunk.append(byte)
+
+    def finish_chunk(self):
+        if not self.chunk:
+            return
+        chunk = bytes(self.chunk)
+        self.chunk.clear()
+        parsed = parse_packet(chunk)
+        if parsed is None:
+            self.feed_text(chunk)
+        else:
+            self.handle_packet(*parsed)
+
+    def feed_text(self, data):
+        self.text += data
+        while b"\n" in self.text:
+            line, _, rest = bytes(self.text).partition(b"\n")
+            self.text = bytearray(rest)
+            self.text_handler(line.decode("utf-8", errors="replace").rstrip("\r"))
+
+    def handle_packet(self, kind, seq, timestamp, payload):
+        # 序号不连续说明设备端因串口繁忙丢弃了包 (或传输中损坏)
+        if self.last_seq is not None and kind != PKT_HELLO:
+            self.lost += (seq - self.last_seq - 1) & 0xFFFF
+        self.last_seq = seq
+
+        if kind == PKT_HELLO:
+            version, interval, accel_scale, gyro_scale = HELLO.unpack_from(payload)
+            if version != SUPPORTED_VERSION:
+                print(f"<警告: 遥测版本 {version}，本工具支持 {SUPPORTED_VERSION}>", file=sys.stderr)
+            print(f"<遥测开始: 采样间隔 {interval} ms, 换算系数 {accel_scale:g} LSB/g, "
+                  f"{gyro_scale:g} LSB/(°/s)>", file=sys.stderr)
+        elif kind == PKT_SAMPLE and len(payload) >= SAMPLE.size:
+            values = SAMPLE.unpack_from(payload)
+            flags = values[-1]
+            self.writer.writerow([seq, timestamp, *values[:6],
+                                  *(f"{v:.5f}" for v in values[6:12]),
+                                  f"{values[12]:.2f}", f"{values[13]:.2f}",
+                                  int(bool(flags & FLAG_STABLE)), int(bool(flags & FLAG_SESSION))])
+            self.samples += 1
+
+    def summary(self):
+        return f"共 {self.samples} 个样本，丢失 {self.lost} 个"
+
+
+def make_text_handler(elf, stream):
+    if elf is None:
+        return lambda line: print(line, file=stream)
+
+    sys.path.insert(0, str(Path(__file__).resolve().parent))
+    from zen_log import FirmwareImage, decode_line
+    image = FirmwareImage(elf)
+
+    def handle(line):
+        text = decode_line(line, image)
+        if text is not None:
+            print(text, file=stream)
+    return handle
+
+
+def text_stream(args):
+    """CSV输出到标准输出时文本行改为输出到标准错误"""
+    return sys.stderr if args.output is None else sys.stdout
+
+
+def open_output(path):
+    out = open(path, "w", newline="") if path else sys.stdout
+    writer = csv.writer(out)
+    writer.writerow(CSV_FIELDS)
+    return out, writer
+
+
+def cmd_decode(args):
+    out, writer = open_output(args.output)
+    reader = TelemetryReader(writer, make_text_handler(args.elf, text_stream(args)))
+    with open(args.capture, "rb") as f:
+        reader.feed(f.read())
+    reader.finish_chunk()
+    if args.output:
+        out.close()
+    print(reader.summary(), file=sys.stderr)
+
+
+def cmd_capture(args):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("需要安装pyserial: pip install pyserial")
+
+    out, writer = open_output(args.output)
+    reader = TelemetryReader(writer, make_text_handler(args.elf, text_stream(args)))
+    raw = open(args.raw, "wb") if args.raw else None
+    with serial.Serial(args.port, args.baud, timeout=0.1) as port:
+        if not args.no_start:
+            port.write(b"telemetry on\n")
+        try:
+            while True:
+                data = port.read(4096)
+                if not data:
+                    continue
+                if raw:
+                    raw.write(data)
+                reader.feed(data)
+        except KeyboardInterrupt:
+            pass
+        finally:
+            if not args.no_start:
+                port.write(b"telemetry off\n")
+            if raw:
+                raw.close()
+            if args.output:
+                out.close()
+    print(reader.summary(), file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="气定神闲仪二进制遥测读取工具")
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("capture", help="从串口采集遥测 (Ctrl+C结束)")
+    p.add_argument("--port", required=True)
+    p.add_argument("--baud", type=int, default=115200)
+    p.add_argument("-o", "--output", help="样本CSV文件，默认输出到标准输出")
+    p.add_argument("--raw", help="同时保存原始串口数据，之后可用decode重新解析")
+    p.add_argument("--elf", help="与设备上固件对应的firmware.elf，用于解码延迟日志")
+    p.add_argument("--no-start", action="store_true", help="不自动发送telemetry on/off命令")
+    p.set_defaults(func=cmd_capture)
+
+    p = sub.add_parser("decode", help="解析保存的原始串口数据")
+    p.add_argument("capture", help="capture --raw 保存的文件")
+    p.add_argument("-o", "--output", help="样本CSV文件，默认输出到标准输出")
+    p.add_argument("--elf", help="与设备上固件对应的firmware.elf，用于解码延迟日志")
+    p.set_defaults(func=cmd_decode)
+
+    args = parser.parse_args()
+    try:
+        args.func(args)
+    except ValueError as e:
+        sys.exit(f"错误: {e}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,223 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// 主机仿真用的Arduino核心接口 (只包含固件用到的部分)
+// 时间函数读取虚拟时钟，引脚和中断由场景脚本驱动，见 sim/include/sim_clock.h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define INPUT_PULLDOWN 0x09
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define PI 3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define PROGMEM
+#define F(x) (x)
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::min;
+using std::max;
+
+template <class T, class L, class H>
+T constrain(T x, L low, H high) {
+  return x < low ? low : (x > high ? high : x);
+}
+
+// ==================== 时间 ====================
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// ==================== GPIO ====================
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+#define digitalPinToInterrupt(pin) (pin)
+
+// ==================== ADC / 蜂鸣器 ====================
+typedef enum { ADC_0db, ADC_2_5db, ADC_6db, ADC_11db } adc_attenuation_t;
+int analogRead(uint8_t pin);
+void analogReadResolution(int bits);
+void analogSetPinAttenuation(uint8_t pin, adc_attenuation_t attenuation);
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration = 0);
+void noTone(uint8_t pin);
+
+// ==================== 其它 ====================
+long random(long high);
+long random(long low, long high);
+void randomSeed(unsigned long seed);
+bool setCpuFrequencyMhz(uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+
+// ==================== String ====================
+class String {
+private:
+  std::string text;
+
+public:
+  String(const char* value = "") : text(value ? value : "") {}
+  String(const std::string& value) : text(value) {}
+  explicit String(char c) : text(1, c) {}
+  String(int value) : text(std::to_string(value)) {}
+  String(unsigned int value) : text(std::to_string(value)) {}
+  String(long value) : text(std::to_string(value)) {}
+  String(unsigned long value) : text(std::to_string(value)) {}
+  String(float value, unsigned int decimals = 2) : String((double)value, decimals) {}
+  String(double value, unsigned int decimals = 2) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+    text = buffer;
+  }
+
+  const char* c_str() const { return text.c_str(); }
+  unsigned int length() const { return text.size(); }
+  bool isEmpty() const { return text.empty(); }
+  void reserve(unsigned int size) { text.reserve(size); }
+
+  String& operator+=(const String& other) { text += other.text; return *this; }
+  String& operator+=(const char* other) { text += other; return *this; }
+  String& operator+=(char c) { text += c; return *this; }
+  bool concat(const String& other) { text += other.text; return true; }
+  friend String operator+(const String& a, const String& b) { return String(a.text + b.text); }
+  friend String operator+(const String& a, const char* b) { return String(a.text + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.text); }
+
+  bool operator==(const String& other) const { return text == other.text; }
+  bool operator==(const char* other) const { return text == other; }
+  bool operator!=(const String& other) const { return text != other.text; }
+  bool equals(const String& other) const { return text == other.text; }
+  bool equalsIgnoreCase(const String& other) const {
+    return strcasecmp(text.c_str(), other.text.c_str()) == 0;
+  }
+  bool startsWith(const String& prefix) const { return text.compare(0, prefix.text.size(), prefix.text) == 0; }
+  bool endsWith(const String& suffix) const {
+    return text.size() >= suffix.text.size() &&
+           text.compare(text.size() - suffix.text.size(), suffix.text.size(), suffix.text) == 0;
+  }
+
+  char charAt(unsigned int index) const { return index < text.size() ? text[index] : 0; }
+  char operator[](unsigned int index) const { return charAt(index); }
+  int indexOf(char c, unsigned int from = 0) const { return find(text.find(c, from)); }
+  int indexOf(const String& s, unsigned int from = 0) const { return find(text.find(s.text, from)); }
+  int lastIndexOf(char c) const { return find(text.rfind(c)); }
+  String substring(unsigned int from) const { return from < text.size() ? String(text.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    return from < to && from < text.size() ? String(text.substr(from, to - from)) : String();
+  }
+
+  void trim() {
+    size_t start = text.find_first_not_of(" \t\r\n");
+    size_t end = text.find_last_not_of(" \t\r\n");
+    text = start == std::string::npos ? std::string() : text.substr(start, end - start + 1);
+  }
+  void toLowerCase() { for (char& c : text) c = tolower((unsigned char)c); }
+  void toUpperCase() { for (char& c : text) c = toupper((unsigned char)c); }
+  long toInt() const { return atol(text.c_str()); }
+  float toFloat() const { return atof(text.c_str()); }
+
+private:
+  static int find(size_t position) { return position == std::string::npos ? -1 : (int)position; }
+};
+
+// ==================== Print / Stream ====================
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* text) { return text ? write((const uint8_t*)text, strlen(text)) : 0; }
+
+  size_t print(const String& value) { return write(value.c_str()); }
+  size_t print(const char* value) { return write(value); }
+  size_t print(char value) { return write((uint8_t)value); }
+  size_t print(int value) { return print(String(value)); }
+  size_t print(unsigned int value) { return print(String(value)); }
+  size_t print(long value) { return print(String(value)); }
+  size_t print(unsigned long value) { return print(String(value)); }
+  size_t print(double value, int decimals = 2) { return print(String(value, decimals)); }
+
+  size_t println() { return write("\r\n"); }
+  template <class T>
+  size_t println(const T& value) { size_t n = print(value); return n + println(); }
+  size_t println(double value, int decimals) { size_t n = print(value, decimals); return n + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual void flush() {}
+  size_t readBytes(uint8_t* buffer, size_t length);
+};
+
+// 串口输出写入仿真日志 (默认stdout)，输入来自场景脚本的serial命令
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  void end() {}
+  operator bool() const { return true; }
+  void setTxBufferSize(size_t size) { (void)size; }
+  int availableForWrite();
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  void flush() override;
+};
+
+extern HardwareSerial Serial;
+
+// ==================== ESP ====================
+class EspClass {
+public:
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getHeapSize();
+  uint32_t getMaxAllocHeap();
+  uint32_t getPsramSize() { return 0; }
+  const char* getChipModel() { return "ESP32-C3 (sim)"; }
+  uint8_t getChipRevision() { return 4; }
+  uint8_t getChipCores() { return 1; }
+  uint32_t getCpuFreqMHz() { return getCpuFrequencyMhz(); }
+  uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+  uint32_t getFlashChipSpeed() { return 80000000; }
+  uint32_t getCycleCount();
+  [[noreturn]] void restart();
+};
+
+extern EspClass ESP;
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,35 @@
+#ifndef SIM_EEPROM_H
+#define SIM_EEPROM_H
+
+// EEPROM镜像保存在内存中；指定 --eeprom <文件> 时启动加载、每次提交写回，可跨多次运行保留数据
+
+#include <Arduino.h>
+#include <vector>
+
+class EEPROMClass {
+private:
+  std::vector<uint8_t> data;
+
+public:
+  bool begin(size_t size);
+  uint8_t read(int address) const;
+  void write(int address, uint8_t value);
+  bool commit();
+  uint8_t* getDataPtr() { return data.data(); }
+  size_t length() const { return data.size(); }
+
+  template <class T>
+  T& get(int address, T& value) {
+    if (address >= 0 && address + sizeof(T) <= data.size()) memcpy(&value, &data[address], sizeof(T));
+    return value;
+  }
+  template <class T>
+  const T& put(int address, const T& value) {
+    if (address >= 0 && address + sizeof(T) <= data.size()) memcpy(&data[address], &value, sizeof(T));
+    return value;
+  }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // SIM_EEPROM_H
@@ -0,0 +1,78 @@
+#ifndef SIM_FS_H
+#define SIM_FS_H
+
+// 内存中的文件系统 (LittleFS的主机实现)，支持目录遍历、追加写入和随机读取。
+// 写入按Flash页编程计入虚拟时间 (SIM_COST_FILE)
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct FileImpl;
+
+class File : public Stream {
+private:
+  std::shared_ptr<FileImpl> impl;
+
+public:
+  File() {}
+  explicit File(std::shared_ptr<FileImpl> handle) : impl(handle) {}
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  void flush() override {}
+  size_t read(uint8_t* buffer, size_t size);
+
+  bool seek(uint32_t position, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  void close();
+  operator bool() const;
+  const char* path() const;
+  const char* name() const;
+  bool isDirectory() const;
+  File openNextFile(const char* mode = FILE_READ);
+  void rewindDirectory();
+};
+
+class FS {
+public:
+  File open(const char* path, const char* mode = FILE_READ, bool create = false);
+  File open(const String& path, const char* mode = FILE_READ, bool create = false) {
+    return open(path.c_str(), mode, create);
+  }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* from, const char* to);
+  bool rename(const String& from, const String& to) { return rename(from.c_str(), to.c_str()); }
+  bool mkdir(const char* path);
+  bool mkdir(const String& path) { return mkdir(path.c_str()); }
+  bool rmdir(const char* path);
+  bool rmdir(const String& path) { return rmdir(path.c_str()); }
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif // SIM_FS_H
@@ -0,0 +1,37 @@
+#ifndef SIM_MPU6050_H
+#define SIM_MPU6050_H
+
+// MPU6050的主机实现：getMotion6()返回IMU模型 (SimImu) 在当前虚拟时刻的采样，
+// 每次读取计入一次I2C传输耗时
+
+#include <stdint.h>
+
+#define MPU6050_ACCEL_FS_2 0x00
+#define MPU6050_GYRO_FS_250 0x00
+#define MPU6050_DLPF_BW_20 0x04
+#define MPU6050_DHPF_5 0x01
+
+class MPU6050 {
+public:
+  void initialize() {}
+  bool testConnection();
+  void setFullScaleAccelRange(uint8_t range) { (void)range; }
+  void setFullScaleGyroRange(uint8_t range) { (void)range; }
+  void setDLPFMode(uint8_t mode) { (void)mode; }
+  void setDHPFMode(uint8_t mode) { (void)mode; }
+  void setRate(uint8_t rate) { (void)rate; }
+  void setIntDataReadyEnabled(bool enabled) { (void)enabled; }
+  void setMotionDetectionThreshold(uint8_t threshold) { motionThreshold = threshold; }
+  void setMotionDetectionDuration(uint8_t duration) { (void)duration; }
+  void setIntMotionEnabled(bool enabled) { motionEnabled = enabled; }
+  void setSleepEnabled(bool enabled) { (void)enabled; }
+
+  void getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz);
+  bool getIntMotionStatus();
+
+private:
+  uint8_t motionThreshold = 0;       // 2mg/LSB
+  bool motionEnabled = false;
+};
+
+#endif // SIM_MPU6050_H
@@ -0,0 +1,30 @@
+#ifndef SIM_TIMELIB_H
+#define SIM_TIMELIB_H
+
+// Time库的主机实现：系统时间 = 设定值 + 设定后经过的虚拟时间
+
+#include <time.h>
+
+enum timeStatus_t { timeNotSet, timeNeedsSync, timeSet };
+
+timeStatus_t timeStatus();
+void setTime(time_t t);
+void setTime(int hour, int minute, int second, int day, int month, int year);
+time_t now();
+
+int year();
+int year(time_t t);
+int month();
+int month(time_t t);
+int day();
+int day(time_t t);
+int hour();
+int hour(time_t t);
+int minute();
+int minute(time_t t);
+int second();
+int second(time_t t);
+int weekday();                      // 1 = 星期日
+int weekday(time_t t);
+
+#endif // SIM_TIMELIB_H
@@ -0,0 +1,86 @@
+#ifndef SIM_U8G2LIB_H
+#define SIM_U8G2LIB_H
+
+// SSD1306的主机实现：不做光栅化，只记录每帧绘制的文字 (供场景的screen命令输出)，
+// 每次把帧缓冲发送到屏幕时计入一次I2C传输耗时 (SIM_COST_DISPLAY)
+
+#include <Arduino.h>
+#include <vector>
+
+#define U8G2_R0 0
+#define U8X8_PIN_NONE 255
+#define U8G2_DRAW_UPPER_RIGHT 0x01
+#define U8G2_DRAW_UPPER_LEFT 0x02
+#define U8G2_DRAW_LOWER_LEFT 0x04
+#define U8G2_DRAW_LOWER_RIGHT 0x08
+#define U8G2_DRAW_ALL 0x0f
+
+// 字体数据只保存字宽: {ASCII字宽, 非ASCII (中文) 字宽}，用于估算getStrWidth()
+extern const uint8_t u8g2_font_5x7_tf[];
+extern const uint8_t u8g2_font_6x10_tf[];
+extern const uint8_t u8g2_font_logisoso28_tn[];
+extern const uint8_t u8g2_font_logisoso32_tn[];
+extern const uint8_t u8g2_font_wqy12_t_chinese3[];
+extern const uint8_t u8g2_font_wqy12_t_gb2312[];
+
+struct SimTextItem {
+  int x, y;
+  std::string text;
+};
+
+class U8G2 : public Print {
+private:
+  const uint8_t* font = u8g2_font_6x10_tf;
+  int cursorX = 0;
+  int cursorY = 0;
+  bool cursorItem = false;           // print()是否接在上一次print()的文字后面
+  std::vector<SimTextItem> frame;
+
+  void addText(int x, int y, const char* text);
+  void transfer();
+
+public:
+  bool begin();
+  void initDisplay() {}
+  void clearDisplay();
+  void clearBuffer();
+  void sendBuffer();
+  void firstPage();
+  uint8_t nextPage();
+  void display() {}
+  void setPowerSave(uint8_t enabled);
+  void setContrast(uint8_t value);
+  int getDisplayWidth() const { return 128; }
+  int getDisplayHeight() const { return 64; }
+
+  void setFont(const uint8_t* newFont) { font = newFont; }
+  void setFontDirection(uint8_t direction) { (void)direction; }
+  void enableUTF8Print() {}
+  int getStrWidth(const char* text) const;
+  int getUTF8Width(const char* text) const { return getStrWidth(text); }
+  void setCursor(int x, int y);
+  void drawStr(int x, int y, const char* text) { addText(x, y, text); }
+  void drawUTF8(int x, int y, const char* text) { addText(x, y, text); }
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  void setDrawColor(uint8_t color) { (void)color; }
+  void drawPixel(int x, int y) { (void)x; (void)y; }
+  void drawHLine(int x, int y, int w) { (void)x; (void)y; (void)w; }
+  void drawVLine(int x, int y, int h) { (void)x; (void)y; (void)h; }
+  void drawLine(int x0, int y0, int x1, int y1) { (void)x0; (void)y0; (void)x1; (void)y1; }
+  void drawBox(int x, int y, int w, int h) { (void)x; (void)y; (void)w; (void)h; }
+  void drawFrame(int x, int y, int w, int h) { (void)x; (void)y; (void)w; (void)h; }
+  void drawDisc(int x, int y, int r, uint8_t option = U8G2_DRAW_ALL) { (void)x; (void)y; (void)r; (void)option; }
+  void drawCircle(int x, int y, int r, uint8_t option = U8G2_DRAW_ALL) { (void)x; (void)y; (void)r; (void)option; }
+};
+
+class U8G2_SSD1306_128X64_NONAME_F_HW_I2C : public U8G2 {
+public:
+  explicit U8G2_SSD1306_128X64_NONAME_F_HW_I2C(int rotation, int reset = U8X8_PIN_NONE,
+                                               int clock = U8X8_PIN_NONE, int data = U8X8_PIN_NONE) {
+    (void)rotation; (void)reset; (void)clock; (void)data;
+  }
+};
+
+#endif // SIM_U8G2LIB_H
@@ -0,0 +1,29 @@
+#ifndef SIM_WIRE_H
+#define SIM_WIRE_H
+
+// I2C总线：MPU6050 (0x68) 和 SSD1306 (0x3C) 总是应答，其它地址无应答。
+// 实际传输耗时在对应外设的模型中计入 (sim_devices.cpp)
+
+#include <Arduino.h>
+
+class TwoWire {
+private:
+  uint32_t clock = 100000;
+  uint8_t address = 0;
+
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+  void end() {}
+  void setClock(uint32_t frequency) { clock = frequency; }
+  uint32_t getClock() const { return clock; }
+  void beginTransmission(uint8_t target) { address = target; }
+  size_t write(uint8_t value) { (void)value; return 1; }
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t target, uint8_t count) { (void)target; return count; }
+  int available() { return 0; }
+  int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif // SIM_WIRE_H
@@ -0,0 +1,24 @@
+#ifndef SIM_DRIVER_GPIO_H
+#define SIM_DRIVER_GPIO_H
+
+#include "esp_err.h"
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_2 2
+#define GPIO_NUM_3 3
+#define GPIO_NUM_4 4
+
+typedef enum {
+  GPIO_INTR_DISABLE,
+  GPIO_INTR_POSEDGE,
+  GPIO_INTR_NEGEDGE,
+  GPIO_INTR_ANYEDGE,
+  GPIO_INTR_LOW_LEVEL,
+  GPIO_INTR_HIGH_LEVEL
+} gpio_int_type_t;
+
+esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type);
+int gpio_get_level(gpio_num_t pin);
+
+#endif // SIM_DRIVER_GPIO_H
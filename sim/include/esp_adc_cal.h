@@ -0,0 +1,21 @@
+#ifndef SIM_ESP_ADC_CAL_H
+#define SIM_ESP_ADC_CAL_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum { ADC_UNIT_1, ADC_UNIT_2 } adc_unit_t;
+typedef enum { ADC_ATTEN_DB_0, ADC_ATTEN_DB_2_5, ADC_ATTEN_DB_6, ADC_ATTEN_DB_11, ADC_ATTEN_DB_12 = ADC_ATTEN_DB_11 } adc_atten_t;
+typedef enum { ADC_WIDTH_BIT_12 = 3 } adc_bits_width_t;
+typedef enum { ESP_ADC_CAL_VAL_EFUSE_VREF, ESP_ADC_CAL_VAL_EFUSE_TP, ESP_ADC_CAL_VAL_DEFAULT_VREF } esp_adc_cal_value_t;
+
+typedef struct {
+  adc_atten_t atten;
+  uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width,
+                                             uint32_t defaultVref, esp_adc_cal_characteristics_t* chars);
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t* chars);
+
+#endif // SIM_ESP_ADC_CAL_H
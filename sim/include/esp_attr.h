@@ -0,0 +1,10 @@
+#ifndef SIM_ESP_ATTR_H
+#define SIM_ESP_ATTR_H
+
+// 主机上没有IRAM/RTC内存段，属性为空
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+
+#endif // SIM_ESP_ATTR_H
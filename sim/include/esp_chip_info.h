@@ -0,0 +1,17 @@
+#ifndef SIM_ESP_CHIP_INFO_H
+#define SIM_ESP_CHIP_INFO_H
+
+#include <stdint.h>
+
+typedef enum { CHIP_ESP32 = 1, CHIP_ESP32C3 = 5 } esp_chip_model_t;
+
+typedef struct {
+  esp_chip_model_t model;
+  uint32_t features;
+  uint16_t revision;
+  uint8_t cores;
+} esp_chip_info_t;
+
+void esp_chip_info(esp_chip_info_t* info);
+
+#endif // SIM_ESP_CHIP_INFO_H
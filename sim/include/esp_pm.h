@@ -0,0 +1,21 @@
+#ifndef SIM_ESP_PM_H
+#define SIM_ESP_PM_H
+
+// 仿真默认不支持esp_pm (与未启用CONFIG_PM_ENABLE的固件相同)，固件退化为setCpuFrequencyMhz；
+// --pm 启用后记录工作点，允许自动轻度睡眠时主循环等待计为自动轻度睡眠
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef struct {
+  int max_freq_mhz;
+  int min_freq_mhz;
+  bool light_sleep_enable;
+} esp_pm_config_t;
+
+typedef esp_pm_config_t esp_pm_config_esp32_t;
+typedef esp_pm_config_t esp_pm_config_esp32c3_t;
+
+esp_err_t esp_pm_configure(const void* config);
+
+#endif // SIM_ESP_PM_H
@@ -0,0 +1,27 @@
+#ifndef SIM_ESP_SLEEP_H
+#define SIM_ESP_SLEEP_H
+
+// 轻度休眠在虚拟时钟上前进到按钮按下或定时唤醒；深度休眠结束仿真运行
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum {
+  ESP_SLEEP_WAKEUP_UNDEFINED,
+  ESP_SLEEP_WAKEUP_ALL,
+  ESP_SLEEP_WAKEUP_EXT0,
+  ESP_SLEEP_WAKEUP_EXT1,
+  ESP_SLEEP_WAKEUP_TIMER,
+  ESP_SLEEP_WAKEUP_TOUCHPAD,
+  ESP_SLEEP_WAKEUP_ULP,
+  ESP_SLEEP_WAKEUP_GPIO,
+  ESP_SLEEP_WAKEUP_UART
+} esp_sleep_wakeup_cause_t;
+
+esp_err_t esp_sleep_enable_gpio_wakeup();
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs);
+esp_err_t esp_light_sleep_start();
+[[noreturn]] void esp_deep_sleep_start();
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
+
+#endif // SIM_ESP_SLEEP_H
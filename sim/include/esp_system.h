@@ -0,0 +1,10 @@
+#ifndef SIM_ESP_SYSTEM_H
+#define SIM_ESP_SYSTEM_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+uint32_t esp_get_free_heap_size(void);
+uint32_t esp_get_minimum_free_heap_size(void);
+
+#endif // SIM_ESP_SYSTEM_H
@@ -0,0 +1,42 @@
+#ifndef SIM_FREERTOS_H
+#define SIM_FREERTOS_H
+
+// 主机仿真中只有一个任务 (主循环)：xTaskCreate总是失败，固件走同步退化路径，
+// 执行顺序因此完全确定。互斥量和临界区为空操作，节拍为1ms并读取虚拟时钟。
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct SimTask* TaskHandle_t;
+typedef struct SimSemaphore* SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void* parameter);
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskNO_AFFINITY 0x7fffffff
+
+typedef enum { eNoAction, eSetBits, eIncrement, eSetValueWithOverwrite, eSetValueWithoutOverwrite } eNotifyAction;
+
+typedef struct {
+  int owner;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux) ((void)(mux))
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux))
+#define portEXIT_CRITICAL_ISR(mux) ((void)(mux))
+#define portENTER_CRITICAL_SAFE(mux) ((void)(mux))
+#define portEXIT_CRITICAL_SAFE(mux) ((void)(mux))
+#define portYIELD_FROM_ISR(woken) ((void)(woken))
+
+#endif // SIM_FREERTOS_H
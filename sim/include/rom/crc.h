@@ -0,0 +1,9 @@
+#ifndef SIM_ROM_CRC_H
+#define SIM_ROM_CRC_H
+
+#include <stdint.h>
+
+// 与ROM中的crc32_le相同 (多项式0xEDB88320，输入输出取反)
+uint32_t crc32_le(uint32_t crc, const uint8_t* buffer, uint32_t length);
+
+#endif // SIM_ROM_CRC_H
@@ -0,0 +1,88 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <stdint.h>
+#include <functional>
+#include <vector>
+
+// ==================== 虚拟时钟 ====================
+// 主机仿真中所有时间 (millis/micros/esp_timer_get_time/xTaskGetTickCount) 都读取这个时钟。
+// 时钟只在以下情况前进，与主机实际运行速度无关，同一场景每次运行的结果完全相同：
+//   - 固件等待: delay()、vTaskDelay()、主循环等待任务通知、轻度休眠
+//   - 硬件操作耗时: I2C传输、Flash写入等按模型计入 (charge)，固件自身的计算不计时
+// 定时器到期、按钮边沿和场景动作都是带时刻的事件，时钟前进时按时刻顺序执行。
+
+// 计入虚拟时间的硬件操作
+enum SimCost {
+  SIM_COST_IMU = 0,                // MPU6050读取 (I2C)
+  SIM_COST_DISPLAY,                // OLED帧缓冲传输 (I2C)
+  SIM_COST_EEPROM,                 // EEPROM镜像提交 (Flash擦写)
+  SIM_COST_FILE,                   // LittleFS文件写入
+  SIM_COST_ADC,                    // 电池电压采样
+  SIM_COST_DELAY,                  // 固件中delay()/vTaskDelay()阻塞主循环的时间
+  SIM_COST_COUNT
+};
+
+typedef std::function<void()> SimAction;
+
+class SimClock {
+private:
+  struct Event {
+    uint64_t timeUs;
+    uint32_t id;                     // 递增，同一时刻按加入顺序执行
+    SimAction action;
+  };
+
+  static uint64_t nowUs;
+  static uint32_t nextId;
+  static std::vector<Event> events;            // 按 (timeUs, id) 的最小堆
+  static uint64_t costUs[SIM_COST_COUNT];
+  static uint32_t costCount[SIM_COST_COUNT];
+  static uint32_t notifyBits;
+  static bool stopping;
+  static uint32_t randomState;
+
+  static bool later(const Event& a, const Event& b);
+
+public:
+  static uint64_t now();                       // us
+
+  // 在指定时刻执行动作 (时刻相同时按加入顺序)，返回可用于取消的编号
+  static uint32_t schedule(uint64_t atUs, SimAction action);
+  static void cancel(uint32_t id);
+
+  // 前进到指定时刻，依次执行期间到期的事件
+  static void advanceTo(uint64_t targetUs);
+  static void advance(uint64_t us);
+
+  // 前进到下一个事件或limitUs (取较早者)，执行了事件时返回true
+  static bool runNext(uint64_t limitUs);
+  static bool hasEvents();
+
+  // 硬件操作耗时：记入CPU剖析并前进时钟 (期间的中断和定时器照常触发)
+  static void charge(SimCost cost, uint32_t us);
+  static uint64_t getCost(SimCost cost);
+  static uint32_t getCostCount(SimCost cost);
+  static const char* getCostName(SimCost cost);
+
+  // 主循环任务的通知位 (xTaskNotify / xTaskNotifyWait)
+  static void notify(uint32_t bits);
+  static uint32_t takeNotification();
+  static bool hasNotification();
+
+  // 场景结束：等待中的固件调用立即返回，主程序在本轮loop()后停止
+  static void requestStop();
+  static bool stopRequested();
+
+  // 确定性伪随机数 (xorshift)，random()和IMU噪声共用一个序列，种子由 --seed 指定
+  static void seed(uint32_t value);
+  static uint32_t nextRandom();
+  static float nextGaussian();                 // 标准正态分布
+};
+
+// 深度休眠、重启等在设备上不会返回的调用抛出此异常，由仿真主程序结束运行
+struct SimHalt {
+  const char* reason;
+};
+
+#endif // SIM_CLOCK_H
@@ -0,0 +1,184 @@
+#ifndef SIM_DEVICES_H
+#define SIM_DEVICES_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "sim_clock.h"
+
+// ==================== GPIO ====================
+// 引脚电平由场景脚本设置，电平变化时按attachInterrupt()的触发方式立即调用中断处理函数
+class SimGpio {
+private:
+  static const uint8_t PIN_COUNT = 32;
+  static uint8_t levels[PIN_COUNT];
+  static void (*handlers[PIN_COUNT])();
+  static int modes[PIN_COUNT];
+
+public:
+  static void setLevel(uint8_t pin, uint8_t level);
+  static uint8_t getLevel(uint8_t pin);
+  static void attach(uint8_t pin, void (*handler)(), int mode);
+  static void detach(uint8_t pin);
+
+  // 按钮 (BUTTON_PIN，按下电平为BUTTON_PRESSED_STATE)
+  static void setButton(bool pressed);
+  static bool isButtonPressed();
+};
+
+// ==================== IMU模型 ====================
+enum SimImuMode {
+  SIM_IMU_STILL = 0,                 // 静止，只有传感器噪声
+  SIM_IMU_SWAY,                      // 前后摆动 (俯仰角按正弦变化)
+  SIM_IMU_SHAKE,                     // 随机晃动
+  SIM_IMU_TRACE                      // 回放 zen_telemetry.py 采集的CSV
+};
+
+class SimImu {
+private:
+  struct TraceSample {
+    uint32_t timeMs;
+    int16_t raw[6];
+  };
+
+  static SimImuMode mode;
+  static float rollDeg, pitchDeg;    // 静态姿态: roll为左右倾斜 (改变X轴加速度)，pitch为前后倾斜
+  static float accelNoiseG, gyroNoiseDps;
+  static float swayAmplitudeDeg, swayPeriodS;
+  static float shakeG;
+  static float pendingTapG;          // 下一次读取叠加的冲击
+  static uint64_t modeStartUs;
+  static std::vector<TraceSample> trace;
+  static size_t traceIndex;
+  static uint32_t readCount;
+  static int16_t lastRaw[6];
+
+  static void generate(int16_t raw[6]);
+
+public:
+  static void setStill();
+  static void setNoise(float accelG, float gyroDps);
+  static void setTilt(float rollDegrees, float pitchDegrees);
+  static void setSway(float amplitudeDeg, float periodS);
+  static void setShake(float amplitudeG);
+  static void tap(float shockG);
+  static bool loadTrace(const char* path);
+
+  // 当前虚拟时刻的原始计数 (±2g: 16384/g，±250°/s: 131/(°/s))
+  static void sample(int16_t raw[6]);
+  static const int16_t* getLastSample();   // 最近一次sample()的结果
+  static uint32_t getReadCount();
+  static const char* getModeName();
+};
+
+// ==================== 显示 ====================
+struct SimTextItem;
+
+class SimDisplay {
+private:
+  static uint32_t frameCount;
+  static bool powerSave;
+  static std::vector<SimTextItem> lastFrame;
+
+public:
+  static void recordFrame(const std::vector<SimTextItem>& frame);
+  static void setPowerSave(bool enabled);
+  static bool isPowerSave();
+  static uint32_t getFrameCount();
+  static void printFrame(FILE* out);   // 按行输出最近一帧的文字
+};
+
+// ==================== 串口 ====================
+class SimSerial {
+private:
+  static std::string input;
+  static size_t inputPos;
+  static FILE* output;               // nullptr表示丢弃固件输出 (--quiet)
+  static uint64_t bytesWritten;
+
+public:
+  static void setOutput(FILE* out);
+  static void feed(const std::string& line);   // 加入输入缓冲 (自动补换行)
+  static int available();
+  static int read();
+  static int peek();
+  static size_t write(const uint8_t* buffer, size_t size);
+  static void flush();
+  static uint64_t getBytesWritten();
+};
+
+// ==================== 遥测校验 ====================
+// 从串口输出中按0x00切分帧，能通过COBS解码和CRC校验的是遥测包 (与scripts/zen_telemetry.py相同)。
+// SAMPLE包中的原始计数与IMU模型在同一次读取给出的计数比较，不一致说明遥测没有携带实际读数。
+class SimTelemetry {
+private:
+  static std::vector<uint8_t> frame;
+  static bool frameOverflow;         // 当前段超过最大帧长 (文本日志)，到下一个0x00为止丢弃
+  static uint32_t helloCount;
+  static uint32_t sampleCount;
+  static uint32_t rawMismatchCount;
+  static float accelScale, gyroScale; // HELLO包中的换算系数
+  static float maxScaledError;       // 按换算系数还原的物理量与IMU模型的最大偏差 (g或°/s)
+
+  static void handlePacket(const uint8_t* packet, size_t length);
+
+public:
+  static void receive(const uint8_t* buffer, size_t size);
+  static uint32_t getSampleCount();
+  static uint32_t getMismatchCount();
+  static void printReport(FILE* out);
+};
+
+// ==================== 存储与其它外设 ====================
+class SimStorage {
+private:
+  static std::string eepromPath;
+
+public:
+  static void setEepromPath(const char* path);
+  static const char* getEepromPath();  // 未指定时为nullptr
+};
+
+class SimBuzzer {
+private:
+  static uint32_t toneCount;
+  static bool active;
+
+public:
+  static void start(unsigned int frequency);
+  static void stop();
+  static uint32_t getToneCount();
+};
+
+// 主循环空闲 (等待任务通知) 和轻度休眠的累计时间，用于运行结束时的剖析汇总。
+// 启用esp_pm (--pm) 且固件允许自动轻度睡眠时，主循环等待计为自动轻度睡眠
+class SimRuntime {
+private:
+  static uint64_t idleUs;
+  static uint64_t sleepUs;
+  static uint64_t autoSleepUs;
+  static bool pmSupported;
+  static bool autoLightSleep;
+
+public:
+  static void addIdle(uint64_t us) { (autoLightSleep ? autoSleepUs : idleUs) += us; }
+  static void addSleep(uint64_t us) { sleepUs += us; }
+  static uint64_t getIdle() { return idleUs; }
+  static uint64_t getSleep() { return sleepUs; }
+  static uint64_t getAutoSleep() { return autoSleepUs; }
+
+  static void setPmSupported(bool supported) { pmSupported = supported; }
+  static bool isPmSupported() { return pmSupported; }
+  static void setAutoLightSleep(bool enabled) { autoLightSleep = enabled; }
+};
+
+// 各硬件操作在虚拟时钟上计入的耗时 (us)，按实际总线速率估算
+#define SIM_IMU_READ_US 330          // 400kHz I2C读取14字节寄存器
+#define SIM_IMU_STATUS_US 100        // 400kHz I2C读取1字节中断状态寄存器
+#define SIM_DISPLAY_FRAME_US 23500   // 400kHz I2C发送1KB帧缓冲 (SSD1306 128x64)
+#define SIM_EEPROM_COMMIT_US 12000   // 擦除并写入一个4KB扇区
+#define SIM_FILE_PAGE_US 600         // LittleFS写入一页 (256字节)
+#define SIM_ADC_SAMPLE_US 40         // 单次ADC转换
+
+#endif // SIM_DEVICES_H
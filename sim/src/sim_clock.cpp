@@ -0,0 +1,137 @@
+#include "sim_clock.h"
+#include <algorithm>
+#include <math.h>
+
+uint64_t SimClock::nowUs = 0;
+uint32_t SimClock::nextId = 1;
+std::vector<SimClock::Event> SimClock::events;
+uint64_t SimClock::costUs[SIM_COST_COUNT];
+uint32_t SimClock::costCount[SIM_COST_COUNT];
+uint32_t SimClock::notifyBits = 0;
+bool SimClock::stopping = false;
+uint32_t SimClock::randomState = 1;
+
+static const char* const costNames[SIM_COST_COUNT] = {
+  "IMU读取 (I2C)", "显示传输 (I2C)", "EEPROM提交", "文件写入", "ADC采样", "delay阻塞"
+};
+
+bool SimClock::later(const Event& a, const Event& b) {
+  return a.timeUs != b.timeUs ? a.timeUs > b.timeUs : a.id > b.id;
+}
+
+// ==================== 时间与事件 ====================
+uint64_t SimClock::now() {
+  return nowUs;
+}
+
+uint32_t SimClock::schedule(uint64_t atUs, SimAction action) {
+  Event event;
+  event.timeUs = std::max(atUs, nowUs);
+  event.id = nextId++;
+  event.action = action;
+  events.push_back(event);
+  std::push_heap(events.begin(), events.end(), later);
+  return event.id;
+}
+
+void SimClock::cancel(uint32_t id) {
+  // 只清空动作，到期时作为空事件弹出
+  for (Event& event : events) {
+    if (event.id == id) {
+      event.action = nullptr;
+      return;
+    }
+  }
+}
+
+bool SimClock::runNext(uint64_t limitUs) {
+  if (events.empty() || events.front().timeUs > limitUs) {
+    nowUs = std::max(nowUs, limitUs);
+    return false;
+  }
+
+  std::pop_heap(events.begin(), events.end(), later);
+  Event event = events.back();
+  events.pop_back();
+  nowUs = std::max(nowUs, event.timeUs);
+  if (event.action) {
+    event.action();
+  }
+  return true;
+}
+
+bool SimClock::hasEvents() {
+  return !events.empty();
+}
+
+void SimClock::advanceTo(uint64_t targetUs) {
+  while (runNext(targetUs)) {
+  }
+}
+
+void SimClock::advance(uint64_t us) {
+  advanceTo(nowUs + us);
+}
+
+// ==================== CPU剖析 ====================
+void SimClock::charge(SimCost cost, uint32_t us) {
+  costUs[cost] += us;
+  costCount[cost]++;
+  advance(us);
+}
+
+uint64_t SimClock::getCost(SimCost cost) {
+  return costUs[cost];
+}
+
+uint32_t SimClock::getCostCount(SimCost cost) {
+  return costCount[cost];
+}
+
+const char* SimClock::getCostName(SimCost cost) {
+  return costNames[cost];
+}
+
+// ==================== 任务通知 ====================
+void SimClock::notify(uint32_t bits) {
+  notifyBits |= bits;
+}
+
+uint32_t SimClock::takeNotification() {
+  uint32_t bits = notifyBits;
+  notifyBits = 0;
+  return bits;
+}
+
+bool SimClock::hasNotification() {
+  return notifyBits != 0;
+}
+
+void SimClock::requestStop() {
+  stopping = true;
+}
+
+bool SimClock::stopRequested() {
+  return stopping;
+}
+
+// ==================== 伪随机数 ====================
+void SimClock::seed(uint32_t value) {
+  randomState = value != 0 ? value : 1;
+}
+
+uint32_t SimClock::nextRandom() {
+  uint32_t x = randomState;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  randomState = x;
+  return x;
+}
+
+float SimClock::nextGaussian() {
+  // Box-Muller，只用其中一个输出
+  float u1 = (nextRandom() + 1.0f) / 4294967297.0f;
+  float u2 = nextRandom() / 4294967296.0f;
+  return sqrtf(-2.0f * logf(u1)) * cosf(2.0f * (float)M_PI * u2);
+}
@@ -0,0 +1,611 @@
+// 外设模型：按钮/GPIO、MPU6050、SSD1306、串口、EEPROM和蜂鸣器
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <MPU6050.h>
+#include <U8g2lib.h>
+#include <EEPROM.h>
+#include <fstream>
+#include <sstream>
+#include "config.h"
+#include "byte_codec.h"
+#include "data_exporter.h"
+#include "telemetry.h"
+#include "sim_devices.h"
+
+// ==================== GPIO ====================
+uint8_t SimGpio::levels[SimGpio::PIN_COUNT];
+void (*SimGpio::handlers[SimGpio::PIN_COUNT])();
+int SimGpio::modes[SimGpio::PIN_COUNT];
+
+static struct GpioInit {
+  GpioInit() { SimGpio::setLevel(BUTTON_PIN, BUTTON_RELEASED_STATE); }
+} gpioInit;
+
+void SimGpio::setLevel(uint8_t pin, uint8_t level) {
+  if (pin >= PIN_COUNT) {
+    return;
+  }
+  uint8_t old = levels[pin];
+  levels[pin] = level ? HIGH : LOW;
+  if (handlers[pin] == nullptr || old == levels[pin]) {
+    return;
+  }
+  if (modes[pin] == CHANGE || (modes[pin] == RISING && level) || (modes[pin] == FALLING && !level)) {
+    handlers[pin]();
+  }
+}
+
+uint8_t SimGpio::getLevel(uint8_t pin) {
+  return pin < PIN_COUNT ? levels[pin] : LOW;
+}
+
+void SimGpio::attach(uint8_t pin, void (*handler)(), int mode) {
+  if (pin < PIN_COUNT) {
+    handlers[pin] = handler;
+    modes[pin] = mode;
+  }
+}
+
+void SimGpio::detach(uint8_t pin) {
+  if (pin < PIN_COUNT) {
+    handlers[pin] = nullptr;
+  }
+}
+
+void SimGpio::setButton(bool pressed) {
+  setLevel(BUTTON_PIN, pressed ? BUTTON_PRESSED_STATE : BUTTON_RELEASED_STATE);
+}
+
+bool SimGpio::isButtonPressed() {
+  return getLevel(BUTTON_PIN) == BUTTON_PRESSED_STATE;
+}
+
+// ==================== IMU模型 ====================
+SimImuMode SimImu::mode = SIM_IMU_STILL;
+float SimImu::rollDeg = 0;
+float SimImu::pitchDeg = 0;
+float SimImu::accelNoiseG = 0.003f;
+float SimImu::gyroNoiseDps = 0.05f;
+float SimImu::swayAmplitudeDeg = 0;
+float SimImu::swayPeriodS = 1;
+float SimImu::shakeG = 0;
+float SimImu::pendingTapG = 0;
+uint64_t SimImu::modeStartUs = 0;
+std::vector<SimImu::TraceSample> SimImu::trace;
+size_t SimImu::traceIndex = 0;
+uint32_t SimImu::readCount = 0;
+int16_t SimImu::lastRaw[6];
+static bool motionLatched = false;
+
+static const char* const imuModeNames[] = {"静止", "摆动", "晃动", "回放"};
+
+void SimImu::setStill() {
+  mode = SIM_IMU_STILL;
+  modeStartUs = SimClock::now();
+}
+
+void SimImu::setNoise(float accelG, float gyroDps) {
+  accelNoiseG = accelG;
+  gyroNoiseDps = gyroDps;
+}
+
+void SimImu::setTilt(float rollDegrees, float pitchDegrees) {
+  rollDeg = rollDegrees;
+  pitchDeg = pitchDegrees;
+}
+
+void SimImu::setSway(float amplitudeDeg, float periodS) {
+  mode = SIM_IMU_SWAY;
+  swayAmplitudeDeg = amplitudeDeg;
+  swayPeriodS = periodS > 0 ? periodS : 1;
+  modeStartUs = SimClock::now();
+}
+
+void SimImu::setShake(float amplitudeG) {
+  mode = SIM_IMU_SHAKE;
+  shakeG = amplitudeG;
+  modeStartUs = SimClock::now();
+}
+
+void SimImu::tap(float shockG) {
+  pendingTapG = shockG;
+}
+
+bool SimImu::loadTrace(const char* path) {
+  std::ifstream in(path);
+  std::string line;
+  if (!in || !std::getline(in, line)) {
+    return false;
+  }
+
+  // 按表头定位列，兼容zen_telemetry.py以后增加的列
+  static const char* const columns[7] = {"time_ms", "ax_raw", "ay_raw", "az_raw", "gx_raw", "gy_raw", "gz_raw"};
+  int index[7];
+  std::vector<std::string> header;
+  std::stringstream headerStream(line);
+  for (std::string cell; std::getline(headerStream, cell, ',');) {
+    header.push_back(cell);
+  }
+  for (int i = 0; i < 7; i++) {
+    auto found = std::find(header.begin(), header.end(), columns[i]);
+    if (found == header.end()) {
+      return false;
+    }
+    index[i] = found - header.begin();
+  }
+
+  std::vector<TraceSample> samples;
+  while (std::getline(in, line)) {
+    std::vector<std::string> cells;
+    std::stringstream lineStream(line);
+    for (std::string cell; std::getline(lineStream, cell, ',');) {
+      cells.push_back(cell);
+    }
+    if (cells.size() < header.size()) {
+      continue;
+    }
+    TraceSample sample;
+    sample.timeMs = strtoul(cells[index[0]].c_str(), nullptr, 10);
+    for (int i = 0; i < 6; i++) {
+      sample.raw[i] = (int16_t)atoi(cells[index[i + 1]].c_str());
+    }
+    samples.push_back(sample);
+  }
+  if (samples.empty()) {
+    return false;
+  }
+
+  trace.swap(samples);
+  traceIndex = 0;
+  mode = SIM_IMU_TRACE;
+  modeStartUs = SimClock::now();
+  return true;
+}
+
+static int16_t toRaw(float value, float scale) {
+  float raw = roundf(value * scale);
+  return (int16_t)constrain(raw, -32768.0f, 32767.0f);
+}
+
+void SimImu::generate(int16_t raw[6]) {
+  float accel[3];
+  float gyro[3] = {0, 0, 0};
+
+  if (mode == SIM_IMU_TRACE) {
+    // 采样保持：使用时间戳不晚于当前回放时刻的最后一个样本，回放结束后恢复静止
+    uint32_t elapsedMs = (uint32_t)((SimClock::now() - modeStartUs) / 1000) + trace[0].timeMs;
+    while (traceIndex + 1 < trace.size() && trace[traceIndex + 1].timeMs <= elapsedMs) {
+      traceIndex++;
+    }
+    if (traceIndex + 1 < trace.size() || elapsedMs <= trace[traceIndex].timeMs + SENSOR_READ_INTERVAL) {
+      memcpy(raw, trace[traceIndex].raw, sizeof(trace[traceIndex].raw));
+      if (pendingTapG != 0) {
+        raw[2] = toRaw(raw[2] / ACCEL_SCALE_FACTOR + pendingTapG, ACCEL_SCALE_FACTOR);
+        pendingTapG = 0;
+      }
+      return;
+    }
+    setStill();
+  }
+
+  float roll = rollDeg * DEG_TO_RAD;
+  float pitch = pitchDeg * DEG_TO_RAD;
+  if (mode == SIM_IMU_SWAY) {
+    float t = (SimClock::now() - modeStartUs) / 1000000.0f;
+    float omega = 2 * PI / swayPeriodS;
+    pitch += swayAmplitudeDeg * DEG_TO_RAD * sinf(omega * t);
+    gyro[0] = swayAmplitudeDeg * omega * cosf(omega * t);
+  }
+
+  accel[0] = sinf(roll) * cosf(pitch);
+  accel[1] = sinf(pitch);
+  accel[2] = cosf(roll) * cosf(pitch);
+
+  float accelSigma = accelNoiseG;
+  float gyroSigma = gyroNoiseDps;
+  if (mode == SIM_IMU_SHAKE) {
+    accelSigma += shakeG;
+    gyroSigma += shakeG * 200;
+  }
+  for (int i = 0; i < 3; i++) {
+    accel[i] += SimClock::nextGaussian() * accelSigma;
+    gyro[i] += SimClock::nextGaussian() * gyroSigma;
+  }
+  accel[2] += pendingTapG;
+  pendingTapG = 0;
+
+  // 运动检测中断：偏离1g超过阈值时锁存，读取中断状态时清除
+  float magnitude = sqrtf(accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2]);
+  if (fabsf(magnitude - 1.0f) > MOTION_HW_THRESHOLD * 0.002f) {
+    motionLatched = true;
+  }
+
+  for (int i = 0; i < 3; i++) {
+    raw[i] = toRaw(accel[i], ACCEL_SCALE_FACTOR);
+    raw[i + 3] = toRaw(gyro[i], GYRO_SCALE_FACTOR);
+  }
+}
+
+void SimImu::sample(int16_t raw[6]) {
+  readCount++;
+  generate(raw);
+  memcpy(lastRaw, raw, sizeof(lastRaw));
+}
+
+const int16_t* SimImu::getLastSample() {
+  return lastRaw;
+}
+
+uint32_t SimImu::getReadCount() {
+  return readCount;
+}
+
+const char* SimImu::getModeName() {
+  return imuModeNames[mode];
+}
+
+bool MPU6050::testConnection() {
+  return true;
+}
+
+void MPU6050::getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz) {
+  SimClock::charge(SIM_COST_IMU, SIM_IMU_READ_US);
+  int16_t raw[6];
+  SimImu::sample(raw);
+  *ax = raw[0];
+  *ay = raw[1];
+  *az = raw[2];
+  *gx = raw[3];
+  *gy = raw[4];
+  *gz = raw[5];
+}
+
+bool MPU6050::getIntMotionStatus() {
+  SimClock::charge(SIM_COST_IMU, SIM_IMU_STATUS_US);
+  bool status = motionEnabled && motionLatched;
+  motionLatched = false;
+  return status;
+}
+
+// ==================== I2C ====================
+TwoWire Wire;
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+  (void)sda;
+  (void)scl;
+  if (frequency > 0) {
+    clock = frequency;
+  }
+  return true;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  return address == MPU6050_ADDRESS || address == OLED_ADDRESS ? 0 : 2;  // 2: 地址无应答
+}
+
+// ==================== 显示 ====================
+const uint8_t u8g2_font_5x7_tf[] = {5, 5};
+const uint8_t u8g2_font_6x10_tf[] = {6, 6};
+const uint8_t u8g2_font_logisoso28_tn[] = {16, 16};
+const uint8_t u8g2_font_logisoso32_tn[] = {18, 18};
+const uint8_t u8g2_font_wqy12_t_chinese3[] = {6, 12};
+const uint8_t u8g2_font_wqy12_t_gb2312[] = {6, 12};
+
+uint32_t SimDisplay::frameCount = 0;
+bool SimDisplay::powerSave = false;
+std::vector<SimTextItem> SimDisplay::lastFrame;
+
+void SimDisplay::recordFrame(const std::vector<SimTextItem>& frame) {
+  frameCount++;
+  lastFrame = frame;
+}
+
+void SimDisplay::setPowerSave(bool enabled) {
+  powerSave = enabled;
+}
+
+bool SimDisplay::isPowerSave() {
+  return powerSave;
+}
+
+uint32_t SimDisplay::getFrameCount() {
+  return frameCount;
+}
+
+void SimDisplay::printFrame(FILE* out) {
+  std::vector<SimTextItem> items = lastFrame;
+  std::stable_sort(items.begin(), items.end(), [](const SimTextItem& a, const SimTextItem& b) {
+    return a.y != b.y ? a.y < b.y : a.x < b.x;
+  });
+
+  fprintf(out, "  +-- 第%lu帧%s\n", (unsigned long)frameCount, powerSave ? " (屏幕已关闭)" : "");
+  for (size_t i = 0; i < items.size();) {
+    std::string line;
+    int y = items[i].y;
+    for (; i < items.size() && items[i].y == y; i++) {
+      if (!line.empty()) {
+        line += "  ";
+      }
+      line += items[i].text;
+    }
+    fprintf(out, "  | %s\n", line.c_str());
+  }
+}
+
+void U8G2::addText(int x, int y, const char* text) {
+  frame.push_back({x, y, text ? text : ""});
+  cursorItem = false;
+}
+
+void U8G2::transfer() {
+  SimClock::charge(SIM_COST_DISPLAY, SIM_DISPLAY_FRAME_US);
+  SimDisplay::recordFrame(frame);
+}
+
+bool U8G2::begin() {
+  clearBuffer();
+  return true;
+}
+
+void U8G2::clearDisplay() {
+  clearBuffer();
+  transfer();
+}
+
+void U8G2::clearBuffer() {
+  frame.clear();
+  cursorItem = false;
+}
+
+void U8G2::sendBuffer() {
+  transfer();
+}
+
+void U8G2::firstPage() {
+  clearBuffer();
+}
+
+uint8_t U8G2::nextPage() {
+  // 全缓冲模式只有一页
+  transfer();
+  return 0;
+}
+
+void U8G2::setPowerSave(uint8_t enabled) {
+  SimDisplay::setPowerSave(enabled != 0);
+}
+
+void U8G2::setContrast(uint8_t value) {
+  (void)value;
+}
+
+int U8G2::getStrWidth(const char* text) const {
+  int width = 0;
+  for (const unsigned char* p = (const unsigned char*)text; p && *p; p++) {
+    if (*p < 0x80) {
+      width += font[0];
+    } else if ((*p & 0xC0) == 0xC0) {
+      width += font[1];  // UTF-8首字节，后续字节不计宽
+    }
+  }
+  return width;
+}
+
+void U8G2::setCursor(int x, int y) {
+  cursorX = x;
+  cursorY = y;
+  cursorItem = false;
+}
+
+size_t U8G2::write(uint8_t c) {
+  if (!cursorItem) {
+    frame.push_back({cursorX, cursorY, ""});
+    cursorItem = true;
+  }
+  frame.back().text += (char)c;
+  return 1;
+}
+
+// ==================== 串口 ====================
+std::string SimSerial::input;
+size_t SimSerial::inputPos = 0;
+FILE* SimSerial::output = stdout;
+uint64_t SimSerial::bytesWritten = 0;
+
+void SimSerial::setOutput(FILE* out) {
+  output = out;
+}
+
+void SimSerial::feed(const std::string& line) {
+  input.erase(0, inputPos);
+  inputPos = 0;
+  input += line;
+  input += '\n';
+}
+
+int SimSerial::available() {
+  return (int)(input.size() - inputPos);
+}
+
+int SimSerial::read() {
+  return inputPos < input.size() ? (uint8_t)input[inputPos++] : -1;
+}
+
+int SimSerial::peek() {
+  return inputPos < input.size() ? (uint8_t)input[inputPos] : -1;
+}
+
+size_t SimSerial::write(const uint8_t* buffer, size_t size) {
+  SimTelemetry::receive(buffer, size);
+  if (output) {
+    fwrite(buffer, 1, size, output);
+  }
+  bytesWritten += size;
+  return size;
+}
+
+void SimSerial::flush() {
+  if (output) {
+    fflush(output);
+  }
+}
+
+uint64_t SimSerial::getBytesWritten() {
+  return bytesWritten;
+}
+
+// ==================== 遥测校验 ====================
+std::vector<uint8_t> SimTelemetry::frame;
+bool SimTelemetry::frameOverflow = false;
+uint32_t SimTelemetry::helloCount = 0;
+uint32_t SimTelemetry::sampleCount = 0;
+uint32_t SimTelemetry::rawMismatchCount = 0;
+float SimTelemetry::accelScale = 0;
+float SimTelemetry::gyroScale = 0;
+float SimTelemetry::maxScaledError = 0;
+
+void SimTelemetry::receive(const uint8_t* buffer, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    if (buffer[i] != 0) {
+      if (frame.size() < TELEMETRY_FRAME_MAX) {
+        frame.push_back(buffer[i]);
+      } else {
+        frameOverflow = true;
+      }
+      continue;
+    }
+    if (!frame.empty() && !frameOverflow) {
+      uint8_t packet[TELEMETRY_FRAME_MAX];
+      size_t length = Telemetry::cobsDecode(frame.data(), frame.size(), packet);
+      // 不能通过CRC校验的是两帧之间的文本
+      if (length > 4 && DataExporter::crc32Update(0, packet, length - 4) == getU32(packet + length - 4)) {
+        handlePacket(packet, length - 4);
+      }
+    }
+    frame.clear();
+    frameOverflow = false;
+  }
+}
+
+void SimTelemetry::handlePacket(const uint8_t* packet, size_t length) {
+  const uint8_t* payload = packet + 7;           // 类型 + 序号 + 时间戳
+  if (packet[0] == TELEMETRY_PKT_HELLO && length >= 7 + 11) {
+    helloCount++;
+    accelScale = getF32(payload + 3);
+    gyroScale = getF32(payload + 7);
+    return;
+  }
+  if (packet[0] != TELEMETRY_PKT_SAMPLE || length < 7 + 12) {
+    return;
+  }
+
+  sampleCount++;
+  const int16_t* expected = SimImu::getLastSample();
+  bool mismatch = false;
+  for (int i = 0; i < 6; i++) {
+    int16_t raw = (int16_t)getU16(payload + 2 * i);
+    mismatch |= raw != expected[i];
+    if (accelScale > 0 && gyroScale > 0) {
+      float scale = i < 3 ? accelScale : gyroScale;
+      float modelScale = i < 3 ? ACCEL_SCALE_FACTOR : GYRO_SCALE_FACTOR;
+      maxScaledError = fmaxf(maxScaledError, fabsf(raw / scale - expected[i] / modelScale));
+    }
+  }
+  if (mismatch) {
+    rawMismatchCount++;
+  }
+}
+
+uint32_t SimTelemetry::getSampleCount() {
+  return sampleCount;
+}
+
+uint32_t SimTelemetry::getMismatchCount() {
+  return rawMismatchCount;
+}
+
+void SimTelemetry::printReport(FILE* out) {
+  if (helloCount == 0 && sampleCount == 0) {
+    return;
+  }
+  fprintf(out, "[SIM] 遥测: HELLO %lu 包, SAMPLE %lu 包, 原始计数与IMU读数不一致 %lu 包, 换算后最大偏差 %.4f\n",
+          (unsigned long)helloCount, (unsigned long)sampleCount, (unsigned long)rawMismatchCount,
+          maxScaledError);
+}
+
+// ==================== EEPROM ====================
+EEPROMClass EEPROM;
+std::string SimStorage::eepromPath;
+
+void SimStorage::setEepromPath(const char* path) {
+  eepromPath = path ? path : "";
+}
+
+const char* SimStorage::getEepromPath() {
+  return eepromPath.empty() ? nullptr : eepromPath.c_str();
+}
+
+bool EEPROMClass::begin(size_t size) {
+  // 擦除后的Flash为0xFF
+  data.assign(size, 0xFF);
+  const char* path = SimStorage::getEepromPath();
+  if (path) {
+    FILE* file = fopen(path, "rb");
+    if (file) {
+      size_t n = fread(data.data(), 1, size, file);
+      (void)n;
+      fclose(file);
+    }
+  }
+  return true;
+}
+
+uint8_t EEPROMClass::read(int address) const {
+  return address >= 0 && (size_t)address < data.size() ? data[address] : 0;
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  if (address >= 0 && (size_t)address < data.size()) {
+    data[address] = value;
+  }
+}
+
+bool EEPROMClass::commit() {
+  SimClock::charge(SIM_COST_EEPROM, SIM_EEPROM_COMMIT_US);
+  const char* path = SimStorage::getEepromPath();
+  if (path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+      return false;
+    }
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+  }
+  return true;
+}
+
+// ==================== 蜂鸣器 / 运行统计 ====================
+uint32_t SimBuzzer::toneCount = 0;
+bool SimBuzzer::active = false;
+
+void SimBuzzer::start(unsigned int frequency) {
+  (void)frequency;
+  toneCount++;
+  active = true;
+}
+
+void SimBuzzer::stop() {
+  active = false;
+}
+
+uint32_t SimBuzzer::getToneCount() {
+  return toneCount;
+}
+
+uint64_t SimRuntime::idleUs = 0;
+uint64_t SimRuntime::sleepUs = 0;
+uint64_t SimRuntime::autoSleepUs = 0;
+bool SimRuntime::pmSupported = false;
+bool SimRuntime::autoLightSleep = false;
@@ -0,0 +1,280 @@
+// 内存文件系统 (LittleFS)
+
+#include <FS.h>
+#include <LittleFS.h>
+#include <map>
+#include <set>
+#include "sim_devices.h"
+
+fs::LittleFSFS LittleFS;
+
+static const size_t FS_TOTAL_BYTES = 1408 * 1024;   // 与默认分区表中的文件系统分区相同
+static const size_t FS_PAGE_BYTES = 256;
+
+typedef std::shared_ptr<std::vector<uint8_t>> FileData;
+static std::map<std::string, FileData> files;
+static std::set<std::string> directories = {"/"};
+
+namespace fs {
+
+struct FileImpl {
+  std::string path;
+  FileData data;                     // 目录为nullptr
+  size_t position = 0;
+  bool writable = false;
+  bool open = true;
+  std::vector<std::string> entries;  // 目录的子项 (打开时的快照)
+  size_t nextEntry = 0;
+};
+
+} // namespace fs
+
+static std::string normalize(const char* path) {
+  std::string result = path && path[0] == '/' ? path : std::string("/") + (path ? path : "");
+  while (result.size() > 1 && result.back() == '/') {
+    result.pop_back();
+  }
+  return result;
+}
+
+static std::string parentOf(const std::string& path) {
+  size_t slash = path.rfind('/');
+  return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+static std::vector<std::string> childrenOf(const std::string& dir) {
+  std::string prefix = dir == "/" ? "/" : dir + "/";
+  std::vector<std::string> children;
+  for (const auto& entry : files) {
+    if (entry.first.compare(0, prefix.size(), prefix) == 0 && entry.first.find('/', prefix.size()) == std::string::npos) {
+      children.push_back(entry.first);
+    }
+  }
+  for (const auto& entry : directories) {
+    if (entry != dir && entry.compare(0, prefix.size(), prefix) == 0 &&
+        entry.find('/', prefix.size()) == std::string::npos) {
+      children.push_back(entry);
+    }
+  }
+  return children;
+}
+
+// ==================== File ====================
+namespace fs {
+
+size_t File::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+  if (!impl || !impl->open || !impl->writable || !impl->data) {
+    return 0;
+  }
+  std::vector<uint8_t>& data = *impl->data;
+  if (impl->position + size > data.size()) {
+    data.resize(impl->position + size);
+  }
+  memcpy(data.data() + impl->position, buffer, size);
+  impl->position += size;
+
+  // 按涉及的Flash页数计入写入耗时
+  uint32_t pages = (uint32_t)((size + FS_PAGE_BYTES - 1) / FS_PAGE_BYTES);
+  SimClock::charge(SIM_COST_FILE, pages * SIM_FILE_PAGE_US);
+  return size;
+}
+
+int File::available() {
+  if (!impl || !impl->open || !impl->data) {
+    return 0;
+  }
+  return (int)(impl->data->size() - std::min(impl->position, impl->data->size()));
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+  return available() > 0 ? (*impl->data)[impl->position] : -1;
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+  size_t n = std::min(size, (size_t)available());
+  if (n > 0) {
+    memcpy(buffer, impl->data->data() + impl->position, n);
+    impl->position += n;
+  }
+  return n;
+}
+
+bool File::seek(uint32_t position, SeekMode mode) {
+  if (!impl || !impl->data) {
+    return false;
+  }
+  size_t base = mode == SeekSet ? 0 : (mode == SeekCur ? impl->position : impl->data->size());
+  if (base + position > impl->data->size()) {
+    return false;
+  }
+  impl->position = base + position;
+  return true;
+}
+
+size_t File::position() const {
+  return impl ? impl->position : 0;
+}
+
+size_t File::size() const {
+  return impl && impl->data ? impl->data->size() : 0;
+}
+
+void File::close() {
+  if (impl) {
+    impl->open = false;
+  }
+}
+
+File::operator bool() const {
+  return impl && impl->open;
+}
+
+const char* File::path() const {
+  return impl ? impl->path.c_str() : "";
+}
+
+const char* File::name() const {
+  if (!impl) {
+    return "";
+  }
+  size_t slash = impl->path.rfind('/');
+  return impl->path.c_str() + slash + 1;
+}
+
+bool File::isDirectory() const {
+  return impl && impl->open && !impl->data;
+}
+
+File File::openNextFile(const char* mode) {
+  if (!isDirectory()) {
+    return File();
+  }
+  while (impl->nextEntry < impl->entries.size()) {
+    File entry = LittleFS.open(impl->entries[impl->nextEntry++].c_str(), mode);
+    if (entry) {
+      return entry;
+    }
+  }
+  return File();
+}
+
+void File::rewindDirectory() {
+  if (isDirectory()) {
+    impl->nextEntry = 0;
+  }
+}
+
+// ==================== FS ====================
+File FS::open(const char* path, const char* mode, bool create) {
+  std::string key = normalize(path);
+  auto impl = std::make_shared<FileImpl>();
+  impl->path = key;
+
+  if (directories.count(key)) {
+    impl->entries = childrenOf(key);
+    return File(impl);
+  }
+
+  bool reading = strcmp(mode, FILE_READ) == 0;
+  auto found = files.find(key);
+  if (reading) {
+    if (found == files.end()) {
+      return File();
+    }
+    impl->data = found->second;
+    return File(impl);
+  }
+
+  if (!directories.count(parentOf(key))) {
+    if (!create) {
+      return File();
+    }
+    mkdir(parentOf(key).c_str());
+  }
+  if (found == files.end() || strcmp(mode, FILE_WRITE) == 0) {
+    files[key] = std::make_shared<std::vector<uint8_t>>();
+  }
+  impl->data = files[key];
+  impl->writable = true;
+  impl->position = strcmp(mode, FILE_APPEND) == 0 ? impl->data->size() : 0;
+  return File(impl);
+}
+
+bool FS::exists(const char* path) {
+  std::string key = normalize(path);
+  return files.count(key) > 0 || directories.count(key) > 0;
+}
+
+bool FS::remove(const char* path) {
+  return files.erase(normalize(path)) > 0;
+}
+
+bool FS::rename(const char* from, const char* to) {
+  auto found = files.find(normalize(from));
+  if (found == files.end()) {
+    return false;
+  }
+  FileData data = found->second;
+  files.erase(found);
+  files[normalize(to)] = data;
+  return true;
+}
+
+bool FS::mkdir(const char* path) {
+  std::string key = normalize(path);
+  if (files.count(key)) {
+    return false;
+  }
+  if (key != "/" && !directories.count(parentOf(key))) {
+    mkdir(parentOf(key).c_str());
+  }
+  directories.insert(key);
+  return true;
+}
+
+bool FS::rmdir(const char* path) {
+  std::string key = normalize(path);
+  if (key == "/" || !childrenOf(key).empty()) {
+    return false;
+  }
+  return directories.erase(key) > 0;
+}
+
+// ==================== LittleFS ====================
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+  (void)formatOnFail;
+  (void)basePath;
+  (void)maxOpenFiles;
+  (void)partitionLabel;
+  return true;
+}
+
+bool LittleFSFS::format() {
+  files.clear();
+  directories = {"/"};
+  return true;
+}
+
+size_t LittleFSFS::totalBytes() {
+  return FS_TOTAL_BYTES;
+}
+
+size_t LittleFSFS::usedBytes() {
+  // LittleFS按4KB块分配
+  size_t used = 2 * 4096;
+  for (const auto& entry : files) {
+    used += (entry.second->size() + 4095) / 4096 * 4096;
+  }
+  return used;
+}
+
+} // namespace fs
@@ -0,0 +1,426 @@
+// 主机仿真入口：加载场景脚本，在虚拟时钟上运行固件的setup()/loop()，结束时输出时间剖析
+//
+// 用法: zen_sim <场景文件> [--seed N] [--until 时间] [--quiet] [--log 文件] [--eeprom 文件] [--pm]
+//
+// 场景脚本每行一条命令: <时间> <命令> [参数...]，#之后为注释
+//   时间: 90s / 1500ms / 2m10s / 1h30m / 01:30:00 / 1:30.5，前缀+表示相对上一条命令
+//   click                    单击 (按下80ms)
+//   clicks <n>               n连击
+//   press <时长>             按住指定时长，如 press 1.5s
+//   down / up                按下 / 松开按钮
+//   imu still                静止 (只有噪声)
+//   imu noise <g> <°/s>      传感器噪声标准差
+//   imu tilt <roll°> [pitch°] 静态姿态 (roll为左右倾斜)
+//   imu sway <幅度°> <周期s>  前后摆动
+//   imu shake <g>            随机晃动
+//   imu tap [g]              下一次读取叠加一次冲击 (默认1.0g)
+//   imu trace <csv>          回放 scripts/zen_telemetry.py 采集的CSV
+//   serial <文本>            向串口控制台输入一行
+//   screen                   输出当前屏幕上的文字
+//   log <文本>               在输出中加入标记
+//   end                      结束仿真 (没有end时在最后一条命令处结束)
+
+#include <Arduino.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include "sim_clock.h"
+#include "sim_devices.h"
+
+void setup();
+void loop();
+
+// loop()没有让时钟前进时 (等待超时为0且没有硬件操作)，按空转处理前进的时间，避免死循环
+#define SIM_SPIN_STEP_US 50
+#define SIM_CLICK_MS 80
+#define SIM_CLICK_GAP_MS 120
+
+struct SimOptions {
+  const char* scenario = nullptr;
+  uint32_t seed = 1;
+  bool hasUntil = false;
+  uint64_t untilUs = 0;
+  bool quiet = false;
+  const char* logPath = nullptr;
+  const char* eepromPath = nullptr;
+  bool pm = false;
+};
+
+static uint32_t loopCount = 0;
+static uint32_t spinCount = 0;
+
+// ==================== 输出 ====================
+static std::string formatTime(uint64_t us) {
+  char buffer[32];
+  uint64_t ms = us / 1000;
+  snprintf(buffer, sizeof(buffer), "%02lu:%02lu:%02lu.%03lu", (unsigned long)(ms / 3600000),
+           (unsigned long)(ms / 60000 % 60), (unsigned long)(ms / 1000 % 60), (unsigned long)(ms % 1000));
+  return buffer;
+}
+
+static void simLog(const char* format, ...) __attribute__((format(printf, 1, 2)));
+
+static void simLog(const char* format, ...) {
+  printf("[SIM %s] ", formatTime(SimClock::now()).c_str());
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+  printf("\n");
+}
+
+// ==================== 场景解析 ====================
+// 时长: 数字 + 单位 (ms/s/m/h，省略为秒，可组合)，或 [hh:]mm:ss[.fff]
+static bool parseDuration(const std::string& text, uint64_t& us) {
+  if (text.empty()) {
+    return false;
+  }
+  if (text.find(':') != std::string::npos) {
+    double total = 0;
+    std::stringstream parts(text);
+    for (std::string part; std::getline(parts, part, ':');) {
+      char* end = nullptr;
+      double value = strtod(part.c_str(), &end);
+      if (part.empty() || *end != '\0' || value < 0) {
+        return false;
+      }
+      total = total * 60 + value;
+    }
+    us = (uint64_t)llround(total * 1e6);
+    return true;
+  }
+
+  // 可以组合多个单位，如 1h30m、2m10s
+  double total = 0;
+  const char* p = text.c_str();
+  while (*p) {
+    char* end = nullptr;
+    double value = strtod(p, &end);
+    if (end == p || value < 0) {
+      return false;
+    }
+    const char* unitEnd = end;
+    while (isalpha((unsigned char)*unitEnd)) {
+      unitEnd++;
+    }
+    std::string unit((const char*)end, unitEnd);
+    double scale;
+    if (unit.empty() || unit == "s") {
+      scale = 1e6;
+    } else if (unit == "ms") {
+      scale = 1e3;
+    } else if (unit == "m" || unit == "min") {
+      scale = 60e6;
+    } else if (unit == "h") {
+      scale = 3600e6;
+    } else {
+      return false;
+    }
+    total += value * scale;
+    p = unitEnd;
+  }
+  us = (uint64_t)llround(total);
+  return true;
+}
+
+static void scheduleButton(uint64_t atUs, uint64_t holdUs) {
+  SimClock::schedule(atUs, []() { SimGpio::setButton(true); });
+  SimClock::schedule(atUs + holdUs, []() { SimGpio::setButton(false); });
+}
+
+static bool parseFloat(std::istringstream& in, float& value) {
+  return (bool)(in >> value);
+}
+
+// 解析一条命令并加入事件队列，出错时返回错误说明
+static const char* scheduleCommand(uint64_t atUs, const std::string& command, std::istringstream& args,
+                                   bool& isEnd) {
+  isEnd = false;
+  if (command == "click") {
+    scheduleButton(atUs, SIM_CLICK_MS * 1000ULL);
+  } else if (command == "clicks") {
+    int count = 0;
+    if (!(args >> count) || count < 1) {
+      return "clicks需要次数";
+    }
+    for (int i = 0; i < count; i++) {
+      scheduleButton(atUs + i * (SIM_CLICK_MS + SIM_CLICK_GAP_MS) * 1000ULL, SIM_CLICK_MS * 1000ULL);
+    }
+  } else if (command == "press") {
+    std::string text;
+    uint64_t holdUs;
+    if (!(args >> text) || !parseDuration(text, holdUs)) {
+      return "press需要时长";
+    }
+    scheduleButton(atUs, holdUs);
+  } else if (command == "down" || command == "up") {
+    bool pressed = command == "down";
+    SimClock::schedule(atUs, [pressed]() { SimGpio::setButton(pressed); });
+  } else if (command == "imu") {
+    std::string mode;
+    args >> mode;
+    float a = 0, b = 0;
+    if (mode == "still") {
+      SimClock::schedule(atUs, []() { SimImu::setStill(); });
+    } else if (mode == "noise") {
+      if (!parseFloat(args, a) || !parseFloat(args, b)) {
+        return "imu noise需要加速度(g)和角速度(°/s)噪声";
+      }
+      SimClock::schedule(atUs, [a, b]() { SimImu::setNoise(a, b); });
+    } else if (mode == "tilt") {
+      if (!parseFloat(args, a)) {
+        return "imu tilt需要角度";
+      }
+      parseFloat(args, b);
+      SimClock::schedule(atUs, [a, b]() { SimImu::setTilt(a, b); });
+    } else if (mode == "sway") {
+      if (!parseFloat(args, a) || !parseFloat(args, b)) {
+        return "imu sway需要幅度(°)和周期(s)";
+      }
+      SimClock::schedule(atUs, [a, b]() { SimImu::setSway(a, b); });
+    } else if (mode == "shake") {
+      if (!parseFloat(args, a)) {
+        return "imu shake需要幅度(g)";
+      }
+      SimClock::schedule(atUs, [a]() { SimImu::setShake(a); });
+    } else if (mode == "tap") {
+      a = 1.0f;
+      parseFloat(args, a);
+      SimClock::schedule(atUs, [a]() { SimImu::tap(a); });
+    } else if (mode == "trace") {
+      std::string path;
+      if (!(args >> path)) {
+        return "imu trace需要CSV文件";
+      }
+      SimClock::schedule(atUs, [path]() {
+        if (SimImu::loadTrace(path.c_str())) {
+          simLog("开始回放 %s", path.c_str());
+        } else {
+          simLog("无法读取IMU记录 %s，保持原模式", path.c_str());
+        }
+      });
+    } else {
+      return "未知的imu模式";
+    }
+  } else if (command == "serial") {
+    std::string line;
+    std::getline(args >> std::ws, line);
+    SimClock::schedule(atUs, [line]() {
+      simLog("串口输入: %s", line.c_str());
+      SimSerial::feed(line);
+    });
+  } else if (command == "screen") {
+    SimClock::schedule(atUs, []() {
+      simLog("屏幕内容:");
+      SimDisplay::printFrame(stdout);
+    });
+  } else if (command == "log") {
+    std::string text;
+    std::getline(args >> std::ws, text);
+    SimClock::schedule(atUs, [text]() { simLog("%s", text.c_str()); });
+  } else if (command == "end") {
+    isEnd = true;
+  } else {
+    return "未知命令";
+  }
+  return nullptr;
+}
+
+static bool loadScenario(const SimOptions& options) {
+  std::ifstream in(options.scenario);
+  if (!in) {
+    fprintf(stderr, "无法打开场景文件 %s\n", options.scenario);
+    return false;
+  }
+
+  uint64_t lastUs = 0;
+  uint64_t endUs = 0;
+  bool hasEnd = false;
+  int lineNumber = 0;
+  for (std::string line; std::getline(in, line);) {
+    lineNumber++;
+    size_t comment = line.find('#');
+    if (comment != std::string::npos) {
+      line.erase(comment);
+    }
+    std::istringstream fields(line);
+    std::string timeText, command;
+    if (!(fields >> timeText)) {
+      continue;
+    }
+
+    bool relative = timeText[0] == '+';
+    uint64_t us;
+    if (!parseDuration(relative ? timeText.substr(1) : timeText, us) || !(fields >> command)) {
+      fprintf(stderr, "%s:%d: 无法解析 \"%s\"\n", options.scenario, lineNumber, line.c_str());
+      return false;
+    }
+    uint64_t atUs = relative ? lastUs + us : us;
+
+    bool isEnd;
+    const char* error = scheduleCommand(atUs, command, fields, isEnd);
+    if (error) {
+      fprintf(stderr, "%s:%d: %s: %s\n", options.scenario, lineNumber, error, line.c_str());
+      return false;
+    }
+    if (isEnd) {
+      endUs = atUs;
+      hasEnd = true;
+    }
+    lastUs = atUs;
+  }
+
+  if (options.hasUntil) {
+    endUs = options.untilUs;
+  } else if (!hasEnd) {
+    endUs = lastUs;
+  }
+  SimClock::schedule(endUs, []() { SimClock::requestStop(); });
+  return true;
+}
+
+// ==================== 命令行 ====================
+static void usage(const char* program) {
+  fprintf(stderr,
+          "用法: %s <场景文件> [选项]\n"
+          "  --seed N         随机数种子 (默认1)，影响IMU噪声和模拟电压\n"
+          "  --until 时间     在指定虚拟时刻结束，覆盖场景中的end\n"
+          "  --quiet          不输出固件串口日志\n"
+          "  --log 文件       固件串口输出写入文件\n"
+          "  --eeprom 文件    EEPROM内容从文件加载并在提交时写回\n"
+          "  --pm             支持esp_pm (动态调频和自动轻度睡眠)\n",
+          program);
+}
+
+static bool parseOptions(int argc, char** argv, SimOptions& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--seed" && hasValue) {
+      options.seed = strtoul(argv[++i], nullptr, 0);
+    } else if (arg == "--until" && hasValue) {
+      options.hasUntil = parseDuration(argv[++i], options.untilUs);
+      if (!options.hasUntil) {
+        return false;
+      }
+    } else if (arg == "--quiet") {
+      options.quiet = true;
+    } else if (arg == "--log" && hasValue) {
+      options.logPath = argv[++i];
+    } else if (arg == "--eeprom" && hasValue) {
+      options.eepromPath = argv[++i];
+    } else if (arg == "--pm") {
+      options.pm = true;
+    } else if (arg[0] != '-' && options.scenario == nullptr) {
+      options.scenario = argv[i];
+    } else {
+      return false;
+    }
+  }
+  return options.scenario != nullptr;
+}
+
+// ==================== 剖析汇总 ====================
+// 终端显示宽度：ASCII占1列，中文 (UTF-8多字节) 占2列
+static int displayWidth(const char* text) {
+  int width = 0;
+  for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+    if (*p < 0x80) {
+      width++;
+    } else if ((*p & 0xC0) != 0x80) {
+      width += 2;
+    }
+  }
+  return width;
+}
+
+static void printRow(const char* name, uint32_t count, uint64_t us, uint64_t totalUs) {
+  char countText[16] = "";
+  if (count > 0) {
+    snprintf(countText, sizeof(countText), "%lu", (unsigned long)count);
+  }
+  int padding = 18 - displayWidth(name);
+  printf("[SIM]   %s%*s %10s %12.3f s %7.2f%%\n", name, padding > 0 ? padding : 0, "", countText, us / 1e6,
+         totalUs > 0 ? us * 100.0 / totalUs : 0.0);
+}
+
+static void printSummary(const char* reason) {
+  uint64_t totalUs = SimClock::now();
+  printf("[SIM] ==================== 仿真结束: %s ====================\n", reason);
+  printf("[SIM] 虚拟时间 %s, 主循环 %lu 轮 (空转 %lu 轮), IMU读取 %lu 次, 显示 %lu 帧, 提示音 %lu 次, 串口输出 %llu 字节\n",
+         formatTime(totalUs).c_str(), (unsigned long)loopCount, (unsigned long)spinCount,
+         (unsigned long)SimImu::getReadCount(), (unsigned long)SimDisplay::getFrameCount(),
+         (unsigned long)SimBuzzer::getToneCount(), (unsigned long long)SimSerial::getBytesWritten());
+
+  // 虚拟时间的去向：硬件操作 + 主循环等待 + 轻度休眠，余下为空转
+  printf("[SIM] 时间分布:\n");
+  printf("[SIM]   项目                     次数           时间     占比\n");
+  uint64_t accounted = SimRuntime::getIdle() + SimRuntime::getAutoSleep() + SimRuntime::getSleep();
+  for (int i = 0; i < SIM_COST_COUNT; i++) {
+    SimCost cost = (SimCost)i;
+    accounted += SimClock::getCost(cost);
+    printRow(SimClock::getCostName(cost), SimClock::getCostCount(cost), SimClock::getCost(cost), totalUs);
+  }
+  printRow("主循环等待", 0, SimRuntime::getIdle(), totalUs);
+  printRow("自动轻度睡眠", 0, SimRuntime::getAutoSleep(), totalUs);
+  printRow("轻度休眠", 0, SimRuntime::getSleep(), totalUs);
+  printRow("空转", spinCount, totalUs > accounted ? totalUs - accounted : 0, totalUs);
+  fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+  SimOptions options;
+  if (!parseOptions(argc, argv, options)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  SimClock::seed(options.seed);
+  SimStorage::setEepromPath(options.eepromPath);
+  SimRuntime::setPmSupported(options.pm);
+  FILE* logFile = nullptr;
+  if (options.logPath) {
+    logFile = fopen(options.logPath, "w");
+    if (!logFile) {
+      fprintf(stderr, "无法写入 %s\n", options.logPath);
+      return 2;
+    }
+  }
+  SimSerial::setOutput(options.quiet ? nullptr : (logFile ? logFile : stdout));
+
+  if (!loadScenario(options)) {
+    return 2;
+  }
+
+  auto wallStart = std::chrono::steady_clock::now();
+  const char* reason = "场景结束";
+  try {
+    setup();
+    while (!SimClock::stopRequested()) {
+      uint64_t before = SimClock::now();
+      loop();
+      loopCount++;
+      if (SimClock::now() == before) {
+        spinCount++;
+        SimClock::advance(SIM_SPIN_STEP_US);
+      }
+    }
+  } catch (const SimHalt& halt) {
+    reason = halt.reason;
+  }
+  double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+  SimSerial::flush();
+  if (logFile) {
+    fclose(logFile);
+  }
+  printSummary(reason);
+  SimTelemetry::printReport(stdout);
+
+  // 主机耗时每次运行都不同，输出到stderr，stdout对同一场景和种子保持逐字节相同
+  fprintf(stderr, "[SIM] 主机耗时 %.3f s, 虚拟时间/主机时间 = %.0fx\n", wallSeconds,
+          wallSeconds > 0 ? SimClock::now() / 1e6 / wallSeconds : 0.0);
+
+  // 遥测中的原始计数必须是实际读数
+  return SimTelemetry::getMismatchCount() > 0 ? 1 : 0;
+}
@@ -0,0 +1,593 @@
+// Arduino核心、ESP-IDF和FreeRTOS接口的主机实现，全部基于虚拟时钟 (sim_clock.h)
+
+#include <Arduino.h>
+#include <TimeLib.h>
+#include <esp_timer.h>
+#include <esp_sleep.h>
+#include <esp_pm.h>
+#include <esp_adc_cal.h>
+#include <esp_chip_info.h>
+#include <esp_system.h>
+#include <driver/gpio.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <rom/crc.h>
+#include "sim_clock.h"
+#include "sim_devices.h"
+
+static const uint64_t FOREVER = UINT64_MAX;
+
+// 等待到deadline或条件满足 (条件在每个事件执行后检查)，返回条件是否满足。
+// 永远等待且不会再有事件时，固件不可能被唤醒，结束仿真
+template <class Condition>
+static bool waitUntil(uint64_t deadline, Condition done) {
+  while (!done()) {
+    if (SimClock::stopRequested()) {
+      return false;
+    }
+    if (deadline == FOREVER && !SimClock::hasEvents()) {
+      throw SimHalt{"永久等待 (没有可唤醒的事件)"};
+    }
+    if (!SimClock::runNext(deadline)) {
+      return done();
+    }
+  }
+  return true;
+}
+
+static uint64_t deadlineAfter(uint64_t us) {
+  return us == FOREVER ? FOREVER : SimClock::now() + us;
+}
+
+// ==================== 时间 ====================
+unsigned long millis() {
+  return (unsigned long)(uint32_t)(SimClock::now() / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)(uint32_t)SimClock::now();
+}
+
+void delay(unsigned long ms) {
+  if (ms > 0) {
+    SimClock::charge(SIM_COST_DELAY, (uint32_t)ms * 1000);
+  }
+}
+
+void delayMicroseconds(unsigned int us) {
+  SimClock::charge(SIM_COST_DELAY, us);
+}
+
+void yield() {
+}
+
+int64_t esp_timer_get_time() {
+  return (int64_t)SimClock::now();
+}
+
+// ==================== GPIO / ADC / 蜂鸣器 ====================
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+int digitalRead(uint8_t pin) {
+  return SimGpio::getLevel(pin);
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  SimGpio::setLevel(pin, value);
+}
+
+void attachInterrupt(uint8_t interrupt, void (*handler)(void), int mode) {
+  SimGpio::attach(interrupt, handler, mode);
+}
+
+void detachInterrupt(uint8_t interrupt) {
+  SimGpio::detach(interrupt);
+}
+
+int gpio_get_level(gpio_num_t pin) {
+  return SimGpio::getLevel((uint8_t)pin);
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type) {
+  (void)pin;
+  (void)type;
+  return ESP_OK;
+}
+
+int analogRead(uint8_t pin) {
+  (void)pin;
+  SimClock::charge(SIM_COST_ADC, SIM_ADC_SAMPLE_US);
+  // 3.9V电池经1/2分压，11dB衰减下约为满量程的60%
+  return 2450 + (int)(SimClock::nextRandom() % 9) - 4;
+}
+
+void analogReadResolution(int bits) {
+  (void)bits;
+}
+
+void analogSetPinAttenuation(uint8_t pin, adc_attenuation_t attenuation) {
+  (void)pin;
+  (void)attenuation;
+}
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width,
+                                             uint32_t defaultVref, esp_adc_cal_characteristics_t* chars) {
+  (void)unit;
+  (void)width;
+  chars->atten = atten;
+  chars->vref = defaultVref;
+  return ESP_ADC_CAL_VAL_EFUSE_TP;
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t* chars) {
+  (void)chars;
+  return raw * 3100 / 4095;
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  (void)pin;
+  SimBuzzer::start(frequency);
+  if (duration > 0) {
+    SimClock::schedule(SimClock::now() + (uint64_t)duration * 1000, SimBuzzer::stop);
+  }
+}
+
+void noTone(uint8_t pin) {
+  (void)pin;
+  SimBuzzer::stop();
+}
+
+// ==================== 随机数 / CPU频率 ====================
+long random(long high) {
+  return high > 0 ? (long)(SimClock::nextRandom() % (uint32_t)high) : 0;
+}
+
+long random(long low, long high) {
+  return high > low ? low + random(high - low) : low;
+}
+
+void randomSeed(unsigned long seed) {
+  (void)seed;  // 序列只由 --seed 决定
+}
+
+static uint32_t cpuFrequencyMhz = 160;
+
+bool setCpuFrequencyMhz(uint32_t mhz) {
+  cpuFrequencyMhz = mhz;
+  return true;
+}
+
+uint32_t getCpuFrequencyMhz() {
+  return cpuFrequencyMhz;
+}
+
+// ==================== Print / Stream / Serial ====================
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (n < size && write(buffer[n])) {
+    n++;
+  }
+  return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char local[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(local, sizeof(local), format, args);
+  va_end(args);
+  if (length < 0) {
+    return 0;
+  }
+  if ((size_t)length < sizeof(local)) {
+    return write((const uint8_t*)local, length);
+  }
+
+  std::string buffer(length + 1, '\0');
+  va_start(args, format);
+  vsnprintf(&buffer[0], buffer.size(), format, args);
+  va_end(args);
+  return write((const uint8_t*)buffer.data(), length);
+}
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+  size_t n = 0;
+  while (n < length && available() > 0) {
+    buffer[n++] = (uint8_t)read();
+  }
+  return n;
+}
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) {
+  return SimSerial::write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  return SimSerial::write(buffer, size);
+}
+
+int HardwareSerial::availableForWrite() {
+  return 4096;  // 主机输出不会阻塞
+}
+
+int HardwareSerial::available() {
+  return SimSerial::available();
+}
+
+int HardwareSerial::read() {
+  return SimSerial::read();
+}
+
+int HardwareSerial::peek() {
+  return SimSerial::peek();
+}
+
+void HardwareSerial::flush() {
+  SimSerial::flush();
+}
+
+// ==================== ESP / 芯片信息 ====================
+EspClass ESP;
+
+// 堆数值固定为ESP32-C3典型值，保证输出可复现
+uint32_t EspClass::getFreeHeap() { return 245760; }
+uint32_t EspClass::getMinFreeHeap() { return 240128; }
+uint32_t EspClass::getHeapSize() { return 327680; }
+uint32_t EspClass::getMaxAllocHeap() { return 110592; }
+
+uint32_t EspClass::getCycleCount() {
+  return (uint32_t)(SimClock::now() * cpuFrequencyMhz);
+}
+
+void EspClass::restart() {
+  throw SimHalt{"ESP.restart()"};
+}
+
+uint32_t esp_get_free_heap_size(void) {
+  return ESP.getFreeHeap();
+}
+
+uint32_t esp_get_minimum_free_heap_size(void) {
+  return ESP.getMinFreeHeap();
+}
+
+void esp_chip_info(esp_chip_info_t* info) {
+  info->model = CHIP_ESP32C3;
+  info->features = 0;
+  info->revision = 4;
+  info->cores = 1;
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+  switch (code) {
+    case ESP_OK: return "ESP_OK";
+    case ESP_FAIL: return "ESP_FAIL";
+    case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+    default: return "UNKNOWN ERROR";
+  }
+}
+
+uint32_t crc32_le(uint32_t crc, const uint8_t* buffer, uint32_t length) {
+  crc = ~crc;
+  for (uint32_t i = 0; i < length; i++) {
+    crc ^= buffer[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+// ==================== esp_timer ====================
+struct SimTimer {
+  esp_timer_cb_t callback;
+  void* arg;
+  uint64_t periodUs;                 // 0表示单次
+  uint32_t eventId;                  // 0表示未启动
+};
+
+static void fireTimer(SimTimer* timer) {
+  timer->eventId = 0;
+  if (timer->periodUs > 0) {
+    // 下一次按固定周期排定，不累积回调的执行时间
+    uint64_t next = SimClock::now() + timer->periodUs;
+    timer->eventId = SimClock::schedule(next, [timer]() { fireTimer(timer); });
+  }
+  timer->callback(timer->arg);
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+  if (args == nullptr || args->callback == nullptr || handle == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *handle = new SimTimer{args->callback, args->arg, 0, 0};
+  return ESP_OK;
+}
+
+static esp_err_t startTimer(esp_timer_handle_t timer, uint64_t delayUs, uint64_t periodUs) {
+  if (timer == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (timer->eventId != 0) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->periodUs = periodUs;
+  timer->eventId = SimClock::schedule(SimClock::now() + delayUs, [timer]() { fireTimer(timer); });
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+  return startTimer(timer, timeoutUs, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+  return startTimer(timer, periodUs, periodUs);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (timer == nullptr || timer->eventId == 0) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  SimClock::cancel(timer->eventId);
+  timer->eventId = 0;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+  if (timer == nullptr) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (timer->eventId != 0) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  delete timer;
+  return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+  return timer != nullptr && timer->eventId != 0;
+}
+
+// ==================== 休眠 / 电源管理 ====================
+static uint64_t timerWakeupUs = 0;
+static esp_sleep_wakeup_cause_t wakeupCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+esp_err_t esp_sleep_enable_gpio_wakeup() {
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs) {
+  timerWakeupUs = timeUs;
+  return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start() {
+  // 按钮 (高电平唤醒) 或定时唤醒，期间到期的定时器照常执行
+  uint64_t start = SimClock::now();
+  uint64_t deadline = timerWakeupUs > 0 ? deadlineAfter(timerWakeupUs) : FOREVER;
+  if (waitUntil(deadline, []() { return SimGpio::isButtonPressed(); })) {
+    wakeupCause = ESP_SLEEP_WAKEUP_GPIO;
+  } else {
+    wakeupCause = ESP_SLEEP_WAKEUP_TIMER;
+  }
+  SimRuntime::addSleep(SimClock::now() - start);
+  return ESP_OK;
+}
+
+void esp_deep_sleep_start() {
+  throw SimHalt{"esp_deep_sleep_start()"};
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+  return wakeupCause;
+}
+
+esp_err_t esp_pm_configure(const void* config) {
+  if (!SimRuntime::isPmSupported()) {
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+  const esp_pm_config_t* pm = static_cast<const esp_pm_config_t*>(config);
+  cpuFrequencyMhz = pm->max_freq_mhz;
+  SimRuntime::setAutoLightSleep(pm->light_sleep_enable);
+  return ESP_OK;
+}
+
+// ==================== FreeRTOS ====================
+struct SimTask {
+  const char* name;
+};
+
+struct SimSemaphore {
+  bool mutex;
+  uint32_t count;
+};
+
+static SimTask loopTask = {"loopTask"};
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                       void* parameter, UBaseType_t priority, TaskHandle_t* handle) {
+  // 不创建任务：固件在调用者上下文中同步执行，保证仿真确定
+  (void)function;
+  (void)name;
+  (void)stackDepth;
+  (void)parameter;
+  (void)priority;
+  if (handle) {
+    *handle = nullptr;
+  }
+  return pdFAIL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackDepth,
+                                   void* parameter, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core) {
+  (void)core;
+  return xTaskCreate(function, name, stackDepth, parameter, priority, handle);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  (void)task;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  if (ticks > 0) {
+    SimClock::charge(SIM_COST_DELAY, (uint32_t)ticks * 1000);
+  }
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)(SimClock::now() / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return &loopTask;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  (void)task;
+  return 4096;
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+  return task ? task->name : loopTask.name;
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action) {
+  (void)action;
+  if (task == &loopTask) {
+    SimClock::notify(value);
+  }
+  return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action,
+                              BaseType_t* higherPriorityWoken) {
+  if (higherPriorityWoken) {
+    *higherPriorityWoken = pdFALSE;
+  }
+  return xTaskNotify(task, value, action);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t* value,
+                           TickType_t ticksToWait) {
+  (void)clearOnEntry;
+  (void)clearOnExit;
+  uint64_t start = SimClock::now();
+  uint64_t deadline = ticksToWait == portMAX_DELAY ? FOREVER : deadlineAfter((uint64_t)ticksToWait * 1000);
+  bool notified = waitUntil(deadline, []() { return SimClock::hasNotification(); });
+  SimRuntime::addIdle(SimClock::now() - start);
+
+  uint32_t bits = notified ? SimClock::takeNotification() : 0;
+  if (value) {
+    *value = bits;
+  }
+  return notified ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  (void)task;  // 仿真中没有其它任务
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+  (void)clearOnExit;
+  if (ticksToWait == portMAX_DELAY) {
+    throw SimHalt{"ulTaskNotifyTake()永久等待"};
+  }
+  vTaskDelay(ticksToWait);
+  return 0;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return new SimSemaphore{true, 1};
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+  return new SimSemaphore{false, 0};
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticksToWait) {
+  if (semaphore->mutex) {
+    return pdTRUE;
+  }
+  if (semaphore->count > 0) {
+    semaphore->count--;
+    return pdTRUE;
+  }
+  // 只有一个任务，没有人能释放信号量
+  if (ticksToWait == portMAX_DELAY) {
+    throw SimHalt{"xSemaphoreTake()死锁"};
+  }
+  vTaskDelay(ticksToWait);
+  return pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  if (!semaphore->mutex) {
+    semaphore->count = 1;
+  }
+  return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+  delete semaphore;
+}
+
+// ==================== TimeLib ====================
+static bool timeWasSet = false;
+static time_t timeBase = 0;
+static uint64_t timeBaseUs = 0;
+
+timeStatus_t timeStatus() {
+  return timeWasSet ? timeSet : timeNotSet;
+}
+
+void setTime(time_t t) {
+  timeBase = t;
+  timeBaseUs = SimClock::now();
+  timeWasSet = true;
+}
+
+void setTime(int hr, int min, int sec, int dy, int mnth, int yr) {
+  struct tm parts = {};
+  parts.tm_year = (yr >= 1000 ? yr : yr + 2000) - 1900;
+  parts.tm_mon = mnth - 1;
+  parts.tm_mday = dy;
+  parts.tm_hour = hr;
+  parts.tm_min = min;
+  parts.tm_sec = sec;
+  setTime(timegm(&parts));
+}
+
+time_t now() {
+  return timeBase + (time_t)((SimClock::now() - timeBaseUs) / 1000000);
+}
+
+static struct tm breakTime(time_t t) {
+  struct tm parts;
+  gmtime_r(&t, &parts);
+  return parts;
+}
+
+int year(time_t t) { return breakTime(t).tm_year + 1900; }
+int month(time_t t) { return breakTime(t).tm_mon + 1; }
+int day(time_t t) { return breakTime(t).tm_mday; }
+int hour(time_t t) { return breakTime(t).tm_hour; }
+int minute(time_t t) { return breakTime(t).tm_min; }
+int second(time_t t) { return breakTime(t).tm_sec; }
+int weekday(time_t t) { return breakTime(t).tm_wday + 1; }
+int year() { return year(now()); }
+int month() { return month(now()); }
+int day() { return day(now()); }
+int hour() { return hour(now()); }
+int minute() { return minute(now()); }
+int second() { return second(now()); }
+int weekday() { return weekday(now()); }
@@ -0,0 +1,173 @@
+#include "audio_sequencer.h"
+
+// ==================== 预定义音序 ====================
+static const ToneStep breakWarningSteps[] = {
+  {BUZZER_BREAK_FREQUENCY, BUZZER_DURATION, 0}
+};
+static const ToneStep successSteps[] = {
+  {BUZZER_SUCCESS_FREQUENCY, BUZZER_DURATION, 0}
+};
+static const ToneStep errorSteps[] = {
+  {800, 100, BUZZER_STEP_GAP}, {600, 100, 0}
+};
+static const ToneStep startSteps[] = {
+  {1000, 100, BUZZER_STEP_GAP}, {1200, 100, BUZZER_STEP_GAP}, {1500, 150, 0}
+};
+static const ToneStep stopSteps[] = {
+  {1500, 100, BUZZER_STEP_GAP}, {1200, 100, BUZZER_STEP_GAP}, {1000, 150, 0}
+};
+static const ToneStep errorAlertSteps[] = {
+  {ERROR_TONE_FREQUENCY, ERROR_TONE_DURATION, ERROR_TONE_INTERVAL},
+  {ERROR_TONE_FREQUENCY, ERROR_TONE_DURATION, ERROR_TONE_INTERVAL},
+  {ERROR_TONE_FREQUENCY, ERROR_TONE_DURATION, 0}
+};
+static_assert(sizeof(errorAlertSteps) / sizeof(errorAlertSteps[0]) == ERROR_TONE_COUNT,
+              "错误报警音序长度应与ERROR_TONE_COUNT一致");
+
+struct PatternEntry {
+  const ToneStep* steps;
+  uint8_t count;
+};
+
+#define PATTERN(steps) {steps, sizeof(steps) / sizeof(steps[0])}
+
+// 按SoundPattern顺序排列
+static const PatternEntry patternTable[SOUND_PATTERN_COUNT] = {
+  PATTERN(breakWarningSteps),
+  PATTERN(successSteps),
+  PATTERN(errorSteps),
+  PATTERN(startSteps),
+  PATTERN(stopSteps),
+  PATTERN(errorAlertSteps)
+};
+
+esp_timer_handle_t AudioSequencer::timer = nullptr;
+SemaphoreHandle_t AudioSequencer::lock = nullptr;
+const ToneStep* AudioSequencer::steps = nullptr;
+uint8_t AudioSequencer::stepCount = 0;
+uint8_t AudioSequencer::stepIndex = 0;
+bool AudioSequencer::inGap = false;
+volatile bool AudioSequencer::playing = false;
+ToneStep AudioSequencer::customStep = {0, 0, 0};
+
+bool AudioSequencer::begin() {
+  if (timer != nullptr) {
+    return true;
+  }
+
+  lock = xSemaphoreCreateMutex();
+  esp_timer_create_args_t args = {};
+  args.callback = timerCallback;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.name = "audio_seq";
+  if (lock == nullptr || esp_timer_create(&args, &timer) != ESP_OK) {
+    DEBUG_ERROR("AUDIO", "提示音定时器创建失败");
+    timer = nullptr;
+    return false;
+  }
+  return true;
+}
+
+// 调用前必须持有lock
+void AudioSequencer::startStep() {
+  const ToneStep& step = steps[stepIndex];
+  if (step.frequency > 0) {
+    tone(BUZZER_PIN, step.frequency);
+  } else {
+    noTone(BUZZER_PIN);
+  }
+  inGap = false;
+  esp_timer_start_once(timer, (uint64_t)step.durationMs * 1000);
+}
+
+void AudioSequencer::timerCallback(void*) {
+  xSemaphoreTake(lock, portMAX_DELAY);
+
+  // 等待锁期间主任务可能已经开始了新的音序 (定时器被重新启动)，本次回调作废
+  if (!playing || esp_timer_is_active(timer)) {
+    xSemaphoreGive(lock);
+    return;
+  }
+
+  const ToneStep& step = steps[stepIndex];
+  if (!inGap) {
+    noTone(BUZZER_PIN);
+    if (step.gapMs > 0) {
+      inGap = true;
+      esp_timer_start_once(timer, (uint64_t)step.gapMs * 1000);
+      xSemaphoreGive(lock);
+      return;
+    }
+  }
+
+  stepIndex++;
+  if (stepIndex < stepCount) {
+    startStep();
+  } else {
+    digitalWrite(BUZZER_PIN, LOW);
+    playing = false;
+  }
+  xSemaphoreGive(lock);
+}
+
+bool AudioSequencer::start(const ToneStep* sequence, uint8_t count) {
+  if (count == 0 || !begin()) {
+    return false;
+  }
+
+  xSemaphoreTake(lock, portMAX_DELAY);
+  esp_timer_stop(timer);
+  steps = sequence;
+  stepCount = count;
+  stepIndex = 0;
+  playing = true;
+  startStep();
+  xSemaphoreGive(lock);
+  return true;
+}
+
+bool AudioSequencer::play(SoundPattern pattern) {
+  if (pattern >= SOUND_PATTERN_COUNT) {
+    return false;
+  }
+  return start(patternTable[pattern].steps, patternTable[pattern].count);
+}
+
+bool AudioSequencer::playTone(uint16_t frequency, uint16_t durationMs) {
+  if (!begin()) {
+    return false;
+  }
+  // customStep可能正在被回调读取，先停掉当前音序再修改
+  stop();
+  customStep = {frequency, durationMs, 0};
+  return start(&customStep, 1);
+}
+
+void AudioSequencer::stop() {
+  if (timer == nullptr) {
+    return;
+  }
+
+  xSemaphoreTake(lock, portMAX_DELAY);
+  esp_timer_stop(timer);
+  noTone(BUZZER_PIN);
+  digitalWrite(BUZZER_PIN, LOW);
+  playing = false;
+  xSemaphoreGive(lock);
+}
+
+bool AudioSequencer::isPlaying() {
+  return playing;
+}
+
+uint32_t AudioSequencer::getPatternDuration(SoundPattern pattern) {
+  if (pattern >= SOUND_PATTERN_COUNT) {
+    return 0;
+  }
+
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < patternTable[pattern].count; i++) {
+    total += patternTable[pattern].steps[i].durationMs + patternTable[pattern].steps[i].gapMs;
+  }
+  return total;
+}
@@ -0,0 +1,147 @@
+#include "battery_estimator.h"
+
+// 单节锂离子电池小电流放电的开路电压曲线
+const float BatteryEstimator::dischargeCurve[][2] = {
+  {4.20f, 100}, {4.15f, 95}, {4.11f, 90}, {4.08f, 85}, {4.02f, 80},
+  {3.98f, 75},  {3.95f, 70}, {3.91f, 65}, {3.87f, 60}, {3.85f, 55},
+  {3.84f, 50},  {3.82f, 45}, {3.80f, 40}, {3.79f, 35}, {3.77f, 30},
+  {3.75f, 25},  {3.73f, 20}, {3.71f, 15}, {3.69f, 10}, {3.61f, 5},
+  {3.27f, 0}
+};
+const uint8_t BatteryEstimator::curvePoints = sizeof(dischargeCurve) / sizeof(dischargeCurve[0]);
+
+BatteryEstimator::BatteryEstimator() {
+  for (uint8_t i = 0; i < SYSTEM_STATE_COUNT; i++) {
+    stateCurrentMa[i] = BATTERY_NOMINAL_CURRENT_MA;
+    stateTimeMs[i] = 0;
+  }
+  stateCurrentMa[STATE_SLEEP] = BATTERY_SLEEP_CURRENT_MA;
+}
+
+float BatteryEstimator::socFromVoltage(float voltage) {
+  if (voltage >= dischargeCurve[0][0]) {
+    return 100.0f;
+  }
+  if (voltage <= dischargeCurve[curvePoints - 1][0]) {
+    return 0.0f;
+  }
+
+  for (uint8_t i = 1; i < curvePoints; i++) {
+    if (voltage >= dischargeCurve[i][0]) {
+      float v0 = dischargeCurve[i][0], s0 = dischargeCurve[i][1];
+      float v1 = dischargeCurve[i - 1][0], s1 = dischargeCurve[i - 1][1];
+      return s0 + (voltage - v0) / (v1 - v0) * (s1 - s0);
+    }
+  }
+  return 0.0f;
+}
+
+void BatteryEstimator::begin(float voltage, uint8_t systemState, uint32_t nowMs) {
+  state = systemState < SYSTEM_STATE_COUNT ? systemState : (uint8_t)STATE_IDLE;
+  loadedVoltage = voltage;
+  openCircuitVoltage = voltage + getSagVoltage();
+  voltageSoc = socFromVoltage(openCircuitVoltage);
+  remainingMah = voltageSoc / 100.0f * BATTERY_CAPACITY_MAH;
+  lastAccountMs = nowMs;
+  started = true;
+  restartLearning(nowMs);
+}
+
+void BatteryEstimator::account(uint32_t nowMs) {
+  uint32_t elapsed = nowMs - lastAccountMs;
+  stateTimeMs[state] += elapsed;
+  remainingMah -= stateCurrentMa[state] * elapsed / 3600000.0f;
+  if (remainingMah < 0) {
+    remainingMah = 0;
+  }
+  lastAccountMs = nowMs;
+}
+
+void BatteryEstimator::restartLearning(uint32_t nowMs) {
+  learnStartMs = nowMs;
+  learnStartSoc = voltageSoc;
+}
+
+void BatteryEstimator::setState(uint8_t systemState, uint32_t nowMs) {
+  if (systemState >= SYSTEM_STATE_COUNT || systemState == state) {
+    return;
+  }
+  if (started) {
+    account(nowMs);
+    restartLearning(nowMs);
+  }
+  state = systemState;
+}
+
+void BatteryEstimator::addSample(float voltage, uint32_t nowMs) {
+  if (!started) {
+    begin(voltage, state, nowMs);
+    return;
+  }
+
+  account(nowMs);
+
+  // 补偿负载压降后查放电曲线，电压噪声较大，再做一次平滑
+  loadedVoltage = voltage;
+  openCircuitVoltage = voltage + getSagVoltage();
+  voltageSoc = voltageSoc * 0.8f + socFromVoltage(openCircuitVoltage) * 0.2f;
+
+  // 用电压推算的电量缓慢修正库仑计数
+  float voltageMah = voltageSoc / 100.0f * BATTERY_CAPACITY_MAH;
+  remainingMah += (voltageMah - remainingMah) * BATTERY_SOC_CORRECTION;
+
+  // 同一状态持续足够久：用电量变化反推该状态的平均电流
+  uint32_t learnElapsed = nowMs - learnStartMs;
+  if (learnElapsed >= BATTERY_LEARN_WINDOW_MS) {
+    float usedMah = (learnStartSoc - voltageSoc) / 100.0f * BATTERY_CAPACITY_MAH;
+    float measuredMa = usedMah * 3600000.0f / learnElapsed;
+    // 充电或噪声导致的异常值不参与修正
+    if (measuredMa > 0 && measuredMa < BATTERY_NOMINAL_CURRENT_MA * 10) {
+      stateCurrentMa[state] = stateCurrentMa[state] * 0.7f + measuredMa * 0.3f;
+      DEBUG_DEBUG("BATTERY", "状态%d平均电流修正为 %.1f mA (本窗口 %.1f mA)",
+                  state, stateCurrentMa[state], measuredMa);
+    }
+    restartLearning(nowMs);
+  }
+}
+
+bool BatteryEstimator::isStarted() const {
+  return started;
+}
+
+float BatteryEstimator::getLoadedVoltage() const {
+  return loadedVoltage;
+}
+
+float BatteryEstimator::getOpenCircuitVoltage() const {
+  return openCircuitVoltage;
+}
+
+float BatteryEstimator::getSagVoltage() const {
+  return stateCurrentMa[state] / 1000.0f * BATTERY_INTERNAL_RESISTANCE;
+}
+
+uint8_t BatteryEstimator::getPercentage() const {
+  float percentage = remainingMah / BATTERY_CAPACITY_MAH * 100.0f;
+  return (uint8_t)constrain((int)(percentage + 0.5f), 0, 100);
+}
+
+float BatteryEstimator::getRemainingMah() const {
+  return remainingMah;
+}
+
+float BatteryEstimator::getStateCurrent(uint8_t systemState) const {
+  return systemState < SYSTEM_STATE_COUNT ? stateCurrentMa[systemState] : 0.0f;
+}
+
+uint32_t BatteryEstimator::getStateTime(uint8_t systemState) const {
+  return systemState < SYSTEM_STATE_COUNT ? stateTimeMs[systemState] : 0;
+}
+
+uint32_t BatteryEstimator::getRemainingMinutes(uint8_t systemState) const {
+  float current = getStateCurrent(systemState);
+  if (current <= 0) {
+    return 0;
+  }
+  return (uint32_t)(remainingMah / current * 60.0f);
+}
@@ -0,0 +1,64 @@
+#include "boot_trace.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+BootStage BootTrace::stages[BOOT_TRACE_MAX_STAGES];
+uint8_t BootTrace::stageCount = 0;
+uint32_t BootTrace::firstScoreUs = 0;
+bool BootTrace::fastResume = false;
+
+// 数据加载任务与主任务会同时记录阶段
+static portMUX_TYPE traceLock = portMUX_INITIALIZER_UNLOCKED;
+
+void BootTrace::mark(const char* name) {
+  portENTER_CRITICAL(&traceLock);
+  if (stageCount < BOOT_TRACE_MAX_STAGES) {
+    stages[stageCount].name = name;
+    stages[stageCount].timestampUs = (uint32_t)esp_timer_get_time();
+    stageCount++;
+  }
+  portEXIT_CRITICAL(&traceLock);
+}
+
+bool BootTrace::markFirstScore() {
+  if (firstScoreUs != 0) {
+    return false;
+  }
+
+  firstScoreUs = (uint32_t)esp_timer_get_time();
+  return true;
+}
+
+void BootTrace::setFastResume(bool resumed) {
+  fastResume = resumed;
+}
+
+uint32_t BootTrace::getTimeToFirstScore() {
+  return firstScoreUs;
+}
+
+uint8_t BootTrace::getStageCount() {
+  return stageCount;
+}
+
+const BootStage* BootTrace::getStage(uint8_t index) {
+  return index < stageCount ? &stages[index] : nullptr;
+}
+
+void BootTrace::printReport() {
+  DEBUG_INFO("BOOT", "=== 启动阶段耗时 (%s) ===", fastResume ? "休眠唤醒" : "冷启动");
+
+  uint32_t previous = 0;
+  for (uint8_t i = 0; i < stageCount; i++) {
+    DEBUG_INFO("BOOT", "%-10s +%6lu us  @%7lu us", stages[i].name,
+               (unsigned long)(stages[i].timestampUs - previous),
+               (unsigned long)stages[i].timestampUs);
+    previous = stages[i].timestampUs;
+  }
+
+  if (firstScoreUs != 0) {
+    DEBUG_INFO("BOOT", "首个评分: %lu ms", (unsigned long)(firstScoreUs / 1000));
+  } else {
+    DEBUG_INFO("BOOT", "首个评分: 尚未产生");
+  }
+}
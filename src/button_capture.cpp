@@ -0,0 +1,109 @@
+#include "button_capture.h"
+#include "loop_scheduler.h"
+#include <esp_timer.h>
+
+ButtonEdge ButtonCapture::queue[BUTTON_QUEUE_SIZE];
+volatile uint8_t ButtonCapture::head = 0;
+volatile uint8_t ButtonCapture::tail = 0;
+volatile uint32_t ButtonCapture::overflowCount = 0;
+bool ButtonCapture::stablePressed = false;
+bool ButtonCapture::rawPressed = false;
+uint64_t ButtonCapture::rawTimeUs = 0;
+bool ButtonCapture::inLockout = false;
+uint64_t ButtonCapture::lockoutStartUs = 0;
+uint32_t ButtonCapture::seenOverflows = 0;
+
+static const uint64_t debounceUs = (uint64_t)INPUT_DEBOUNCE_INTERVAL * 1000;
+
+void IRAM_ATTR ButtonCapture::edgeIsr() {
+  pushEdge(esp_timer_get_time(), digitalRead(BUTTON_PIN) == BUTTON_PRESSED_STATE);
+  LoopScheduler::postFromIsr(LOOP_EVENT_BUTTON);
+}
+
+void IRAM_ATTR ButtonCapture::pushEdge(uint64_t timestampUs, bool pressed) {
+  uint8_t next = (head + 1) % BUTTON_QUEUE_SIZE;
+  if (next == tail) {
+    // 队列已满 (主循环长时间未处理)，丢弃并在读取时按实际电平重新同步
+    overflowCount++;
+    return;
+  }
+  queue[head].timestampUs = timestampUs;
+  queue[head].pressed = pressed;
+  head = next;   // 数据写完后再发布
+}
+
+void ButtonCapture::begin() {
+  reset();
+  attachInterrupt(digitalPinToInterrupt(BUTTON_PIN), edgeIsr, CHANGE);
+}
+
+void ButtonCapture::reset() {
+  tail = head;
+  stablePressed = digitalRead(BUTTON_PIN) == BUTTON_PRESSED_STATE;
+  rawPressed = stablePressed;
+  rawTimeUs = esp_timer_get_time();
+  inLockout = false;
+  seenOverflows = overflowCount;
+}
+
+bool ButtonCapture::commit(bool pressed, uint64_t timestampUs, ButtonEdge& edge) {
+  stablePressed = pressed;
+  inLockout = true;
+  lockoutStartUs = timestampUs;
+  edge.timestampUs = timestampUs;
+  edge.pressed = pressed;
+  return true;
+}
+
+bool ButtonCapture::poll(ButtonEdge& edge, uint64_t nowUs) {
+  while (tail != head) {
+    ButtonEdge raw = queue[tail];
+    tail = (tail + 1) % BUTTON_QUEUE_SIZE;
+
+    rawPressed = raw.pressed;
+    rawTimeUs = raw.timestampUs;
+
+    // 锁定期内的边沿视为抖动
+    if (inLockout && raw.timestampUs - lockoutStartUs < debounceUs) {
+      continue;
+    }
+    inLockout = false;
+
+    if (raw.pressed != stablePressed) {
+      return commit(raw.pressed, raw.timestampUs, edge);
+    }
+  }
+
+  // 有边沿被丢弃时，最后记录的电平不可信，直接读取GPIO
+  if (seenOverflows != overflowCount) {
+    seenOverflows = overflowCount;
+    rawPressed = digitalRead(BUTTON_PIN) == BUTTON_PRESSED_STATE;
+    rawTimeUs = nowUs;
+  }
+
+  // 锁定期结束后核对电平：抖动中最后一个边沿 (或丢弃边沿后重新读取的电平) 可能与稳定状态不同
+  if (inLockout && nowUs - lockoutStartUs >= debounceUs) {
+    inLockout = false;
+  }
+  if (!inLockout && rawPressed != stablePressed) {
+    return commit(rawPressed, rawTimeUs, edge);
+  }
+
+  return false;
+}
+
+bool ButtonCapture::isPressed() {
+  return stablePressed;
+}
+
+uint32_t ButtonCapture::getNextDeadline(uint64_t nowUs) {
+  if (!inLockout) {
+    return UINT32_MAX;
+  }
+  uint64_t elapsed = nowUs - lockoutStartUs;
+  return elapsed >= debounceUs ? 0 : (uint32_t)((debounceUs - elapsed) / 1000) + 1;
+}
+
+uint32_t ButtonCapture::getOverflowCount() {
+  return overflowCount;
+}
@@ -0,0 +1,559 @@
+#include "data_exporter.h"
+#include "byte_codec.h"
+#include "data_manager.h"
+#include "memory_monitor.h"
+
+#define EXPORT_MAGIC "ZEX1"
+#define EXPORT_SESSION_BYTES 64          // 每条会话记录携带的文件字节数
+#define EXPORT_CSV_LINE_MAX 128
+#define EXPORT_CSV_PREFIX "@EXC "
+
+// ==================== 十六进制 ====================
+static inline int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// ==================== 字段编码 ====================
+#define EXPORT_SETTINGS_SIZE 17
+#define EXPORT_DAY_SIZE 37
+#define EXPORT_SUMMARY_SIZE 20
+#define EXPORT_SUMMARY_MIN_SIZE 16        // 早期导出不含采样时长
+
+uint8_t DataExporter::encodeSettings(const SystemSettings& settings, uint8_t* out) {
+  uint8_t* p = out;
+  p = putF32(p, settings.stabilityThreshold);
+  *p++ = settings.soundEnabled ? 1 : 0;
+  *p++ = settings.displayBrightness;
+  p = putU32(p, settings.practiceTime);
+  *p++ = settings.autoSleep ? 1 : 0;
+  p = putU32(p, settings.sleepTimeout);
+  *p++ = settings.calibrationEnabled ? 1 : 0;
+  *p++ = settings.language;
+  return p - out;
+}
+
+bool DataExporter::decodeSettings(const uint8_t* in, uint8_t length, SystemSettings& settings) {
+  if (length < EXPORT_SETTINGS_SIZE) {
+    return false;
+  }
+  settings.stabilityThreshold = getF32(in);
+  settings.soundEnabled = in[4] != 0;
+  settings.displayBrightness = in[5];
+  settings.practiceTime = getU32(in + 6);
+  settings.autoSleep = in[10] != 0;
+  settings.sleepTimeout = getU32(in + 11);
+  settings.calibrationEnabled = in[15] != 0;
+  settings.language = in[16];
+  return true;
+}
+
+uint8_t DataExporter::encodeDay(uint8_t slot, const DailyStats& stats, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = slot;
+  p = putU16(p, stats.year);
+  *p++ = stats.month;
+  *p++ = stats.day;
+  p = putU32(p, stats.totalTime);
+  p = putU16(p, stats.sessionCount);
+  p = putU16(p, stats.totalBreaks);
+  p = putF32(p, stats.avgStability);
+  p = putF32(p, stats.bestStability);
+  p = putU32(p, stats.stableTime);
+  p = putF32(p, stats.medianStability);
+  p = putF32(p, stats.p10Stability);
+  p = putF32(p, stats.p90Stability);
+  return p - out;
+}
+
+bool DataExporter::decodeDay(const uint8_t* in, uint8_t length, uint8_t& slot, DailyStats& stats) {
+  if (length < EXPORT_DAY_SIZE) {
+    return false;
+  }
+  slot = in[0];
+  stats.year = getU16(in + 1);
+  stats.month = in[3];
+  stats.day = in[4];
+  stats.totalTime = getU32(in + 5);
+  stats.sessionCount = getU16(in + 9);
+  stats.totalBreaks = getU16(in + 11);
+  stats.avgStability = getF32(in + 13);
+  stats.bestStability = getF32(in + 17);
+  stats.stableTime = getU32(in + 21);
+  stats.medianStability = getF32(in + 25);
+  stats.p10Stability = getF32(in + 29);
+  stats.p90Stability = getF32(in + 33);
+  return true;
+}
+
+uint8_t DataExporter::encodeSummary(const DaySummary& day, uint8_t* out) {
+  uint8_t* p = out;
+  p = putU16(p, day.year);
+  *p++ = day.month;
+  *p++ = day.day;
+  p = putU32(p, day.totalTime);
+  p = putU16(p, day.sessionCount);
+  p = putU16(p, day.totalBreaks);
+  p = putU16(p, day.avgCenti);
+  p = putU16(p, day.bestCenti);
+  p = putU32(p, day.sampledTime);
+  return p - out;
+}
+
+bool DataExporter::decodeSummary(const uint8_t* in, uint8_t length, DaySummary& day) {
+  if (length < EXPORT_SUMMARY_MIN_SIZE) {
+    return false;
+  }
+  day.year = getU16(in);
+  day.month = in[2];
+  day.day = in[3];
+  day.totalTime = getU32(in + 4);
+  day.sessionCount = getU16(in + 8);
+  day.totalBreaks = getU16(in + 10);
+  day.avgCenti = getU16(in + 12);
+  day.bestCenti = getU16(in + 14);
+  day.sampledTime = length >= EXPORT_SUMMARY_SIZE ? getU32(in + 16) : day.totalTime;
+  return true;
+}
+
+uint32_t DataExporter::crc32Update(uint32_t crc, const uint8_t* data, size_t length) {
+  // 标准CRC-32 (多项式0xEDB88320)，按半字节查表，表只占64字节
+  static const uint32_t table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+    crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
+// ==================== 流式导出器 ====================
+DataExporter::DataExporter() {
+  stage = STAGE_IDLE;
+}
+
+bool DataExporter::begin(const DataManager& dataManager, ExportFormat exportFormat) {
+  if (isActive()) {
+    DEBUG_WARN("EXPORT", "导出正在进行，忽略新的导出请求");
+    return false;
+  }
+
+  source = &dataManager;
+  format = exportFormat;
+  stage = STAGE_HEADER;
+  cursor = 0;
+  pendingLength = 0;
+  lineSequence = 0;
+  crc = 0;
+  bytesWritten = 0;
+
+  DEBUG_INFO("EXPORT", "开始导出数据 (%s)", format == EXPORT_BINARY ? "二进制" : "CSV");
+  return true;
+}
+
+void DataExporter::cancel() {
+  if (sessionFile) {
+    sessionFile.close();
+  }
+  stage = STAGE_IDLE;
+  pendingLength = 0;
+}
+
+bool DataExporter::isActive() const {
+  return stage != STAGE_IDLE;
+}
+
+uint32_t DataExporter::getBytesWritten() const {
+  return bytesWritten;
+}
+
+void DataExporter::update() {
+  if (stage == STAGE_IDLE) {
+    return;
+  }
+  HEAP_TAG_SCOPE(HEAP_TAG_EXPORT);   // 会话文件句柄和读取缓冲
+
+  for (int lines = 0; lines < EXPORT_LINES_PER_UPDATE; lines++) {
+    if (format == EXPORT_BINARY) {
+      // 凑满一行再输出
+      while (pendingLength < EXPORT_CHUNK_SIZE && produceNext()) {
+      }
+      if (pendingLength == 0) {
+        break;
+      }
+
+      // 发送缓冲放不下整行时留到下一次循环，不阻塞
+      if (!emitLine(pendingLength < EXPORT_CHUNK_SIZE ? pendingLength : EXPORT_CHUNK_SIZE)) {
+        return;
+      }
+    } else {
+      // 每次生成一整行 (空的历史槽位等不生成)
+      while (pendingLength == 0 && produceNext()) {
+      }
+      if (pendingLength == 0) {
+        break;
+      }
+      if (!emitCsvLine()) {
+        return;
+      }
+    }
+  }
+
+  if (stage == STAGE_FLUSH && pendingLength == 0) {
+    stage = STAGE_IDLE;
+    DEBUG_INFO("EXPORT", "数据导出完成，共%lu字节", (unsigned long)bytesWritten);
+  }
+}
+
+bool DataExporter::produceNext() {
+  uint8_t payload[EXPORT_DAY_SIZE];
+  char line[EXPORT_CSV_LINE_MAX];
+
+  switch (stage) {
+    case STAGE_HEADER:
+      if (format == EXPORT_BINARY) {
+        memcpy(payload, EXPORT_MAGIC, 4);
+        payload[4] = EXPORT_FORMAT_VERSION;
+        appendRecord(EXPORT_REC_HEADER, payload, 5);
+      } else {
+        snprintf(line, sizeof(line), "# zen-motion export v%d", EXPORT_FORMAT_VERSION);
+        appendCsvLine(line);
+      }
+      stage = STAGE_SETTINGS;
+      return true;
+
+    case STAGE_SETTINGS:
+      if (format == EXPORT_BINARY) {
+        appendRecord(EXPORT_REC_SETTINGS, payload, encodeSettings(source->getSettings(), payload));
+      } else {
+        appendCsvLine("kind,index,date,total_ms,sessions,breaks,avg,best,stable_ms,median,p10,p90");
+      }
+      stage = STAGE_DAYS;
+      cursor = 0;
+      return true;
+
+    case STAGE_DAYS: {
+      if (cursor > MAX_HISTORY_DAYS) {
+        stage = STAGE_ROLLING;
+        cursor = 0;
+        return true;
+      }
+
+      DailyStats stats = cursor == 0 ? source->getTodayStats() : source->getHistoryStats(cursor - 1);
+      int slot = cursor++;
+      if (slot > 0 && stats.year == 0) {
+        return true;  // 空的历史槽位
+      }
+
+      if (format == EXPORT_BINARY) {
+        appendRecord(EXPORT_REC_DAY, payload, encodeDay(slot, stats, payload));
+      } else {
+        snprintf(line, sizeof(line), "day,%d,%04d-%02d-%02d,%lu,%d,%d,%.2f,%.2f,%lu,%.2f,%.2f,%.2f",
+                 slot, stats.year, stats.month, stats.day, (unsigned long)stats.totalTime,
+                 stats.sessionCount, stats.totalBreaks, stats.avgStability, stats.bestStability,
+                 (unsigned long)stats.stableTime, stats.medianStability,
+                 stats.p10Stability, stats.p90Stability);
+        appendCsvLine(line);
+      }
+      return true;
+    }
+
+    case STAGE_ROLLING: {
+      const RollingStats& rolling = source->getRollingStats();
+      if (cursor >= rolling.getDayCount()) {
+        if (format == EXPORT_BINARY) {
+          stage = STAGE_SESSIONS;
+          lastSessionId = source->getLatestRecordedSession();
+          sessionId = lastSessionId > SESSION_RECORD_MAX_FILES ? lastSessionId - SESSION_RECORD_MAX_FILES + 1 : 1;
+        } else {
+          stage = STAGE_END;
+        }
+        return true;
+      }
+
+      // 按时间先后输出，最旧的在前
+      int index = cursor++;
+      const DaySummary& day = rolling.getDay(rolling.getDayCount() - 1 - index);
+      if (format == EXPORT_BINARY) {
+        appendRecord(EXPORT_REC_ROLLING_DAY, payload, encodeSummary(day, payload));
+      } else {
+        snprintf(line, sizeof(line), "rolling,%d,%04d-%02d-%02d,%lu,%u,%u,%.2f,%.2f,,,,",
+                 index, day.year, day.month, day.day, (unsigned long)day.totalTime,
+                 day.sessionCount, day.totalBreaks, day.avgCenti / 100.0, day.bestCenti / 100.0);
+        appendCsvLine(line);
+      }
+      return true;
+    }
+
+    case STAGE_SESSIONS:
+      return produceSessionChunk();
+
+    case STAGE_END:
+      if (format == EXPORT_BINARY) {
+        putU32(payload, crc);
+        appendRecord(EXPORT_REC_END, payload, 4);
+      } else {
+        snprintf(line, sizeof(line), "#crc32=%08lx", (unsigned long)crc);
+        appendCsvLine(line);
+      }
+      stage = STAGE_FLUSH;
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+bool DataExporter::produceSessionChunk() {
+  uint8_t payload[4 + EXPORT_SESSION_BYTES];
+
+  while (sessionId != 0 && sessionId <= lastSessionId) {
+    if (!sessionFile) {
+      sessionFile = source->openSessionRecord(sessionId);
+      if (!sessionFile) {
+        sessionId++;
+        continue;
+      }
+    }
+
+    // 原样转发记录文件，主机端按会话序号拼接后解码
+    putU32(payload, sessionId);
+    size_t length = sessionFile.read(payload + 4, EXPORT_SESSION_BYTES);
+    if (length == 0) {
+      sessionFile.close();
+      sessionId++;
+      continue;
+    }
+
+    appendRecord(EXPORT_REC_SESSION, payload, 4 + length);
+    return true;
+  }
+
+  stage = STAGE_END;
+  return true;
+}
+
+void DataExporter::appendRecord(uint8_t type, const uint8_t* payload, uint8_t length) {
+  uint8_t* p = pending + pendingLength;
+  p[0] = type;
+  p[1] = length;
+  memcpy(p + 2, payload, length);
+
+  crc = crc32Update(crc, p, length + 2);
+  pendingLength += length + 2;
+}
+
+bool DataExporter::emitLine(size_t length) {
+  static const char hexDigits[] = "0123456789abcdef";
+  char line[12 + EXPORT_CHUNK_SIZE * 2];
+
+  int n = snprintf(line, sizeof(line), "@EXB %04x ", lineSequence);
+  for (size_t i = 0; i < length; i++) {
+    line[n++] = hexDigits[pending[i] >> 4];
+    line[n++] = hexDigits[pending[i] & 0x0F];
+  }
+  line[n++] = '\n';
+
+  if (Serial.availableForWrite() < n) {
+    return false;
+  }
+  Serial.write((const uint8_t*)line, n);
+
+  lineSequence++;
+  bytesWritten += length;
+  pendingLength -= length;
+  memmove(pending, pending + length, pendingLength);
+  return true;
+}
+
+void DataExporter::appendCsvLine(const char* line) {
+  // CSV的CRC覆盖每行内容及换行符，不含"@EXC "前缀
+  if (strncmp(line, "#crc32=", 7) != 0) {
+    crc = crc32Update(crc, (const uint8_t*)line, strlen(line));
+    crc = crc32Update(crc, (const uint8_t*)"\n", 1);
+  }
+  pendingLength = snprintf((char*)pending, sizeof(pending), EXPORT_CSV_PREFIX "%s\n", line);
+}
+
+bool DataExporter::emitCsvLine() {
+  if (Serial.availableForWrite() < (int)pendingLength) {
+    return false;
+  }
+  Serial.write(pending, pendingLength);
+  bytesWritten += pendingLength - (sizeof(EXPORT_CSV_PREFIX) - 1);
+  pendingLength = 0;
+  return true;
+}
+
+// ==================== 流式导入器 ====================
+DataImporter::DataImporter() {
+  clear();
+}
+
+void DataImporter::clear() {
+  reset();
+  active = false;
+}
+
+void DataImporter::reset() {
+  memset(&bundle, 0, sizeof(bundle));
+  state = IMPORT_WAIT_TYPE;
+  recordType = 0;
+  recordLength = 0;
+  payloadCount = 0;
+  crc = 0;
+  recordStartCrc = 0;
+  expectedSequence = 0;
+  complete = false;
+  failed = false;
+}
+
+bool DataImporter::feedLine(const char* line) {
+  if (strncmp(line, "@EXB ", 5) != 0) {
+    return false;
+  }
+  HEAP_TAG_SCOPE(HEAP_TAG_EXPORT);
+
+  // 解析行序号，序号0表示新的导出流开始
+  uint16_t sequence = 0;
+  for (int i = 5; i < 9; i++) {
+    int v = hexValue(line[i]);
+    if (v < 0) {
+      fail("行格式错误");
+      return true;
+    }
+    sequence = (sequence << 4) | v;
+  }
+
+  if (sequence == 0) {
+    reset();
+    active = true;
+    DEBUG_INFO("IMPORT", "开始接收导入数据");
+  }
+  if (!active || complete || failed) {
+    return true;
+  }
+  if (sequence != expectedSequence) {
+    fail("行序号不连续");
+    return true;
+  }
+  expectedSequence++;
+
+  for (const char* p = line + 10; p[0] && p[1]; p += 2) {
+    int high = hexValue(p[0]);
+    int low = hexValue(p[1]);
+    if (high < 0 || low < 0) {
+      break;  // 行尾的回车等字符
+    }
+    feedByte((high << 4) | low);
+    if (complete || failed) {
+      break;
+    }
+  }
+  return true;
+}
+
+void DataImporter::feedByte(uint8_t value) {
+  if (state == IMPORT_WAIT_TYPE) {
+    recordStartCrc = crc;
+  }
+  crc = DataExporter::crc32Update(crc, &value, 1);
+
+  switch (state) {
+    case IMPORT_WAIT_TYPE:
+      recordType = value;
+      state = IMPORT_WAIT_LENGTH;
+      break;
+
+    case IMPORT_WAIT_LENGTH:
+      recordLength = value;
+      payloadCount = 0;
+      if (recordLength == 0) {
+        handleRecord();
+        state = IMPORT_WAIT_TYPE;
+      } else {
+        state = IMPORT_PAYLOAD;
+      }
+      break;
+
+    case IMPORT_PAYLOAD:
+      payload[payloadCount++] = value;
+      if (payloadCount >= recordLength) {
+        handleRecord();
+        state = IMPORT_WAIT_TYPE;
+      }
+      break;
+  }
+}
+
+void DataImporter::handleRecord() {
+  switch (recordType) {
+    case EXPORT_REC_HEADER:
+      if (recordLength < 5 || memcmp(payload, EXPORT_MAGIC, 4) != 0 ||
+          payload[4] != EXPORT_FORMAT_VERSION) {
+        fail("文件头或版本不匹配");
+      }
+      break;
+
+    case EXPORT_REC_SETTINGS:
+      bundle.hasSettings = DataExporter::decodeSettings(payload, recordLength, bundle.settings);
+      break;
+
+    case EXPORT_REC_DAY: {
+      uint8_t slot;
+      DailyStats stats;
+      if (DataExporter::decodeDay(payload, recordLength, slot, stats) && slot <= MAX_HISTORY_DAYS) {
+        bundle.days[slot] = stats;
+        if (slot + 1 > bundle.dayCount) {
+          bundle.dayCount = slot + 1;
+        }
+      }
+      break;
+    }
+
+    case EXPORT_REC_ROLLING_DAY:
+      if (bundle.rollingCount < ROLLING_MONTH_DAYS - 1 &&
+          DataExporter::decodeSummary(payload, recordLength, bundle.rollingDays[bundle.rollingCount])) {
+        bundle.rollingCount++;
+      }
+      break;
+
+    case EXPORT_REC_END:
+      if (recordLength == 4 && getU32(payload) == recordStartCrc) {
+        complete = true;
+        DEBUG_INFO("IMPORT", "导入数据接收完成，CRC校验通过");
+      } else {
+        fail("CRC校验失败");
+      }
+      break;
+
+    default:
+      // 会话曲线及未知记录不导入，直接跳过
+      break;
+  }
+}
+
+void DataImporter::fail(const char* reason) {
+  failed = true;
+  DEBUG_WARN("IMPORT", "导入失败: %s", reason);
+}
+
+bool DataImporter::isComplete() const {
+  return complete;
+}
+
+bool DataImporter::hasFailed() const {
+  return failed;
+}
+
+const ImportBundle& DataImporter::getBundle() const {
+  return bundle;
+}
@@ -1,5 +1,29 @@
 #include "data_manager.h"
+#include "perf_timer.h"
+#include "event_bus.h"
 #include <time.h>
+#include <LittleFS.h>
+
+#define ROLLING_STATS_MAGIC 0x3152525A  // "ZRR1"
+#define ROLLING_STATS_VERSION 2         // v2: DaySummary增加有效采样时长
+
+// 滚动统计文件头，之后为按时间先后排列的DaySummary
+struct RollingStatsHeader {
+  uint32_t magic;
+  uint8_t version;
+  uint8_t count;
+  uint16_t reserved;
+};
+
+// 今日直方图紧跟在历史数据之后，以秒为单位压缩存储，整个数据区不得覆盖校准数据
+struct StoredHistogram {
+  uint16_t bins[STABILITY_HISTOGRAM_BINS];  // 每档累计时长 (s)
+};
+
+#define EEPROM_HISTOGRAM_ADDR (EEPROM_SETTINGS_ADDR + sizeof(SystemSettings) + \
+                               (MAX_HISTORY_DAYS + 1) * sizeof(DailyStats))
+static_assert(EEPROM_HISTOGRAM_ADDR + sizeof(StoredHistogram) <= EEPROM_CALIBRATION_ADDR,
+              "EEPROM统计数据区与校准数据区重叠");
 
 DataManager::DataManager() {
   // 初始化当前会话
@@ -9,6 +33,10 @@ DataManager::DataManager() {
   currentSession.avgStability = 0.0;
   currentSession.maxStability = 0.0;
   currentSession.minStability = 100.0;
+  currentSession.medianStability = 0.0;
+  currentSession.p10Stability = 0.0;
+  currentSession.p90Stability = 0.0;
+  currentSession.stableTime = 0;
   currentSession.breakCount = 0;
   currentSession.completed = false;
   
@@ -21,6 +49,11 @@ DataManager::DataManager() {
   todayStats.avgStability = 0.0;
   todayStats.bestStability = 0.0;
   todayStats.totalBreaks = 0;
+  todayStats.stableTime = 0;
+  todayStats.medianStability = 0.0;
+  todayStats.p10Stability = 0.0;
+  todayStats.p90Stability = 0.0;
+  StabilityAggregator::clearHistogram(todayHistogram);
   
   // 初始化历史数据
   for (int i = 0; i < MAX_HISTORY_DAYS; i++) {
@@ -29,12 +62,20 @@ DataManager::DataManager() {
 }
 
 bool DataManager::initialize(TimeManager* tm) {
-  // 初始化EEPROM
-  EEPROM.begin(EEPROM_SIZE);
+  // 初始化持久化服务（加载EEPROM镜像并启动后台提交任务）
+  PersistenceWorker::begin();
   
   // 加载数据
   loadData();
   
+  // 初始化会话曲线记录
+  if (!recorder.initialize()) {
+    DEBUG_WARN("DATA_MANAGER", "会话曲线记录不可用");
+  }
+  
+  // 加载滚动统计（依赖文件系统）
+  loadRollingStats();
+  
   // 设置时间管理器
   timeManager = tm;
   if (timeManager) {
@@ -57,6 +98,11 @@ bool DataManager::initialize(TimeManager* tm) {
   return true;
 }
 
+void DataManager::subscribeEvents() {
+  // 评分累计到当前会话，破定计入统计
+  EventBus::subscribe(EventBus::mask(BUS_EVENT_SCORE) | EventBus::mask(BUS_EVENT_BREAK), onBusEvent, this);
+}
+
 void DataManager::reset() {
   // 重置当前会话
   currentSession.startTime = 0;
@@ -65,6 +111,10 @@ void DataManager::reset() {
   currentSession.avgStability = 0.0;
   currentSession.maxStability = 0.0;
   currentSession.minStability = 100.0;
+  currentSession.medianStability = 0.0;
+  currentSession.p10Stability = 0.0;
+  currentSession.p90Stability = 0.0;
+  currentSession.stableTime = 0;
   currentSession.breakCount = 0;
   currentSession.completed = false;
   
@@ -96,11 +146,24 @@ void DataManager::startSession() {
   currentSession.avgStability = 0.0;
   currentSession.maxStability = 0.0;
   currentSession.minStability = 100.0;
+  currentSession.medianStability = 0.0;
+  currentSession.p10Stability = 0.0;
+  currentSession.p90Stability = 0.0;
+  currentSession.stableTime = 0;
   currentSession.breakCount = 0;
   currentSession.completed = false;
+  sessionAggregator.reset(settings.stabilityThreshold);
+  
+  // 开始记录稳定性曲线
+  DateTime startDate = {};
+  if (timeManager) {
+    startDate = timeManager->getCurrentDateTime();
+  }
+  recorder.begin(startDate);
   
   dataChanged = true;
   DEBUG_PRINTLN("练习会话开始");
+  EventBus::publishSession(BUS_EVENT_SESSION_START, currentSession);
 }
 
 void DataManager::pauseSession() {
@@ -110,6 +173,9 @@ void DataManager::pauseSession() {
   
   currentSession.endTime = millis();
   currentSession.duration += (currentSession.endTime - currentSession.startTime);
+  sessionAggregator.pause(currentSession.endTime);
+  updateSessionAggregates();
+  recorder.pause();
   
   DEBUG_PRINTLN("练习会话暂停");
 }
@@ -121,6 +187,7 @@ void DataManager::resumeSession() {
   
   currentSession.startTime = millis();
   currentSession.endTime = 0;
+  recorder.resume(currentSession.startTime);
   
   DEBUG_PRINTLN("练习会话恢复");
 }
@@ -134,15 +201,22 @@ void DataManager::stopSession() {
   if (currentSession.endTime == 0) {
     currentSession.endTime = millis();
     currentSession.duration += (currentSession.endTime - currentSession.startTime);
+    sessionAggregator.pause(currentSession.endTime);
+    updateSessionAggregates();
   }
   
   currentSession.completed = true;
   
+  // 写入剩余的曲线数据
+  recorder.finish();
+  
   // 更新今日统计
   updateTodayStats();
   
   dataChanged = true;
   DEBUG_PRINTF("练习会话结束，持续时间: %lu ms\n", currentSession.duration);
+  EventBus::publishSession(BUS_EVENT_SESSION_STOP, currentSession);
+  EventBus::publishStats();
 }
 
 bool DataManager::isSessionActive() const {
@@ -175,17 +249,38 @@ void DataManager::updateSessionStability(float score) {
     return;
   }
   
-  // 更新最大和最小稳定性
-  if (score > currentSession.maxStability) {
-    currentSession.maxStability = score;
-  }
-  if (score < currentSession.minStability) {
-    currentSession.minStability = score;
+  // 流式累计，按采样间隔加权
+  sessionAggregator.addSample(score, millis());
+  updateSessionAggregates();
+  
+  // 降采样记录到曲线缓冲
+  recorder.addSample(score, millis());
+}
+
+void DataManager::updateSessionAggregates() {
+  if (sessionAggregator.getSampleCount() == 0) {
+    return;
   }
   
-  // 这里可以实现更复杂的平均值计算
-  // 简单起见，使用当前值作为平均值的近似
-  currentSession.avgStability = score;
+  currentSession.avgStability = sessionAggregator.getMean();
+  currentSession.maxStability = sessionAggregator.getMaxScore();
+  currentSession.minStability = sessionAggregator.getMinScore();
+  currentSession.medianStability = sessionAggregator.getMedian();
+  currentSession.p10Stability = sessionAggregator.getPercentile(0.1f);
+  currentSession.p90Stability = sessionAggregator.getPercentile(0.9f);
+  currentSession.stableTime = sessionAggregator.getStableTime();
+}
+
+uint32_t DataManager::getLatestRecordedSession() const {
+  return recorder.getLatestSessionId();
+}
+
+size_t DataManager::loadSessionSeries(uint32_t sessionId, uint8_t* points, size_t maxPoints) const {
+  return recorder.loadSeries(sessionId, points, maxPoints);
+}
+
+File DataManager::openSessionRecord(uint32_t sessionId) const {
+  return recorder.openRecord(sessionId);
 }
 
 DailyStats DataManager::getTodayStats() const {
@@ -205,6 +300,16 @@ void DataManager::addBreakEvent() {
   }
   todayStats.totalBreaks++;
   dataChanged = true;
+  EventBus::publishStats();
+}
+
+void DataManager::onBusEvent(const BusEvent& event, void* context) {
+  DataManager* self = static_cast<DataManager*>(context);
+  if (event.type == BUS_EVENT_SCORE) {
+    self->updateSessionStability(event.stability->score);
+  } else if (event.type == BUS_EVENT_BREAK) {
+    self->addBreakEvent();
+  }
 }
 
 SystemSettings DataManager::getSettings() const {
@@ -215,11 +320,13 @@ void DataManager::updateSettings(const SystemSettings& newSettings) {
   settings = newSettings;
   dataChanged = true;
   DEBUG_PRINTLN("设置已更新");
+  EventBus::publishSettings(settings);
 }
 
 void DataManager::resetSettings() {
   initializeDefaultSettings();
   DEBUG_PRINTLN("设置已重置为默认值");
+  EventBus::publishSettings(settings);
 }
 
 void DataManager::updateTodayStats() {
@@ -229,14 +336,24 @@ void DataManager::updateTodayStats() {
   // 更新总时间
   todayStats.totalTime += currentSession.duration;
   
-  // 更新平均稳定性
-  if (todayStats.sessionCount == 1) {
-    todayStats.avgStability = currentSession.avgStability;
-  } else {
-    todayStats.avgStability = (todayStats.avgStability * (todayStats.sessionCount - 1) + 
-                              currentSession.avgStability) / todayStats.sessionCount;
+  // 更新平均稳定性，按各会话的有效采样时长加权
+  uint32_t previousTime = StabilityAggregator::histogramTotal(todayHistogram);
+  uint32_t sessionTime = sessionAggregator.getSampledTime();
+  if (previousTime + sessionTime > 0) {
+    todayStats.avgStability = ((double)todayStats.avgStability * previousTime +
+                               (double)currentSession.avgStability * sessionTime) /
+                              (previousTime + sessionTime);
   }
   
+  // 合并直方图，重新计算今日分位数
+  StabilityAggregator::mergeHistogram(todayHistogram, sessionAggregator.getHistogram());
+  todayStats.medianStability = StabilityAggregator::percentileOf(todayHistogram, 0.5f);
+  todayStats.p10Stability = StabilityAggregator::percentileOf(todayHistogram, 0.1f);
+  todayStats.p90Stability = StabilityAggregator::percentileOf(todayHistogram, 0.9f);
+  
+  // 更新稳定时长
+  todayStats.stableTime += currentSession.stableTime;
+  
   // 更新最佳稳定性
   if (currentSession.maxStability > todayStats.bestStability) {
     todayStats.bestStability = currentSession.maxStability;
@@ -257,7 +374,7 @@ void DataManager::saveData() {
   lastSaveTime = millis();
   dataChanged = false;
   
-  DEBUG_PRINTLN("数据已保存到EEPROM");
+  DEBUG_PRINTLN("数据已提交后台保存");
 }
 
 void DataManager::loadData() {
@@ -270,59 +387,80 @@ bool DataManager::needsSave() const {
 }
 
 void DataManager::forceSave() {
+  // 休眠/断电前使用：等待后台任务把数据写入Flash
   saveToEEPROM();
   lastSaveTime = millis();
   dataChanged = false;
-  DEBUG_PRINTLN("强制保存数据完成");
+  if (PersistenceWorker::flush()) {
+    DEBUG_PRINTLN("强制保存数据完成");
+  }
 }
 
 void DataManager::saveToEEPROM() {
+  PERF_SCOPE("EEPROM_SAVE");
+
   // 保存今日统计数据
-  EEPROM.put(EEPROM_TOTAL_TIME_ADDR, todayStats.totalTime);
-  EEPROM.put(EEPROM_SESSION_COUNT_ADDR, todayStats.sessionCount);
-  EEPROM.put(EEPROM_BEST_SCORE_ADDR, todayStats.bestStability);
+  PersistenceWorker::put(EEPROM_TOTAL_TIME_ADDR, todayStats.totalTime);
+  PersistenceWorker::put(EEPROM_SESSION_COUNT_ADDR, todayStats.sessionCount);
+  PersistenceWorker::put(EEPROM_BEST_SCORE_ADDR, todayStats.bestStability);
 
   // 保存设置数据
-  EEPROM.put(EEPROM_SETTINGS_ADDR, settings);
+  PersistenceWorker::put(EEPROM_SETTINGS_ADDR, settings);
 
   // 保存今日统计完整数据
-  EEPROM.put(EEPROM_SETTINGS_ADDR + sizeof(SystemSettings), todayStats);
+  PersistenceWorker::put(EEPROM_SETTINGS_ADDR + sizeof(SystemSettings), todayStats);
 
   // 保存历史数据
   int historyAddr = EEPROM_SETTINGS_ADDR + sizeof(SystemSettings) + sizeof(DailyStats);
   for (int i = 0; i < MAX_HISTORY_DAYS; i++) {
-    EEPROM.put(historyAddr + i * sizeof(DailyStats), historyStats[i]);
+    PersistenceWorker::put(historyAddr + i * sizeof(DailyStats), historyStats[i]);
+  }
+
+  // 保存今日直方图
+  StoredHistogram stored;
+  for (int i = 0; i < STABILITY_HISTOGRAM_BINS; i++) {
+    uint32_t seconds = (todayHistogram.bins[i] + 500) / 1000;
+    stored.bins[i] = seconds > 0xFFFF ? 0xFFFF : seconds;
   }
+  PersistenceWorker::put(EEPROM_HISTOGRAM_ADDR, stored);
 
   // 写入有效性标志
-  EEPROM.write(EEPROM_SIZE - 1, 0xAA);
+  PersistenceWorker::writeByte(EEPROM_SIZE - 1, EEPROM_LAYOUT_MAGIC);
 
-  EEPROM.commit();
+  // Flash写入交给后台任务，连续的保存请求会被合并
+  PersistenceWorker::requestCommit();
 }
 
 void DataManager::loadFromEEPROM() {
   // 检查数据有效性
-  if (EEPROM.read(EEPROM_SIZE - 1) != 0xAA) {
+  if (PersistenceWorker::readByte(EEPROM_SIZE - 1) != EEPROM_LAYOUT_MAGIC) {
     DEBUG_PRINTLN("EEPROM数据无效，使用默认值");
     initializeDefaultSettings();
     return;
   }
 
   // 加载基本统计数据
-  EEPROM.get(EEPROM_TOTAL_TIME_ADDR, todayStats.totalTime);
-  EEPROM.get(EEPROM_SESSION_COUNT_ADDR, todayStats.sessionCount);
-  EEPROM.get(EEPROM_BEST_SCORE_ADDR, todayStats.bestStability);
+  PersistenceWorker::get(EEPROM_TOTAL_TIME_ADDR, todayStats.totalTime);
+  PersistenceWorker::get(EEPROM_SESSION_COUNT_ADDR, todayStats.sessionCount);
+  PersistenceWorker::get(EEPROM_BEST_SCORE_ADDR, todayStats.bestStability);
 
   // 加载设置数据
-  EEPROM.get(EEPROM_SETTINGS_ADDR, settings);
+  PersistenceWorker::get(EEPROM_SETTINGS_ADDR, settings);
 
   // 加载今日统计完整数据
-  EEPROM.get(EEPROM_SETTINGS_ADDR + sizeof(SystemSettings), todayStats);
+  PersistenceWorker::get(EEPROM_SETTINGS_ADDR + sizeof(SystemSettings), todayStats);
 
   // 加载历史数据
   int historyAddr = EEPROM_SETTINGS_ADDR + sizeof(SystemSettings) + sizeof(DailyStats);
   for (int i = 0; i < MAX_HISTORY_DAYS; i++) {
-    EEPROM.get(historyAddr + i * sizeof(DailyStats), historyStats[i]);
+    PersistenceWorker::get(historyAddr + i * sizeof(DailyStats), historyStats[i]);
+  }
+
+  // 加载今日直方图
+  StoredHistogram stored;
+  PersistenceWorker::get(EEPROM_HISTOGRAM_ADDR, stored);
+  for (int i = 0; i < STABILITY_HISTOGRAM_BINS; i++) {
+    todayHistogram.bins[i] = (uint32_t)stored.bins[i] * 1000;
   }
 }
 
@@ -372,6 +510,12 @@ bool DataManager::checkAndUpdateDate() {
         }
         historyStats[0] = emptyDay;
       }
+      
+      // 滚动统计同样补齐空缺天数（超过月窗口的部分无需补齐）
+      for (int i = 1; i < daysDiff && i < ROLLING_MONTH_DAYS; i++) {
+        DailyStats emptyDay = {};
+        rollingStats.pushDay(RollingStats::summarize(emptyDay, 0));
+      }
     }
     
     // 重置今日数据
@@ -382,7 +526,9 @@ bool DataManager::checkAndUpdateDate() {
     
     lastCheckDate = currentDate;
     dataChanged = true;
-    forceSave(); // 立即保存
+    saveData(); // 立即提交保存
+    saveRollingStats();
+    EventBus::publishStats();
     
     return true;
   }
@@ -398,10 +544,11 @@ void DataManager::moveTodayToHistory() {
   
   // 将今日数据移到历史数据的第一位
   historyStats[0] = todayStats;
+  rollingStats.pushDay(RollingStats::summarize(todayStats, StabilityAggregator::histogramTotal(todayHistogram)));
   
   DEBUG_INFO("DATA_MANAGER", "今日数据已保存到历史: %d/%d/%d, 练习%d次, 总时长%lums",
              todayStats.year, todayStats.month, todayStats.day,
-             todayStats.sessionCount, todayStats.totalTime);
+             todayStats.sessionCount, (unsigned long)todayStats.totalTime);
 }
 
 void DataManager::resetTodayStats() {
@@ -410,6 +557,11 @@ void DataManager::resetTodayStats() {
   todayStats.avgStability = 0.0;
   todayStats.bestStability = 0.0;
   todayStats.totalBreaks = 0;
+  todayStats.stableTime = 0;
+  todayStats.medianStability = 0.0;
+  todayStats.p10Stability = 0.0;
+  todayStats.p90Stability = 0.0;
+  StabilityAggregator::clearHistogram(todayHistogram);
   // 日期信息由调用者设置
 }
 
@@ -421,6 +573,8 @@ void DataManager::rotateHistoryData() {
 
   // 将今日数据移到历史数据的第一位
   historyStats[0] = todayStats;
+  rollingStats.pushDay(RollingStats::summarize(todayStats, StabilityAggregator::histogramTotal(todayHistogram)));
+  saveRollingStats();
 
   // 重置今日数据
   todayStats.totalTime = 0;
@@ -428,6 +582,11 @@ void DataManager::rotateHistoryData() {
   todayStats.avgStability = 0.0;
   todayStats.bestStability = 0.0;
   todayStats.totalBreaks = 0;
+  todayStats.stableTime = 0;
+  todayStats.medianStability = 0.0;
+  todayStats.p10Stability = 0.0;
+  todayStats.p90Stability = 0.0;
+  StabilityAggregator::clearHistogram(todayHistogram);
 
   // 更新日期（这里简化处理）
   todayStats.year = 2024;
@@ -436,83 +595,200 @@ void DataManager::rotateHistoryData() {
 
   dataChanged = true;
   DEBUG_PRINTLN("历史数据已轮转，新的一天开始");
+  EventBus::publishStats();
 }
 
+// 汇总查询基于月窗口（含今日），均为O(1)
 unsigned long DataManager::getTotalPracticeTime() const {
-  unsigned long total = todayStats.totalTime;
-  for (int i = 0; i < MAX_HISTORY_DAYS; i++) {
-    total += historyStats[i].totalTime;
-  }
-  return total;
+  return getMonthStats().totalTime;
 }
 
 int DataManager::getTotalSessions() const {
-  int total = todayStats.sessionCount;
-  for (int i = 0; i < MAX_HISTORY_DAYS; i++) {
-    total += historyStats[i].sessionCount;
-  }
-  return total;
+  return getMonthStats().sessionCount;
 }
 
 float DataManager::getAverageStability() const {
-  float totalStability = 0.0;
-  int totalSessions = 0;
+  return getMonthStats().avgStability;
+}
 
-  if (todayStats.sessionCount > 0) {
-    totalStability += todayStats.avgStability * todayStats.sessionCount;
-    totalSessions += todayStats.sessionCount;
-  }
+float DataManager::getBestStability() const {
+  return getMonthStats().bestStability;
+}
 
-  for (int i = 0; i < MAX_HISTORY_DAYS; i++) {
-    if (historyStats[i].sessionCount > 0) {
-      totalStability += historyStats[i].avgStability * historyStats[i].sessionCount;
-      totalSessions += historyStats[i].sessionCount;
-    }
+int DataManager::getTotalBreaks() const {
+  return getMonthStats().totalBreaks;
+}
+
+PeriodStats DataManager::getWeekStats() const {
+  return rollingStats.getWeekStats(todayStats, StabilityAggregator::histogramTotal(todayHistogram));
+}
+
+PeriodStats DataManager::getMonthStats() const {
+  return rollingStats.getMonthStats(todayStats, StabilityAggregator::histogramTotal(todayHistogram));
+}
+
+void DataManager::getWeeklyStats(unsigned long& totalTime, int& totalSessions, float& avgStability) {
+  PeriodStats week = getWeekStats();
+  totalTime = week.totalTime;
+  totalSessions = week.sessionCount;
+  avgStability = week.avgStability;
+}
+
+void DataManager::getMonthlyStats(unsigned long& totalTime, int& totalSessions, float& avgStability) {
+  PeriodStats month = getMonthStats();
+  totalTime = month.totalTime;
+  totalSessions = month.sessionCount;
+  avgStability = month.avgStability;
+}
+
+const RollingStats& DataManager::getRollingStats() const {
+  return rollingStats;
+}
+
+void DataManager::captureResumeState(SessionResumeState& state) {
+  memset(&state, 0, sizeof(state));
+
+  // 休眠期间不算练习时间：先暂停，把时长结算进duration
+  state.sessionActive = isSessionActive();
+  if (state.sessionActive) {
+    pauseSession();
+    recorder.suspend();
+    state.session = currentSession;
+    state.aggregator = sessionAggregator.getState();
+    state.recordId = recorder.isRecording() ? recorder.getCurrentSessionId() : 0;
+    state.recordPoints = recorder.getPointCount();
+    state.recordBlocks = recorder.getBlockCount();
   }
 
-  return totalSessions > 0 ? totalStability / totalSessions : 0.0;
+  state.todayStats = todayStats;
+  state.todayHistogram = todayHistogram;
 }
 
-float DataManager::getBestStability() const {
-  float best = todayStats.bestStability;
-  for (int i = 0; i < MAX_HISTORY_DAYS; i++) {
-    if (historyStats[i].bestStability > best) {
-      best = historyStats[i].bestStability;
+void DataManager::restoreResumeState(const SessionResumeState& state) {
+  // 今日统计：EEPROM中是同一天的数据时以RTC快照为准 (休眠前落盘可能超时)
+  if (state.todayStats.year == todayStats.year &&
+      state.todayStats.month == todayStats.month &&
+      state.todayStats.day == todayStats.day) {
+    todayStats = state.todayStats;
+    todayHistogram = state.todayHistogram;
+  }
+
+  if (state.sessionActive) {
+    // millis()已从0重新计时，以当前时刻作为暂停点
+    currentSession = state.session;
+    unsigned long now = millis();
+    currentSession.startTime = now > 0 ? now : 1;
+    currentSession.endTime = currentSession.startTime;
+    currentSession.completed = false;
+    sessionAggregator.restoreState(state.aggregator);
+
+    if (state.recordId != 0) {
+      recorder.reattach(state.recordId, state.recordPoints, state.recordBlocks);
     }
+
+    DEBUG_INFO("DATA_MANAGER", "已恢复休眠前的会话 (已练习%lu ms)", currentSession.duration);
+    EventBus::publishSession(BUS_EVENT_SESSION_START, currentSession);
   }
-  return best;
+
+  dataChanged = true;
+  EventBus::publishStats();
 }
 
-int DataManager::getTotalBreaks() const {
-  int total = todayStats.totalBreaks;
-  for (int i = 0; i < MAX_HISTORY_DAYS; i++) {
-    total += historyStats[i].totalBreaks;
+bool DataManager::importData(const ImportBundle& bundle) {
+  if (bundle.hasSettings) {
+    settings = bundle.settings;
+  }
+  
+  if (bundle.dayCount > 0) {
+    todayStats = bundle.days[0];
+    for (int i = 0; i < MAX_HISTORY_DAYS; i++) {
+      historyStats[i] = bundle.days[i + 1];
+    }
+    
+    // 直方图不在导出范围内，以中位数所在档近似今日分布，保证后续加权正确
+    StabilityAggregator::clearHistogram(todayHistogram);
+    StabilityAggregator::addToHistogram(todayHistogram, todayStats.medianStability, todayStats.totalTime);
+  }
+  
+  if (bundle.rollingCount > 0) {
+    rollingStats.clear();
+    for (int i = 0; i < bundle.rollingCount; i++) {
+      rollingStats.pushDay(bundle.rollingDays[i]);
+    }
   }
-  return total;
+  
+  dataChanged = true;
+  saveData();
+  saveRollingStats();
+  
+  DEBUG_INFO("DATA_MANAGER", "数据导入完成: %d个日统计, %d天滚动统计",
+             bundle.dayCount, bundle.rollingCount);
+  if (bundle.hasSettings) {
+    EventBus::publishSettings(settings);
+  }
+  EventBus::publishStats();
+  return true;
 }
 
-void DataManager::getWeeklyStats(unsigned long& totalTime, int& totalSessions, float& avgStability) {
-  totalTime = 0;
-  totalSessions = 0;
-  float totalStability = 0.0;
-
-  // 包括今天
-  totalTime += todayStats.totalTime;
-  totalSessions += todayStats.sessionCount;
-  if (todayStats.sessionCount > 0) {
-    totalStability += todayStats.avgStability * todayStats.sessionCount;
-  }
-
-  // 过去6天
-  for (int i = 0; i < min(6, MAX_HISTORY_DAYS); i++) {
-    totalTime += historyStats[i].totalTime;
-    totalSessions += historyStats[i].sessionCount;
-    if (historyStats[i].sessionCount > 0) {
-      totalStability += historyStats[i].avgStability * historyStats[i].sessionCount;
+void DataManager::loadRollingStats() {
+  rollingStats.clear();
+  
+  RollingStatsHeader header = {};
+  File file;
+  if (recorder.isReady() && LittleFS.exists(ROLLING_STATS_FILE)) {
+    file = LittleFS.open(ROLLING_STATS_FILE, FILE_READ);
+  }
+  
+  if (file && file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+      header.magic == ROLLING_STATS_MAGIC && header.version == ROLLING_STATS_VERSION) {
+    // 按时间先后重放，重建窗口累计量
+    DaySummary day;
+    for (int i = 0; i < header.count; i++) {
+      if (file.read((uint8_t*)&day, sizeof(day)) != sizeof(day)) {
+        break;
+      }
+      rollingStats.pushDay(day);
+    }
+    file.close();
+    DEBUG_INFO("DATA_MANAGER", "滚动统计已加载: %d天", rollingStats.getDayCount());
+    return;
+  }
+  if (file) {
+    file.close();
+  }
+  
+  // 没有滚动统计文件（或版本不符）时，从7天历史数据初始化
+  // 历史数据未保存采样时长，以总时长近似
+  for (int i = MAX_HISTORY_DAYS - 1; i >= 0; i--) {
+    if (historyStats[i].year != 0) {
+      rollingStats.pushDay(RollingStats::summarize(historyStats[i], historyStats[i].totalTime));
     }
   }
+  DEBUG_INFO("DATA_MANAGER", "滚动统计从历史数据初始化: %d天", rollingStats.getDayCount());
+}
 
-  avgStability = totalSessions > 0 ? totalStability / totalSessions : 0.0;
+void DataManager::saveRollingStats() {
+  if (!recorder.isReady()) {
+    return;
+  }
+  
+  File file = LittleFS.open(ROLLING_STATS_FILE, FILE_WRITE);
+  if (!file) {
+    DEBUG_WARN("DATA_MANAGER", "滚动统计保存失败");
+    return;
+  }
+  
+  RollingStatsHeader header = {};
+  header.magic = ROLLING_STATS_MAGIC;
+  header.version = ROLLING_STATS_VERSION;
+  header.count = rollingStats.getDayCount();
+  file.write((const uint8_t*)&header, sizeof(header));
+  
+  // 按时间先后写入，最旧的在前
+  for (int i = rollingStats.getDayCount() - 1; i >= 0; i--) {
+    file.write((const uint8_t*)&rollingStats.getDay(i), sizeof(DaySummary));
+  }
+  file.close();
 }
 
 void DataManager::printSessionInfo() const {
@@ -523,15 +799,23 @@ void DataManager::printSessionInfo() const {
   DEBUG_PRINTF("平均稳定性: %.1f\n", currentSession.avgStability);
   DEBUG_PRINTF("最高稳定性: %.1f\n", currentSession.maxStability);
   DEBUG_PRINTF("最低稳定性: %.1f\n", currentSession.minStability);
+  DEBUG_PRINTF("分位数: P10 %.1f / 中位 %.1f / P90 %.1f\n",
+               currentSession.p10Stability, currentSession.medianStability, currentSession.p90Stability);
+  DEBUG_PRINTF("稳定时长: %lu ms\n", currentSession.stableTime);
   DEBUG_PRINTF("破定次数: %d\n", currentSession.breakCount);
+  DEBUG_PRINTF("曲线记录: 会话%lu, %lu点\n", (unsigned long)recorder.getCurrentSessionId(),
+               (unsigned long)recorder.getPointCount());
 }
 
 void DataManager::printTodayStats() const {
   DEBUG_PRINTLN("=== 今日统计 ===");
   DEBUG_PRINTF("练习次数: %d\n", todayStats.sessionCount);
-  DEBUG_PRINTF("总时长: %lu ms\n", todayStats.totalTime);
+  DEBUG_PRINTF("总时长: %lu ms\n", (unsigned long)todayStats.totalTime);
   DEBUG_PRINTF("平均稳定性: %.1f\n", todayStats.avgStability);
   DEBUG_PRINTF("最佳稳定性: %.1f\n", todayStats.bestStability);
+  DEBUG_PRINTF("分位数: P10 %.1f / 中位 %.1f / P90 %.1f\n",
+               todayStats.p10Stability, todayStats.medianStability, todayStats.p90Stability);
+  DEBUG_PRINTF("稳定时长: %lu ms\n", (unsigned long)todayStats.stableTime);
   DEBUG_PRINTF("破定次数: %d\n", todayStats.totalBreaks);
 }
 
@@ -540,6 +824,9 @@ void DataManager::printSettings() const {
   DEBUG_PRINTF("稳定性阈值: %.1f\n", settings.stabilityThreshold);
   DEBUG_PRINTF("声音开启: %s\n", settings.soundEnabled ? "是" : "否");
   DEBUG_PRINTF("显示亮度: %d\n", settings.displayBrightness);
-  DEBUG_PRINTF("练习时长: %lu ms\n", settings.practiceTime);
+  DEBUG_PRINTF("练习时长: %lu ms\n", (unsigned long)settings.practiceTime);
   DEBUG_PRINTF("自动休眠: %s\n", settings.autoSleep ? "是" : "否");
+  DEBUG_PRINTF("休眠超时: %lu ms\n", (unsigned long)settings.sleepTimeout);
+  DEBUG_PRINTF("自动校准: %s\n", settings.calibrationEnabled ? "是" : "否");
+  DEBUG_PRINTF("语言: %s\n", settings.language == 0 ? "中文" : "英文");
 }
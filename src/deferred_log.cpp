@@ -0,0 +1,257 @@
+#include "deferred_log.h"
+#include "memory_monitor.h"
+
+static_assert((DEFERRED_LOG_BUFFER_SIZE & (DEFERRED_LOG_BUFFER_SIZE - 1)) == 0,
+              "DEFERRED_LOG_BUFFER_SIZE必须是2的幂");
+static_assert(DEFERRED_LOG_MAX_RECORD <= 255, "记录长度用一个字节表示");
+
+// 格式串校验: 解码工具读取ELF中该地址的字符串，不一致说明ELF与固件不匹配
+static const char logSentinel[] = "ZENLOG1";
+
+// ==================== LogRecord ====================
+LogRecord::LogRecord(uint8_t level, const char* module, const char* format, uint32_t timestamp) {
+  length = 0;
+  data[length++] = 0;   // 总长度在size()之前更新
+  data[length++] = level;
+  putU32(timestamp);
+  putU32((uint32_t)(uintptr_t)module);
+  putU32((uint32_t)(uintptr_t)format);
+  data[0] = length;
+}
+
+void LogRecord::putU32(uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    data[length++] = (uint8_t)(value >> (8 * i));
+  }
+}
+
+bool LogRecord::reserve(uint8_t size) {
+  if (length + size > DEFERRED_LOG_MAX_RECORD) {
+    data[1] |= LOG_LEVEL_TRUNCATED;
+    return false;
+  }
+  return true;
+}
+
+void LogRecord::addInt(uint32_t value) {
+  if (!reserve(5)) return;
+  data[length++] = LOG_TAG_INT;
+  putU32(value);
+  data[0] = length;
+}
+
+void LogRecord::addInt64(uint64_t value) {
+  if (!reserve(9)) return;
+  data[length++] = LOG_TAG_INT64;
+  putU32((uint32_t)value);
+  putU32((uint32_t)(value >> 32));
+  data[0] = length;
+}
+
+void LogRecord::addDouble(double value) {
+  if (!reserve(9)) return;
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  data[length++] = LOG_TAG_DOUBLE;
+  putU32((uint32_t)bits);
+  putU32((uint32_t)(bits >> 32));
+  data[0] = length;
+}
+
+void LogRecord::addString(const char* value) {
+  if (value == nullptr) {
+    value = "(null)";
+  }
+  size_t len = strnlen(value, DEFERRED_LOG_MAX_STRING);
+  if (length + 2 + len > DEFERRED_LOG_MAX_RECORD) {
+    // 放不下时截断字符串，而不是丢弃后续参数的类型信息
+    data[1] |= LOG_LEVEL_TRUNCATED;
+    if (length + 2 > DEFERRED_LOG_MAX_RECORD) return;
+    len = DEFERRED_LOG_MAX_RECORD - length - 2;
+  } else if (value[len] != '\0') {
+    data[1] |= LOG_LEVEL_TRUNCATED;
+  }
+  data[length++] = LOG_TAG_STRING;
+  data[length++] = (uint8_t)len;
+  memcpy(data + length, value, len);
+  length += len;
+  data[0] = length;
+}
+
+void LogRecord::addPointer(const void* value) {
+  if (!reserve(5)) return;
+  data[length++] = LOG_TAG_POINTER;
+  putU32((uint32_t)(uintptr_t)value);
+  data[0] = length;
+}
+
+// ==================== LogRing ====================
+bool LogRing::push(const uint8_t* record, uint8_t length) {
+  portENTER_CRITICAL_SAFE(&lock);
+  uint32_t used = head - tail;
+  if (DEFERRED_LOG_BUFFER_SIZE - used < length) {
+    dropped++;
+    portEXIT_CRITICAL_SAFE(&lock);
+    return false;
+  }
+
+  uint32_t index = head & (DEFERRED_LOG_BUFFER_SIZE - 1);
+  uint32_t first = min((uint32_t)length, DEFERRED_LOG_BUFFER_SIZE - index);
+  memcpy(buffer + index, record, first);
+  memcpy(buffer, record + first, length - first);
+  head = head + length;
+  pushed++;
+  if (used + length > highWater) {
+    highWater = used + length;
+  }
+  portEXIT_CRITICAL_SAFE(&lock);
+  return true;
+}
+
+uint8_t LogRing::pop(uint8_t* record) {
+  // 只有消费者修改tail；head在记录完整写入后才前移
+  if (head == tail) {
+    return 0;
+  }
+
+  uint32_t index = tail & (DEFERRED_LOG_BUFFER_SIZE - 1);
+  uint8_t length = buffer[index];
+  uint32_t first = min((uint32_t)length, DEFERRED_LOG_BUFFER_SIZE - index);
+  memcpy(record, buffer + index, first);
+  memcpy(record + first, buffer, length - first);
+  tail = tail + length;
+  return length;
+}
+
+uint32_t LogRing::takeDropped() {
+  portENTER_CRITICAL_SAFE(&lock);
+  uint32_t count = dropped - reportedDropped;
+  reportedDropped = dropped;
+  portEXIT_CRITICAL_SAFE(&lock);
+  return count;
+}
+
+uint32_t LogRing::getUsed() const {
+  return head - tail;
+}
+
+uint32_t LogRing::getHighWater() const {
+  return highWater;
+}
+
+uint32_t LogRing::getPushedCount() const {
+  return pushed;
+}
+
+uint32_t LogRing::getDroppedCount() const {
+  return dropped;
+}
+
+// ==================== DeferredLog ====================
+LogRing DeferredLog::ring;
+TaskHandle_t DeferredLog::task = nullptr;
+SemaphoreHandle_t DeferredLog::drainLock = nullptr;
+
+bool DeferredLog::begin() {
+  if (task != nullptr) {
+    return true;
+  }
+
+  // 告诉解码工具校验串的地址，用于确认ELF与固件匹配
+  Serial.printf("@LS %08lx\n", (unsigned long)(uintptr_t)logSentinel);
+
+  drainLock = xSemaphoreCreateMutex();
+  if (drainLock == nullptr ||
+      xTaskCreate(taskMain, "log_drain", DEFERRED_LOG_TASK_STACK, nullptr,
+                  DEFERRED_LOG_TASK_PRIORITY, &task) != pdPASS) {
+    // 没有输出任务时记录留在缓冲中，只能由flush()输出
+    task = nullptr;
+    Serial.println("延迟日志输出任务创建失败");
+    return false;
+  }
+  MemoryMonitor::registerTask(task, "log_drain");
+  return true;
+}
+
+void DeferredLog::taskMain(void*) {
+  for (;;) {
+    drain(false);
+    vTaskDelay(pdMS_TO_TICKS(DEFERRED_LOG_DRAIN_INTERVAL));
+  }
+}
+
+bool DeferredLog::writeLine(const char* prefix, const uint8_t* data, uint8_t length, bool blocking) {
+  static const char hexDigits[] = "0123456789abcdef";
+  char line[4 + DEFERRED_LOG_MAX_RECORD * 2 + 1];
+  size_t n = 0;
+  while (*prefix) {
+    line[n++] = *prefix++;
+  }
+  for (uint8_t i = 0; i < length; i++) {
+    line[n++] = hexDigits[data[i] >> 4];
+    line[n++] = hexDigits[data[i] & 0x0F];
+  }
+  line[n++] = '\n';
+
+  // 后台输出不等待串口：发送缓冲放不下整行时留到下一轮 (USB串口未连接时记录会被丢弃计数)
+  if (!blocking && Serial.availableForWrite() < (int)n) {
+    return false;
+  }
+  Serial.write((const uint8_t*)line, n);
+  return true;
+}
+
+void DeferredLog::drain(bool blocking) {
+  if (drainLock != nullptr) {
+    xSemaphoreTake(drainLock, portMAX_DELAY);
+  }
+
+  uint32_t lost = ring.takeDropped();
+  if (lost > 0) {
+    uint8_t count[4] = {(uint8_t)lost, (uint8_t)(lost >> 8), (uint8_t)(lost >> 16), (uint8_t)(lost >> 24)};
+    writeLine("@LD ", count, sizeof(count), true);
+  }
+
+  uint8_t record[DEFERRED_LOG_MAX_RECORD];
+  static uint8_t pendingLength = 0;
+  static uint8_t pending[DEFERRED_LOG_MAX_RECORD];
+  for (;;) {
+    // 上一轮因串口繁忙没有输出的记录先输出
+    uint8_t length = pendingLength;
+    const uint8_t* data = pending;
+    if (length == 0) {
+      length = ring.pop(record);
+      data = record;
+      if (length == 0) {
+        break;
+      }
+    }
+    if (!writeLine("@LG ", data, length, blocking)) {
+      if (data != pending) {
+        memcpy(pending, data, length);
+      }
+      pendingLength = length;
+      break;
+    }
+    pendingLength = 0;
+  }
+
+  if (drainLock != nullptr) {
+    xSemaphoreGive(drainLock);
+  }
+}
+
+void DeferredLog::flush() {
+  drain(true);
+  Serial.flush();
+}
+
+LogRing& DeferredLog::getRing() {
+  return ring;
+}
+
+void DeferredLog::printStats() {
+  DEBUG_INFO("LOG", "延迟日志: 写入 %lu 条, 丢弃 %lu 条, 缓冲最大占用 %lu/%d 字节",
+             (unsigned long)ring.getPushedCount(), (unsigned long)ring.getDroppedCount(),
+             (unsigned long)ring.getHighWater(), DEFERRED_LOG_BUFFER_SIZE);
+}
@@ -1,4 +1,8 @@
 #include "diagnostic_utils.h"
+#include "persistence_worker.h"
+#include "loop_scheduler.h"
+#include "audio_sequencer.h"
+#include "memory_monitor.h"
 #include <esp_system.h>
 #include <esp_chip_info.h>
 
@@ -22,11 +26,6 @@ DiagnosticStatus g_diagnosticStatus = {
   .lastDiagnosticTime = 0
 };
 
-// 性能计时器数组
-#define MAX_PERFORMANCE_TIMERS 10
-static PerformanceTimer performanceTimers[MAX_PERFORMANCE_TIMERS];
-static int performanceTimerCount = 0;
-
 void DiagnosticUtils::initialize() {
   DEBUG_INFO("DIAGNOSTIC", "初始化诊断系统...");
   
@@ -80,17 +79,28 @@ void DiagnosticUtils::printMemoryInfo() {
   DEBUG_INFO("MEMORY", "PSRAM: 不适用于ESP32-C3");
 }
 
-void DiagnosticUtils::periodicSystemReport() {
+bool DiagnosticUtils::periodicSystemReport() {
   uint32_t currentTime = millis();
   if (currentTime - lastSystemReport >= systemReportInterval) {
+    HEAP_TAG_SCOPE(HEAP_TAG_LOG);
     DEBUG_INFO("PERIODIC", "=== 定期系统报告 ===");
     DEBUG_INFO("PERIODIC", "运行时间: %s", formatUptime(currentTime).c_str());
     printMemoryInfo();
+    MemoryMonitor::sample();
+    MemoryMonitor::printReport();
     DEBUG_INFO("PERIODIC", "错误计数: %d, 警告计数: %d", 
                g_diagnosticStatus.errorCount, g_diagnosticStatus.warningCount);
+    PersistenceWorker::printStats();
+    LoopScheduler::printStats();
+    PerfTimers::printStats();
+#if DEBUG && DEBUG_DEFERRED_LOG
+    DeferredLog::printStats();
+#endif
     
     lastSystemReport = currentTime;
+    return true;
   }
+  return false;
 }
 
 bool DiagnosticUtils::scanI2CBus() {
@@ -334,15 +344,13 @@ void DiagnosticUtils::printPowerStatus() {
 void DiagnosticUtils::playErrorSequence() {
   DEBUG_INFO("AUDIO", "播放错误音序列");
 
-  for (int i = 0; i < ERROR_TONE_COUNT; i++) {
-    tone(BUZZER_PIN, ERROR_TONE_FREQUENCY, ERROR_TONE_DURATION);
-    delay(ERROR_TONE_DURATION + ERROR_TONE_INTERVAL);
-  }
+  // 由定时器推进，不阻塞调用者 (reportError可能在主循环中调用)
+  AudioSequencer::play(SOUND_ERROR_ALERT);
 }
 
 void DiagnosticUtils::reportError(const char* module, const char* error) {
   g_diagnosticStatus.errorCount++;
-  DEBUG_ERROR(module, "%s", error);
+  DEBUG_LOG_DYNAMIC(DEBUG_LEVEL_ERROR, module, "%s", error);
 
   // 播放错误音（如果启用）
   #if DIAGNOSTIC_MODE_ENABLED
@@ -352,7 +360,7 @@ void DiagnosticUtils::reportError(const char* module, const char* error) {
 
 void DiagnosticUtils::reportWarning(const char* module, const char* warning) {
   g_diagnosticStatus.warningCount++;
-  DEBUG_WARN(module, "%s", warning);
+  DEBUG_LOG_DYNAMIC(DEBUG_LEVEL_WARN, module, "%s", warning);
 }
 
 String DiagnosticUtils::formatBytes(size_t bytes) {
@@ -382,58 +390,6 @@ String DiagnosticUtils::formatUptime(unsigned long ms) {
   }
 }
 
-void DiagnosticUtils::startPerformanceTimer(const char* name) {
-  if (performanceTimerCount >= MAX_PERFORMANCE_TIMERS) {
-    DEBUG_WARN("PERF", "性能计时器数量已达上限");
-    return;
-  }
-
-  // 查找现有计时器或创建新的
-  for (int i = 0; i < performanceTimerCount; i++) {
-    if (strcmp(performanceTimers[i].name, name) == 0) {
-      performanceTimers[i].startTime = micros();
-      return;
-    }
-  }
-
-  // 创建新计时器
-  performanceTimers[performanceTimerCount].name = name;
-  performanceTimers[performanceTimerCount].startTime = micros();
-  performanceTimers[performanceTimerCount].totalTime = 0;
-  performanceTimers[performanceTimerCount].callCount = 0;
-  performanceTimerCount++;
-}
-
-void DiagnosticUtils::endPerformanceTimer(const char* name) {
-  unsigned long endTime = micros();
-
-  for (int i = 0; i < performanceTimerCount; i++) {
-    if (strcmp(performanceTimers[i].name, name) == 0) {
-      unsigned long duration = endTime - performanceTimers[i].startTime;
-      performanceTimers[i].totalTime += duration;
-      performanceTimers[i].callCount++;
-      return;
-    }
-  }
-
-  DEBUG_WARN("PERF", "未找到性能计时器: %s", name);
-}
-
-void DiagnosticUtils::printPerformanceStats() {
-  DEBUG_INFO("PERF", "=== 性能统计 ===");
-
-  for (int i = 0; i < performanceTimerCount; i++) {
-    if (performanceTimers[i].callCount > 0) {
-      unsigned long avgTime = performanceTimers[i].totalTime / performanceTimers[i].callCount;
-      DEBUG_INFO("PERF", "%s: 调用%d次, 总时间%luμs, 平均%luμs",
-                 performanceTimers[i].name,
-                 performanceTimers[i].callCount,
-                 performanceTimers[i].totalTime,
-                 avgTime);
-    }
-  }
-}
-
 bool DiagnosticUtils::diagnoseOLED() {
   DEBUG_INFO("OLED", "=== OLED显示屏诊断 ===");
 
@@ -652,7 +608,7 @@ bool DiagnosticUtils::testInputOutput() {
 }
 
 void DiagnosticUtils::hexDump(const uint8_t* data, size_t length) {
-  DEBUG_DEBUG("HEXDUMP", "数据长度: %d 字节", length);
+  DEBUG_DEBUG("HEXDUMP", "数据长度: %u 字节", (unsigned)length);
 
   for (size_t i = 0; i < length; i += 16) {
     char line[80];
@@ -1,6 +1,10 @@
 #include "display_manager.h"
 #include "diagnostic_utils.h"
 #include "data_manager.h"
+#include "energy_profiler.h"
+#include "perf_timer.h"
+#include "memory_monitor.h"
+#include "event_bus.h"
 
 DisplayManager::DisplayManager() : display(U8G2_R0, /* reset=*/ U8X8_PIN_NONE) {
   currentPage = PAGE_BOOT_ANIMATION;
@@ -21,11 +25,12 @@ DisplayManager::DisplayManager() : display(U8G2_R0, /* reset=*/ U8X8_PIN_NONE) {
   lastMenuScroll = 0;
 }
 
-bool DisplayManager::initialize() {
+bool DisplayManager::initialize(bool fastResume) {
   DEBUG_INFO("DISPLAY", "开始初始化OLED显示屏...");
 
-  // 执行OLED专项诊断
-  if (!DiagnosticUtils::diagnoseOLED()) {
+  // 先快速探测OLED，无响应时才执行完整诊断 (全总线扫描耗时1秒以上)
+  // 休眠唤醒时屏幕刚刚还在工作，直接跳过
+  if (!fastResume && !DiagnosticUtils::testI2CDevice(OLED_ADDRESS) && !DiagnosticUtils::diagnoseOLED()) {
     DEBUG_ERROR("DISPLAY", "OLED诊断失败，尝试恢复...");
 
     // 尝试不同的I2C时钟速度
@@ -91,8 +96,17 @@ bool DisplayManager::initialize() {
 
 
   
-  // 启动开机动画
-  startBootAnimation();
+  // 启动开机动画 (休眠唤醒时直接回到休眠前的页面)
+  if (!fastResume) {
+    startBootAnimation();
+  }
+
+  // 显示的数据变化时才重绘
+  EventBus::subscribe(EventBus::mask(BUS_EVENT_SCORE) | EventBus::mask(BUS_EVENT_BREAK) |
+                      EventBus::mask(BUS_EVENT_SESSION_START) | EventBus::mask(BUS_EVENT_SESSION_STOP) |
+                      EventBus::mask(BUS_EVENT_STATS) | EventBus::mask(BUS_EVENT_BATTERY) |
+                      EventBus::mask(BUS_EVENT_SETTINGS),
+                      onBusEvent, this);
 
   isInitialized = true;
   g_diagnosticStatus.oledWorking = true;
@@ -139,19 +153,50 @@ void DisplayManager::previousPage() {
   setPage(prevPage);
 }
 
+void DisplayManager::onBusEvent(const BusEvent& event, void* context) {
+  DisplayManager* self = static_cast<DisplayManager*>(context);
+  if (event.type == BUS_EVENT_SCORE) {
+    // 评分只在主页面以整数显示；稳定状态决定所有页面上的破定提醒
+    int score = (int)event.stability->score;
+    bool stable = event.stability->isStable;
+    if (stable != self->shownStable || (score != self->shownScore && self->currentPage == PAGE_MAIN)) {
+      self->needsUpdate = true;
+    }
+    self->shownScore = score;
+    self->shownStable = stable;
+  } else {
+    self->needsUpdate = true;
+  }
+}
+
+bool DisplayManager::isAnimating(const ZenMotionData& data) const {
+  return currentPage == PAGE_BOOT_ANIMATION ||
+         currentPage == PAGE_CALIBRATION ||
+         !data.stability.isStable ||                        // 破定提醒闪烁
+         (currentPage == PAGE_MAIN && data.status.currentState == STATE_PRACTICING);  // 练习计时
+}
+
 void DisplayManager::update(const ZenMotionData& data) {
   if (!isInitialized || !displayData.isOn) return;
   
-  // 检查是否需要更新
+  // 内容变化 (事件、按键、页面或状态切换) 时立即重绘；
+  // 有动画时按刷新间隔重绘，静止的页面只做低频兜底刷新
   unsigned long currentTime = millis();
-  if (!needsUpdate && (currentTime - lastUpdate) < DISPLAY_UPDATE_INTERVAL) {
+  if (data.status.currentState != shownState) {
+    needsUpdate = true;
+  }
+  unsigned long interval = isAnimating(data) ? DISPLAY_UPDATE_INTERVAL : DISPLAY_IDLE_REFRESH_INTERVAL;
+  if (!needsUpdate && (currentTime - lastUpdate) < interval) {
     return;
   }
+  PERF_SCOPE("DISPLAY_UPDATE");
+  HEAP_TAG_SCOPE(HEAP_TAG_DISPLAY);
   
   // 更新动画
   updateAnimation();
 
-  // 使用firstPage/nextPage循环进行显示
+  // 使用firstPage/nextPage循环进行显示，nextPage()发送当前页
+  bool morePages;
   display.firstPage();
   do {
     // 根据当前页面绘制内容
@@ -177,6 +222,9 @@ void DisplayManager::update(const ZenMotionData& data) {
       case PAGE_HISTORY:
         drawHistoryPage(data);
         break;
+      case PAGE_ENERGY:
+        drawEnergyPage(data);
+        break;
     }
 
     // 绘制状态图标
@@ -186,10 +234,15 @@ void DisplayManager::update(const ZenMotionData& data) {
     if (!data.stability.isStable) {
       drawBreakWarning();
     }
-  } while (display.nextPage());
+
+    uint32_t transferStartUs = micros();
+    morePages = display.nextPage();
+    busTimeUs += micros() - transferStartUs;
+  } while (morePages);
   
   lastUpdate = currentTime;
   needsUpdate = false;
+  shownState = data.status.currentState;
 }
 
 void DisplayManager::forceUpdate() {
@@ -200,6 +253,12 @@ bool DisplayManager::needsRefresh() const {
   return needsUpdate;
 }
 
+uint32_t DisplayManager::takeBusTimeUs() {
+  uint32_t us = busTimeUs;
+  busTimeUs = 0;
+  return us;
+}
+
 void DisplayManager::setBrightness(uint8_t brightness) {
   displayData.brightness = brightness;
   // u8g2设置对比度
@@ -610,31 +669,67 @@ void DisplayManager::drawHistoryPage(const ZenMotionData& data) {
   // 绘制分隔线
   display.drawHLine(0, 37, SCREEN_WIDTH);
   
-  // 本周统计标题
-  display.drawStr(2, 47, "Week Summary:");
-  
-  // 计算本周数据（简化版，显示最近7天累计）
-  unsigned long weekTotalTime = data.todayStats.totalTime;
-  int weekSessions = data.todayStats.sessionCount;
-  float weekAvgScore = data.todayStats.avgStability;
-  
-  // 如果有历史数据访问，这里应该累加历史数据
-  // 目前简化处理，只显示今日数据作为示例
+  // 近7天统计（由DataManager增量维护，这里只读取）
+  String weekTime = "7d: " + formatTime(data.weekStats.totalTime) +
+                    " " + String(data.weekStats.activeDays) + "d";
+  display.drawStr(2, 47, weekTime.c_str());
   
-  // 本周练习时长
-  String weekTime = "Time: " + formatTime(weekTotalTime);
-  display.drawStr(2, 57, weekTime.c_str());
+  // 近7天练习次数和平均分
+  String weekStats = "Sess:" + String(data.weekStats.sessionCount) + 
+                     " Avg:" + formatScore(data.weekStats.avgStability);
+  display.drawStr(2, 56, weekStats.c_str());
   
-  // 本周练习次数和平均分
-  String weekStats = "Sess:" + String(weekSessions) + 
-                     " Avg:" + formatScore(weekAvgScore);
-  display.drawStr(2, 64, weekStats.c_str());
+  // 近30天练习时长和平均分
+  String monthStats = "30d: " + formatTime(data.monthStats.totalTime) +
+                      " Avg:" + formatScore(data.monthStats.avgStability);
+  display.drawStr(2, 64, monthStats.c_str());
   
   // 在右上角显示日期（如果有RTC的话）
   // display.setFont(u8g2_font_5x7_tf);
   // display.drawStr(SCREEN_WIDTH - 35, 8, "12/07");
 }
 
+void DisplayManager::drawEnergyPage(const ZenMotionData& data) {
+  // 标题 - 使用中文字体并居中
+  display.setFont(u8g2_font_wqy12_t_gb2312);
+  String title = "功耗统计";
+  int titleWidth = display.getUTF8Width(title.c_str());
+  int titleX = (SCREEN_WIDTH - titleWidth) / 2;
+  if (titleX < 0) titleX = 0;
+  display.drawUTF8(titleX, 12, title.c_str());
+
+  display.drawHLine(0, 14, SCREEN_WIDTH);
+  display.setFont(u8g2_font_6x10_tf);
+
+  const EnergyReport& energy = data.energy;
+  if (energy.totalMs == 0) {
+    display.drawStr(2, 30, "No data");
+    return;
+  }
+
+  // 总平均电流和剩余练习时间
+  float average = EnergyProfiler::averageCurrent(energy.totalMah, energy.totalMs);
+  String line1 = "Avg:" + String(average, 1) + "mA " + String(data.status.remainingMinutes) + "min";
+  display.drawStr(2, 24, line1.c_str());
+
+  // 各部件平均电流 (mA)
+  String line2 = "CPU:" + String(EnergyProfiler::averageCurrent(energy.consumerMah[ENERGY_CPU], energy.totalMs), 1) +
+                 " OLED:" + String(EnergyProfiler::averageCurrent(energy.consumerMah[ENERGY_DISPLAY], energy.totalMs), 1);
+  display.drawStr(2, 34, line2.c_str());
+  String line3 = "IMU:" + String(EnergyProfiler::averageCurrent(energy.consumerMah[ENERGY_IMU], energy.totalMs), 1) +
+                 " Bz:" + String(EnergyProfiler::averageCurrent(energy.consumerMah[ENERGY_BUZZER], energy.totalMs), 2);
+  display.drawStr(2, 44, line3.c_str());
+
+  display.drawHLine(0, 47, SCREEN_WIDTH);
+
+  // 练习状态与CPU占空比
+  float practice = EnergyProfiler::averageCurrent(energy.stateMah[STATE_PRACTICING], energy.stateMs[STATE_PRACTICING]);
+  String line4 = "Prac:" + String(practice, 1) + "mA";
+  display.drawStr(2, 56, line4.c_str());
+  String line5 = "CPU duty:" + String(energy.consumerOnMs[ENERGY_CPU] * 100.0f / energy.totalMs, 1) + "%";
+  display.drawStr(2, 64, line5.c_str());
+}
+
 void DisplayManager::drawStabilityScore(int x, int y, float score, bool isStable) {
   display.setFont(u8g2_font_logisoso32_tn);
   String scoreText = String((int)score);
@@ -665,11 +760,8 @@ void DisplayManager::drawProgressBar(int x, int y, int width, int height, float
   }
 }
 
-void DisplayManager::drawBatteryIcon(int x, int y, float voltage, bool isCharging) {
-  // 计算电池电量百分比
-  float percentage = (voltage - 3.0) / (4.2 - 3.0) * 100.0;
+void DisplayManager::drawBatteryIcon(int x, int y, uint8_t percentage, bool isCharging) {
   if (percentage > 100) percentage = 100;
-  if (percentage < 0) percentage = 0;
 
   // 绘制电池外框
   display.drawFrame(x, y, 12, 6);
@@ -691,7 +783,7 @@ void DisplayManager::drawBatteryIcon(int x, int y, float voltage, bool isChargin
 
 void DisplayManager::drawStatusIcons(const ZenMotionData& data) {
   // 绘制电池图标
-  drawBatteryIcon(SCREEN_WIDTH - 20, 0, data.status.batteryVoltage, false);
+  drawBatteryIcon(SCREEN_WIDTH - 20, 0, data.status.batteryPercent, false);
 
   // 如果有错误，显示错误图标
   if (data.status.sensorError || data.status.displayError) {
@@ -836,7 +928,26 @@ bool DisplayManager::isBootAnimationActive() const {
 
 bool DisplayManager::isBootAnimationComplete() const {
   if (!bootAnimationActive) return true;
-  return (millis() - bootAnimationStartTime) >= BOOT_ANIMATION_DURATION;
+  return (millis() - bootAnimationStartTime) >= getBootAnimationDuration();
+}
+
+unsigned long DisplayManager::getBootAnimationDuration() const {
+  // 初始化完成前按最长时间展示进度，完成后缩短到最短展示时间
+  return bootReady ? BOOT_ANIMATION_MIN_DURATION : BOOT_ANIMATION_DURATION;
+}
+
+void DisplayManager::setBootReady() {
+  bootReady = true;
+  needsUpdate = true;
+}
+
+void DisplayManager::skipBootAnimation() {
+  if (!bootAnimationActive || !bootReady) {
+    return;
+  }
+
+  bootAnimationActive = false;
+  DEBUG_INFO("DISPLAY", "开机动画已跳过");
 }
 
 // ==================== 主菜单管理 ====================
@@ -880,8 +991,10 @@ void DisplayManager::drawBootAnimationPage(const ZenMotionData& data) {
     lastAnimationUpdate = currentTime;
   }
 
+  unsigned long duration = getBootAnimationDuration();
+
   // 检查动画是否完成
-  if (elapsed >= BOOT_ANIMATION_DURATION) {
+  if (elapsed >= duration) {
     bootAnimationActive = false;
     // 不在这里切换页面，由主程序统一管理状态
     DEBUG_INFO("DISPLAY", "开机动画完成");
@@ -889,7 +1002,7 @@ void DisplayManager::drawBootAnimationPage(const ZenMotionData& data) {
   }
 
   // 计算进度百分比，确保范围在0-100之间
-  int progress = (elapsed * 100) / BOOT_ANIMATION_DURATION;
+  int progress = (elapsed * 100) / duration;
   if (progress > 100) progress = 100;
   if (progress < 0) progress = 0;
 
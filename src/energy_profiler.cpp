@@ -0,0 +1,117 @@
+#include "energy_profiler.h"
+
+static const char* const consumerNames[ENERGY_CONSUMER_COUNT] = {
+  "CPU", "显示", "IMU", "蜂鸣器", "常开"
+};
+
+EnergyProfiler::EnergyProfiler() {
+  for (uint8_t i = 0; i < ENERGY_CONSUMER_COUNT; i++) {
+    active[i] = false;
+    level[i] = 255;
+  }
+  // CPU和常开部分在运行期间始终计入
+  active[ENERGY_CPU] = true;
+  active[ENERGY_BOARD] = true;
+}
+
+void EnergyProfiler::begin(uint32_t nowMs) {
+  lastAccountMs = nowMs;
+  pendingBusyUs = 0;
+  report = {};
+}
+
+float EnergyProfiler::consumerCurrent(uint8_t consumer) const {
+  switch (consumer) {
+    case ENERGY_DISPLAY:
+      return ENERGY_DISPLAY_BASE_MA + (ENERGY_DISPLAY_FULL_MA - ENERGY_DISPLAY_BASE_MA) * level[consumer] / 255.0f;
+    case ENERGY_IMU:
+      return ENERGY_IMU_MA;
+    case ENERGY_BUZZER:
+      return ENERGY_BUZZER_MA * level[consumer] / 255.0f;
+    case ENERGY_BOARD:
+      return ENERGY_BOARD_MA;
+    default:
+      return 0.0f;
+  }
+}
+
+float EnergyProfiler::averageCurrent(float mah, uint32_t ms) {
+  return ms > 0 ? mah * 3600000.0f / ms : 0.0f;
+}
+
+void EnergyProfiler::account(uint32_t nowMs) {
+  uint32_t elapsed = nowMs - lastAccountMs;
+  if (elapsed == 0) {
+    return;
+  }
+  lastAccountMs = nowMs;
+
+  float periodMah = 0;
+  for (uint8_t i = 0; i < ENERGY_CONSUMER_COUNT; i++) {
+    if (i == ENERGY_CPU || !active[i]) {
+      continue;
+    }
+    float mah = consumerCurrent(i) * elapsed / 3600000.0f;
+    report.consumerOnMs[i] += elapsed;
+    report.consumerMah[i] += mah;
+    periodMah += mah;
+  }
+
+  // CPU: 忙碌部分按当前频率的运行电流，其余按空闲或轻度睡眠电流
+  // 忙碌时间在循环结束时才上报，超出本时间段的部分留到下一段
+  uint32_t busyMs = (uint32_t)min((uint64_t)elapsed, pendingBusyUs / 1000);
+  pendingBusyUs -= (uint64_t)busyMs * 1000;
+  float activeMa = ENERGY_CPU_BASE_MA + ENERGY_CPU_MA_PER_MHZ * cpuFreqMhz;
+  float idleMa = lightSleep ? ENERGY_LIGHT_SLEEP_MA : ENERGY_CPU_IDLE_MA;
+  float cpuMah = (activeMa * busyMs + idleMa * (elapsed - busyMs)) / 3600000.0f;
+  report.consumerOnMs[ENERGY_CPU] += busyMs;
+  report.consumerMah[ENERGY_CPU] += cpuMah;
+  periodMah += cpuMah;
+
+  report.stateMs[state] += elapsed;
+  report.stateMah[state] += periodMah;
+  report.totalMs += elapsed;
+  report.totalMah += periodMah;
+}
+
+void EnergyProfiler::setState(uint8_t systemState, uint32_t nowMs) {
+  if (systemState >= SYSTEM_STATE_COUNT || systemState == state) {
+    return;
+  }
+  account(nowMs);
+  state = systemState;
+}
+
+void EnergyProfiler::setConsumer(EnergyConsumer consumer, bool on, uint8_t consumerLevel, uint32_t nowMs) {
+  if (consumer >= ENERGY_CONSUMER_COUNT || consumer == ENERGY_CPU) {
+    return;
+  }
+  if (active[consumer] == on && level[consumer] == consumerLevel) {
+    return;
+  }
+  account(nowMs);
+  active[consumer] = on;
+  level[consumer] = consumerLevel;
+}
+
+void EnergyProfiler::setCpuOperatingPoint(uint16_t freqMhz, bool lightSleepEnabled, uint32_t nowMs) {
+  if (freqMhz == cpuFreqMhz && lightSleepEnabled == lightSleep) {
+    return;
+  }
+  account(nowMs);
+  cpuFreqMhz = freqMhz;
+  lightSleep = lightSleepEnabled;
+}
+
+void EnergyProfiler::addCpuBusy(uint32_t busyUs) {
+  pendingBusyUs += busyUs;
+}
+
+EnergyReport EnergyProfiler::getReport(uint32_t nowMs) {
+  account(nowMs);
+  return report;
+}
+
+const char* EnergyProfiler::getConsumerName(uint8_t consumer) {
+  return consumer < ENERGY_CONSUMER_COUNT ? consumerNames[consumer] : "?";
+}
@@ -0,0 +1,103 @@
+#include "event_bus.h"
+
+static_assert(BUS_EVENT_COUNT <= 16, "事件订阅掩码为16位");
+
+static const char* const eventNames[BUS_EVENT_COUNT] = {
+  "评分", "破定", "会话开始", "会话结束", "统计", "电池", "设置"
+};
+
+EventBus::Subscriber EventBus::subscribers[EVENT_BUS_MAX_SUBSCRIBERS];
+uint8_t EventBus::subscriberCount = 0;
+uint32_t EventBus::publishCount[BUS_EVENT_COUNT];
+uint32_t EventBus::deliveryCount = 0;
+
+// ==================== 订阅 ====================
+bool EventBus::subscribe(uint16_t eventMask, BusHandler handler, void* context) {
+  if (handler == nullptr || eventMask == 0) {
+    return false;
+  }
+  if (subscriberCount >= EVENT_BUS_MAX_SUBSCRIBERS) {
+    DEBUG_ERROR("EVENT", "订阅表已满 (%d)", EVENT_BUS_MAX_SUBSCRIBERS);
+    return false;
+  }
+
+  Subscriber& subscriber = subscribers[subscriberCount++];
+  subscriber.mask = eventMask;
+  subscriber.handler = handler;
+  subscriber.context = context;
+  return true;
+}
+
+void EventBus::unsubscribe(BusHandler handler, void* context) {
+  // 保持其余订阅者的顺序
+  uint8_t kept = 0;
+  for (uint8_t i = 0; i < subscriberCount; i++) {
+    if (subscribers[i].handler != handler || subscribers[i].context != context) {
+      subscribers[kept++] = subscribers[i];
+    }
+  }
+  subscriberCount = kept;
+}
+
+// ==================== 发布 ====================
+void EventBus::publish(BusEventType type, const void* payload) {
+  BusEvent event;
+  event.type = type;
+  event.payload = payload;
+  publishCount[type]++;
+
+  uint16_t bit = mask(type);
+  for (uint8_t i = 0; i < subscriberCount; i++) {
+    if (subscribers[i].mask & bit) {
+      deliveryCount++;
+      subscribers[i].handler(event, subscribers[i].context);
+    }
+  }
+}
+
+void EventBus::publishScore(const StabilityData& stability) {
+  publish(BUS_EVENT_SCORE, &stability);
+}
+
+void EventBus::publishBreak(const StabilityData& stability) {
+  publish(BUS_EVENT_BREAK, &stability);
+}
+
+void EventBus::publishSession(BusEventType type, const PracticeSession& session) {
+  publish(type, &session);
+}
+
+void EventBus::publishStats() {
+  publish(BUS_EVENT_STATS, nullptr);
+}
+
+void EventBus::publishBattery(const BatteryStatus& battery) {
+  publish(BUS_EVENT_BATTERY, &battery);
+}
+
+void EventBus::publishSettings(const SystemSettings& settings) {
+  publish(BUS_EVENT_SETTINGS, &settings);
+}
+
+// ==================== 统计 ====================
+uint32_t EventBus::getPublishCount(BusEventType type) {
+  return type < BUS_EVENT_COUNT ? publishCount[type] : 0;
+}
+
+uint32_t EventBus::getDeliveryCount() {
+  return deliveryCount;
+}
+
+void EventBus::printStats() {
+  DEBUG_INFO("EVENT", "=== 事件总线 (%d个订阅者, 共分发%lu次) ===",
+             subscriberCount, (unsigned long)deliveryCount);
+  for (uint8_t i = 0; i < BUS_EVENT_COUNT; i++) {
+    DEBUG_INFO("EVENT", "  %s: %lu", eventNames[i], (unsigned long)publishCount[i]);
+  }
+}
+
+void EventBus::reset() {
+  subscriberCount = 0;
+  deliveryCount = 0;
+  memset(publishCount, 0, sizeof(publishCount));
+}
@@ -0,0 +1,155 @@
+#include "frequency_governor.h"
+
+// ESP32-C3可用的CPU频率 (MHz)，由低到高
+const uint16_t FrequencyGovernor::levels[DFS_LEVEL_COUNT] = {40, 80, 160};
+
+FrequencyGovernor::FrequencyGovernor() {
+  minLevel = levelForFrequency(DFS_MIN_FREQ_MHZ);
+  ceiling = levelForFrequency(DFS_MAX_FREQ_MHZ);
+  level = ceiling;
+}
+
+void FrequencyGovernor::begin(uint32_t nowMs) {
+  // 启动时以最高频率运行，第一个窗口结束后再按实测负载调整
+  level = ceiling;
+  lightSleep = false;
+  resetWindow(nowMs);
+  lastAccountMs = nowMs;
+  stats = {};
+}
+
+void FrequencyGovernor::resetWindow(uint32_t nowMs) {
+  windowStartMs = nowMs;
+  windowBusyUs = 0;
+  windowIoUs = 0;
+  windowMaxBusyUs = 0;
+  windowMaxCpuUs = 0;
+  windowMaxIoUs = 0;
+}
+
+uint8_t FrequencyGovernor::levelForFrequency(uint16_t freqMhz) {
+  // 不超过给定频率的最高工作点
+  uint8_t index = 0;
+  for (uint8_t i = 0; i < DFS_LEVEL_COUNT; i++) {
+    if (levels[i] <= freqMhz) {
+      index = i;
+    }
+  }
+  return index;
+}
+
+void FrequencyGovernor::account(uint32_t nowMs) {
+  uint32_t elapsed = nowMs - lastAccountMs;
+  stats.residencyMs[level] += elapsed;
+  if (lightSleep) {
+    stats.lightSleepMs += elapsed;
+  }
+  lastAccountMs = nowMs;
+}
+
+uint64_t FrequencyGovernor::projectBusy(uint64_t busyUs, uint64_t ioUs, uint8_t index) const {
+  // CPU部分按频率比例换算到候选工作点，I2C传输不变
+  return ioUs + (busyUs - ioUs) * levels[level] / levels[index];
+}
+
+uint8_t FrequencyGovernor::selectLevel(uint32_t windowUs) const {
+  const uint32_t deadlineUs = (uint32_t)SENSOR_READ_INTERVAL * 1000;
+  const uint32_t budgetUs = deadlineUs / 100 * DFS_DEADLINE_BUDGET;
+
+  for (uint8_t i = minLevel; i <= ceiling; i++) {
+    uint32_t projectedLoad = (uint32_t)(projectBusy(windowBusyUs, windowIoUs, i) * 100 / windowUs);
+    uint32_t projectedMaxCpu = (uint32_t)((uint64_t)windowMaxCpuUs * levels[level] / levels[i]);
+
+    // 降频需要更低的负载，避免在两个工作点之间来回切换
+    uint32_t threshold = (i < level) ? DFS_DOWN_LOAD : DFS_TARGET_LOAD;
+    if (projectedLoad <= threshold && projectedMaxCpu <= budgetUs &&
+        windowMaxIoUs + projectedMaxCpu <= deadlineUs) {
+      return i;
+    }
+  }
+  return ceiling;
+}
+
+bool FrequencyGovernor::update(uint32_t busyUs, uint32_t ioUs, uint32_t nowMs) {
+  const uint32_t deadlineUs = (uint32_t)SENSOR_READ_INTERVAL * 1000;
+  const uint32_t budgetUs = deadlineUs / 100 * DFS_DEADLINE_BUDGET;
+
+  ioUs = min(ioUs, busyUs);
+  uint32_t cpuUs = busyUs - ioUs;
+  windowBusyUs += busyUs;
+  windowIoUs += ioUs;
+  windowMaxBusyUs = max(windowMaxBusyUs, busyUs);
+  windowMaxCpuUs = max(windowMaxCpuUs, cpuUs);
+  windowMaxIoUs = max(windowMaxIoUs, ioUs);
+  if (busyUs > deadlineUs) {
+    stats.deadlineMisses++;
+  }
+
+  uint8_t targetLevel = level;
+  bool targetSleep = lightSleep;
+
+  if ((int32_t)(boostUntilMs - nowMs) > 0) {
+    // 用户操作期间保持最高频率
+    targetLevel = ceiling;
+    targetSleep = false;
+  } else if (cpuUs > budgetUs && level < ceiling) {
+    // 单次循环的CPU部分超出预算，不等窗口结束立即升到最高工作点
+    targetLevel = ceiling;
+    targetSleep = false;
+  } else if (nowMs - windowStartMs >= DFS_WINDOW_MS) {
+    uint32_t windowUs = (nowMs - windowStartMs) * 1000;
+    stats.loadPermille = (uint16_t)min((uint64_t)1000, windowBusyUs * 1000 / windowUs);
+    stats.maxBusyUs = windowMaxBusyUs;
+
+    targetLevel = selectLevel(windowUs);
+    uint32_t projectedLoad = (uint32_t)(projectBusy(windowBusyUs, windowIoUs, targetLevel) * 100 / windowUs);
+    targetSleep = (targetLevel == minLevel) && projectedLoad < DFS_LIGHT_SLEEP_LOAD;
+
+    resetWindow(nowMs);
+  }
+
+  // 频率上限可能在两次更新之间被下调
+  if (targetLevel > ceiling) {
+    targetLevel = ceiling;
+  }
+
+  if (targetLevel == level && targetSleep == lightSleep) {
+    return false;
+  }
+
+  account(nowMs);
+  if (targetLevel != level) {
+    stats.switchCount++;
+    // 换算基准改变，重新开始统计窗口
+    resetWindow(nowMs);
+  }
+  level = targetLevel;
+  lightSleep = targetSleep;
+  return true;
+}
+
+void FrequencyGovernor::boost(uint32_t nowMs, uint32_t durationMs) {
+  boostUntilMs = nowMs + durationMs;
+}
+
+void FrequencyGovernor::setCeiling(uint16_t maxFreqMhz) {
+  // 只修改上限，实际切换在下一次update()中完成并计入驻留统计
+  ceiling = max(levelForFrequency(maxFreqMhz), minLevel);
+}
+
+uint16_t FrequencyGovernor::getFrequency() const {
+  return levels[level];
+}
+
+bool FrequencyGovernor::isLightSleepAllowed() const {
+  return lightSleep;
+}
+
+GovernorStats FrequencyGovernor::getStats(uint32_t nowMs) {
+  account(nowMs);
+  return stats;
+}
+
+uint16_t FrequencyGovernor::getLevelFrequency(uint8_t index) {
+  return index < DFS_LEVEL_COUNT ? levels[index] : 0;
+}
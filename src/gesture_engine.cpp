@@ -0,0 +1,187 @@
+#include "gesture_engine.h"
+
+// ==================== 手势规则表 ====================
+// 下标为按下次数-1。在连击的第N次按住即为"N击后按住"
+static const GestureRule gestureTable[GESTURE_MAX_PRESS_COUNT] = {
+  //  短按                   长按                  超长按 (按住时触发)          按住重复
+  {{BUTTON_PRESSED,        BUTTON_LONG_PRESSED, BUTTON_LONG_LONG_PRESSED}, false},
+  {{BUTTON_DOUBLE_PRESSED, BUTTON_LONG_PRESSED, BUTTON_LONG_LONG_PRESSED}, true},
+  {{BUTTON_TRIPLE_PRESSED, BUTTON_LONG_PRESSED, BUTTON_LONG_LONG_PRESSED}, true}
+};
+
+static_assert(GESTURE_REPEAT_DELAY < GESTURE_LONG_PRESS_TIME &&
+              GESTURE_LONG_PRESS_TIME < GESTURE_LONG_LONG_PRESS_TIME,
+              "手势阈值应满足 自动重复 < 长按 < 超长按");
+
+const GestureRule& GestureEngine::ruleFor(uint8_t count) {
+  if (count < 1) count = 1;
+  if (count > GESTURE_MAX_PRESS_COUNT) count = GESTURE_MAX_PRESS_COUNT;
+  return gestureTable[count - 1];
+}
+
+GestureHoldClass GestureEngine::classify(unsigned long duration) {
+  if (duration >= GESTURE_LONG_LONG_PRESS_TIME) return GESTURE_HOLD_LONG_LONG;
+  if (duration >= GESTURE_LONG_PRESS_TIME) return GESTURE_HOLD_LONG;
+  return GESTURE_HOLD_SHORT;
+}
+
+bool GestureEngine::hasLongerGesture() const {
+  return pressCount < GESTURE_MAX_PRESS_COUNT &&
+         gestureTable[pressCount].events[GESTURE_HOLD_SHORT] != BUTTON_IDLE;
+}
+
+bool GestureEngine::emit(ButtonState state, unsigned long releaseTime, ButtonEvent& event) {
+  if (state == BUTTON_IDLE) {
+    return false;
+  }
+  event.state = state;
+  event.pressTime = pressTime;
+  event.releaseTime = releaseTime;
+  event.duration = releaseTime - pressTime;
+  event.pressCount = pressCount;
+  event.repeatCount = state == BUTTON_HOLD_REPEAT ? repeatCount : 0;
+  event.source = INPUT_SOURCE_BUTTON;
+  event.processed = false;
+  return true;
+}
+
+void GestureEngine::reset() {
+  pressed = false;
+  pressTime = 0;
+  lastReleaseTime = 0;
+  pressCount = 0;
+  pendingRelease = false;
+  holdConsumed = false;
+  repeatArmed = false;
+  repeatCount = 0;
+}
+
+void GestureEngine::setRepeatEnabled(bool enabled) {
+  repeatEnabled = enabled;
+}
+
+bool GestureEngine::isRepeatEnabled() const {
+  return repeatEnabled;
+}
+
+bool GestureEngine::onEdge(bool isPressed, unsigned long edgeTime, ButtonEvent& event) {
+  if (isPressed == pressed) {
+    return false;
+  }
+
+  if (isPressed) {
+    bool emitted = false;
+    if (pendingRelease && edgeTime - lastReleaseTime <= GESTURE_MULTI_CLICK_WINDOW) {
+      pressCount++;
+    } else {
+      // 上一个手势的等待已经超时 (定时检查还没来得及处理)，先按时产生它的事件
+      if (pendingRelease) {
+        emitted = emit(ruleFor(pressCount).events[GESTURE_HOLD_SHORT], lastReleaseTime, event);
+      }
+      pressCount = 1;
+    }
+
+    pendingRelease = false;
+    pressed = true;
+    pressTime = edgeTime;
+    holdConsumed = false;
+    repeatArmed = repeatEnabled && ruleFor(pressCount).repeatOnHold;
+    repeatCount = 0;
+    nextRepeatTime = edgeTime + GESTURE_REPEAT_DELAY;
+    return emitted;
+  }
+
+  pressed = false;
+  unsigned long duration = edgeTime - pressTime;
+
+  if (holdConsumed) {
+    // 按住期间已经产生过事件，本次手势结束
+    pressCount = 0;
+    return false;
+  }
+
+  if (repeatArmed && duration >= GESTURE_REPEAT_DELAY) {
+    // 主循环来不及在按住期间检查，松开时补发一次重复
+    repeatCount = 1;
+    bool emitted = emit(BUTTON_HOLD_REPEAT, edgeTime, event);
+    pressCount = 0;
+    return emitted;
+  }
+
+  GestureHoldClass holdClass = classify(duration);
+  if (holdClass == GESTURE_HOLD_SHORT && hasLongerGesture()) {
+    pendingRelease = true;
+    lastReleaseTime = edgeTime;
+    return false;
+  }
+
+  bool emitted = emit(ruleFor(pressCount).events[holdClass], edgeTime, event);
+  pressCount = 0;
+  return emitted;
+}
+
+bool GestureEngine::onTick(unsigned long currentTime, ButtonEvent& event) {
+  if (pendingRelease) {
+    if (currentTime - lastReleaseTime <= GESTURE_MULTI_CLICK_WINDOW) {
+      return false;
+    }
+    pendingRelease = false;
+    bool emitted = emit(ruleFor(pressCount).events[GESTURE_HOLD_SHORT], lastReleaseTime, event);
+    pressCount = 0;
+    return emitted;
+  }
+
+  if (!pressed) {
+    return false;
+  }
+
+  if (repeatArmed) {
+    if ((long)(currentTime - nextRepeatTime) < 0) {
+      return false;
+    }
+    holdConsumed = true;
+    repeatCount++;
+    nextRepeatTime = currentTime + (repeatCount >= GESTURE_REPEAT_ACCEL_COUNT ?
+                                    GESTURE_REPEAT_FAST_INTERVAL : GESTURE_REPEAT_INTERVAL);
+    return emit(BUTTON_HOLD_REPEAT, currentTime, event);
+  }
+
+  if (!holdConsumed && currentTime - pressTime >= GESTURE_LONG_LONG_PRESS_TIME) {
+    holdConsumed = true;
+    return emit(ruleFor(pressCount).events[GESTURE_HOLD_LONG_LONG], currentTime, event);
+  }
+
+  return false;
+}
+
+uint32_t GestureEngine::getNextDeadline(unsigned long currentTime) const {
+  unsigned long deadline;
+  if (pendingRelease) {
+    deadline = lastReleaseTime + GESTURE_MULTI_CLICK_WINDOW + 1;
+  } else if (pressed && repeatArmed) {
+    deadline = nextRepeatTime;
+  } else if (pressed && !holdConsumed) {
+    deadline = pressTime + GESTURE_LONG_LONG_PRESS_TIME;
+  } else {
+    return UINT32_MAX;
+  }
+
+  long remaining = (long)(deadline - currentTime);
+  return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+bool GestureEngine::isPressed() const {
+  return pressed;
+}
+
+unsigned long GestureEngine::getPressTime() const {
+  return pressTime;
+}
+
+uint8_t GestureEngine::getPressCount() const {
+  return pressCount;
+}
+
+bool GestureEngine::isWaitingForMore() const {
+  return pendingRelease;
+}
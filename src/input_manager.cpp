@@ -1,4 +1,7 @@
 #include "input_manager.h"
+#include "audio_sequencer.h"
+#include "button_capture.h"
+#include <esp_timer.h>
 
 InputManager::InputManager() {
   // 初始化按钮事件
@@ -6,16 +9,12 @@ InputManager::InputManager() {
   buttonEvent.pressTime = 0;
   buttonEvent.releaseTime = 0;
   buttonEvent.duration = 0;
+  buttonEvent.pressCount = 0;
+  buttonEvent.repeatCount = 0;
+  buttonEvent.source = INPUT_SOURCE_BUTTON;
   buttonEvent.processed = true;
   hasEvent = false;
 
-  // 初始化双击检测
-  waitingForDoubleClick = false;
-  lastClickTime = 0;
-  buttonPressTime = 0;
-  pendingSingleClick = false;
-  singleClickDelayTime = 0;
-
   // 初始化音频数据
   audioData.enabled = true;
   audioData.frequency = 0;
@@ -25,20 +24,21 @@ InputManager::InputManager() {
 }
 
 bool InputManager::initialize() {
-  // 初始化Bounce2按钮对象
-  button.attach(BUTTON_PIN, BUTTON_PIN_MODE);
-  button.interval(25); // 25ms防抖间隔
+  // 按钮边沿由中断捕获并打时间戳，主循环中防抖
+  pinMode(BUTTON_PIN, BUTTON_PIN_MODE);
+  ButtonCapture::begin();
 
   // 初始化蜂鸣器引脚
   pinMode(BUZZER_PIN, OUTPUT);
   digitalWrite(BUZZER_PIN, LOW);
+  AudioSequencer::begin();
 
   DEBUG_INFO("INPUT", "输入管理器初始化成功!");
   DEBUG_INFO("INPUT", "按钮配置: 按下=%s, 松开=%s, 引脚模式=%s",
              BUTTON_PRESSED_STATE ? "HIGH" : "LOW",
              BUTTON_RELEASED_STATE ? "HIGH" : "LOW",
              "INPUT");
-  DEBUG_INFO("INPUT", "当前按钮状态: %s", button.read() ? "HIGH" : "LOW");
+  DEBUG_INFO("INPUT", "当前按钮状态: %s", ButtonCapture::isPressed() ? "按下" : "松开");
 
   return true;
 }
@@ -48,126 +48,51 @@ void InputManager::reset() {
   buttonEvent.state = BUTTON_IDLE;
   buttonEvent.processed = true;
   hasEvent = false;
-  waitingForDoubleClick = false;
-  buttonPressTime = 0;
-  lastClickTime = 0;
-  pendingSingleClick = false;
-  singleClickDelayTime = 0;
+  gestures.reset();
+  motion.reset();
+
+  // 丢弃尚未处理的边沿，以当前电平为准
+  ButtonCapture::reset();
 
   // 停止蜂鸣器
   stopBuzzer();
 
   DEBUG_DEBUG("INPUT", "输入管理器重置，当前按钮状态: %s",
-              button.read() ? "HIGH" : "LOW");
+              ButtonCapture::isPressed() ? "按下" : "松开");
 }
 
 void InputManager::update() {
-  // 更新Bounce2按钮状态
-  button.update();
-
-  // 处理按钮事件
-  processButtonEvent();
-
-  // 更新蜂鸣器状态
-  if (buzzerActive && audioData.isPlaying) {
-    unsigned long currentTime = millis();
-    if (currentTime - buzzerStartTime >= audioData.duration) {
-      stopBuzzer();
-    }
-  }
-}
-
-void InputManager::processButtonEvent() {
-  unsigned long currentTime = millis();
-
-  // 添加实时按钮状态监控（每秒输出一次）
-  static unsigned long lastStatusReport = 0;
-  if (currentTime - lastStatusReport > 1000) {
-    DEBUG_DEBUG("INPUT", "按钮状态监控: 当前=%s, 原始GPIO=%d",
-                button.read() ? "HIGH" : "LOW",
-                digitalRead(BUTTON_PIN));
-    lastStatusReport = currentTime;
-  }
-
-  // 检测按钮按下事件 (LOW -> HIGH)
-  if (button.rose()) {
-    buttonPressTime = currentTime;
-    buttonEvent.pressTime = currentTime;
-    DEBUG_INFO("INPUT", "✓ 按钮按下检测 (Bounce2: LOW->HIGH)");
-  }
-
-  // 检测按钮释放事件 (HIGH -> LOW)
-  if (button.fell()) {
-    buttonEvent.releaseTime = currentTime;
-    buttonEvent.duration = currentTime - buttonPressTime;
-
-    DEBUG_INFO("INPUT", "✓ 按钮释放检测 (Bounce2)，持续时间: %lu ms", buttonEvent.duration);
-
-    // 判断是长按还是短按
-    if (buttonEvent.duration >= longPressThreshold) {
-      // 长按立即生成事件
-      buttonEvent.state = BUTTON_LONG_PRESSED;
-      buttonEvent.processed = false;
-      hasEvent = true;
-      // 取消任何等待中的单击事件
-      pendingSingleClick = false;
-      waitingForDoubleClick = false;
-      DEBUG_INFO("INPUT", "✓ 生成长按事件，持续时间: %lu ms", buttonEvent.duration);
-    } else {
-      // 短按：检查是否为双击的第二次点击
-      if (waitingForDoubleClick &&
-          (currentTime - lastClickTime) <= doubleClickThreshold) {
-        // 这是双击的第二次点击
-        buttonEvent.state = BUTTON_DOUBLE_PRESSED;
-        buttonEvent.processed = false;
-        hasEvent = true;
-        waitingForDoubleClick = false;
-        pendingSingleClick = false;  // 取消待处理的单击事件
-        DEBUG_INFO("INPUT", "✓ 生成双击事件");
-      } else {
-        // 这可能是双击的第一次点击，延迟处理
-        if (pendingSingleClick) {
-          // 如果已经有等待中的单击事件，立即处理它
-          DEBUG_INFO("INPUT", "✓ 处理之前的单击事件");
-          // 这里可以选择立即处理或覆盖，我们选择立即处理
-        }
-        
-        // 设置单击事件为待处理状态
-        pendingSingleClick = true;
-        singleClickDelayTime = currentTime;
-        waitingForDoubleClick = true;
-        lastClickTime = currentTime;
-        DEBUG_INFO("INPUT", "✓ 设置单击事件为待处理状态，等待可能的双击");
-      }
+  // 按时间顺序处理中断记录的边沿，按下/松开时刻使用边沿自己的时间戳
+  ButtonEdge edge;
+  ButtonEvent event;
+  while (ButtonCapture::poll(edge, esp_timer_get_time())) {
+    DEBUG_DEBUG("INPUT", "按钮%s @%lu ms", edge.pressed ? "按下" : "释放",
+                (unsigned long)(edge.timestampUs / 1000));
+    motion.noteButtonActivity((unsigned long)(edge.timestampUs / 1000));
+    if (gestures.onEdge(edge.pressed, (unsigned long)(edge.timestampUs / 1000), event)) {
+      setButtonEvent(event);
     }
   }
 
-  // 处理待处理的单击事件（超时后生成单击事件）
-  if (pendingSingleClick && 
-      (currentTime - singleClickDelayTime) > doubleClickThreshold) {
-    // 双击等待超时，生成单击事件
-    buttonEvent.state = BUTTON_PRESSED;
-    buttonEvent.processed = false;
-    hasEvent = true;
-    pendingSingleClick = false;
-    waitingForDoubleClick = false;
-    DEBUG_INFO("INPUT", "✓ 双击等待超时，生成单击事件");
+  // 连击等待超时、超长按、自动重复
+  if (gestures.onTick(millis(), event)) {
+    setButtonEvent(event);
   }
-}
-
-void InputManager::handleSingleClick() {
-  DEBUG_INFO("INPUT", "处理单击事件");
-  // 单击事件将由主程序处理
-}
 
-void InputManager::handleDoubleClick() {
-  DEBUG_INFO("INPUT", "处理双击事件");
-  // 双击事件将由主程序处理
+  // 音序由定时器推进，这里只同步播放状态
+  audioData.isPlaying = AudioSequencer::isPlaying();
 }
 
-void InputManager::handleLongPress() {
-  DEBUG_INFO("INPUT", "处理长按事件");
-  // 长按事件将由主程序处理
+void InputManager::setButtonEvent(const ButtonEvent& event) {
+  buttonEvent = event;
+  hasEvent = true;
+  if (event.state == BUTTON_HOLD_REPEAT) {
+    DEBUG_DEBUG("INPUT", "✓ 自动重复 #%u (%u击后按住)", event.repeatCount, event.pressCount);
+  } else {
+    DEBUG_INFO("INPUT", "✓ 生成%s事件: %d, 按下%u次, 持续时间: %lu ms",
+               event.source == INPUT_SOURCE_MOTION ? "运动手势" : "按钮",
+               event.state, event.pressCount, event.duration);
+  }
 }
 
 ButtonEvent InputManager::getButtonEvent() {
@@ -187,17 +112,47 @@ void InputManager::clearButtonEvent() {
   DEBUG_DEBUG("INPUT", "✓ 按钮事件已清理");
 }
 
+void InputManager::setHoldRepeatEnabled(bool enabled) {
+  gestures.setRepeatEnabled(enabled);
+}
+
+void InputManager::updateMotion(const MotionSample& sample) {
+  if (!motionEnabled) {
+    return;
+  }
+
+  ButtonEvent event;
+  // 按钮事件优先，尚未处理时丢弃本次运动手势
+  if (motion.update(sample, event) && !hasButtonEvent()) {
+    setButtonEvent(event);
+  }
+}
+
+void InputManager::setMotionInputEnabled(bool enabled) {
+  if (enabled == motionEnabled) {
+    return;
+  }
+  motionEnabled = enabled;
+  // 重新开启时不沿用关闭前的敲击/倾斜状态
+  motion.reset();
+  DEBUG_INFO("INPUT", "运动手势输入%s", enabled ? "开启" : "关闭");
+}
+
+bool InputManager::isMotionInputEnabled() const {
+  return motionEnabled;
+}
+
 bool InputManager::isButtonPressed() const {
-  return button.read() == BUTTON_PRESSED_STATE;
+  return ButtonCapture::isPressed();
 }
 
 bool InputManager::isButtonReleased() const {
-  return button.read() == BUTTON_RELEASED_STATE;
+  return !ButtonCapture::isPressed();
 }
 
 unsigned long InputManager::getPressDuration() const {
-  if (isButtonPressed() && buttonPressTime > 0) {
-    return millis() - buttonPressTime;
+  if (isButtonPressed() && gestures.isPressed()) {
+    return millis() - gestures.getPressTime();
   }
   return 0;
 }
@@ -209,57 +164,49 @@ void InputManager::playTone(uint16_t frequency, uint16_t duration) {
   
   audioData.frequency = frequency;
   audioData.duration = duration;
-  audioData.isPlaying = true;
   audioData.startTime = millis();
-  
-  buzzerStartTime = millis();
-  buzzerActive = true;
-  
-  // 使用tone函数播放声音
-  tone(BUZZER_PIN, frequency, duration);
+  audioData.isPlaying = AudioSequencer::playTone(frequency, duration);
   
   DEBUG_PRINTF("播放音调: %d Hz, %d ms\n", frequency, duration);
 }
 
+void InputManager::playPattern(SoundPattern pattern) {
+  if (!audioData.enabled) {
+    return;
+  }
+
+  audioData.frequency = 0;
+  audioData.duration = AudioSequencer::getPatternDuration(pattern);
+  audioData.startTime = millis();
+  audioData.isPlaying = AudioSequencer::play(pattern);
+}
+
 void InputManager::playBreakWarning() {
-  playTone(BUZZER_BREAK_FREQUENCY, BUZZER_DURATION);
+  playPattern(SOUND_BREAK_WARNING);
 }
 
 void InputManager::playSuccessSound() {
-  playTone(BUZZER_SUCCESS_FREQUENCY, BUZZER_DURATION);
+  playPattern(SOUND_SUCCESS);
 }
 
 void InputManager::playErrorSound() {
-  // 播放两声短促的错误提示音
-  playTone(800, 100);
-  delay(50);
-  playTone(600, 100);
+  // 两声短促的错误提示音
+  playPattern(SOUND_ERROR);
 }
 
 void InputManager::playStartSound() {
-  // 播放上升音调
-  playTone(1000, 100);
-  delay(50);
-  playTone(1200, 100);
-  delay(50);
-  playTone(1500, 150);
+  // 上升音调
+  playPattern(SOUND_START);
 }
 
 void InputManager::playStopSound() {
-  // 播放下降音调
-  playTone(1500, 100);
-  delay(50);
-  playTone(1200, 100);
-  delay(50);
-  playTone(1000, 150);
+  // 下降音调
+  playPattern(SOUND_STOP);
 }
 
 void InputManager::stopBuzzer() {
-  noTone(BUZZER_PIN);
-  digitalWrite(BUZZER_PIN, LOW);
-  
+  AudioSequencer::stop();
   audioData.isPlaying = false;
-  buzzerActive = false;
   
   DEBUG_PRINTLN("蜂鸣器停止");
 }
@@ -283,8 +230,18 @@ void InputManager::setVolume(uint8_t volume) {
   DEBUG_PRINTF("音量设置为: %d%%\n", volume);
 }
 
+uint32_t InputManager::getNextWakeDelay() const {
+  // 防抖锁定期结束时需要核对一次电平
+  uint32_t delayMs = ButtonCapture::getNextDeadline(esp_timer_get_time());
+
+  // 连击等待超时、超长按阈值、下一次自动重复
+  delayMs = min(delayMs, gestures.getNextDeadline(millis()));
+
+  return delayMs;
+}
+
 bool InputManager::isBuzzerActive() const {
-  return buzzerActive;
+  return AudioSequencer::isPlaying();
 }
 
 AudioData InputManager::getAudioData() const {
@@ -304,7 +261,10 @@ void InputManager::printButtonInfo() const {
   DEBUG_INFO("INPUT", "按下时间: %lu ms", buttonEvent.pressTime);
   DEBUG_INFO("INPUT", "释放时间: %lu ms", buttonEvent.releaseTime);
   DEBUG_INFO("INPUT", "持续时间: %lu ms", buttonEvent.duration);
-  DEBUG_INFO("INPUT", "等待双击: %s", waitingForDoubleClick ? "是" : "否");
+  DEBUG_INFO("INPUT", "按下次数: %u", buttonEvent.pressCount);
+  DEBUG_INFO("INPUT", "等待连击: %s", gestures.isWaitingForMore() ? "是" : "否");
+  DEBUG_INFO("INPUT", "按住自动重复: %s", gestures.isRepeatEnabled() ? "开启" : "关闭");
+  DEBUG_INFO("INPUT", "运动手势: %s", motionEnabled ? "开启" : "关闭");
 }
 
 void InputManager::printAudioInfo() const {
@@ -313,5 +273,5 @@ void InputManager::printAudioInfo() const {
   DEBUG_PRINTF("当前频率: %d Hz\n", audioData.frequency);
   DEBUG_PRINTF("播放时长: %d ms\n", audioData.duration);
   DEBUG_PRINTF("正在播放: %s\n", audioData.isPlaying ? "是" : "否");
-  DEBUG_PRINTF("蜂鸣器活跃: %s\n", buzzerActive ? "是" : "否");
+  DEBUG_PRINTF("蜂鸣器活跃: %s\n", isBuzzerActive() ? "是" : "否");
 }
@@ -0,0 +1,191 @@
+#include "loop_monitor.h"
+#include "loop_scheduler.h"
+
+static const char* const stageNames[LOOP_STAGE_COUNT] = {
+  "传感器", "输入", "电源", "状态机", "显示", "保存", "串口", "报告"
+};
+
+LoopMonitor::LoopMonitor() {
+  resetWindow();
+}
+
+void LoopMonitor::resetWindow() {
+  PerfTimers::clear(iterationStats, PERF_KEY("LOOP_ITERATION"), "LOOP_ITERATION");
+  PerfTimers::clear(sensorLateStats, PERF_KEY("LOOP_SENSOR_LATE"), "LOOP_SENSOR_LATE");
+  PerfTimers::clear(frameStats, PERF_KEY("LOOP_FRAME"), "LOOP_FRAME");
+  iterationMisses = 0;
+  sensorLateMisses = 0;
+  frameMisses = 0;
+  missedSensorTicks = 0;
+  memset(stageMisses, 0, sizeof(stageMisses));
+  lastMissStage = LOOP_STAGE_COUNT;
+  missReported = false;
+}
+
+void LoopMonitor::beginIteration(uint32_t nowUs, uint32_t events) {
+  iterationActive = true;
+  iterationEvents = events;
+  iterationStartUs = nowUs;
+  stageStartUs = nowUs;
+  memset(stageUs, 0, sizeof(stageUs));
+}
+
+void LoopMonitor::recordSensorTick(uint32_t tickUs, uint32_t ticks) {
+  if (!iterationActive) {
+    return;
+  }
+
+  // 节拍之间主循环没有处理的节拍 (事件位合并) 就是漏读
+  if (hasSensorTicks && ticks - lastSensorTicks > 1) {
+    missedSensorTicks += ticks - lastSensorTicks - 1;
+  }
+  hasSensorTicks = true;
+  lastSensorTicks = ticks;
+
+  uint32_t lateUs = iterationStartUs - tickUs;
+  if ((int32_t)lateUs < 0) {
+    lateUs = 0;   // 节拍在本轮开始后才到达
+  }
+  PerfTimers::record(&sensorLateStats, lateUs, lateUs);
+  if (lateUs > LOOP_SENSOR_LATE_DEADLINE_US) {
+    sensorLateMisses++;
+    recordMiss(previousSlowStage, lateUs, previousSlowStageUs);
+  }
+}
+
+void LoopMonitor::endStage(LoopStage stage, uint32_t nowUs) {
+  if (!iterationActive) {
+    return;
+  }
+  uint32_t duration = nowUs - stageStartUs;
+  stageUs[stage] += duration;
+  stageStartUs = nowUs;
+
+  if (stage == LOOP_STAGE_DISPLAY && (iterationEvents & LOOP_EVENT_DISPLAY)) {
+    PerfTimers::record(&frameStats, duration, duration);
+    if (duration > LOOP_FRAME_DEADLINE_US) {
+      frameMisses++;
+      recordMiss(LOOP_STAGE_DISPLAY, duration, duration);
+    }
+  }
+}
+
+uint32_t LoopMonitor::endIteration(uint32_t nowUs) {
+  if (!iterationActive) {
+    return 0;
+  }
+  iterationActive = false;
+
+  uint32_t duration = nowUs - iterationStartUs;
+  PerfTimers::record(&iterationStats, duration, duration);
+  previousSlowStage = slowestStage();
+  previousSlowStageUs = stageUs[previousSlowStage];
+  if (duration > LOOP_DEADLINE_US) {
+    iterationMisses++;
+    recordMiss(previousSlowStage, duration, previousSlowStageUs);
+  }
+  return duration;
+}
+
+uint8_t LoopMonitor::slowestStage() const {
+  uint8_t slowest = 0;
+  for (uint8_t i = 1; i < LOOP_STAGE_COUNT; i++) {
+    if (stageUs[i] > stageUs[slowest]) {
+      slowest = i;
+    }
+  }
+  return slowest;
+}
+
+void LoopMonitor::recordMiss(uint8_t stage, uint32_t durationUs, uint32_t stageDurationUs) {
+  if (stage < LOOP_STAGE_COUNT) {
+    stageMisses[stage]++;
+  }
+  lastMissStage = stage;
+  lastMissUs = durationUs;
+  lastMissStageUs = stageDurationUs;
+  lastMissMs = millis();
+
+  // 立即输出窗口内的第一次超时，其余的在报告中汇总
+  if (!missReported) {
+    missReported = true;
+    DEBUG_WARN("LOOP", "主循环超时: %lu us, 主要阶段: %s",
+               (unsigned long)durationUs, getStageName(stage));
+  }
+}
+
+void LoopMonitor::printReport(uint32_t nowMs) {
+  if (iterationStats.count > 0) {
+    DEBUG_INFO("LOOP", "每轮耗时: 平均 %lu, p50≤%lu, p99≤%lu, 最大 %lu us, 超时 %lu 次",
+               (unsigned long)(iterationStats.totalUs / iterationStats.count),
+               (unsigned long)PerfTimers::percentile(iterationStats, 50),
+               (unsigned long)PerfTimers::percentile(iterationStats, 99),
+               (unsigned long)iterationStats.maxUs, (unsigned long)iterationMisses);
+  }
+  if (sensorLateStats.count > 0) {
+    DEBUG_INFO("LOOP", "传感器读取延迟: 平均 %lu, p99≤%lu, 最大 %lu us, 超时 %lu 次, 漏读 %lu 次",
+               (unsigned long)(sensorLateStats.totalUs / sensorLateStats.count),
+               (unsigned long)PerfTimers::percentile(sensorLateStats, 99),
+               (unsigned long)sensorLateStats.maxUs, (unsigned long)sensorLateMisses,
+               (unsigned long)missedSensorTicks);
+  }
+  if (frameStats.count > 0) {
+    DEBUG_INFO("LOOP", "显示帧耗时: 平均 %lu, p99≤%lu, 最大 %lu us, 超时 %lu 次",
+               (unsigned long)(frameStats.totalUs / frameStats.count),
+               (unsigned long)PerfTimers::percentile(frameStats, 99),
+               (unsigned long)frameStats.maxUs, (unsigned long)frameMisses);
+  }
+
+  if (lastMissStage != LOOP_STAGE_COUNT) {
+    DEBUG_WARN("LOOP", "最近超时: %lu us, %s阶段 %lu us, %lu ms前",
+               (unsigned long)lastMissUs, getStageName(lastMissStage),
+               (unsigned long)lastMissStageUs, (unsigned long)(nowMs - lastMissMs));
+    for (uint8_t i = 0; i < LOOP_STAGE_COUNT; i++) {
+      if (stageMisses[i] > 0) {
+        DEBUG_WARN("LOOP", "  %s阶段超时 %lu 次", getStageName(i), (unsigned long)stageMisses[i]);
+      }
+    }
+  }
+
+  resetWindow();
+}
+
+const PerfTimerStats& LoopMonitor::getIterationStats() const {
+  return iterationStats;
+}
+
+const PerfTimerStats& LoopMonitor::getSensorLateStats() const {
+  return sensorLateStats;
+}
+
+const PerfTimerStats& LoopMonitor::getFrameStats() const {
+  return frameStats;
+}
+
+uint32_t LoopMonitor::getIterationMisses() const {
+  return iterationMisses;
+}
+
+uint32_t LoopMonitor::getSensorLateMisses() const {
+  return sensorLateMisses;
+}
+
+uint32_t LoopMonitor::getFrameMisses() const {
+  return frameMisses;
+}
+
+uint32_t LoopMonitor::getMissedSensorTicks() const {
+  return missedSensorTicks;
+}
+
+uint32_t LoopMonitor::getStageMisses(LoopStage stage) const {
+  return stageMisses[stage];
+}
+
+uint8_t LoopMonitor::getLastMissStage() const {
+  return lastMissStage;
+}
+
+const char* LoopMonitor::getStageName(uint8_t stage) {
+  return stage < LOOP_STAGE_COUNT ? stageNames[stage] : "未知";
+}
@@ -0,0 +1,138 @@
+#include "loop_scheduler.h"
+
+TaskHandle_t LoopScheduler::loopTask = nullptr;
+esp_timer_handle_t LoopScheduler::sensorTimer = nullptr;
+esp_timer_handle_t LoopScheduler::displayTimer = nullptr;
+bool LoopScheduler::eventDriven = false;
+uint32_t LoopScheduler::lastSensorMs = 0;
+uint32_t LoopScheduler::lastDisplayMs = 0;
+uint32_t LoopScheduler::eventWakeups = 0;
+uint32_t LoopScheduler::timeoutWakeups = 0;
+volatile uint32_t LoopScheduler::sensorTickUs = 0;
+volatile uint32_t LoopScheduler::sensorTicks = 0;
+
+void IRAM_ATTR LoopScheduler::sensorIsr() {
+  sensorTickUs = (uint32_t)esp_timer_get_time();
+  sensorTicks = sensorTicks + 1;
+  postFromIsr(LOOP_EVENT_SENSOR);
+}
+
+void LoopScheduler::timerCallback(void* arg) {
+  // 在esp_timer任务中执行，arg为要投递的事件位
+  uint32_t events = (uint32_t)(uintptr_t)arg;
+  if (events & LOOP_EVENT_SENSOR) {
+    sensorTickUs = (uint32_t)esp_timer_get_time();
+    sensorTicks = sensorTicks + 1;
+  }
+  post(events);
+}
+
+bool LoopScheduler::begin() {
+  loopTask = xTaskGetCurrentTaskHandle();
+  lastSensorMs = millis();
+  lastDisplayMs = lastSensorMs;
+
+  // 按钮边沿中断由ButtonCapture挂接，记录边沿后通过postFromIsr()唤醒主循环
+
+  esp_timer_create_args_t args = {};
+  args.callback = timerCallback;
+  args.dispatch_method = ESP_TIMER_TASK;
+  args.skip_unhandled_events = true;
+
+  bool ok = true;
+#if MPU_INT_PIN >= 0
+  // MPU6050数据就绪中断直接作为传感器节拍
+  pinMode(MPU_INT_PIN, INPUT);
+  attachInterrupt(digitalPinToInterrupt(MPU_INT_PIN), sensorIsr, RISING);
+#else
+  args.arg = (void*)(uintptr_t)LOOP_EVENT_SENSOR;
+  args.name = "loop_sensor";
+  ok = esp_timer_create(&args, &sensorTimer) == ESP_OK &&
+       esp_timer_start_periodic(sensorTimer, (uint64_t)SENSOR_READ_INTERVAL * 1000) == ESP_OK;
+#endif
+
+  if (ok) {
+    args.arg = (void*)(uintptr_t)LOOP_EVENT_DISPLAY;
+    args.name = "loop_display";
+    ok = esp_timer_create(&args, &displayTimer) == ESP_OK &&
+         esp_timer_start_periodic(displayTimer, (uint64_t)DISPLAY_UPDATE_INTERVAL * 1000) == ESP_OK;
+  }
+
+  eventDriven = ok;
+  if (ok) {
+    DEBUG_INFO("LOOP", "事件驱动主循环: 传感器%s %dms, 显示 %dms",
+               MPU_INT_PIN >= 0 ? "中断" : "定时器", SENSOR_READ_INTERVAL, DISPLAY_UPDATE_INTERVAL);
+  } else {
+    DEBUG_WARN("LOOP", "定时器创建失败，退回%dms固定轮询", LOOP_FALLBACK_POLL_INTERVAL);
+  }
+  return ok;
+}
+
+void LoopScheduler::post(uint32_t events) {
+  if (loopTask != nullptr) {
+    xTaskNotify(loopTask, events, eSetBits);
+  }
+}
+
+void IRAM_ATTR LoopScheduler::postFromIsr(uint32_t events) {
+  if (loopTask == nullptr) {
+    return;
+  }
+  BaseType_t higherPriorityWoken = pdFALSE;
+  xTaskNotifyFromISR(loopTask, events, eSetBits, &higherPriorityWoken);
+  portYIELD_FROM_ISR(higherPriorityWoken);
+}
+
+uint32_t LoopScheduler::pollFallback() {
+  uint32_t events = 0;
+  uint32_t now = millis();
+  if (now - lastSensorMs >= SENSOR_READ_INTERVAL) {
+    events |= LOOP_EVENT_SENSOR;
+    lastSensorMs = now;
+    sensorTickUs = micros();
+    sensorTicks = sensorTicks + 1;
+  }
+  if (now - lastDisplayMs >= DISPLAY_UPDATE_INTERVAL) {
+    events |= LOOP_EVENT_DISPLAY;
+    lastDisplayMs = now;
+  }
+  return events;
+}
+
+uint32_t LoopScheduler::waitForEvents(uint32_t timeoutMs) {
+  uint32_t limit = eventDriven ? LOOP_MAX_WAIT_MS : LOOP_FALLBACK_POLL_INTERVAL;
+  if (timeoutMs > limit) {
+    timeoutMs = limit;
+  }
+
+  uint32_t events = 0;
+  if (xTaskNotifyWait(0, UINT32_MAX, &events, pdMS_TO_TICKS(timeoutMs)) == pdTRUE) {
+    eventWakeups++;
+  } else {
+    events = 0;
+    timeoutWakeups++;
+  }
+
+  if (!eventDriven) {
+    events |= pollFallback();
+  }
+  return events;
+}
+
+bool LoopScheduler::isEventDriven() {
+  return eventDriven;
+}
+
+uint32_t LoopScheduler::getSensorTickUs() {
+  return sensorTickUs;
+}
+
+uint32_t LoopScheduler::getSensorTicks() {
+  return sensorTicks;
+}
+
+void LoopScheduler::printStats() {
+  DEBUG_INFO("LOOP", "主循环唤醒: 事件 %lu 次, 超时 %lu 次 (%s)",
+             (unsigned long)eventWakeups, (unsigned long)timeoutWakeups,
+             eventDriven ? "事件驱动" : "固定轮询");
+}
@@ -9,6 +9,16 @@
 #include "diagnostic_utils.h"
 #include "time_manager.h"
 #include "settings_menu.h"
+#include "data_exporter.h"
+#include "rtc_state.h"
+#include "boot_trace.h"
+#include "loop_scheduler.h"
+#include "loop_monitor.h"
+#include "memory_monitor.h"
+#include "serial_console.h"
+#include "telemetry.h"
+#include "state_machine.h"
+#include "event_bus.h"
 
 // ==================== 全局对象 ====================
 SensorManager sensorManager;
@@ -17,15 +27,17 @@ InputManager inputManager;
 DataManager dataManager;
 PowerManager powerManager;
 TimeManager* timeManager = nullptr;  // 时间管理器
+DataExporter dataExporter;           // 串口数据导出
+DataImporter dataImporter;           // 串口数据导入
+LoopMonitor loopMonitor;             // 主循环时序监控
 
 // ==================== 全局数据 ====================
 ZenMotionData zenData;
 
 // ==================== 系统状态 ====================
-SystemState currentState = STATE_BOOT_ANIMATION;
-unsigned long lastUpdate = 0;
-unsigned long lastSensorRead = 0;
 bool systemInitialized = false;
+bool fastResume = false;             // 从深度休眠唤醒且RTC快照有效
+ResumeState resumeState;             // 唤醒时读取的RTC快照
 
 // ==================== 函数声明 ====================
 void initializeSystem();
@@ -34,6 +46,8 @@ void updateDisplay();
 void handleInput();
 void updatePower();
 void saveData();
+void handleSerialTransfer();
+void sendTelemetrySample();
 void handleSystemState();
 void handleBootAnimationState();
 void handleMainMenuState();
@@ -45,17 +59,69 @@ void handleMenuState();
 void handleSettingsState();
 void handleHistoryState();
 void handleSleepState();
+void enterMainMenuState();
 void handleSingleClick();
 void handleLongPress();
 void handleDoubleClick();
+void handleTriplePress();
+void handleLongLongPress();
+void handleHoldRepeat(const ButtonEvent& event);
+void handleTilt(bool right);
 void printSystemInfo();
+void saveResumeState();
+void applyResumeState();
+uint32_t getLoopWaitTime();
+void onBusEvent(const BusEvent& event, void* context);
+void applyBatteryStatus(const BatteryStatus& battery);
 
 // 状态管理函数
-bool isValidStateTransition(SystemState from, SystemState to);
 void changeSystemState(SystemState newState, const char* reason);
 void updateDisplayForState();
 void validateSystemConsistency();
 
+// 串口命令
+void consoleHelp(const char* args);
+void consoleStats(const char* args);
+void consolePerf(const char* args);
+void consoleHistory(const char* args);
+void consoleSettings(const char* args);
+void consoleSet(const char* args);
+void consoleExport(const char* args);
+void consolePower(const char* args);
+void consoleTelemetry(const char* args);
+
+// ==================== 状态表 ====================
+// 按SystemState顺序，每行一个状态。练习、校准和开机 (首个评分) 全速读取传感器，
+// 暂停和历史页面只需要手势输入，隔一个节拍读取；运动手势在练习和校准中关闭
+constexpr StateDescriptor stateTable[SYSTEM_STATE_COUNT] = {
+  // 状态                名称        进入时页面           分频 策略                                                  进入                退出     每轮
+  {STATE_BOOT_ANIMATION, "开机动画", PAGE_BOOT_ANIMATION, 1, STATE_POLICY_MOTION_INPUT,                             nullptr,            nullptr, handleBootAnimationState},
+  {STATE_MAIN_MENU,      "主菜单",   PAGE_MAIN_MENU,      1, STATE_POLICY_MOTION_INPUT,                             enterMainMenuState, nullptr, handleMainMenuState},
+  {STATE_IDLE,           "空闲",     PAGE_MAIN,           1, STATE_POLICY_MOTION_INPUT,                             nullptr,            nullptr, handleIdleState},
+  {STATE_CALIBRATING,    "校准",     PAGE_CALIBRATION,    1, 0,                                                     nullptr,            nullptr, handleCalibratingState},
+  {STATE_PRACTICING,     "练习",     PAGE_MAIN,           1, 0,                                                     nullptr,            nullptr, handlePracticingState},
+  {STATE_PAUSED,         "暂停",     PAGE_MAIN,           2, STATE_POLICY_MOTION_INPUT,                             nullptr,            nullptr, handlePausedState},
+  {STATE_MENU,           "旧菜单",   STATE_PAGE_KEEP,     1, STATE_POLICY_MOTION_INPUT,                             nullptr,            nullptr, handleMenuState},
+  {STATE_SETTINGS,       "设置",     PAGE_SETTINGS,       1, STATE_POLICY_MOTION_INPUT | STATE_POLICY_HOLD_REPEAT, nullptr,            nullptr, handleSettingsState},
+  {STATE_HISTORY,        "历史",     PAGE_HISTORY,        2, STATE_POLICY_MOTION_INPUT,                             nullptr,            nullptr, handleHistoryState},
+  {STATE_SLEEP,          "休眠",     STATE_PAGE_KEEP,     0, STATE_POLICY_MOTION_INPUT,                             nullptr,            nullptr, handleSleepState}
+};
+static_assert(StateTable::ordered(stateTable, SYSTEM_STATE_COUNT), "状态表必须按SystemState顺序排列");
+
+StateMachine stateMachine(stateTable, STATE_BOOT_ANIMATION);
+
+const ConsoleCommand consoleCommands[] = {
+  {"help", "", "列出命令", consoleHelp},
+  {"stats", "", "内存、主循环、日志和遥测统计", consoleStats},
+  {"perf", "[reset]", "作用域计时统计，reset同时清零", consolePerf},
+  {"history", "", "今日和历史每日统计", consoleHistory},
+  {"settings", "", "当前设置", consoleSettings},
+  {"set", "<项> <值>", "修改设置: threshold/sound/brightness/practice/autosleep/sleep/calibration/language", consoleSet},
+  {"export", "[csv|cancel]", "串口导出数据", consoleExport},
+  {"power", "", "能耗和电源状态", consolePower},
+  {"telemetry", "[on|off]", "以传感器频率输出二进制遥测 (scripts/zen_telemetry.py)", consoleTelemetry},
+};
+
 void setup() {
   // 初始化调试串口
   DEBUG_INIT();
@@ -71,23 +137,32 @@ void setup() {
   // 初始化诊断系统
   DiagnosticUtils::initialize();
 
+  // 深度休眠唤醒时读取RTC快照，校验通过则走快速恢复路径 (快照只使用一次)
+  fastResume = RtcStateStore::isResumableWakeup() && RtcStateStore::load(resumeState);
+  RtcStateStore::invalidate();
+
   // 检查是否需要硬件自检 (根据开发板配置检测按钮状态)
   pinMode(BUTTON_PIN, BUTTON_PIN_MODE);
-  delay(50); // 等待引脚稳定
-  if (digitalRead(BUTTON_PIN) == BUTTON_PRESSED_STATE) {
-    DEBUG_INFO("MAIN", "检测到按钮按下 (%s)，启动硬件自检...",
-               (BUTTON_PRESSED_STATE == HIGH) ? "HIGH" : "LOW");
-    delay(HARDWARE_TEST_BUTTON_COMBO_TIME);
+  if (fastResume) {
+    // 唤醒按钮此时可能仍处于按下状态，不能当作自检请求
+    DEBUG_INFO("MAIN", "从深度休眠唤醒，快速恢复 (第%u次)", resumeState.sleepCount);
+  } else {
+    delay(50); // 等待引脚稳定
     if (digitalRead(BUTTON_PIN) == BUTTON_PRESSED_STATE) {
-      DEBUG_INFO("MAIN", "执行完整硬件自检");
-      DiagnosticUtils::performHardwareSelfTest();
-      delay(2000);
+      DEBUG_INFO("MAIN", "检测到按钮按下 (%s)，启动硬件自检...",
+                 (BUTTON_PRESSED_STATE == HIGH) ? "HIGH" : "LOW");
+      delay(HARDWARE_TEST_BUTTON_COMBO_TIME);
+      if (digitalRead(BUTTON_PIN) == BUTTON_PRESSED_STATE) {
+        DEBUG_INFO("MAIN", "执行完整硬件自检");
+        DiagnosticUtils::performHardwareSelfTest();
+        delay(2000);
+      } else {
+        DEBUG_INFO("MAIN", "按钮已释放，取消硬件自检");
+      }
     } else {
-      DEBUG_INFO("MAIN", "按钮已释放，取消硬件自检");
+      DEBUG_DEBUG("MAIN", "按钮未按下 (%s)，正常启动",
+                  (BUTTON_RELEASED_STATE == HIGH) ? "HIGH" : "LOW");
     }
-  } else {
-    DEBUG_DEBUG("MAIN", "按钮未按下 (%s)，正常启动",
-                (BUTTON_RELEASED_STATE == HIGH) ? "HIGH" : "LOW");
   }
 
   // 初始化系统
@@ -103,45 +178,95 @@ void loop() {
     return;
   }
 
-  unsigned long currentTime = millis();
+  // 阻塞等待下一个事件 (按钮中断、传感器/显示定时器) 或最近的截止时间，
+  // 等待期间主任务不占用CPU，电源管理可以进入自动轻度睡眠
+  uint32_t events = LoopScheduler::waitForEvents(getLoopWaitTime());
+  loopMonitor.beginIteration(micros(), events);
 
   // 更新传感器数据
-  if (currentTime - lastSensorRead >= SENSOR_READ_INTERVAL) {
-    updateSensors();
-    lastSensorRead = currentTime;
+  if (events & LOOP_EVENT_SENSOR) {
+    loopMonitor.recordSensorTick(LoopScheduler::getSensorTickUs(), LoopScheduler::getSensorTicks());
+    if (stateMachine.takeSensorTick()) {
+      updateSensors();
+    }
   }
+  loopMonitor.endStage(LOOP_STAGE_SENSOR, micros());
 
   // 处理输入
   handleInput();
+  loopMonitor.endStage(LOOP_STAGE_INPUT, micros());
 
   // 更新电源管理
   updatePower();
+  loopMonitor.endStage(LOOP_STAGE_POWER, micros());
 
   // 处理系统状态
   handleSystemState();
+  loopMonitor.endStage(LOOP_STAGE_STATE, micros());
 
   // 更新显示
-  if (currentTime - lastUpdate >= DISPLAY_UPDATE_INTERVAL) {
+  if (events & LOOP_EVENT_DISPLAY) {
     updateDisplay();
-    lastUpdate = currentTime;
   }
+  loopMonitor.endStage(LOOP_STAGE_DISPLAY, micros());
 
   // 保存数据
   saveData();
+  loopMonitor.endStage(LOOP_STAGE_SAVE, micros());
+
+  // 串口导出/导入（分块进行，不阻塞主循环）
+  handleSerialTransfer();
+  loopMonitor.endStage(LOOP_STAGE_SERIAL, micros());
 
   // 定期系统报告
-  DiagnosticUtils::periodicSystemReport();
+  if (DiagnosticUtils::periodicSystemReport()) {
+    powerManager.printGovernorStats();
+    loopMonitor.printReport(millis());
+  }
+  loopMonitor.endStage(LOOP_STAGE_REPORT, micros());
+
+  // 本次循环的忙碌时间交给调频策略 (不含等待事件的时间)，I2C传输单独上报，不按CPU频率换算
+  uint32_t busyUs = loopMonitor.endIteration(micros());
+  powerManager.recordLoopLoad(busyUs, sensorManager.takeBusTimeUs() + displayManager.takeBusTimeUs());
+  PersistenceWorker::recordLoopIteration(busyUs);
+}
+
+// 主循环最多可以等待多久：取各模块最近的截止时间
+// 周期性的传感器读取和显示刷新由定时器事件唤醒，不在这里计算
+uint32_t getLoopWaitTime() {
+  uint32_t waitMs = inputManager.getNextWakeDelay();
+
+  // 导出进行中：每轮发送一块，保持原来的轮询节奏
+  if (dataExporter.isActive()) {
+    waitMs = min(waitMs, (uint32_t)LOOP_BUSY_POLL_INTERVAL);
+  }
+
+  return waitMs;
+}
 
-  // 短暂延迟
-  delay(10);
+// ==================== 启动流水线 ====================
+// 数据加载 (EEPROM镜像 + LittleFS挂载) 放在独立任务中，
+// 与输入/显示初始化并行：主任务等待I2C传输时数据任务可以运行
+SemaphoreHandle_t dataInitDone = nullptr;
+bool dataInitResult = false;
+
+void dataInitTask(void*) {
+  dataInitResult = dataManager.initialize(timeManager);
+  BootTrace::mark("data");
+  xSemaphoreGive(dataInitDone);
+  vTaskDelete(nullptr);
 }
 
 void initializeSystem() {
   DEBUG_INFO("INIT", "开始初始化系统...");
   PERFORMANCE_START("SYSTEM_INIT");
+  BootTrace::setFastResume(fastResume);
+  BootTrace::mark("setup");
 
-  // 打印系统信息
-  DEBUG_SYSTEM_INFO();
+  // 打印系统信息 (快速恢复时跳过)
+  if (!fastResume) {
+    DEBUG_SYSTEM_INFO();
+  }
 
   // 初始化电源管理器
   DEBUG_INFO("INIT", "初始化电源管理器...");
@@ -152,6 +277,7 @@ void initializeSystem() {
     return;
   }
   PERFORMANCE_END("POWER_INIT");
+  BootTrace::mark("power");
   DEBUG_INFO("INIT", "✓ 电源管理器初始化成功");
 
   // 检查唤醒原因
@@ -171,6 +297,10 @@ void initializeSystem() {
     }
   }
 
+  // 尽早唤醒MPU6050，让陀螺仪在其它外设初始化期间完成预热
+  sensorManager.beginWarmup();
+  BootTrace::mark("i2c");
+
   // 初始化时间管理器
   DEBUG_INFO("INIT", "初始化时间管理器...");
   timeManager = new TimeManager();
@@ -181,17 +311,22 @@ void initializeSystem() {
     delete timeManager;
     timeManager = nullptr;
   }
+  BootTrace::mark("time");
 
-  // 初始化数据管理器
+  // 启动数据管理器加载任务 (依赖时间管理器)
   DEBUG_INFO("INIT", "初始化数据管理器...");
   PERFORMANCE_START("DATA_INIT");
-  if (!dataManager.initialize(timeManager)) {
-    DEBUG_ERROR("INIT", "数据管理器初始化失败!");
-    DiagnosticUtils::reportError("INIT", "数据管理器初始化失败");
-    return;
+  dataInitDone = xSemaphoreCreateBinary();
+  if (dataInitDone == nullptr ||
+      xTaskCreate(dataInitTask, "boot_data", BOOT_DATA_TASK_STACK, nullptr, 1, nullptr) != pdPASS) {
+    // 任务不可用时退化为串行加载
+    DEBUG_WARN("INIT", "数据加载任务创建失败，串行加载");
+    dataInitResult = dataManager.initialize(timeManager);
+    BootTrace::mark("data");
+    if (dataInitDone) {
+      xSemaphoreGive(dataInitDone);
+    }
   }
-  PERFORMANCE_END("DATA_INIT");
-  DEBUG_INFO("INIT", "✓ 数据管理器初始化成功");
 
   // 初始化输入管理器
   DEBUG_INFO("INIT", "初始化输入管理器...");
@@ -202,21 +337,36 @@ void initializeSystem() {
     return;
   }
   PERFORMANCE_END("INPUT_INIT");
+  BootTrace::mark("input");
   DEBUG_INFO("INIT", "✓ 输入管理器初始化成功");
 
-  // 初始化显示管理器 (包含详细的OLED诊断)
+  // 初始化显示管理器 (OLED无响应时才执行完整诊断)
   DEBUG_INFO("INIT", "初始化显示管理器...");
   PERFORMANCE_START("DISPLAY_INIT");
-  if (!displayManager.initialize()) {
+  if (!displayManager.initialize(fastResume)) {
     DEBUG_ERROR("INIT", "显示管理器初始化失败!");
     DiagnosticUtils::reportError("INIT", "OLED显示屏初始化失败");
     DiagnosticUtils::printOLEDDiagnostics();
     return;
   }
   PERFORMANCE_END("DISPLAY_INIT");
+  BootTrace::mark("display");
   DEBUG_INFO("INIT", "✓ 显示管理器初始化成功");
 
-  // 初始化传感器管理器
+  // 等待数据加载完成：之后的校准数据和设置都来自EEPROM镜像
+  if (dataInitDone) {
+    xSemaphoreTake(dataInitDone, portMAX_DELAY);
+  }
+  PERFORMANCE_END("DATA_INIT");
+  if (!dataInitResult) {
+    DEBUG_ERROR("INIT", "数据管理器初始化失败!");
+    DiagnosticUtils::reportError("INIT", "数据管理器初始化失败");
+    return;
+  }
+  dataManager.subscribeEvents();
+  DEBUG_INFO("INIT", "✓ 数据管理器初始化成功");
+
+  // 完成传感器管理器初始化 (预热已在前面开始)
   DEBUG_INFO("INIT", "初始化传感器管理器...");
   PERFORMANCE_START("SENSOR_INIT");
   if (!sensorManager.initialize()) {
@@ -228,6 +378,7 @@ void initializeSystem() {
     return;
   }
   PERFORMANCE_END("SENSOR_INIT");
+  BootTrace::mark("sensor");
   DEBUG_INFO("INIT", "✓ 传感器管理器初始化成功");
 
   // 加载设置
@@ -239,6 +390,18 @@ void initializeSystem() {
   // 设置显示亮度
   displayManager.setBrightness(zenData.settings.displayBrightness);
 
+  // 加载统计和电池状态，之后只在事件到达时更新
+  zenData.currentSession = dataManager.getCurrentSession();
+  zenData.todayStats = dataManager.getTodayStats();
+  zenData.weekStats = dataManager.getWeekStats();
+  zenData.monthStats = dataManager.getMonthStats();
+  applyBatteryStatus(powerManager.getBatteryStatus());
+  EventBus::subscribe(EventBus::mask(BUS_EVENT_SCORE) | EventBus::mask(BUS_EVENT_BREAK) |
+                      EventBus::mask(BUS_EVENT_SESSION_START) | EventBus::mask(BUS_EVENT_SESSION_STOP) |
+                      EventBus::mask(BUS_EVENT_STATS) | EventBus::mask(BUS_EVENT_BATTERY) |
+                      EventBus::mask(BUS_EVENT_SETTINGS),
+                      onBusEvent);
+
   // 初始化系统状态
   zenData.status.currentState = STATE_IDLE;
   zenData.status.currentPage = PAGE_MAIN;
@@ -247,42 +410,49 @@ void initializeSystem() {
   zenData.status.sensorError = false;
   zenData.status.displayError = false;
 
-  // 播放启动音
-  inputManager.playStartSound();
+  if (fastResume) {
+    // 恢复休眠前的传感器与会话状态，跳过开机动画和启动音
+    applyResumeState();
+  } else {
+    // 播放启动音
+    inputManager.playStartSound();
+  }
 
   systemInitialized = true;
-  // 保持开机动画状态，让其自然过渡到主菜单
-  // currentState已经在全局初始化为STATE_BOOT_ANIMATION
+  // 冷启动时保持开机动画状态：初始化已完成，动画缩短且可按键跳过
+  // 状态机已经在全局初始化为STATE_BOOT_ANIMATION
+  displayManager.setBootReady();
+  LoopScheduler::begin();
+  SerialConsole::begin(consoleCommands, sizeof(consoleCommands) / sizeof(consoleCommands[0]));
+  MemoryMonitor::registerTask(xTaskGetCurrentTaskHandle(), "loop");
+  BootTrace::mark("ready");
 
   PERFORMANCE_END("SYSTEM_INIT");
   DEBUG_INFO("INIT", "✓ 系统初始化完成!");
 
   // 打印性能统计
-  DiagnosticUtils::printPerformanceStats();
+  PerfTimers::printStats();
 
   // 最终内存检查
   DEBUG_MEMORY();
 }
 
 void updateSensors() {
-  // 读取传感器数据
+  // 读取传感器数据 (评分和破定通过事件总线发布，会话统计和zenData.stability由订阅者更新)
   if (sensorManager.readSensorData()) {
     zenData.sensor = sensorManager.getRawData();
-    zenData.stability = sensorManager.getStabilityData();
 
-    // 更新会话稳定性数据
-    if (dataManager.isSessionActive()) {
-      dataManager.updateSessionStability(zenData.stability.score);
+    // 二进制遥测 (开启时每次读取输出一包)
+    if (Telemetry::isEnabled()) {
+      sendTelemetrySample();
     }
 
-    // 检查破定事件
-    if (sensorManager.isBreakDetected()) {
-      dataManager.addBreakEvent();
+    // 敲击/倾斜手势 (练习和校准期间由handleInput()关闭)
+    inputManager.updateMotion(sensorManager.getMotionSample());
 
-      // 播放破定提醒音
-      if (zenData.settings.soundEnabled && currentState == STATE_PRACTICING) {
-        inputManager.playBreakWarning();
-      }
+    // 首个有效评分：启动完成的最终指标
+    if (BootTrace::markFirstScore()) {
+      BootTrace::printReport();
     }
 
     zenData.status.sensorError = false;
@@ -307,23 +477,16 @@ void updateDisplay() {
     // 清除唤醒事件
     powerManager.clearWakeupEvent();
   }
-  // 更新显示数据
-  zenData.currentSession = dataManager.getCurrentSession();
-  zenData.todayStats = dataManager.getTodayStats();
-  zenData.settings = dataManager.getSettings();
-  zenData.status.batteryVoltage = powerManager.getBatteryVoltage();
-  zenData.status.isCharging = powerManager.isBatteryCharging();
-  zenData.status.lowBattery = powerManager.isLowBattery();
-
+  // 会话、统计、设置和电池数据由事件更新，这里只更新随时间变化的部分
   // 更新会话时长为实时值
   zenData.currentSession.duration = dataManager.getSessionDuration();
 
   // 更新系统状态相关数据
-  zenData.status.currentState = currentState;
+  zenData.status.currentState = stateMachine.getState();
   zenData.status.uptime = millis();
 
   // 根据当前状态更新特定数据
-  switch (currentState) {
+  switch (stateMachine.getState()) {
     case STATE_PRACTICING:
     case STATE_PAUSED:
       // 不要重新获取会话数据，保持实时时长
@@ -342,10 +505,17 @@ void updateDisplay() {
   // 更新显示
   displayManager.update(zenData);
 
-  DEBUG_DEBUG("DISPLAY", "显示已更新，状态: %d", currentState);
+  DEBUG_DEBUG("DISPLAY", "显示已更新，状态: %d", stateMachine.getState());
 }
 
 void handleInput() {
+  // 设置界面中连击后按住可连续调整数值，其它界面按住只识别长按/超长按
+  inputManager.setHoldRepeatEnabled(stateMachine.hasPolicy(STATE_POLICY_HOLD_REPEAT));
+  // 运动手势在练习中关闭，避免敲击/倾斜影响评分；校准需要设备静止，同样关闭。
+  // 硬件运动检测中断随之关闭，不再产生额外的INT脉冲和状态寄存器读取
+  bool motionInput = stateMachine.hasPolicy(STATE_POLICY_MOTION_INPUT);
+  inputManager.setMotionInputEnabled(motionInput);
+  sensorManager.setMotionDetectionEnabled(motionInput);
   inputManager.update();
 
   if (inputManager.hasButtonEvent()) {
@@ -355,8 +525,14 @@ void handleInput() {
     powerManager.updateActivity();
     zenData.status.lastActivity = millis();
 
-    // 添加调试信息
-    DEBUG_INFO("INPUT", "检测到按钮事件: %d", event.state);
+    // 按键可能改变菜单选择或设置项，下一帧重绘
+    displayManager.forceUpdate();
+
+    // 添加调试信息 (自动重复事件较频繁，只在调试级别输出)
+    if (event.state != BUTTON_HOLD_REPEAT) {
+      DEBUG_INFO("INPUT", "检测到%s事件: %d",
+                 event.source == INPUT_SOURCE_MOTION ? "运动手势" : "按钮", event.state);
+    }
 
     switch (event.state) {
       case BUTTON_PRESSED:
@@ -371,6 +547,21 @@ void handleInput() {
         DEBUG_INFO("INPUT", "处理双击事件");
         handleDoubleClick();
         break;
+      case BUTTON_TRIPLE_PRESSED:
+        DEBUG_INFO("INPUT", "处理三击事件");
+        handleTriplePress();
+        break;
+      case BUTTON_LONG_LONG_PRESSED:
+        DEBUG_INFO("INPUT", "处理超长按事件");
+        handleLongLongPress();
+        break;
+      case BUTTON_HOLD_REPEAT:
+        handleHoldRepeat(event);
+        break;
+      case BUTTON_TILT_LEFT:
+      case BUTTON_TILT_RIGHT:
+        handleTilt(event.state == BUTTON_TILT_RIGHT);
+        break;
       default:
         DEBUG_WARN("INPUT", "未知按钮事件: %d", event.state);
         break;
@@ -381,12 +572,13 @@ void handleInput() {
 }
 
 void handleSingleClick() {
-  DEBUG_INFO("INPUT", "单击按钮，当前状态: %d", currentState);
+  DEBUG_INFO("INPUT", "单击按钮，当前状态: %d", stateMachine.getState());
 
-  switch (currentState) {
+  switch (stateMachine.getState()) {
     case STATE_BOOT_ANIMATION:
-      // 开机动画期间忽略按钮
-      DEBUG_INFO("STATE", "开机动画中，忽略单击");
+      // 初始化完成后任意按键跳过开机动画，之前的按键忽略
+      DEBUG_INFO("STATE", "开机动画中，单击跳过动画");
+      displayManager.skipBootAnimation();
       break;
 
     case STATE_MAIN_MENU:
@@ -463,24 +655,29 @@ void handleSingleClick() {
       break;
       
     case STATE_HISTORY:
-      // 在历史页面中的导航
-      DEBUG_INFO("STATE", "历史页面导航");
-      displayManager.showMessage("导航功能", 500);
+      // 单击在历史记录和功耗统计之间切换
+      if (displayManager.getCurrentPage() == PAGE_ENERGY) {
+        displayManager.setPage(PAGE_HISTORY);
+      } else {
+        zenData.energy = powerManager.getEnergyReport();
+        displayManager.setPage(PAGE_ENERGY);
+      }
       break;
 
     default:
-      DEBUG_WARN("STATE", "未知状态: %d", currentState);
+      DEBUG_WARN("STATE", "未知状态: %d", stateMachine.getState());
       break;
   }
 }
 
 void handleLongPress() {
-  DEBUG_INFO("INPUT", "长按按钮，当前状态: %d", currentState);
+  DEBUG_INFO("INPUT", "长按按钮，当前状态: %d", stateMachine.getState());
 
-  switch (currentState) {
+  switch (stateMachine.getState()) {
     case STATE_BOOT_ANIMATION:
-      // 开机动画期间忽略按钮
-      DEBUG_INFO("STATE", "开机动画中，忽略长按");
+      // 初始化完成后任意按键跳过开机动画，之前的按键忽略
+      DEBUG_INFO("STATE", "开机动画中，长按跳过动画");
+      displayManager.skipBootAnimation();
       break;
 
     case STATE_MAIN_MENU:
@@ -623,18 +820,19 @@ void handleLongPress() {
       break;
 
     default:
-      DEBUG_WARN("STATE", "未知状态: %d", currentState);
+      DEBUG_WARN("STATE", "未知状态: %d", stateMachine.getState());
       break;
   }
 }
 
 void handleDoubleClick() {
-  DEBUG_INFO("INPUT", "双击按钮，当前状态: %d", currentState);
+  DEBUG_INFO("INPUT", "双击按钮，当前状态: %d", stateMachine.getState());
 
-  switch (currentState) {
+  switch (stateMachine.getState()) {
     case STATE_BOOT_ANIMATION:
-      // 开机动画期间忽略按钮
-      DEBUG_INFO("STATE", "开机动画中，忽略双击");
+      // 初始化完成后任意按键跳过开机动画，之前的按键忽略
+      DEBUG_INFO("STATE", "开机动画中，双击跳过动画");
+      displayManager.skipBootAnimation();
       break;
 
     case STATE_MAIN_MENU:
@@ -704,84 +902,476 @@ void handleDoubleClick() {
       break;
 
     default:
-      DEBUG_INFO("STATE", "当前状态不支持双击: %d", currentState);
+      DEBUG_INFO("STATE", "当前状态不支持双击: %d", stateMachine.getState());
+      displayManager.showMessage("操作无效", 500);
+      break;
+  }
+}
+
+void handleTriplePress() {
+  DEBUG_INFO("INPUT", "三击按钮，当前状态: %d", stateMachine.getState());
+
+  switch (stateMachine.getState()) {
+    case STATE_BOOT_ANIMATION:
+      // 初始化完成后任意按键跳过开机动画，之前的按键忽略
+      DEBUG_INFO("STATE", "开机动画中，三击跳过动画");
+      displayManager.skipBootAnimation();
+      break;
+
+    case STATE_SETTINGS:
+      {
+        SettingsMenuState& settingsState = displayManager.getSettingsState();
+
+        if (settingsState.inDateTimeEdit) {
+          // 日期时间编辑模式 - 三击增加当前项 (三击后按住连续增加)
+          DEBUG_INFO("STATE", "日期时间编辑 - 增加值");
+          displayManager.adjustDateTimeValue(true);
+        } else if (settingsState.currentItem != SETTINGS_DATE_TIME) {
+          // 普通设置菜单 - 三击减少数值 (布尔值切换)
+          DEBUG_INFO("STATE", "设置页面 - 减少设置值");
+          displayManager.adjustSettingValue(false);
+          displayManager.forceUpdate();
+        }
+      }
+      break;
+
+    default:
+      DEBUG_INFO("STATE", "当前状态不支持三击: %d", stateMachine.getState());
       displayManager.showMessage("操作无效", 500);
       break;
   }
 }
 
+void handleLongLongPress() {
+  DEBUG_INFO("INPUT", "超长按按钮，当前状态: %d", stateMachine.getState());
+
+  if (stateMachine.getState() == STATE_SETTINGS) {
+    SettingsMenuState& settingsState = displayManager.getSettingsState();
+    if (settingsState.inDateTimeEdit) {
+      // 放弃本次日期时间修改
+      DEBUG_INFO("STATE", "放弃日期时间设置");
+      displayManager.exitDateTimeEdit();
+      displayManager.showMessage("已取消", 1000);
+    } else {
+      DEBUG_INFO("STATE", "返回主菜单");
+      changeSystemState(STATE_MAIN_MENU, "超长按返回主菜单");
+      displayManager.showMessage("返回主菜单", 1000);
+    }
+    return;
+  }
+
+  // 其它状态下与长按相同 (按住期间即触发，无需松开)
+  handleLongPress();
+}
+
+void handleHoldRepeat(const ButtonEvent& event) {
+  // 只在设置界面开启自动重复，与同样次数的连击动作一致：
+  // 日期时间编辑中双击减少、三击增加；普通设置中双击增加、三击减少
+  if (stateMachine.getState() != STATE_SETTINGS) {
+    return;
+  }
+
+  SettingsMenuState& settingsState = displayManager.getSettingsState();
+  if (settingsState.inDateTimeEdit) {
+    displayManager.adjustDateTimeValue(event.pressCount != 2);
+  } else if (settingsState.currentItem == SETTINGS_STABILITY_THRESHOLD ||
+             settingsState.currentItem == SETTINGS_PRACTICE_TIME) {
+    // 只有数值项连续调整，布尔项按住不反复切换
+    displayManager.adjustSettingValue(event.pressCount == 2);
+  } else {
+    return;
+  }
+  displayManager.forceUpdate();
+  DEBUG_DEBUG("STATE", "设置项连续调整 #%u", event.repeatCount);
+}
+
+void handleTilt(bool right) {
+  DEBUG_DEBUG("INPUT", "向%s倾斜，当前状态: %d", right ? "右" : "左", stateMachine.getState());
+
+  switch (stateMachine.getState()) {
+    case STATE_MAIN_MENU:
+      // 左右倾斜切换菜单选项
+      if (right) {
+        displayManager.nextMenuOption();
+      } else {
+        displayManager.previousMenuOption();
+      }
+      break;
+
+    case STATE_MENU:
+      if (right) {
+        displayManager.nextPage();
+      } else {
+        displayManager.previousPage();
+      }
+      break;
+
+    case STATE_SETTINGS:
+      {
+        // 右倾增加、左倾减少，保持倾斜时连续调整
+        SettingsMenuState& settingsState = displayManager.getSettingsState();
+        if (settingsState.inDateTimeEdit) {
+          displayManager.adjustDateTimeValue(right);
+        } else if (settingsState.currentItem == SETTINGS_STABILITY_THRESHOLD ||
+                   settingsState.currentItem == SETTINGS_PRACTICE_TIME) {
+          displayManager.adjustSettingValue(right);
+        } else {
+          break;
+        }
+        displayManager.forceUpdate();
+      }
+      break;
+
+    default:
+      // 其它状态不响应倾斜
+      break;
+  }
+}
+
 void updatePower() {
+  powerManager.setSystemState(stateMachine.getState());
+
+  // 功耗统计：各部件的当前状态 (只在变化时结算)
+  powerManager.setConsumer(ENERGY_DISPLAY, displayManager.isOn(), zenData.settings.displayBrightness);
+  powerManager.setConsumer(ENERGY_IMU, !zenData.status.sensorError);
+  powerManager.setConsumer(ENERGY_BUZZER, inputManager.isBuzzerActive());
+
   powerManager.updateBatteryStatus();
 
   // 检查电源事件
   if (powerManager.hasPowerEvent()) {
     String message = powerManager.getPowerEventMessage();
+    powerManager.clearPowerEvent();
     displayManager.showWarning(message);
 
     // 如果电池严重不足，强制保存数据并休眠
     if (powerManager.isCriticalBattery()) {
+      saveResumeState();
       dataManager.forceSave();
       powerManager.forceSleep();
     }
   }
 
   // 检查是否应该休眠
-  if (powerManager.shouldSleep() && currentState == STATE_IDLE) {
+  if (powerManager.shouldSleep() && stateMachine.getState() == STATE_IDLE) {
     DEBUG_PRINTLN("准备进入休眠模式");
+    saveResumeState();
     dataManager.forceSave();
     displayManager.showShutdownScreen();
     powerManager.enterSleepMode();
+    // 轻度休眠唤醒后重新开始本轮计时，休眠时间不算作主循环耗时
+    loopMonitor.beginIteration(micros(), 0);
   }
 
   // 优化功耗
   powerManager.optimizePowerConsumption();
 }
 
+void saveResumeState() {
+  // 写入RTC快照，深度休眠唤醒后由applyResumeState()恢复
+  ResumeState state = {};
+  state.systemState = (uint8_t)stateMachine.getState();
+  state.sleepCount = fastResume ? resumeState.sleepCount + 1 : 1;
+  sensorManager.captureResumeState(state.sensor);
+  dataManager.captureResumeState(state.data);
+  RtcStateStore::save(state);
+}
+
+void applyResumeState() {
+  sensorManager.restoreResumeState(resumeState.sensor);
+  dataManager.restoreResumeState(resumeState.data);
+
+  // 未结束的会话恢复为暂停状态，由用户决定是否继续；其余回到休眠前的浏览页面或主菜单
+  SystemState resumed = (SystemState)resumeState.systemState;
+  if (dataManager.isSessionPaused()) {
+    resumed = STATE_PAUSED;
+  } else if (resumed != STATE_IDLE && resumed != STATE_HISTORY) {
+    resumed = STATE_MAIN_MENU;
+  }
+
+  stateMachine.restore(resumed);
+  updateDisplayForState();
+
+  DEBUG_INFO("INIT", "已从RTC快照恢复，状态: %s，唤醒耗时 %lu ms", stateMachine.getName(resumed), millis());
+}
+
 void saveData() {
   if (dataManager.needsSave()) {
     dataManager.saveData();
   }
 }
 
-void handleSystemState() {
-  zenData.status.currentState = currentState;
+void handleSerialTransfer() {
+  static char line[EXPORT_LINE_MAX];
+  static size_t lineLength = 0;
+  static bool overflow = false;
+
+  // 按行读取串口输入
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (lineLength < sizeof(line) - 1) {
+        line[lineLength++] = c;
+      } else {
+        overflow = true;
+      }
+      continue;
+    }
+    if (lineLength == 0) {
+      continue;
+    }
 
-  switch (currentState) {
-    case STATE_BOOT_ANIMATION:
-      handleBootAnimationState();
-      break;
-    case STATE_SLEEP:
-      // 确保清理休眠状态，如需特殊处理可在此添加
-      DEBUG_PRINTLN("正在处理唤醒后的恢复过程");
-      changeSystemState(STATE_MAIN_MENU, "恢复后切换到主菜单");
-      break;
-    case STATE_MAIN_MENU:
-      handleMainMenuState();
-      break;
-    case STATE_IDLE:
-      handleIdleState();
+    line[lineLength] = '\0';
+    lineLength = 0;
+    if (overflow) {
+      overflow = false;
+      SerialConsole::printf("输入行过长，已丢弃\n");
+      continue;
+    }
+
+    if (dataImporter.feedLine(line)) {
+      if (dataImporter.isComplete()) {
+        dataManager.importData(dataImporter.getBundle());
+        dataImporter.clear();
+      } else if (dataImporter.hasFailed()) {
+        dataImporter.clear();
+      }
+    } else if (!SerialConsole::dispatch(line)) {
+      SerialConsole::printf("未知命令: %s (输入help查看命令列表)\n", line);
+    }
+  }
+
+  dataExporter.update();
+}
+
+void sendTelemetrySample() {
+  TelemetrySample sample;
+  SensorData filtered = sensorManager.getFilteredData();
+  sample.timestampMs = filtered.timestamp;
+  sensorManager.getRawCounts(sample.raw);
+  sample.filtered[0] = filtered.accelX;
+  sample.filtered[1] = filtered.accelY;
+  sample.filtered[2] = filtered.accelZ;
+  sample.filtered[3] = filtered.gyroX;
+  sample.filtered[4] = filtered.gyroY;
+  sample.filtered[5] = filtered.gyroZ;
+  sample.score = zenData.stability.score;
+  sample.avgScore = zenData.stability.avgScore;
+  sample.flags = (zenData.stability.isStable ? TELEMETRY_FLAG_STABLE : 0) |
+                 (dataManager.isSessionActive() ? TELEMETRY_FLAG_SESSION : 0);
+  Telemetry::sendSample(sample);
+}
+
+// ==================== 事件总线 ====================
+// zenData中的各部分只在对应事件到达时更新 (DataManager和DisplayManager各自另有订阅)
+void onBusEvent(const BusEvent& event, void*) {
+  switch (event.type) {
+    case BUS_EVENT_SCORE:
+      zenData.stability = *event.stability;
       break;
-    case STATE_CALIBRATING:
-      handleCalibratingState();
+
+    case BUS_EVENT_BREAK:
+      // 播放破定提醒音
+      if (zenData.settings.soundEnabled && stateMachine.getState() == STATE_PRACTICING) {
+        inputManager.playBreakWarning();
+      }
       break;
-    case STATE_PRACTICING:
-      handlePracticingState();
+
+    case BUS_EVENT_SESSION_START:
+    case BUS_EVENT_SESSION_STOP:
+      zenData.currentSession = *event.session;
       break;
-    case STATE_PAUSED:
-      handlePausedState();
+
+    case BUS_EVENT_STATS:
+      zenData.todayStats = dataManager.getTodayStats();
+      zenData.weekStats = dataManager.getWeekStats();
+      zenData.monthStats = dataManager.getMonthStats();
       break;
-    case STATE_MENU:
-      handleMenuState();
+
+    case BUS_EVENT_BATTERY:
+      applyBatteryStatus(*event.battery);
       break;
-    case STATE_SETTINGS:
-      handleSettingsState();
+
+    case BUS_EVENT_SETTINGS:
+      // 设置页面、串口set命令和数据导入修改的设置都在这里生效
+      zenData.settings = *event.settings;
+      inputManager.setAudioEnabled(zenData.settings.soundEnabled);
+      displayManager.setBrightness(zenData.settings.displayBrightness);
       break;
-    case STATE_HISTORY:
-      handleHistoryState();
+
+    default:
       break;
   }
 }
 
+void applyBatteryStatus(const BatteryStatus& battery) {
+  zenData.status.batteryVoltage = battery.voltage;
+  zenData.status.batteryPercent = battery.percent;
+  zenData.status.remainingMinutes = battery.remainingMinutes;
+  zenData.status.isCharging = battery.isCharging;
+  zenData.status.lowBattery = battery.lowBattery;
+}
+
+// ==================== 串口命令 ====================
+// 回复经SerialConsole::printf输出，DEBUG_*日志宏只用于诊断
+void consoleHelp(const char*) {
+  SerialConsole::printHelp();
+}
+
+void consoleStats(const char*) {
+  uint32_t nowMs = millis();
+  SerialConsole::printf("状态: %s, 已持续 %lu ms, 转换 %lu 次, 拒绝 %lu 次\n",
+                        stateMachine.getDescriptor().name, (unsigned long)stateMachine.getTimeInState(nowMs),
+                        (unsigned long)stateMachine.getTransitionCount(),
+                        (unsigned long)stateMachine.getRejectedCount());
+
+  MemoryMonitor::sample();
+  const MemorySample& heap = MemoryMonitor::getHistory(0);
+  SerialConsole::printf("堆: 可用 %lu, 最大块 %lu, 碎片率 %d%% (最差 %d%%), 历史最低可用 %lu\n",
+                        (unsigned long)heap.freeHeap, (unsigned long)heap.largestBlock,
+                        MemoryMonitor::fragmentationOf(heap), MemoryMonitor::getWorstFragmentation(),
+                        (unsigned long)heap.minFreeHeap);
+
+  const PerfTimerStats& iteration = loopMonitor.getIterationStats();
+  if (iteration.count > 0) {
+    SerialConsole::printf("主循环: 平均 %lu, p99≤%lu, 最大 %lu us, 超时 %lu 次\n",
+                          (unsigned long)(iteration.totalUs / iteration.count),
+                          (unsigned long)PerfTimers::percentile(iteration, 99),
+                          (unsigned long)iteration.maxUs, (unsigned long)loopMonitor.getIterationMisses());
+  }
+  const PerfTimerStats& sensorLate = loopMonitor.getSensorLateStats();
+  if (sensorLate.count > 0) {
+    SerialConsole::printf("传感器读取延迟: p99≤%lu, 最大 %lu us, 漏读 %lu 次\n",
+                          (unsigned long)PerfTimers::percentile(sensorLate, 99),
+                          (unsigned long)sensorLate.maxUs, (unsigned long)loopMonitor.getMissedSensorTicks());
+  }
+
+#if DEBUG && DEBUG_DEFERRED_LOG
+  LogRing& ring = DeferredLog::getRing();
+  SerialConsole::printf("延迟日志: 写入 %lu 条, 丢弃 %lu 条, 缓冲最大占用 %lu/%d 字节\n",
+                        (unsigned long)ring.getPushedCount(), (unsigned long)ring.getDroppedCount(),
+                        (unsigned long)ring.getHighWater(), DEFERRED_LOG_BUFFER_SIZE);
+#endif
+  SerialConsole::printf("遥测: %s, 已发送 %lu 包, 串口繁忙丢弃 %lu 包\n",
+                        Telemetry::isEnabled() ? "开启" : "关闭",
+                        (unsigned long)Telemetry::getSentCount(), (unsigned long)Telemetry::getDroppedCount());
+  SerialConsole::printf("事件总线: 共分发 %lu 次\n", (unsigned long)EventBus::getDeliveryCount());
+
+  DailyStats today = dataManager.getTodayStats();
+  SerialConsole::printf("今日: 练习 %d 次, %lu 秒, 平均 %.1f, 中位 %.1f, 最佳 %.1f, 破定 %d\n",
+                        today.sessionCount, (unsigned long)(today.totalTime / 1000), today.avgStability,
+                        today.medianStability, today.bestStability, today.totalBreaks);
+}
+
+void consolePerf(const char* args) {
+  for (uint8_t i = 0; i < PERF_TIMER_SLOTS; i++) {
+    const PerfTimerStats& stats = PerfTimers::getSlot(i);
+    if (stats.key == 0 || stats.count == 0) {
+      continue;
+    }
+    SerialConsole::printf("%s: 调用%lu次, 平均%luus (自身%luus), 最大%lu p50≤%lu p99≤%luus\n",
+                          stats.name, (unsigned long)stats.count,
+                          (unsigned long)(stats.totalUs / stats.count),
+                          (unsigned long)(stats.selfUs / stats.count), (unsigned long)stats.maxUs,
+                          (unsigned long)PerfTimers::percentile(stats, 50),
+                          (unsigned long)PerfTimers::percentile(stats, 99));
+  }
+  if (strcmp(args, "reset") == 0) {
+    PerfTimers::reset();
+    SerialConsole::printf("计时统计已清零\n");
+  }
+}
+
+void consoleHistory(const char*) {
+  DailyStats today = dataManager.getTodayStats();
+  SerialConsole::printf("今日: 练习 %d 次, %lu 秒, 平均 %.1f, 最佳 %.1f, 破定 %d\n",
+                        today.sessionCount, (unsigned long)(today.totalTime / 1000), today.avgStability,
+                        today.bestStability, today.totalBreaks);
+  for (int i = 0; i < MAX_HISTORY_DAYS; i++) {
+    DailyStats day = dataManager.getHistoryStats(i);
+    if (day.year == 0 && day.sessionCount == 0) {
+      continue;
+    }
+    SerialConsole::printf("%04u-%02u-%02u: 练习 %d 次, %lu 秒, 平均 %.1f, 最佳 %.1f, 破定 %d\n",
+                          day.year, day.month, day.day, day.sessionCount, (unsigned long)(day.totalTime / 1000),
+                          day.avgStability, day.bestStability, day.totalBreaks);
+  }
+}
+
+void consoleSettings(const char*) {
+  SystemSettings settings = dataManager.getSettings();
+  SerialConsole::printf("threshold %.1f\nsound %s\nbrightness %u\npractice %lu\n",
+                        settings.stabilityThreshold, settings.soundEnabled ? "on" : "off",
+                        settings.displayBrightness, (unsigned long)(settings.practiceTime / 60000));
+  SerialConsole::printf("autosleep %s\nsleep %lu\ncalibration %s\nlanguage %s\n",
+                        settings.autoSleep ? "on" : "off", (unsigned long)(settings.sleepTimeout / 60000),
+                        settings.calibrationEnabled ? "on" : "off", settings.language == 0 ? "zh" : "en");
+}
+
+void consoleSet(const char* args) {
+  SystemSettings settings = dataManager.getSettings();
+  if (!SerialConsole::applySetting(settings, args)) {
+    SerialConsole::printf("无效的设置: %s\n", args);
+    return;
+  }
+  dataManager.updateSettings(settings);
+  SerialConsole::printf("设置已修改: %s\n", args);
+}
+
+void consoleExport(const char* args) {
+  if (args[0] == '\0') {
+    dataExporter.begin(dataManager, EXPORT_BINARY);
+  } else if (strcmp(args, "csv") == 0) {
+    dataExporter.begin(dataManager, EXPORT_CSV);
+  } else if (strcmp(args, "cancel") == 0) {
+    dataExporter.cancel();
+    SerialConsole::printf("数据导出已取消\n");
+  } else {
+    SerialConsole::printf("用法: export [csv|cancel]\n");
+  }
+}
+
+void consolePower(const char*) {
+  const BatteryEstimator& battery = powerManager.getBatteryEstimator();
+  SerialConsole::printf("电池: %.2f V (开路 %.3f V), %d%%, 剩余 %.0f mAh, 可练习约 %lu 分钟\n",
+                        powerManager.getBatteryVoltage(), battery.getOpenCircuitVoltage(),
+                        powerManager.getBatteryPercentage(), battery.getRemainingMah(),
+                        (unsigned long)powerManager.getRemainingPracticeMinutes());
+  SerialConsole::printf("CPU %u MHz, 平均电流 %.1f mA\n",
+                        powerManager.getCpuFrequency(), powerManager.getAveragePowerConsumption());
+
+  EnergyReport report = powerManager.getEnergyReport();
+  if (report.totalMs == 0) {
+    return;
+  }
+  SerialConsole::printf("功耗统计 (%lu s): 总耗电 %.2f mAh, 平均 %.1f mA\n",
+                        (unsigned long)(report.totalMs / 1000), report.totalMah,
+                        EnergyProfiler::averageCurrent(report.totalMah, report.totalMs));
+  for (uint8_t i = 0; i < ENERGY_CONSUMER_COUNT; i++) {
+    SerialConsole::printf("  %-6s 占空比 %5.1f%%, %.2f mAh\n", EnergyProfiler::getConsumerName(i),
+                          report.consumerOnMs[i] * 100.0f / report.totalMs, report.consumerMah[i]);
+  }
+}
+
+void consoleTelemetry(const char* args) {
+  if (strcmp(args, "on") == 0) {
+    // 之后的输出都是二进制帧，不再回复文本
+    Telemetry::start();
+    return;
+  }
+  if (strcmp(args, "off") == 0) {
+    Telemetry::stop();
+  }
+  SerialConsole::printf("遥测: %s, 已发送 %lu 包, 串口繁忙丢弃 %lu 包\n",
+                        Telemetry::isEnabled() ? "开启" : "关闭",
+                        (unsigned long)Telemetry::getSentCount(), (unsigned long)Telemetry::getDroppedCount());
+}
+
+void handleSystemState() {
+  zenData.status.currentState = stateMachine.getState();
+  stateMachine.tick();
+}
+
 void handleIdleState() {
   // 空闲状态处理
   // 检查是否需要自动校准
@@ -798,8 +1388,7 @@ void handleCalibratingState() {
     displayManager.showCalibrationProgress(50); // 简化处理
   } else if (sensorManager.isCalibrationComplete()) {
     // 校准完成
-    currentState = STATE_IDLE;
-    displayManager.setPage(PAGE_MAIN);
+    changeSystemState(STATE_IDLE, "校准完成");
     inputManager.playSuccessSound();
     displayManager.showMessage("校准完成!", 2000);
     DEBUG_PRINTLN("校准完成");
@@ -814,8 +1403,7 @@ void handlePracticingState() {
   if (zenData.currentSession.duration >= zenData.settings.practiceTime) {
     // 练习时间到
     dataManager.stopSession();
-    currentState = STATE_IDLE;
-    displayManager.setPage(PAGE_MAIN);
+    changeSystemState(STATE_IDLE, "练习时间到");
     inputManager.playSuccessSound();
     displayManager.showMessage("练习完成!", 3000);
     DEBUG_PRINTLN("练习时间到，自动停止");
@@ -847,13 +1435,18 @@ void handleSettingsState() {
 }
 
 void handleSleepState() {
-  // 休眠状态处理
-  // 通常不会执行到这里，因为系统已经休眠
+  // 从休眠返回后的过渡状态，确保清理休眠状态，如需特殊处理可在此添加
+  DEBUG_PRINTLN("正在处理唤醒后的恢复过程");
+  changeSystemState(STATE_MAIN_MENU, "恢复后切换到主菜单");
+}
+
+void enterMainMenuState() {
+  displayManager.setMenuOption(MENU_START_PRACTICE); // 初始化当前选中菜单项
 }
 
 void printSystemInfo() {
   DEBUG_PRINTLN("\n=== 系统状态信息 ===");
-  DEBUG_PRINTF("当前状态: %d\n", currentState);
+  DEBUG_PRINTF("当前状态: %d\n", stateMachine.getState());
   DEBUG_PRINTF("运行时间: %lu ms\n", millis());
   DEBUG_PRINTF("系统初始化: %s\n", systemInitialized ? "是" : "否");
 
@@ -867,63 +1460,19 @@ void printSystemInfo() {
 
 // ==================== 状态管理函数 ====================
 
-bool isValidStateTransition(SystemState from, SystemState to) {
-  // 定义有效的状态转换
-  switch (from) {
-    case STATE_BOOT_ANIMATION:
-      return (to == STATE_MAIN_MENU);
-
-    case STATE_MAIN_MENU:
-      return (to == STATE_PRACTICING || to == STATE_HISTORY || to == STATE_SETTINGS ||
-              to == STATE_CALIBRATING || to == STATE_SLEEP);
-
-    case STATE_IDLE:
-      return (to == STATE_MAIN_MENU || to == STATE_PRACTICING || to == STATE_MENU ||
-              to == STATE_CALIBRATING || to == STATE_SLEEP);
-
-    case STATE_PRACTICING:
-      return (to == STATE_PAUSED || to == STATE_MAIN_MENU || to == STATE_IDLE);
-
-    case STATE_PAUSED:
-      return (to == STATE_PRACTICING || to == STATE_MAIN_MENU || to == STATE_IDLE);
-
-    case STATE_MENU:
-      return (to == STATE_MAIN_MENU || to == STATE_IDLE || to == STATE_SETTINGS);
-
-    case STATE_CALIBRATING:
-      return (to == STATE_MAIN_MENU || to == STATE_IDLE);
-
-    case STATE_SETTINGS:
-      return (to == STATE_MAIN_MENU || to == STATE_MENU || to == STATE_IDLE);
-
-    case STATE_HISTORY:
-      return (to == STATE_MAIN_MENU || to == STATE_IDLE);
-
-    case STATE_SLEEP:
-      return (to == STATE_MAIN_MENU || to == STATE_IDLE);
-
-    default:
-      return false;
-  }
-}
-
 void changeSystemState(SystemState newState, const char* reason) {
-  SystemState oldState = currentState;
+  SystemState oldState = stateMachine.getState();
 
-  // 验证状态转换是否有效
-  if (!isValidStateTransition(oldState, newState)) {
-    DEBUG_ERROR("STATE", "无效的状态转换: %d -> %d (%s)", oldState, newState, reason);
+  // 验证并执行状态转换 (退出/进入处理在状态表中)
+  if (!stateMachine.change(newState)) {
+    DEBUG_ERROR("STATE", "无效的状态转换: %s -> %s (%s)",
+                stateMachine.getName(oldState), stateMachine.getName(newState), reason);
     return;
   }
 
-  // 执行状态转换
-currentState = newState;
-  if(newState == STATE_MAIN_MENU) {
-    displayManager.setMenuOption(MENU_START_PRACTICE); // 初始化当前选中菜单项
-  }
-
   // 记录状态转换
-  DEBUG_INFO("STATE", "状态转换: %d -> %d (%s)", oldState, newState, reason);
+  DEBUG_INFO("STATE", "状态转换: %s -> %s (%s)",
+             stateMachine.getName(oldState), stateMachine.getName(newState), reason);
 
   // 更新显示
   updateDisplayForState();
@@ -936,73 +1485,38 @@ currentState = newState;
 }
 
 void updateDisplayForState() {
-  // 根据当前状态更新显示页面
-  switch (currentState) {
-    case STATE_BOOT_ANIMATION:
-      displayManager.setPage(PAGE_BOOT_ANIMATION);
-      break;
-
-    case STATE_MAIN_MENU:
-      displayManager.setPage(PAGE_MAIN_MENU);
-      break;
-
-    case STATE_IDLE:
-    case STATE_PRACTICING:
-    case STATE_PAUSED:
-      displayManager.setPage(PAGE_MAIN);
-      break;
-
-    case STATE_MENU:
-      // 保持当前页面，允许用户浏览
-      break;
-
-    case STATE_CALIBRATING:
-      displayManager.setPage(PAGE_CALIBRATION);
-      break;
-
-    case STATE_SETTINGS:
-      displayManager.setPage(PAGE_SETTINGS);
-      break;
-
-    case STATE_HISTORY:
-      displayManager.setPage(PAGE_HISTORY);
-      break;
-
-    case STATE_SLEEP:
-      // 显示将被关闭
-      break;
-
-    default:
-      DEBUG_WARN("STATE", "未知状态，使用默认页面: %d", currentState);
-      displayManager.setPage(PAGE_MAIN_MENU);
-      break;
+  // 切换到状态表中该状态的页面 (旧菜单保持当前页面允许浏览，休眠时显示将被关闭)
+  uint8_t page = stateMachine.getDescriptor().page;
+  if (page != STATE_PAGE_KEEP) {
+    displayManager.setPage((DisplayPage)page);
   }
 
-  DEBUG_DEBUG("STATE", "显示页面已更新为状态: %d", currentState);
+  DEBUG_DEBUG("STATE", "显示页面已更新为状态: %s", stateMachine.getDescriptor().name);
 }
 
 void validateSystemConsistency() {
   // 验证系统状态一致性
   bool consistent = true;
+  SystemState state = stateMachine.getState();
 
   // 检查练习状态与数据管理器状态的一致性
-  if (currentState == STATE_PRACTICING && !dataManager.isSessionActive()) {
+  if (state == STATE_PRACTICING && !dataManager.isSessionActive()) {
     DEBUG_WARN("STATE", "状态不一致: 系统处于练习状态但会话未激活");
     consistent = false;
   }
 
-  if (currentState != STATE_PRACTICING && dataManager.isSessionActive()) {
+  if (state != STATE_PRACTICING && dataManager.isSessionActive()) {
     DEBUG_WARN("STATE", "状态不一致: 会话激活但系统不在练习状态");
     consistent = false;
   }
 
   // 检查校准状态与传感器管理器状态的一致性
-  if (currentState == STATE_CALIBRATING && !sensorManager.isCalibrationInProgress()) {
+  if (state == STATE_CALIBRATING && !sensorManager.isCalibrationInProgress()) {
     DEBUG_WARN("STATE", "状态不一致: 系统处于校准状态但传感器未在校准");
     consistent = false;
   }
 
-  if (currentState != STATE_CALIBRATING && sensorManager.isCalibrationInProgress()) {
+  if (state != STATE_CALIBRATING && sensorManager.isCalibrationInProgress()) {
     DEBUG_WARN("STATE", "状态不一致: 传感器在校准但系统不在校准状态");
     consistent = false;
   }
@@ -1030,18 +1544,19 @@ void handleBootAnimationState() {
 void handleMainMenuState() {
   // 主菜单状态处理
   // 检查是否有自动切换需求
-  static unsigned long lastMenuActivity = 0;
+  // 按钮事件在handleInput()中已处理并清除，无操作时长以zenData中的最后活动时间为准
+  static bool idleReported = false;
   unsigned long currentTime = millis();
 
-  // 更新最后活动时间（如果有按钮操作）
-  if (inputManager.hasButtonEvent()) {
-    lastMenuActivity = currentTime;
-  }
-
-  // 主菜单状态下的定期检查
-  if (currentTime - lastMenuActivity > 300000) { // 5分钟无操作
-    DEBUG_INFO("STATE", "主菜单长时间无操作，考虑进入休眠");
+  // 主菜单状态下的定期检查，每段无操作期间只提示一次
+  if (currentTime - zenData.status.lastActivity > 300000) { // 5分钟无操作
+    if (!idleReported) {
+      DEBUG_INFO("STATE", "主菜单长时间无操作，考虑进入休眠");
+      idleReported = true;
+    }
     // 可以在这里添加自动休眠逻辑
+  } else {
+    idleReported = false;
   }
 
   DEBUG_DEBUG("STATE", "主菜单状态正常运行");
@@ -1049,9 +1564,7 @@ void handleMainMenuState() {
 
 void handleHistoryState() {
   // 历史数据状态处理
-  // 更新历史数据显示
-  zenData.todayStats = dataManager.getTodayStats();
-
+  // 今日/周/月统计由BUS_EVENT_STATS事件更新
   // 检查是否需要刷新历史数据
   static unsigned long lastHistoryUpdate = 0;
   unsigned long currentTime = millis();
@@ -1059,6 +1572,9 @@ void handleHistoryState() {
   if (currentTime - lastHistoryUpdate > 5000) { // 每5秒更新一次
     // 刷新历史统计数据
     lastHistoryUpdate = currentTime;
+    if (displayManager.getCurrentPage() == PAGE_ENERGY) {
+      zenData.energy = powerManager.getEnergyReport();
+    }
     DEBUG_DEBUG("STATE", "更新历史数据显示");
   }
 
@@ -0,0 +1,274 @@
+#include "memory_monitor.h"
+
+static_assert((HEAP_TRACK_SLOTS & (HEAP_TRACK_SLOTS - 1)) == 0, "HEAP_TRACK_SLOTS必须是2的幂");
+
+static const char* const tagNames[HEAP_TAG_COUNT] = {
+  "其它", "显示", "导出", "日志"
+};
+
+MemoryMonitor::TrackedBlock MemoryMonitor::blocks[HEAP_TRACK_SLOTS];
+HeapTagStats MemoryMonitor::tagStats[HEAP_TAG_COUNT];
+volatile uint16_t MemoryMonitor::trackedCount = 0;
+portMUX_TYPE MemoryMonitor::lock = portMUX_INITIALIZER_UNLOCKED;
+volatile uint8_t MemoryMonitor::currentTag = HEAP_TAG_OTHER;
+volatile TaskHandle_t MemoryMonitor::tagTask = nullptr;
+MemorySample MemoryMonitor::history[MEMORY_HISTORY_SIZE];
+uint8_t MemoryMonitor::historyCount = 0;
+uint8_t MemoryMonitor::historyNext = 0;
+uint8_t MemoryMonitor::worstFragmentation = 0;
+MemoryMonitor::TaskEntry MemoryMonitor::tasks[MEMORY_MAX_TASKS];
+uint8_t MemoryMonitor::taskCount = 0;
+
+// ==================== 分配跟踪 ====================
+uint32_t MemoryMonitor::slotFor(const void* ptr) {
+  uint32_t x = (uint32_t)(uintptr_t)ptr >> 3;   // 堆块至少8字节对齐
+  return (x ^ (x >> 7)) & (HEAP_TRACK_SLOTS - 1);
+}
+
+void MemoryMonitor::insertLocked(void* ptr, uint32_t size, uint8_t tag) {
+  HeapTagStats& stats = tagStats[tag];
+  stats.allocCount++;
+
+  uint32_t index = slotFor(ptr);
+  for (uint32_t probe = 0; probe < HEAP_TRACK_SLOTS; probe++) {
+    TrackedBlock& block = blocks[index];
+    if (block.ptr == nullptr) {
+      block.ptr = ptr;
+      block.size = size;
+      block.tag = tag;
+      trackedCount = trackedCount + 1;
+      stats.currentBytes += size;
+      if (stats.currentBytes > stats.peakBytes) {
+        stats.peakBytes = stats.currentBytes;
+      }
+      return;
+    }
+    index = (index + 1) & (HEAP_TRACK_SLOTS - 1);
+  }
+  stats.untrackedCount++;
+}
+
+bool MemoryMonitor::removeLocked(void* ptr, uint32_t& size, uint8_t& tag) {
+  uint32_t index = slotFor(ptr);
+  uint32_t probe = 0;
+  while (blocks[index].ptr != ptr) {
+    if (blocks[index].ptr == nullptr || ++probe >= HEAP_TRACK_SLOTS) {
+      return false;
+    }
+    index = (index + 1) & (HEAP_TRACK_SLOTS - 1);
+  }
+  size = blocks[index].size;
+  tag = blocks[index].tag;
+
+  // 线性探测的删除：把后面探测链上的块前移填补空位，不留墓碑
+  uint32_t hole = index;
+  uint32_t next = (hole + 1) & (HEAP_TRACK_SLOTS - 1);
+  while (blocks[next].ptr != nullptr) {
+    uint32_t home = slotFor(blocks[next].ptr);
+    // home在(hole, next]之间 (环形) 时该块留在原位
+    bool stays = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+    if (!stays) {
+      blocks[hole] = blocks[next];
+      hole = next;
+    }
+    next = (next + 1) & (HEAP_TRACK_SLOTS - 1);
+  }
+  blocks[hole].ptr = nullptr;
+  trackedCount = trackedCount - 1;
+
+  tagStats[tag].currentBytes -= size;
+  return true;
+}
+
+void MemoryMonitor::noteAlloc(void* ptr, size_t size) {
+  uint8_t tag = currentTag;
+  if (ptr == nullptr || tag == HEAP_TAG_OTHER || xTaskGetCurrentTaskHandle() != tagTask) {
+    return;
+  }
+  portENTER_CRITICAL_SAFE(&lock);
+  insertLocked(ptr, size, tag);
+  portEXIT_CRITICAL_SAFE(&lock);
+}
+
+void MemoryMonitor::noteFree(void* ptr) {
+  if (ptr == nullptr || trackedCount == 0) {
+    return;
+  }
+  uint32_t size;
+  uint8_t tag;
+  portENTER_CRITICAL_SAFE(&lock);
+  removeLocked(ptr, size, tag);
+  portEXIT_CRITICAL_SAFE(&lock);
+}
+
+void MemoryMonitor::noteRealloc(void* oldPtr, void* newPtr, size_t size) {
+  if (newPtr == nullptr) {
+    // 失败时原块仍然有效；size为0时等同于free
+    if (size == 0) {
+      noteFree(oldPtr);
+    }
+    return;
+  }
+
+  // 已跟踪的块保持原来的归属，否则按新分配处理
+  uint32_t oldSize;
+  uint8_t tag;
+  portENTER_CRITICAL_SAFE(&lock);
+  bool tracked = oldPtr != nullptr && trackedCount > 0 && removeLocked(oldPtr, oldSize, tag);
+  if (tracked) {
+    tagStats[tag].allocCount--;   // 同一块的扩容不计为新的分配
+    insertLocked(newPtr, size, tag);
+  }
+  portEXIT_CRITICAL_SAFE(&lock);
+
+  if (!tracked) {
+    noteAlloc(newPtr, size);
+  }
+}
+
+uint8_t MemoryMonitor::setTag(uint8_t tag) {
+  uint8_t previous = currentTag;
+  tagTask = tag == HEAP_TAG_OTHER ? nullptr : xTaskGetCurrentTaskHandle();
+  currentTag = tag;
+  return previous;
+}
+
+const HeapTagStats& MemoryMonitor::getTagStats(uint8_t tag) {
+  return tagStats[tag < HEAP_TAG_COUNT ? tag : (uint8_t)HEAP_TAG_OTHER];
+}
+
+void MemoryMonitor::resetTagStats() {
+  portENTER_CRITICAL_SAFE(&lock);
+  memset(blocks, 0, sizeof(blocks));
+  memset(tagStats, 0, sizeof(tagStats));
+  trackedCount = 0;
+  portEXIT_CRITICAL_SAFE(&lock);
+}
+
+// ==================== 堆碎片与任务栈 ====================
+void MemoryMonitor::registerTask(TaskHandle_t handle, const char* name) {
+  if (handle == nullptr) {
+    return;
+  }
+  for (uint8_t i = 0; i < taskCount; i++) {
+    if (tasks[i].handle == handle) {
+      return;
+    }
+  }
+  if (taskCount < MEMORY_MAX_TASKS) {
+    tasks[taskCount].handle = handle;
+    tasks[taskCount].name = name;
+    taskCount++;
+  }
+}
+
+uint8_t MemoryMonitor::fragmentationOf(const MemorySample& sample) {
+  if (sample.freeHeap == 0) {
+    return 0;
+  }
+  return 100 - (uint8_t)((uint64_t)sample.largestBlock * 100 / sample.freeHeap);
+}
+
+void MemoryMonitor::sample() {
+  MemorySample& s = history[historyNext];
+  s.timeMs = millis();
+  s.freeHeap = ESP.getFreeHeap();
+  s.largestBlock = ESP.getMaxAllocHeap();
+  s.minFreeHeap = ESP.getMinFreeHeap();
+
+  historyNext = (historyNext + 1) % MEMORY_HISTORY_SIZE;
+  if (historyCount < MEMORY_HISTORY_SIZE) {
+    historyCount++;
+  }
+  uint8_t fragmentation = fragmentationOf(s);
+  if (fragmentation > worstFragmentation) {
+    worstFragmentation = fragmentation;
+  }
+}
+
+uint8_t MemoryMonitor::getHistoryCount() {
+  return historyCount;
+}
+
+const MemorySample& MemoryMonitor::getHistory(uint8_t age) {
+  uint8_t index = (historyNext + MEMORY_HISTORY_SIZE - 1 - age % MEMORY_HISTORY_SIZE) % MEMORY_HISTORY_SIZE;
+  return history[index];
+}
+
+uint8_t MemoryMonitor::getWorstFragmentation() {
+  return worstFragmentation;
+}
+
+void MemoryMonitor::printReport() {
+  if (historyCount > 0) {
+    const MemorySample& latest = getHistory(0);
+    DEBUG_INFO("MEMORY", "堆: 可用 %lu, 最大块 %lu, 碎片率 %d%% (最差 %d%%), 历史最低可用 %lu",
+               (unsigned long)latest.freeHeap, (unsigned long)latest.largestBlock,
+               fragmentationOf(latest), worstFragmentation, (unsigned long)latest.minFreeHeap);
+
+    if (historyCount > 1) {
+      // 窗口内可用堆不变而最大块持续变小，说明String等反复分配造成了碎片
+      const MemorySample& oldest = getHistory(historyCount - 1);
+      DEBUG_INFO("MEMORY", "堆趋势 (%lu秒): 可用 %+ld, 最大块 %+ld",
+                 (unsigned long)((latest.timeMs - oldest.timeMs) / 1000),
+                 (long)latest.freeHeap - (long)oldest.freeHeap,
+                 (long)latest.largestBlock - (long)oldest.largestBlock);
+    }
+  }
+
+#if HEAP_TRACKING
+  for (uint8_t i = HEAP_TAG_OTHER + 1; i < HEAP_TAG_COUNT; i++) {
+    const HeapTagStats& stats = tagStats[i];
+    DEBUG_INFO("MEMORY", "  %s: 当前 %lu B, 峰值 %lu B, 分配 %lu 次%s",
+               getTagName(i), (unsigned long)stats.currentBytes, (unsigned long)stats.peakBytes,
+               (unsigned long)stats.allocCount, stats.untrackedCount > 0 ? " (跟踪表已满)" : "");
+  }
+#endif
+
+  for (uint8_t i = 0; i < taskCount; i++) {
+    uint32_t freeStack = uxTaskGetStackHighWaterMark(tasks[i].handle);
+    if (freeStack < MEMORY_STACK_WARN_BYTES) {
+      DEBUG_WARN("MEMORY", "  任务 %s 栈剩余最少 %lu B", tasks[i].name, (unsigned long)freeStack);
+    } else {
+      DEBUG_INFO("MEMORY", "  任务 %s 栈剩余最少 %lu B", tasks[i].name, (unsigned long)freeStack);
+    }
+  }
+}
+
+const char* MemoryMonitor::getTagName(uint8_t tag) {
+  return tag < HEAP_TAG_COUNT ? tagNames[tag] : "未知";
+}
+
+// ==================== malloc包装 ====================
+// 链接参数 --wrap=malloc 等把所有对malloc的引用 (包括预编译库、String、new) 指向这里
+#if HEAP_TRACKING
+extern "C" {
+void* __real_malloc(size_t size);
+void __real_free(void* ptr);
+void* __real_realloc(void* ptr, size_t size);
+void* __real_calloc(size_t count, size_t size);
+
+void* __wrap_malloc(size_t size) {
+  void* ptr = __real_malloc(size);
+  MemoryMonitor::noteAlloc(ptr, size);
+  return ptr;
+}
+
+void __wrap_free(void* ptr) {
+  MemoryMonitor::noteFree(ptr);
+  __real_free(ptr);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+  void* result = __real_realloc(ptr, size);
+  MemoryMonitor::noteRealloc(ptr, result, size);
+  return result;
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+  void* ptr = __real_calloc(count, size);
+  MemoryMonitor::noteAlloc(ptr, count * size);
+  return ptr;
+}
+}
+#endif
@@ -0,0 +1,143 @@
+#include "motion_gesture.h"
+#include <math.h>
+
+static const float tiltTriggerSin = sinf(MOTION_TILT_ANGLE * DEG_TO_RAD);
+static const float tiltReleaseSin = sinf(MOTION_TILT_RELEASE_ANGLE * DEG_TO_RAD);
+
+void MotionGesture::reset() {
+  shockActive = false;
+  tapCount = 0;
+  tiltArmed = false;
+  tiltDirection = 0;
+  tiltRepeats = 0;
+}
+
+void MotionGesture::noteButtonActivity(unsigned long time) {
+  hasButtonActivity = true;
+  lastButtonActivity = time;
+}
+
+bool MotionGesture::nearButtonActivity(unsigned long time) const {
+  if (!hasButtonActivity) {
+    return false;
+  }
+  long delta = (long)(time - lastButtonActivity);
+  return delta > -MOTION_BUTTON_GUARD_TIME && delta < MOTION_BUTTON_GUARD_TIME;
+}
+
+bool MotionGesture::emit(ButtonState state, uint8_t count, uint16_t repeat,
+                         unsigned long startTime, unsigned long endTime, ButtonEvent& event) {
+  event.state = state;
+  event.pressTime = startTime;
+  event.releaseTime = endTime;
+  event.duration = endTime - startTime;
+  event.pressCount = count;
+  event.repeatCount = repeat;
+  event.source = INPUT_SOURCE_MOTION;
+  event.processed = false;
+  return true;
+}
+
+bool MotionGesture::update(const MotionSample& sample, ButtonEvent& event) {
+  if (updateTap(sample, event)) {
+    return true;
+  }
+  return updateTilt(sample, event);
+}
+
+bool MotionGesture::updateTap(const MotionSample& sample, ButtonEvent& event) {
+  unsigned long now = sample.timestamp;
+  bool shock = sample.hwMotion || sample.shock > MOTION_TAP_THRESHOLD_G;
+
+  if (shock) {
+    if (!shockActive) {
+      shockActive = true;
+      shockStart = now;
+    }
+    shockLast = now;
+    return false;
+  }
+
+  if (shockActive) {
+    // 冲击结束: 短促的才算敲击，持续晃动 (走动、拿起设备) 放弃整个手势
+    shockActive = false;
+    bool isTap = shockLast - shockStart <= MOTION_TAP_MAX_DURATION && !nearButtonActivity(shockStart);
+    if (!isTap) {
+      tapCount = 0;
+      return false;
+    }
+
+    if (tapCount == 1 && shockStart - firstTapTime <= MOTION_DOUBLE_TAP_WINDOW) {
+      tapCount = 0;
+      return emit(BUTTON_DOUBLE_PRESSED, 2, 0, firstTapTime, now, event);
+    }
+    tapCount = 1;
+    firstTapTime = shockStart;
+    return false;
+  }
+
+  // 等待第二次敲击超时，产生单次敲击 (期间有按钮动作则放弃)
+  if (tapCount == 1 && now - firstTapTime > MOTION_DOUBLE_TAP_WINDOW) {
+    tapCount = 0;
+    if (hasButtonActivity && (long)(lastButtonActivity - firstTapTime) >= 0) {
+      return false;
+    }
+    return emit(BUTTON_PRESSED, 1, 0, firstTapTime, now, event);
+  }
+  return false;
+}
+
+bool MotionGesture::updateTilt(const MotionSample& sample, ButtonEvent& event) {
+  // 冲击期间加速度不代表重力方向
+  if (shockActive) {
+    return false;
+  }
+
+  float magnitude = sqrtf(sample.accelX * sample.accelX +
+                          sample.accelY * sample.accelY +
+                          sample.accelZ * sample.accelZ);
+  if (magnitude < 0.5f) {
+    return false;   // 失重/自由落体，无法判断方向
+  }
+  float tiltSin = sample.accelX / magnitude;
+  unsigned long now = sample.timestamp;
+
+  if (fabsf(tiltSin) < tiltReleaseSin) {
+    tiltArmed = true;
+    tiltDirection = 0;
+    return false;
+  }
+  if (!tiltArmed || fabsf(tiltSin) < tiltTriggerSin) {
+    return false;
+  }
+
+  int8_t direction = tiltSin > 0 ? 1 : -1;
+  if (direction != tiltDirection) {
+    tiltDirection = direction;
+    tiltStart = now;
+    tiltRepeats = 0;
+    nextTiltTime = now + MOTION_TILT_HOLD_TIME;
+    return false;
+  }
+
+  if ((long)(now - nextTiltTime) < 0) {
+    return false;
+  }
+
+  tiltRepeats++;
+  nextTiltTime = now + MOTION_TILT_REPEAT_INTERVAL;
+  if (tiltRepeats >= MOTION_TILT_MAX_REPEATS) {
+    // 长时间不回正，多半是斜放着，回正之前不再触发
+    tiltArmed = false;
+  }
+  return emit(direction > 0 ? BUTTON_TILT_RIGHT : BUTTON_TILT_LEFT, 1, tiltRepeats,
+              tiltStart, now, event);
+}
+
+bool MotionGesture::isTapPending() const {
+  return tapCount > 0;
+}
+
+int8_t MotionGesture::getTiltDirection() const {
+  return tiltDirection;
+}
@@ -0,0 +1,154 @@
+#include "perf_timer.h"
+
+static_assert((PERF_TIMER_SLOTS & (PERF_TIMER_SLOTS - 1)) == 0, "PERF_TIMER_SLOTS必须是2的幂");
+static_assert(PERF_HISTOGRAM_BUCKETS <= 32, "直方图桶按32位耗时的最高位划分");
+
+PerfTimerStats PerfTimers::slots[PERF_TIMER_SLOTS];
+bool PerfTimers::overflowReported = false;
+ScopeTimer* ScopeTimer::current = nullptr;
+
+// ==================== PerfTimers ====================
+PerfTimerStats* PerfTimers::find(uint32_t key, const char* name) {
+  for (uint8_t probe = 0; probe < PERF_TIMER_SLOTS; probe++) {
+    PerfTimerStats& slot = slots[(key + probe) & (PERF_TIMER_SLOTS - 1)];
+    if (slot.key == key) {
+      return &slot;
+    }
+    if (slot.key == 0) {
+      clear(slot, key, name);
+      return &slot;
+    }
+  }
+
+  if (!overflowReported) {
+    overflowReported = true;
+    DEBUG_WARN("PERF", "性能计时器数量已达上限，忽略: %s", name);
+  }
+  return nullptr;
+}
+
+void PerfTimers::clear(PerfTimerStats& stats, uint32_t key, const char* name) {
+  memset(&stats, 0, sizeof(stats));
+  stats.key = key;
+  stats.name = name;
+  stats.minUs = UINT32_MAX;
+}
+
+uint8_t PerfTimers::bucketFor(uint32_t us) {
+  if (us < 2) {
+    return 0;
+  }
+  uint8_t bucket = 31 - __builtin_clz(us);
+  return bucket < PERF_HISTOGRAM_BUCKETS ? bucket : PERF_HISTOGRAM_BUCKETS - 1;
+}
+
+void PerfTimers::record(PerfTimerStats* stats, uint32_t elapsedUs, uint32_t selfUs) {
+  if (stats == nullptr) {
+    return;
+  }
+  stats->count++;
+  stats->totalUs += elapsedUs;
+  stats->selfUs += selfUs;
+  if (elapsedUs < stats->minUs) {
+    stats->minUs = elapsedUs;
+  }
+  if (elapsedUs > stats->maxUs) {
+    stats->maxUs = elapsedUs;
+  }
+  stats->histogram[bucketFor(elapsedUs)]++;
+}
+
+void PerfTimers::start(uint32_t key, const char* name) {
+  PerfTimerStats* stats = find(key, name);
+  if (stats != nullptr) {
+    stats->startUs = micros();
+  }
+}
+
+void PerfTimers::end(uint32_t key, const char* name) {
+  uint32_t now = micros();
+  PerfTimerStats* stats = find(key, name);
+  if (stats == nullptr) {
+    return;
+  }
+  uint32_t elapsed = now - stats->startUs;
+  record(stats, elapsed, elapsed);
+}
+
+uint32_t PerfTimers::percentile(const PerfTimerStats& stats, uint8_t percent) {
+  if (stats.count == 0) {
+    return 0;
+  }
+
+  // 第一个累计数达到目标的桶，取桶上界并限制在实测范围内
+  uint32_t target = ((uint64_t)stats.count * percent + 99) / 100;
+  uint32_t cumulative = 0;
+  for (uint8_t i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+    cumulative += stats.histogram[i];
+    if (cumulative >= target) {
+      uint32_t upper = i >= 31 ? UINT32_MAX : (2u << i) - 1;
+      if (upper > stats.maxUs) {
+        upper = stats.maxUs;
+      }
+      return upper < stats.minUs ? stats.minUs : upper;
+    }
+  }
+  return stats.maxUs;
+}
+
+const PerfTimerStats* PerfTimers::get(uint32_t key) {
+  for (uint8_t probe = 0; probe < PERF_TIMER_SLOTS; probe++) {
+    const PerfTimerStats& slot = slots[(key + probe) & (PERF_TIMER_SLOTS - 1)];
+    if (slot.key == key) {
+      return &slot;
+    }
+    if (slot.key == 0) {
+      break;
+    }
+  }
+  return nullptr;
+}
+
+const PerfTimerStats& PerfTimers::getSlot(uint8_t index) {
+  return slots[index & (PERF_TIMER_SLOTS - 1)];
+}
+
+void PerfTimers::reset() {
+  memset(slots, 0, sizeof(slots));
+  overflowReported = false;
+}
+
+void PerfTimers::printStats() {
+  DEBUG_INFO("PERF", "=== 性能统计 ===");
+
+  for (uint8_t i = 0; i < PERF_TIMER_SLOTS; i++) {
+    const PerfTimerStats& stats = slots[i];
+    if (stats.key == 0 || stats.count == 0) {
+      continue;
+    }
+    DEBUG_INFO("PERF", "%s: 调用%lu次, 平均%luμs (自身%luμs), 最小%lu 最大%lu p50≤%lu p99≤%luμs",
+               stats.name, (unsigned long)stats.count,
+               (unsigned long)(stats.totalUs / stats.count),
+               (unsigned long)(stats.selfUs / stats.count),
+               (unsigned long)stats.minUs, (unsigned long)stats.maxUs,
+               (unsigned long)percentile(stats, 50), (unsigned long)percentile(stats, 99));
+  }
+}
+
+// ==================== ScopeTimer ====================
+ScopeTimer::ScopeTimer(uint32_t key, const char* name) {
+  stats = PerfTimers::find(key, name);
+  parent = current;
+  childUs = 0;
+  current = this;
+  startUs = micros();
+}
+
+ScopeTimer::~ScopeTimer() {
+  uint32_t elapsed = micros() - startUs;
+  current = parent;
+  if (parent != nullptr) {
+    parent->childUs += elapsed;
+  }
+  PerfTimers::record(stats, elapsed, elapsed > childUs ? elapsed - childUs : 0);
+}
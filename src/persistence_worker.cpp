@@ -0,0 +1,217 @@
+#include "persistence_worker.h"
+#include "memory_monitor.h"
+#include <esp_timer.h>
+
+uint8_t PersistenceWorker::image[EEPROM_SIZE];
+uint8_t PersistenceWorker::snapshot[EEPROM_SIZE];
+bool PersistenceWorker::initialized = false;
+volatile bool PersistenceWorker::dirty = false;
+volatile bool PersistenceWorker::urgent = false;
+volatile bool PersistenceWorker::committing = false;
+volatile uint32_t PersistenceWorker::firstDirtyTime = 0;
+volatile uint32_t PersistenceWorker::lastWriteTime = 0;
+volatile uint32_t PersistenceWorker::commitSequence = 0;
+uint32_t PersistenceWorker::loopSeenSequence = 0;
+SemaphoreHandle_t PersistenceWorker::mutex = nullptr;
+TaskHandle_t PersistenceWorker::task = nullptr;
+PersistenceStats PersistenceWorker::stats = {};
+
+bool PersistenceWorker::begin() {
+  if (initialized) {
+    return true;
+  }
+
+  if (!EEPROM.begin(EEPROM_SIZE)) {
+    DEBUG_ERROR("PERSIST", "EEPROM初始化失败");
+    return false;
+  }
+
+  // 镜像以EEPROM当前内容为起点，之后的读写都在镜像上完成
+  for (int i = 0; i < EEPROM_SIZE; i++) {
+    image[i] = EEPROM.read(i);
+  }
+
+  mutex = xSemaphoreCreateMutex();
+  if (mutex == nullptr ||
+      xTaskCreate(taskMain, "persist", PERSIST_TASK_STACK, nullptr, PERSIST_TASK_PRIORITY, &task) != pdPASS) {
+    // 后台任务不可用时退化为同步提交
+    task = nullptr;
+    DEBUG_WARN("PERSIST", "后台持久化任务创建失败，使用同步提交");
+  }
+
+  MemoryMonitor::registerTask(task, "persist");
+
+  initialized = true;
+  DEBUG_INFO("PERSIST", "持久化服务已启动 (%s)", task ? "后台" : "同步");
+  return true;
+}
+
+void PersistenceWorker::trackMirrorWrite(uint32_t startUs) {
+  uint32_t elapsed = (uint32_t)esp_timer_get_time() - startUs;
+  if (elapsed > stats.maxMirrorWriteUs) {
+    stats.maxMirrorWriteUs = elapsed;
+  }
+}
+
+void PersistenceWorker::write(int address, const void* data, size_t length) {
+  if (address < 0 || address + length > EEPROM_SIZE) {
+    DEBUG_ERROR("PERSIST", "写入越界: 地址%d 长度%u", address, (unsigned)length);
+    return;
+  }
+
+  uint32_t startUs = (uint32_t)esp_timer_get_time();
+  if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+  memcpy(image + address, data, length);
+  if (mutex) xSemaphoreGive(mutex);
+  trackMirrorWrite(startUs);
+}
+
+void PersistenceWorker::read(int address, void* data, size_t length) {
+  if (address < 0 || address + length > EEPROM_SIZE) {
+    memset(data, 0, length);
+    return;
+  }
+
+  if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+  memcpy(data, image + address, length);
+  if (mutex) xSemaphoreGive(mutex);
+}
+
+void PersistenceWorker::writeByte(int address, uint8_t value) {
+  write(address, &value, 1);
+}
+
+uint8_t PersistenceWorker::readByte(int address) {
+  uint8_t value = 0;
+  read(address, &value, 1);
+  return value;
+}
+
+void PersistenceWorker::requestCommit() {
+  uint32_t now = millis();
+  if (!dirty) {
+    firstDirtyTime = now;
+  }
+  lastWriteTime = now;
+  dirty = true;
+  stats.requestCount++;
+
+  if (task) {
+    xTaskNotifyGive(task);
+  } else {
+    // 没有后台任务时立即同步提交，否则数据只会在flush()时落盘
+    commitSnapshot();
+  }
+}
+
+bool PersistenceWorker::flush(uint32_t timeoutMs) {
+  if (!initialized) {
+    return false;
+  }
+
+  // 没有后台任务时直接在调用者上下文提交
+  if (!task) {
+    return dirty ? commitSnapshot() : true;
+  }
+
+  uint32_t failuresBefore = stats.failedCount;
+  urgent = true;
+  xTaskNotifyGive(task);
+
+  uint32_t start = millis();
+  while (dirty || committing) {
+    if (stats.failedCount != failuresBefore) {
+      DEBUG_WARN("PERSIST", "数据落盘失败，后台稍后重试");
+      return false;
+    }
+    if (millis() - start >= timeoutMs) {
+      DEBUG_WARN("PERSIST", "等待数据落盘超时 (%lu ms)", (unsigned long)timeoutMs);
+      return false;
+    }
+    vTaskDelay(1);
+  }
+  return true;
+}
+
+bool PersistenceWorker::isIdle() {
+  return !dirty && !committing;
+}
+
+void PersistenceWorker::taskMain(void*) {
+  uint32_t retryDelayMs = 0;       // 上次提交失败时的重试间隔，0表示没有待重试的提交
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, retryDelayMs > 0 ? pdMS_TO_TICKS(retryDelayMs) : portMAX_DELAY);
+
+    // 合并短时间内的连续写入：等变更平息，但最长不超过PERSIST_MAX_DELAY
+    while (dirty && !urgent) {
+      uint32_t now = millis();
+      if (now - lastWriteTime >= PERSIST_COALESCE_MS || now - firstDirtyTime >= PERSIST_MAX_DELAY) {
+        break;
+      }
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PERSIST_COALESCE_MS));
+    }
+
+    if (dirty) {
+      if (commitSnapshot()) {
+        retryDelayMs = 0;
+      } else {
+        retryDelayMs = retryDelayMs > 0 ? min(retryDelayMs * 2, (uint32_t)PERSIST_RETRY_MAX_MS) : PERSIST_RETRY_MIN_MS;
+      }
+    }
+    urgent = false;
+  }
+}
+
+bool PersistenceWorker::commitSnapshot() {
+  // 锁内只做内存拷贝，Flash写入在锁外进行，主循环可以继续修改镜像
+  if (mutex) xSemaphoreTake(mutex, portMAX_DELAY);
+  committing = true;
+  commitSequence = commitSequence + 1;
+  memcpy(snapshot, image, EEPROM_SIZE);
+  dirty = false;
+  if (mutex) xSemaphoreGive(mutex);
+
+  uint32_t startUs = (uint32_t)esp_timer_get_time();
+  memcpy(EEPROM.getDataPtr(), snapshot, EEPROM_SIZE);
+  bool ok = EEPROM.commit();
+  uint32_t elapsed = (uint32_t)esp_timer_get_time() - startUs;
+
+  stats.commitCount++;
+  stats.lastCommitUs = elapsed;
+  if (elapsed > stats.maxCommitUs) {
+    stats.maxCommitUs = elapsed;
+  }
+  if (!ok) {
+    stats.failedCount++;
+    dirty = true;  // 后台任务按退避间隔重试，同步模式在下次请求时重试
+    DEBUG_ERROR("PERSIST", "EEPROM提交失败");
+  }
+
+  committing = false;
+  DEBUG_DEBUG("PERSIST", "EEPROM提交完成，耗时%lu us", (unsigned long)elapsed);
+  return ok;
+}
+
+void PersistenceWorker::recordLoopIteration(uint32_t iterationUs) {
+  // 本轮结束时仍在提交，或上一轮结束后开始过提交，都算作与提交重叠
+  uint32_t sequence = commitSequence;
+  if (committing || sequence != loopSeenSequence) {
+    if (iterationUs > stats.maxCommitLoopUs) {
+      stats.maxCommitLoopUs = iterationUs;
+    }
+  }
+  loopSeenSequence = sequence;
+}
+
+PersistenceStats PersistenceWorker::getStats() {
+  return stats;
+}
+
+void PersistenceWorker::printStats() {
+  DEBUG_INFO("PERSIST", "提交%lu次 (请求%lu次), 最近%lu us, 最长%lu us, 失败%lu次",
+             (unsigned long)stats.commitCount, (unsigned long)stats.requestCount,
+             (unsigned long)stats.lastCommitUs, (unsigned long)stats.maxCommitUs,
+             (unsigned long)stats.failedCount);
+  DEBUG_INFO("PERSIST", "提交期间主循环单轮最长%lu us, 镜像写入最长%lu us",
+             (unsigned long)stats.maxCommitLoopUs, (unsigned long)stats.maxMirrorWriteUs);
+}
@@ -1,5 +1,7 @@
 #include "power_manager.h"
 #include "diagnostic_utils.h"
+#include "persistence_worker.h"
+#include "event_bus.h"
 #include <driver/gpio.h>
 
 PowerManager::PowerManager() {
@@ -14,6 +16,7 @@ PowerManager::PowerManager() {
 
 bool PowerManager::initialize() {
   DEBUG_INFO("POWER", "初始化电源管理器...");
+  energy.begin(millis());
 
   // 配置电源管理
   configurePowerManagement();
@@ -27,9 +30,24 @@ bool PowerManager::initialize() {
 
   DEBUG_INFO("POWER", "唤醒配置: 按钮GPIO3高电平触发");
 
+  // 电池分压采样使用eFuse中的ADC校准数据
+#if BATTERY_ADC_PIN >= 0
+  analogReadResolution(12);
+  analogSetPinAttenuation(BATTERY_ADC_PIN, ADC_11db);
+  esp_adc_cal_value_t calType = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11,
+                                                         ADC_WIDTH_BIT_12, 1100, &adcChars);
+  DEBUG_INFO("POWER", "电池ADC: GPIO%d, 校准来源: %s", BATTERY_ADC_PIN,
+             calType == ESP_ADC_CAL_VAL_EFUSE_TP ? "eFuse两点" :
+             calType == ESP_ADC_CAL_VAL_EFUSE_VREF ? "eFuse Vref" : "默认Vref");
+#else
+  DEBUG_WARN("POWER", "未配置电池采样引脚，使用模拟电压");
+#endif
+
   // 初始电池状态检查
   DEBUG_DEBUG("POWER", "检查初始电池状态...");
-  updateBatteryStatus();
+  readBatteryVoltage();
+  checkBatteryStatus();
+  lastBatteryCheck = millis();
 
   // 验证电源状态
   if (!DiagnosticUtils::checkPowerSupply()) {
@@ -50,33 +68,97 @@ void PowerManager::reset() {
 }
 
 void PowerManager::configurePowerManagement() {
-  // 根据芯片类型配置电源管理
+  // 根据芯片类型配置电源管理，初始以最高频率运行且不自动睡眠，之后由调频策略调整
   #ifdef CONFIG_IDF_TARGET_ESP32C3
     // ESP32-C3配置
-    pmConfig.max_freq_mhz = 160;        // 最大频率160MHz
-    pmConfig.min_freq_mhz = 10;         // 最小频率10MHz
-    pmConfig.light_sleep_enable = true;  // 启用轻度睡眠
+    pmConfig.max_freq_mhz = DFS_MAX_FREQ_MHZ;
+    pmConfig.min_freq_mhz = DFS_MAX_FREQ_MHZ;
+    pmConfig.light_sleep_enable = false;
     DEBUG_INFO("POWER", "配置ESP32-C3电源管理");
   #elif defined(CONFIG_IDF_TARGET_ESP32)
     // ESP32配置
-    pmConfig.max_freq_mhz = 240;        // ESP32最大频率240MHz
-    pmConfig.min_freq_mhz = 10;         // 最小频率10MHz
-    pmConfig.light_sleep_enable = true;  // 启用轻度睡眠
+    pmConfig.max_freq_mhz = DFS_MAX_FREQ_MHZ;
+    pmConfig.min_freq_mhz = DFS_MAX_FREQ_MHZ;
+    pmConfig.light_sleep_enable = false;
     DEBUG_INFO("POWER", "配置ESP32电源管理");
   #else
     // 默认配置
-    pmConfig.max_freq_mhz = 160;
-    pmConfig.min_freq_mhz = 10;
-    pmConfig.light_sleep_enable = true;
+    pmConfig.max_freq_mhz = DFS_MAX_FREQ_MHZ;
+    pmConfig.min_freq_mhz = DFS_MAX_FREQ_MHZ;
+    pmConfig.light_sleep_enable = false;
     DEBUG_INFO("POWER", "配置默认电源管理");
   #endif
 
   esp_err_t ret = esp_pm_configure(&pmConfig);
-  if (ret != ESP_OK) {
-    DEBUG_ERROR("POWER", "电源管理配置失败: %s", esp_err_to_name(ret));
+  pmAvailable = (ret == ESP_OK);
+  if (!pmAvailable) {
+    // 未启用CONFIG_PM_ENABLE的固件不支持esp_pm，退化为直接设置CPU频率
+    DEBUG_WARN("POWER", "esp_pm不可用 (%s)，调频使用setCpuFrequencyMhz", esp_err_to_name(ret));
   } else {
     DEBUG_INFO("POWER", "电源管理配置成功");
   }
+
+  governor.begin(millis());
+  applyOperatingPoint();
+}
+
+void PowerManager::applyOperatingPoint() {
+  uint16_t freq = governor.getFrequency();
+  bool lightSleep = governor.isLightSleepAllowed();
+
+  if (pmAvailable) {
+    // 空闲时降到XTAL频率并允许自动轻度睡眠，有任务运行时使用选定频率
+    pmConfig.max_freq_mhz = freq;
+    pmConfig.min_freq_mhz = lightSleep ? 40 : freq;
+    pmConfig.light_sleep_enable = lightSleep;
+    esp_err_t ret = esp_pm_configure(&pmConfig);
+    if (ret != ESP_OK) {
+      DEBUG_WARN("POWER", "切换工作点失败: %s", esp_err_to_name(ret));
+      return;
+    }
+  } else if (getCpuFrequencyMhz() != freq) {
+    setCpuFrequencyMhz(freq);
+  }
+  energy.setCpuOperatingPoint(freq, pmAvailable && lightSleep, millis());
+
+  DEBUG_DEBUG("POWER", "工作点: %u MHz, 自动轻度睡眠: %s", freq, lightSleep ? "开" : "关");
+}
+
+void PowerManager::recordLoopLoad(uint32_t busyUs, uint32_t ioUs) {
+  energy.addCpuBusy(busyUs);
+  if (governor.update(busyUs, ioUs, millis())) {
+    applyOperatingPoint();
+  }
+}
+
+uint16_t PowerManager::getCpuFrequency() const {
+  return governor.getFrequency();
+}
+
+bool PowerManager::isAutoLightSleepEnabled() const {
+  return pmAvailable && governor.isLightSleepAllowed();
+}
+
+GovernorStats PowerManager::getGovernorStats() {
+  return governor.getStats(millis());
+}
+
+void PowerManager::printGovernorStats() {
+  GovernorStats stats = governor.getStats(millis());
+  DEBUG_INFO("POWER", "工作点 %u MHz%s, 负载 %u.%u%%, 最长循环 %lu us, 超时 %lu 次, 切换 %lu 次",
+             governor.getFrequency(), isAutoLightSleepEnabled() ? " (自动轻度睡眠)" : "",
+             stats.loadPermille / 10, stats.loadPermille % 10,
+             (unsigned long)stats.maxBusyUs, (unsigned long)stats.deadlineMisses,
+             (unsigned long)stats.switchCount);
+  for (uint8_t i = 0; i < DFS_LEVEL_COUNT; i++) {
+    if (stats.residencyMs[i] > 0) {
+      DEBUG_INFO("POWER", "  %3u MHz: %lu ms", FrequencyGovernor::getLevelFrequency(i),
+                 (unsigned long)stats.residencyMs[i]);
+    }
+  }
+  if (pmAvailable) {
+    DEBUG_INFO("POWER", "  允许轻度睡眠: %lu ms", (unsigned long)stats.lightSleepMs);
+  }
 }
 
 void PowerManager::updateBatteryStatus() {
@@ -87,60 +169,75 @@ void PowerManager::updateBatteryStatus() {
   
   readBatteryVoltage();
   checkBatteryStatus();
+  publishBatteryStatus();
   
   lastBatteryCheck = currentTime;
 }
 
-void PowerManager::readBatteryVoltage() {
-  DEBUG_VERBOSE("POWER", "读取电池电压...");
-
-  // ESP32-C3 SuperMini通常没有专门的电池监测引脚
-  // 这里使用简化的电压读取方法
-  // 实际项目中可能需要外部分压电路
-
+float PowerManager::sampleBatteryVoltage() {
+#if BATTERY_ADC_PIN >= 0
+  // 连续过采样，去掉最大最小值后平均，再用校准曲线换算为电压
+  uint32_t sum = 0;
+  uint32_t minRaw = UINT32_MAX;
+  uint32_t maxRaw = 0;
+  for (int i = 0; i < BATTERY_ADC_OVERSAMPLE; i++) {
+    uint32_t raw = analogRead(BATTERY_ADC_PIN);
+    sum += raw;
+    minRaw = min(minRaw, raw);
+    maxRaw = max(maxRaw, raw);
+  }
+  uint32_t averageRaw = (sum - minRaw - maxRaw) / (BATTERY_ADC_OVERSAMPLE - 2);
+  uint32_t pinMillivolts = esp_adc_cal_raw_to_voltage(averageRaw, &adcChars);
+  return pinMillivolts / 1000.0f * BATTERY_DIVIDER_RATIO;
+#else
+  // ESP32-C3 SuperMini没有电池监测引脚，未接分压电路时使用模拟电压
   float voltageSum = 0;
-  int validSamples = 0;
-
-  // 多次采样求平均值
   for (int i = 0; i < VOLTAGE_SAMPLES; i++) {
-    // 简化处理，使用固定值模拟
-    // 实际应用中需要根据硬件设计实现ADC读取
-    float sample = 3.3f + (random(-100, 100) / 1000.0f); // 模拟电压波动
-
-    // 简单的有效性检查
-    if (sample > 0 && sample < 5.0f) {
-      voltageSum += sample;
-      validSamples++;
-    }
-
-    delay(VOLTAGE_SAMPLE_INTERVAL / VOLTAGE_SAMPLES);
+    voltageSum += BATTERY_SIMULATED_VOLTAGE + (random(-20, 20) / 1000.0f); // 模拟电压波动
   }
+  return voltageSum / VOLTAGE_SAMPLES;
+#endif
+}
 
-  if (validSamples > 0) {
-    float newVoltage = voltageSum / validSamples;
+void PowerManager::readBatteryVoltage() {
+  DEBUG_VERBOSE("POWER", "读取电池电压...");
 
-    // 简单的滤波
-    if (batteryVoltage == 0) {
-      batteryVoltage = newVoltage;
-    } else {
-      batteryVoltage = batteryVoltage * 0.8f + newVoltage * 0.2f; // 低通滤波
-    }
+  float newVoltage = sampleBatteryVoltage();
 
-    DEBUG_VERBOSE("POWER", "电压采样: %.3fV (有效样本: %d/%d)",
-                  batteryVoltage, validSamples, VOLTAGE_SAMPLES);
+  // 简单的有效性检查
+  if (newVoltage <= 0 || newVoltage >= 5.0f) {
+    DEBUG_WARN("POWER", "电压采样异常: %.3fV", newVoltage);
+    return;
+  }
+
+  // 简单的滤波
+  if (batteryVoltage == 0) {
+    batteryVoltage = newVoltage;
   } else {
-    DEBUG_WARN("POWER", "电压采样失败，无有效样本");
+    batteryVoltage = batteryVoltage * 0.8f + newVoltage * 0.2f; // 低通滤波
   }
 
+  // 电量估算使用未滤波的采样，由估算器自行平滑
+  battery.addSample(newVoltage, millis());
+
+  DEBUG_VERBOSE("POWER", "电压采样: %.3fV, 开路电压: %.3fV, 电量: %d%%",
+                batteryVoltage, battery.getOpenCircuitVoltage(), battery.getPercentage());
+
   // 检测充电状态 (需要硬件支持)
   // 这里简化处理
   isCharging = false;
 }
 
 void PowerManager::checkBatteryStatus() {
+#if BATTERY_ADC_PIN < 0
+  // 模拟电压不反映真实电量，不触发低电量处理
+  return;
+#endif
+
   // 检查低电量
   if (batteryVoltage <= BATTERY_LOW_VOLTAGE && !lowBattery) {
     lowBattery = true;
+    powerEventPending = true;
     DEBUG_PRINTLN("电池电量低!");
   } else if (batteryVoltage > BATTERY_LOW_VOLTAGE + 0.1) {
     lowBattery = false;
@@ -149,6 +246,7 @@ void PowerManager::checkBatteryStatus() {
   // 检查严重低电量
   if (batteryVoltage <= BATTERY_CRITICAL_VOLTAGE && !criticalBattery) {
     criticalBattery = true;
+    powerEventPending = true;
     DEBUG_PRINTLN("电池电量严重不足!");
   } else if (batteryVoltage > BATTERY_CRITICAL_VOLTAGE + 0.1) {
     criticalBattery = false;
@@ -160,9 +258,100 @@ float PowerManager::getBatteryVoltage() const {
 }
 
 int PowerManager::getBatteryPercentage() const {
-  // 将电压转换为百分比 (3.0V-4.2V范围)
-  float percentage = (batteryVoltage - 3.0) / 1.2 * 100.0;
-  return constrain((int)percentage, 0, 100);
+  if (!battery.isStarted()) {
+    return (int)BatteryEstimator::socFromVoltage(batteryVoltage);
+  }
+  return battery.getPercentage();
+}
+
+uint32_t PowerManager::getRemainingPracticeMinutes() const {
+  return battery.getRemainingMinutes(STATE_PRACTICING);
+}
+
+BatteryStatus PowerManager::getBatteryStatus() const {
+  BatteryStatus status;
+  status.voltage = batteryVoltage;
+  status.percent = getBatteryPercentage();
+  status.remainingMinutes = getRemainingPracticeMinutes();
+  status.isCharging = isCharging;
+  status.lowBattery = lowBattery;
+  return status;
+}
+
+void PowerManager::publishBatteryStatus() {
+  // 电压每次采样都有波动，只在显示的内容变化时发布
+  BatteryStatus status = getBatteryStatus();
+  if (batteryPublished &&
+      status.percent == publishedBattery.percent &&
+      status.remainingMinutes == publishedBattery.remainingMinutes &&
+      status.isCharging == publishedBattery.isCharging &&
+      status.lowBattery == publishedBattery.lowBattery) {
+    return;
+  }
+
+  publishedBattery = status;
+  batteryPublished = true;
+  EventBus::publishBattery(status);
+}
+
+const BatteryEstimator& PowerManager::getBatteryEstimator() const {
+  return battery;
+}
+
+void PowerManager::setSystemState(SystemState state) {
+  uint32_t now = millis();
+  battery.setState(state, now);
+  energy.setState(state, now);
+}
+
+void PowerManager::setConsumer(EnergyConsumer consumer, bool on, uint8_t level) {
+  energy.setConsumer(consumer, on, level, millis());
+}
+
+EnergyReport PowerManager::getEnergyReport() {
+  return energy.getReport(millis());
+}
+
+void PowerManager::printEnergyReport() {
+  EnergyReport report = energy.getReport(millis());
+  if (report.totalMs == 0) {
+    DEBUG_INFO("POWER", "功耗统计: 暂无数据");
+    return;
+  }
+
+  DEBUG_INFO("POWER", "=== 功耗统计 (%lu s) ===", (unsigned long)(report.totalMs / 1000));
+  DEBUG_INFO("POWER", "总耗电 %.2f mAh, 平均 %.1f mA (电压推算 %.1f mA)",
+             report.totalMah, EnergyProfiler::averageCurrent(report.totalMah, report.totalMs),
+             getAveragePowerConsumption());
+
+  for (uint8_t i = 0; i < ENERGY_CONSUMER_COUNT; i++) {
+    DEBUG_INFO("POWER", "  %-6s 占空比 %5.1f%%, %.2f mAh (%4.1f%%), 平均 %.1f mA",
+               EnergyProfiler::getConsumerName(i),
+               report.consumerOnMs[i] * 100.0f / report.totalMs,
+               report.consumerMah[i],
+               report.totalMah > 0 ? report.consumerMah[i] * 100.0f / report.totalMah : 0.0f,
+               EnergyProfiler::averageCurrent(report.consumerMah[i], report.totalMs));
+  }
+
+  for (uint8_t i = 0; i < SYSTEM_STATE_COUNT; i++) {
+    if (report.stateMs[i] == 0) {
+      continue;
+    }
+    DEBUG_INFO("POWER", "  状态%u: %lu s, %.2f mAh, 平均 %.1f mA",
+               i, (unsigned long)(report.stateMs[i] / 1000), report.stateMah[i],
+               EnergyProfiler::averageCurrent(report.stateMah[i], report.stateMs[i]));
+  }
+}
+
+float PowerManager::getAveragePowerConsumption() const {
+  uint64_t totalMs = 0;
+  float weighted = 0;
+  for (uint8_t i = 0; i < SYSTEM_STATE_COUNT; i++) {
+    uint32_t time = battery.getStateTime(i);
+    totalMs += time;
+    weighted += battery.getStateCurrent(i) * time;
+  }
+  return totalMs > 0 ? weighted / totalMs : battery.getStateCurrent(STATE_IDLE);
 }
 
 bool PowerManager::isLowBattery() const {
@@ -179,6 +368,8 @@ bool PowerManager::isBatteryCharging() const {
 
 void PowerManager::updateActivity() {
   lastActivity = millis();
+  // 用户操作后短时间保持最高频率，保证界面响应
+  governor.boost(lastActivity, DFS_BOOST_TIME);
 }
 
 unsigned long PowerManager::getTimeSinceLastActivity() const {
@@ -222,12 +413,12 @@ void PowerManager::enableLowPowerMode(bool enable) {
   lowPowerMode = enable;
   
   if (enable) {
-    // 降低CPU频率
-    setCpuFrequencyMhz(80);
+    // 限制调频上限
+    governor.setCeiling(DFS_LOW_POWER_FREQ_MHZ);
     DEBUG_PRINTLN("进入低功耗模式");
   } else {
-    // 恢复正常频率
-    setCpuFrequencyMhz(160);
+    // 恢复正常频率上限
+    governor.setCeiling(DFS_MAX_FREQ_MHZ);
     DEBUG_PRINTLN("退出低功耗模式");
   }
 }
@@ -285,7 +476,9 @@ void PowerManager::enterLightSleep() {
 }
 
 void PowerManager::enterDeepSleep() {
-  // 深度休眠，RAM数据丢失
+  // 深度休眠，RAM数据丢失，先确保待提交的数据已落盘
+  PersistenceWorker::flush();
+  DEBUG_FLUSH();
   esp_deep_sleep_start();
   
   // 这行代码不会执行，因为深度休眠会重启系统
@@ -309,7 +502,8 @@ esp_sleep_wakeup_cause_t PowerManager::getWakeupCause() const {
 }
 
 bool PowerManager::hasPowerEvent() const {
-  return lowBattery || criticalBattery;
+  // 只在电量状态变差时提示一次，否则低电量期间每轮都会弹出阻塞的警告
+  return powerEventPending;
 }
 
 String PowerManager::getPowerEventMessage() const {
@@ -322,14 +516,16 @@ String PowerManager::getPowerEventMessage() const {
 }
 
 void PowerManager::clearPowerEvent() {
-  // 清除电源事件标志
-  // 实际实现中可能需要更复杂的逻辑
+  powerEventPending = false;
 }
 
 void PowerManager::shutdown() {
   DEBUG_PRINTLN("系统关闭中...");
   
   // 保存重要数据
+  PersistenceWorker::flush();
+  DEBUG_FLUSH();
+  
   // 关闭外设
   // 进入深度休眠
   esp_deep_sleep_start();
@@ -337,6 +533,8 @@ void PowerManager::shutdown() {
 
 void PowerManager::restart() {
   DEBUG_PRINTLN("系统重启中...");
+  PersistenceWorker::flush();
+  DEBUG_FLUSH();
   ESP.restart();
 }
 
@@ -348,6 +546,12 @@ void PowerManager::printPowerInfo() const {
   DEBUG_PRINTLN("=== 电源信息 ===");
   DEBUG_PRINTF("电池电压: %.2f V\n", batteryVoltage);
   DEBUG_PRINTF("电池百分比: %d%%\n", getBatteryPercentage());
+  DEBUG_PRINTF("开路电压: %.3f V (负载压降 %.3f V)\n",
+               battery.getOpenCircuitVoltage(), battery.getSagVoltage());
+  DEBUG_PRINTF("剩余电量: %.0f mAh, 可练习约 %lu 分钟\n",
+               battery.getRemainingMah(), (unsigned long)getRemainingPracticeMinutes());
+  DEBUG_PRINTF("练习平均电流: %.1f mA, 总平均: %.1f mA\n",
+               battery.getStateCurrent(STATE_PRACTICING), getAveragePowerConsumption());
   DEBUG_PRINTF("充电状态: %s\n", isCharging ? "充电中" : "未充电");
   DEBUG_PRINTF("低电量: %s\n", lowBattery ? "是" : "否");
   DEBUG_PRINTF("严重低电量: %s\n", criticalBattery ? "是" : "否");
@@ -0,0 +1,132 @@
+#include "rolling_stats.h"
+
+RollingStats::RollingStats() {
+  clear();
+}
+
+void RollingStats::clear() {
+  head = 0;
+  count = 0;
+  clearTotals(week);
+  clearTotals(month);
+}
+
+void RollingStats::clearTotals(WindowTotals& totals) {
+  totals.totalTime = 0;
+  totals.sessionCount = 0;
+  totals.totalBreaks = 0;
+  totals.sampledTime = 0;
+  totals.weightedSum = 0;
+  totals.bestCenti = 0;
+  totals.activeDays = 0;
+}
+
+void RollingStats::addDay(WindowTotals& totals, const DaySummary& day) {
+  totals.totalTime += day.totalTime;
+  totals.sessionCount += day.sessionCount;
+  totals.totalBreaks += day.totalBreaks;
+  totals.sampledTime += day.sampledTime;
+  totals.weightedSum += (uint64_t)day.avgCenti * day.sampledTime;
+  if (day.sessionCount > 0) {
+    totals.activeDays++;
+  }
+}
+
+void RollingStats::removeDay(WindowTotals& totals, const DaySummary& day) {
+  totals.totalTime -= day.totalTime;
+  totals.sessionCount -= day.sessionCount;
+  totals.totalBreaks -= day.totalBreaks;
+  totals.sampledTime -= day.sampledTime;
+  totals.weightedSum -= (uint64_t)day.avgCenti * day.sampledTime;
+  if (day.sessionCount > 0) {
+    totals.activeDays--;
+  }
+}
+
+void RollingStats::pushDay(const DaySummary& day) {
+  // 周窗口：第WEEK_SPAN天滑出
+  if (count >= WEEK_SPAN) {
+    removeDay(week, getDay(WEEK_SPAN - 1));
+  }
+  // 月窗口：环形缓冲已满时，被覆盖的最旧一天滑出
+  if (count >= MONTH_SPAN) {
+    removeDay(month, days[head]);
+  }
+
+  days[head] = day;
+  head = (head + 1) % MONTH_SPAN;
+  if (count < MONTH_SPAN) {
+    count++;
+  }
+
+  addDay(week, day);
+  addDay(month, day);
+  week.bestCenti = scanBest(WEEK_SPAN);
+  month.bestCenti = scanBest(MONTH_SPAN);
+}
+
+uint16_t RollingStats::scanBest(int span) const {
+  uint16_t best = 0;
+  for (int i = 0; i < span && i < count; i++) {
+    const DaySummary& day = getDay(i);
+    if (day.bestCenti > best) {
+      best = day.bestCenti;
+    }
+  }
+  return best;
+}
+
+PeriodStats RollingStats::combine(const WindowTotals& totals, const DailyStats& today,
+                                  uint32_t todaySampledTime) {
+  PeriodStats stats;
+  stats.totalTime = totals.totalTime + today.totalTime;
+  stats.sessionCount = totals.sessionCount + today.sessionCount;
+  stats.totalBreaks = totals.totalBreaks + today.totalBreaks;
+  stats.activeDays = totals.activeDays + (today.sessionCount > 0 ? 1 : 0);
+
+  // 按有效采样时长加权，与今日平均的计算口径一致
+  uint64_t sampledTime = (uint64_t)totals.sampledTime + todaySampledTime;
+  double weighted = (double)totals.weightedSum / 100.0 +
+                    (double)today.avgStability * todaySampledTime;
+  stats.avgStability = sampledTime > 0 ? weighted / sampledTime : 0.0;
+
+  stats.bestStability = totals.bestCenti / 100.0f;
+  if (today.bestStability > stats.bestStability) {
+    stats.bestStability = today.bestStability;
+  }
+  return stats;
+}
+
+PeriodStats RollingStats::getWeekStats(const DailyStats& today, uint32_t todaySampledTime) const {
+  return combine(week, today, todaySampledTime);
+}
+
+PeriodStats RollingStats::getMonthStats(const DailyStats& today, uint32_t todaySampledTime) const {
+  return combine(month, today, todaySampledTime);
+}
+
+int RollingStats::getDayCount() const {
+  return count;
+}
+
+const DaySummary& RollingStats::getDay(int daysAgo) const {
+  int index = (head - 1 - daysAgo) % MONTH_SPAN;
+  if (index < 0) {
+    index += MONTH_SPAN;
+  }
+  return days[index];
+}
+
+DaySummary RollingStats::summarize(const DailyStats& stats, uint32_t sampledTime) {
+  DaySummary day;
+  day.year = stats.year;
+  day.month = stats.month;
+  day.day = stats.day;
+  day.totalTime = stats.totalTime;
+  day.sessionCount = stats.sessionCount > 0 ? stats.sessionCount : 0;
+  day.totalBreaks = stats.totalBreaks > 0 ? stats.totalBreaks : 0;
+  day.avgCenti = (uint16_t)(stats.avgStability * 100.0f + 0.5f);
+  day.bestCenti = (uint16_t)(stats.bestStability * 100.0f + 0.5f);
+  day.sampledTime = sampledTime;
+  return day;
+}
@@ -0,0 +1,64 @@
+#include "rtc_state.h"
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#include <rom/crc.h>
+#include <type_traits>
+
+// RTC内存中的快照镜像，必须是平凡类型：
+// 带构造函数的对象会在每次启动时被重新初始化，覆盖保留下来的数据
+struct RtcImage {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t length;
+  uint32_t crc;
+  ResumeState state;
+};
+
+static_assert(std::is_trivial<RtcImage>::value, "RTC快照必须是平凡类型");
+
+RTC_DATA_ATTR static RtcImage rtcImage;
+
+uint32_t RtcStateStore::checksum(const uint8_t* data, size_t length) {
+  return crc32_le(0, data, length);
+}
+
+void RtcStateStore::save(const ResumeState& state) {
+  rtcImage.state = state;
+  rtcImage.magic = RTC_STATE_MAGIC;
+  rtcImage.version = RTC_STATE_VERSION;
+  rtcImage.length = sizeof(ResumeState);
+  rtcImage.crc = checksum((const uint8_t*)&rtcImage.state, sizeof(ResumeState));
+
+  DEBUG_DEBUG("RTC", "状态快照已写入RTC内存 (%u字节)", (unsigned)sizeof(RtcImage));
+}
+
+bool RtcStateStore::load(ResumeState& state) {
+  if (rtcImage.magic != RTC_STATE_MAGIC) {
+    return false;
+  }
+
+  if (rtcImage.version != RTC_STATE_VERSION || rtcImage.length != sizeof(ResumeState)) {
+    DEBUG_WARN("RTC", "RTC快照版本不匹配 (v%u, %u字节)，丢弃", rtcImage.version, rtcImage.length);
+    invalidate();
+    return false;
+  }
+
+  uint32_t crc = checksum((const uint8_t*)&rtcImage.state, sizeof(ResumeState));
+  if (crc != rtcImage.crc) {
+    DEBUG_WARN("RTC", "RTC快照校验失败: %08lx != %08lx", (unsigned long)crc, (unsigned long)rtcImage.crc);
+    invalidate();
+    return false;
+  }
+
+  state = rtcImage.state;
+  return true;
+}
+
+void RtcStateStore::invalidate() {
+  rtcImage.magic = 0;
+}
+
+bool RtcStateStore::isResumableWakeup() {
+  esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+  return cause == ESP_SLEEP_WAKEUP_GPIO || cause == ESP_SLEEP_WAKEUP_TIMER;
+}
@@ -1,5 +1,7 @@
 #include "sensor_manager.h"
-#include <EEPROM.h>
+#include "persistence_worker.h"
+#include "perf_timer.h"
+#include "event_bus.h"
 #include <math.h>
 
 SensorManager::SensorManager() {
@@ -8,6 +10,8 @@ SensorManager::SensorManager() {
     accelFilter[i] = 0.0;
     gyroFilter[i] = 0.0;
   }
+  motionSample = MotionSample();
+  memset(rawCounts, 0, sizeof(rawCounts));
   
   // 初始化稳定性历史数据
   for (int i = 0; i < STABILITY_WINDOW_SIZE; i++) {
@@ -23,13 +27,29 @@ SensorManager::SensorManager() {
   stabilityData.breakCount = 0;
 }
 
-bool SensorManager::initialize() {
+void SensorManager::beginWarmup() {
+  if (warmupStarted) {
+    return;
+  }
+  
   // 初始化I2C
   Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
   Wire.setClock(400000); // 400kHz
   
-  // 初始化MPU6050
+  // 唤醒MPU6050，陀螺仪需要一段时间稳定，期间可以先初始化其它外设
   mpu.initialize();
+  warmupStartTime = millis();
+  warmupStarted = true;
+}
+
+bool SensorManager::initialize() {
+  beginWarmup();
+  
+  // 预热时间不足时补足剩余部分
+  unsigned long elapsed = millis() - warmupStartTime;
+  if (elapsed < SENSOR_WARMUP_TIME) {
+    delay(SENSOR_WARMUP_TIME - elapsed);
+  }
   
   // 检查连接
   if (!mpu.testConnection()) {
@@ -42,6 +62,19 @@ bool SensorManager::initialize() {
   mpu.setFullScaleGyroRange(MPU6050_GYRO_FS_250);  // ±250°/s
   mpu.setDLPFMode(MPU6050_DLPF_BW_20);             // 20Hz低通滤波
   mpu.setRate(MPU6050_SAMPLE_RATE - 1);            // 设置采样率
+#if MPU_INT_PIN >= 0
+  // 数据就绪中断作为主循环的传感器节拍: 开启DLPF时输出频率 = 1kHz / (1 + 分频)
+  mpu.setRate(SENSOR_READ_INTERVAL - 1);
+  mpu.setIntDataReadyEnabled(true);
+#endif
+
+  // 硬件运动检测用于识别敲击: 5Hz高通去掉重力后与阈值比较，结果在中断状态寄存器中保持到读取。
+  // 中断先保持关闭，由setMotionDetectionEnabled()随运动手势输入开启
+  mpu.setDHPFMode(MPU6050_DHPF_5);
+  mpu.setMotionDetectionThreshold(MOTION_HW_THRESHOLD);
+  mpu.setMotionDetectionDuration(1);
+  mpu.setIntMotionEnabled(false);
+  motionDetectionEnabled = false;
   
   // 加载校准数据
   loadCalibration();
@@ -99,8 +132,13 @@ bool SensorManager::updateCalibration() {
   }
   
   // 读取原始数据
-  int16_t ax, ay, az, gx, gy, gz;
-  mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
+  readRawCounts();
+  int16_t ax = rawCounts[0];
+  int16_t ay = rawCounts[1];
+  int16_t az = rawCounts[2];
+  int16_t gx = rawCounts[3];
+  int16_t gy = rawCounts[4];
+  int16_t gz = rawCounts[5];
   
   // 累计数据
   calibrationSum[0] += ax / ACCEL_SCALE_FACTOR;
@@ -150,12 +188,12 @@ bool SensorManager::isCalibrationInProgress() const {
 
 void SensorManager::loadCalibration() {
   // 从EEPROM加载校准数据
-  EEPROM.begin(EEPROM_SIZE);
+  PersistenceWorker::begin();
   
   // 检查校准数据有效性标志
-  uint8_t validFlag = EEPROM.read(EEPROM_SETTINGS_ADDR + 50);
+  uint8_t validFlag = PersistenceWorker::readByte(EEPROM_CALIBRATION_ADDR);
   if (validFlag == 0xAA) {
-    EEPROM.get(EEPROM_SETTINGS_ADDR + 51, calibration);
+    PersistenceWorker::get(EEPROM_CALIBRATION_ADDR + 1, calibration);
     DEBUG_PRINTLN("校准数据已加载");
   } else {
     // 使用默认校准数据
@@ -171,22 +209,52 @@ void SensorManager::loadCalibration() {
 }
 
 void SensorManager::saveCalibration() {
-  // 保存校准数据到EEPROM
-  EEPROM.begin(EEPROM_SIZE);
-  EEPROM.write(EEPROM_SETTINGS_ADDR + 50, 0xAA); // 有效性标志
-  EEPROM.put(EEPROM_SETTINGS_ADDR + 51, calibration);
-  EEPROM.commit();
-  DEBUG_PRINTLN("校准数据已保存");
+  // 保存校准数据到EEPROM（由后台任务写入Flash，不阻塞采样）
+  PersistenceWorker::put(EEPROM_CALIBRATION_ADDR + 1, calibration);
+  PersistenceWorker::writeByte(EEPROM_CALIBRATION_ADDR, 0xAA); // 有效性标志
+  PersistenceWorker::requestCommit();
+  DEBUG_PRINTLN("校准数据已提交保存");
+}
+
+void SensorManager::captureResumeState(SensorResumeState& state) const {
+  state.calibration = calibration;
+  memcpy(state.accelFilter, accelFilter, sizeof(accelFilter));
+  memcpy(state.gyroFilter, gyroFilter, sizeof(gyroFilter));
+  memcpy(state.stabilityHistory, stabilityHistory, sizeof(stabilityHistory));
+  state.historyIndex = historyIndex;
+  state.historyFull = historyFull;
+  state.stabilityData = stabilityData;
+}
+
+void SensorManager::restoreResumeState(const SensorResumeState& state) {
+  // 滤波器和稳定性窗口从休眠前继续，避免唤醒后评分从0重新爬升
+  calibration = state.calibration;
+  memcpy(accelFilter, state.accelFilter, sizeof(accelFilter));
+  memcpy(gyroFilter, state.gyroFilter, sizeof(gyroFilter));
+  memcpy(stabilityHistory, state.stabilityHistory, sizeof(stabilityHistory));
+  historyIndex = constrain(state.historyIndex, 0, STABILITY_WINDOW_SIZE - 1);
+  historyFull = state.historyFull;
+  stabilityData = state.stabilityData;
+
+  // 休眠期间的时间不计入破定间隔
+  stabilityData.lastBreakTime = 0;
 }
 
 bool SensorManager::readSensorData() {
+  PERF_SCOPE("SENSOR_READ");
+
   if (isCalibrating) {
     return updateCalibration();
   }
   
   // 读取原始数据
-  int16_t ax, ay, az, gx, gy, gz;
-  mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
+  readRawCounts();
+  int16_t ax = rawCounts[0];
+  int16_t ay = rawCounts[1];
+  int16_t az = rawCounts[2];
+  int16_t gx = rawCounts[3];
+  int16_t gy = rawCounts[4];
+  int16_t gz = rawCounts[5];
   
   // 转换为物理单位
   rawData.accelX = ax / ACCEL_SCALE_FACTOR;
@@ -197,12 +265,24 @@ bool SensorManager::readSensorData() {
   rawData.gyroZ = gz / GYRO_SCALE_FACTOR;
   rawData.timestamp = millis();
   
+  // 敲击判定使用未滤波的加速度模长，读取中断状态同时清除运动检测标志
+  // 运动检测关闭时 (练习、校准) 不读中断状态，省去每次采样的一次I2C读取
+  motionSample.shock = fabs(sqrt(rawData.accelX * rawData.accelX +
+                                 rawData.accelY * rawData.accelY +
+                                 rawData.accelZ * rawData.accelZ) - 1.0);
+  motionSample.hwMotion = motionDetectionEnabled && readIntMotionStatus();
+  
   // 应用校准
   applyCalibration(rawData);
   
   // 应用滤波
   applyLowPassFilter(rawData);
   
+  motionSample.accelX = rawData.accelX;
+  motionSample.accelY = rawData.accelY;
+  motionSample.accelZ = rawData.accelZ;
+  motionSample.timestamp = rawData.timestamp;
+  
   // 计算稳定性评分
   float score = calculateStabilityScore(rawData);
   updateStabilityHistory(score);
@@ -222,9 +302,17 @@ bool SensorManager::readSensorData() {
   stabilityData.isStable = (score >= STABILITY_THRESHOLD);
   
   // 检查是否破定
+  bool newBreak = false;
   if (!stabilityData.isStable && (millis() - stabilityData.lastBreakTime) > 1000) {
     stabilityData.breakCount++;
     stabilityData.lastBreakTime = millis();
+    newBreak = true;
+  }
+  
+  // 发布评分，每次破定只发布一次破定事件
+  EventBus::publishScore(stabilityData);
+  if (newBreak) {
+    EventBus::publishBreak(stabilityData);
   }
   
   return true;
@@ -315,6 +403,48 @@ SensorData SensorManager::getRawData() const {
   return rawData;
 }
 
+void SensorManager::readRawCounts() {
+  uint32_t startUs = micros();
+  mpu.getMotion6(&rawCounts[0], &rawCounts[1], &rawCounts[2], &rawCounts[3], &rawCounts[4], &rawCounts[5]);
+  busTimeUs += micros() - startUs;
+}
+
+bool SensorManager::readIntMotionStatus() {
+  uint32_t startUs = micros();
+  bool motion = mpu.getIntMotionStatus();
+  busTimeUs += micros() - startUs;
+  return motion;
+}
+
+void SensorManager::setMotionDetectionEnabled(bool enabled) {
+  if (enabled == motionDetectionEnabled) {
+    return;
+  }
+  // 关闭后MPU6050不再产生运动中断: 使用INT引脚作传感器节拍时 (MPU_INT_PIN)，
+  // 运动脉冲也会触发一次额外读取，练习中必须关闭以免打乱稳定性窗口
+  mpu.setIntMotionEnabled(enabled);
+  motionDetectionEnabled = enabled;
+  if (enabled) {
+    // 丢弃关闭期间残留的运动标志
+    readIntMotionStatus();
+  }
+  motionSample.hwMotion = false;
+}
+
+uint32_t SensorManager::takeBusTimeUs() {
+  uint32_t us = busTimeUs;
+  busTimeUs = 0;
+  return us;
+}
+
+void SensorManager::getRawCounts(int16_t counts[6]) const {
+  memcpy(counts, rawCounts, sizeof(rawCounts));
+}
+
+MotionSample SensorManager::getMotionSample() const {
+  return motionSample;
+}
+
 SensorData SensorManager::getFilteredData() const {
   SensorData filtered = rawData;
   filtered.accelX = accelFilter[0];
@@ -0,0 +1,151 @@
+#include "serial_console.h"
+#include <stdarg.h>
+
+const ConsoleCommand* SerialConsole::commands = nullptr;
+uint8_t SerialConsole::commandCount = 0;
+
+// ==================== 分词 ====================
+static const char* skipSpaces(const char* p) {
+  while (*p == ' ' || *p == '\t') {
+    p++;
+  }
+  return p;
+}
+
+static size_t wordLength(const char* p) {
+  size_t n = 0;
+  while (p[n] != '\0' && p[n] != ' ' && p[n] != '\t') {
+    n++;
+  }
+  return n;
+}
+
+static bool wordIs(const char* word, size_t length, const char* name) {
+  return strlen(name) == length && strncmp(word, name, length) == 0;
+}
+
+static bool parseSwitch(const char* value, size_t length, bool& result) {
+  if (wordIs(value, length, "on") || wordIs(value, length, "1")) {
+    result = true;
+    return true;
+  }
+  if (wordIs(value, length, "off") || wordIs(value, length, "0")) {
+    result = false;
+    return true;
+  }
+  return false;
+}
+
+static bool parseNumber(const char* value, size_t length, float minValue, float maxValue, float& result) {
+  char buffer[16];
+  if (length >= sizeof(buffer)) {
+    return false;
+  }
+  memcpy(buffer, value, length);
+  buffer[length] = '\0';
+
+  char* end;
+  float number = strtof(buffer, &end);
+  if (end == buffer || *end != '\0' || number < minValue || number > maxValue) {
+    return false;
+  }
+  result = number;
+  return true;
+}
+
+// ==================== 命令分发 ====================
+void SerialConsole::begin(const ConsoleCommand* table, uint8_t count) {
+  commands = table;
+  commandCount = count;
+#if !DEBUG
+  // 调试输出关闭时DEBUG_INIT()为空，命令台自己打开串口
+  Serial.begin(DEBUG_SERIAL_SPEED);
+#endif
+}
+
+bool SerialConsole::dispatch(const char* line) {
+  const char* name = skipSpaces(line);
+  size_t length = wordLength(name);
+  if (length == 0) {
+    return true;
+  }
+
+  for (uint8_t i = 0; i < commandCount; i++) {
+    if (wordIs(name, length, commands[i].name)) {
+      commands[i].handler(skipSpaces(name + length));
+      return true;
+    }
+  }
+  return false;
+}
+
+void SerialConsole::printHelp() {
+  printf("=== 串口命令 ===\n");
+  for (uint8_t i = 0; i < commandCount; i++) {
+    printf("  %s %s - %s\n", commands[i].name, commands[i].usage, commands[i].help);
+  }
+}
+
+// ==================== 输出 ====================
+void SerialConsole::printf(const char* format, ...) {
+  char buffer[CONSOLE_LINE_MAX];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length <= 0) {
+    return;
+  }
+  if ((size_t)length >= sizeof(buffer)) {
+    // 截断时保留行尾换行
+    length = sizeof(buffer) - 1;
+    buffer[length - 1] = '\n';
+  }
+  Serial.write((const uint8_t*)buffer, length);
+}
+
+bool SerialConsole::applySetting(SystemSettings& settings, const char* args) {
+  const char* key = skipSpaces(args);
+  size_t keyLength = wordLength(key);
+  const char* value = skipSpaces(key + keyLength);
+  size_t valueLength = wordLength(value);
+  if (keyLength == 0 || valueLength == 0 || *skipSpaces(value + valueLength) != '\0') {
+    return false;
+  }
+
+  float number;
+  bool flag;
+  if (wordIs(key, keyLength, "threshold")) {
+    if (!parseNumber(value, valueLength, 0, 100, number)) return false;
+    settings.stabilityThreshold = number;
+  } else if (wordIs(key, keyLength, "sound")) {
+    if (!parseSwitch(value, valueLength, flag)) return false;
+    settings.soundEnabled = flag;
+  } else if (wordIs(key, keyLength, "brightness")) {
+    if (!parseNumber(value, valueLength, 0, 255, number)) return false;
+    settings.displayBrightness = (uint8_t)number;
+  } else if (wordIs(key, keyLength, "practice")) {
+    if (!parseNumber(value, valueLength, 1, MAX_PRACTICE_TIME / 60000, number)) return false;
+    settings.practiceTime = (unsigned long)(number * 60000);
+  } else if (wordIs(key, keyLength, "autosleep")) {
+    if (!parseSwitch(value, valueLength, flag)) return false;
+    settings.autoSleep = flag;
+  } else if (wordIs(key, keyLength, "sleep")) {
+    if (!parseNumber(value, valueLength, 1, 60, number)) return false;
+    settings.sleepTimeout = (unsigned long)(number * 60000);
+  } else if (wordIs(key, keyLength, "calibration")) {
+    if (!parseSwitch(value, valueLength, flag)) return false;
+    settings.calibrationEnabled = flag;
+  } else if (wordIs(key, keyLength, "language")) {
+    if (wordIs(value, valueLength, "zh")) {
+      settings.language = 0;
+    } else if (wordIs(value, valueLength, "en")) {
+      settings.language = 1;
+    } else {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
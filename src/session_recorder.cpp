@@ -0,0 +1,374 @@
+#include "session_recorder.h"
+#include <LittleFS.h>
+
+#define SESSION_RECORD_MAGIC 0x3152535A  // "ZSR1"
+#define SESSION_RECORD_VERSION 1
+
+SessionRecorder::SessionRecorder() {
+  fsReady = false;
+  recording = false;
+  sessionId = 0;
+  latestSessionId = 0;
+  bucketSum = 0.0;
+  bucketCount = 0;
+  bucketStart = 0;
+  blockCount = 0;
+  totalPoints = 0;
+  flushedBlocks = 0;
+}
+
+bool SessionRecorder::initialize() {
+  // 挂载文件系统，首次使用时自动格式化
+  if (!LittleFS.begin(true)) {
+    DEBUG_ERROR("RECORDER", "LittleFS挂载失败，会话曲线记录不可用");
+    fsReady = false;
+    return false;
+  }
+
+  if (!LittleFS.exists(SESSION_RECORD_DIR)) {
+    LittleFS.mkdir(SESSION_RECORD_DIR);
+  }
+
+  // 扫描目录，找出最新的会话序号
+  latestSessionId = 0;
+  File dir = LittleFS.open(SESSION_RECORD_DIR);
+  if (dir && dir.isDirectory()) {
+    File entry = dir.openNextFile();
+    while (entry) {
+      uint32_t id = strtoul(entry.name(), nullptr, 10);
+      if (id > latestSessionId) {
+        latestSessionId = id;
+      }
+      entry.close();
+      entry = dir.openNextFile();
+    }
+    dir.close();
+  }
+
+  fsReady = true;
+  DEBUG_INFO("RECORDER", "会话记录器初始化成功，最新会话: %lu", (unsigned long)latestSessionId);
+  return true;
+}
+
+bool SessionRecorder::begin(const DateTime& startDate) {
+  if (recording) {
+    finish();
+  }
+
+  bucketSum = 0.0;
+  bucketCount = 0;
+  bucketStart = 0;
+  blockCount = 0;
+  totalPoints = 0;
+  flushedBlocks = 0;
+
+  if (!fsReady) {
+    return false;
+  }
+
+  sessionId = latestSessionId + 1;
+  currentPath = pathForSession(sessionId);
+
+  // 写入文件头
+  SessionRecordHeader header = {};
+  header.magic = SESSION_RECORD_MAGIC;
+  header.version = SESSION_RECORD_VERSION;
+  header.sampleInterval = SESSION_RECORD_INTERVAL;
+  header.sessionId = sessionId;
+  header.year = startDate.year;
+  header.month = startDate.month;
+  header.day = startDate.day;
+  header.hour = startDate.hour;
+  header.minute = startDate.minute;
+
+  File file = LittleFS.open(currentPath, FILE_WRITE);
+  if (!file) {
+    DEBUG_ERROR("RECORDER", "无法创建会话记录文件: %s", currentPath.c_str());
+    return false;
+  }
+  file.write((const uint8_t*)&header, sizeof(header));
+  file.close();
+
+  latestSessionId = sessionId;
+  recording = true;
+
+  // 只保留最近的若干个会话
+  pruneOldRecords();
+
+  DEBUG_INFO("RECORDER", "开始记录会话 %lu", (unsigned long)sessionId);
+  return true;
+}
+
+void SessionRecorder::addSample(float score, unsigned long timestamp) {
+  if (!recording) {
+    return;
+  }
+
+  if (bucketCount == 0 && bucketStart == 0) {
+    bucketStart = timestamp;
+  }
+
+  // 跨过采样间隔时先结算上一个点
+  if (timestamp - bucketStart >= SESSION_RECORD_INTERVAL) {
+    closeBucket();
+    bucketStart = timestamp;
+  }
+
+  bucketSum += score;
+  bucketCount++;
+}
+
+void SessionRecorder::pause() {
+  if (!recording) {
+    return;
+  }
+
+  // 暂停时结算不完整的采样点，序列只覆盖有效练习时间
+  closeBucket();
+}
+
+void SessionRecorder::resume(unsigned long timestamp) {
+  if (!recording) {
+    return;
+  }
+
+  bucketStart = timestamp;
+}
+
+void SessionRecorder::finish() {
+  if (!recording) {
+    return;
+  }
+
+  closeBucket();
+  flushBlock();
+  recording = false;
+
+  DEBUG_INFO("RECORDER", "会话 %lu 记录完成，共%lu点，%lu块",
+             (unsigned long)sessionId, (unsigned long)totalPoints, (unsigned long)flushedBlocks);
+}
+
+void SessionRecorder::suspend() {
+  if (!recording) {
+    return;
+  }
+
+  // 块之间相互独立，提前写入不完整的块不影响解码
+  closeBucket();
+  flushBlock();
+}
+
+bool SessionRecorder::reattach(uint32_t id, uint32_t points, uint32_t blocks) {
+  if (!fsReady || id == 0) {
+    return false;
+  }
+
+  String path = pathForSession(id);
+  if (!LittleFS.exists(path)) {
+    DEBUG_WARN("RECORDER", "会话记录文件不存在，无法继续记录: %s", path.c_str());
+    return false;
+  }
+
+  sessionId = id;
+  currentPath = path;
+  if (id > latestSessionId) {
+    latestSessionId = id;
+  }
+  bucketSum = 0.0;
+  bucketCount = 0;
+  bucketStart = 0;
+  blockCount = 0;
+  totalPoints = points;
+  flushedBlocks = blocks;
+  recording = true;
+
+  DEBUG_INFO("RECORDER", "继续记录会话 %lu (已有%lu点)", (unsigned long)sessionId, (unsigned long)totalPoints);
+  return true;
+}
+
+void SessionRecorder::closeBucket() {
+  if (bucketCount == 0) {
+    return;
+  }
+
+  float avg = bucketSum / bucketCount;
+  appendPoint((uint8_t)constrain((int)(avg + 0.5f), 0, 100));
+
+  bucketSum = 0.0;
+  bucketCount = 0;
+}
+
+void SessionRecorder::appendPoint(uint8_t value) {
+  block[blockCount++] = value;
+  totalPoints++;
+
+  // 块满后整块写入Flash，避免逐点写入
+  if (blockCount >= SESSION_RECORD_BLOCK_SIZE) {
+    flushBlock();
+  }
+}
+
+bool SessionRecorder::flushBlock() {
+  if (blockCount == 0) {
+    return true;
+  }
+
+  uint8_t encoded[SESSION_RECORD_BLOCK_SIZE + 1];
+  size_t length = encodeBlock(block, blockCount, encoded);
+  blockCount = 0;
+
+  File file = LittleFS.open(currentPath, FILE_APPEND);
+  if (!file) {
+    DEBUG_WARN("RECORDER", "会话记录块写入失败，丢弃%u字节", (unsigned)length);
+    return false;
+  }
+  file.write(encoded, length);
+  file.close();
+
+  flushedBlocks++;
+  DEBUG_DEBUG("RECORDER", "会话记录块已写入: %u字节", (unsigned)length);
+  return true;
+}
+
+void SessionRecorder::pruneOldRecords() {
+  if (sessionId <= SESSION_RECORD_MAX_FILES) {
+    return;
+  }
+
+  String oldPath = pathForSession(sessionId - SESSION_RECORD_MAX_FILES);
+  if (LittleFS.exists(oldPath)) {
+    LittleFS.remove(oldPath);
+    DEBUG_DEBUG("RECORDER", "删除旧会话记录: %s", oldPath.c_str());
+  }
+}
+
+String SessionRecorder::pathForSession(uint32_t id) const {
+  return String(SESSION_RECORD_DIR) + "/" + String(id) + ".zsr";
+}
+
+bool SessionRecorder::isReady() const {
+  return fsReady;
+}
+
+bool SessionRecorder::isRecording() const {
+  return recording;
+}
+
+uint32_t SessionRecorder::getCurrentSessionId() const {
+  return sessionId;
+}
+
+uint32_t SessionRecorder::getLatestSessionId() const {
+  return latestSessionId;
+}
+
+uint32_t SessionRecorder::getPointCount() const {
+  return totalPoints;
+}
+
+uint32_t SessionRecorder::getBlockCount() const {
+  return flushedBlocks;
+}
+
+size_t SessionRecorder::loadSeries(uint32_t id, uint8_t* points, size_t maxPoints,
+                                   SessionRecordHeader* header) const {
+  if (!fsReady || points == nullptr || maxPoints == 0) {
+    return 0;
+  }
+
+  File file = LittleFS.open(pathForSession(id), FILE_READ);
+  if (!file) {
+    return 0;
+  }
+
+  SessionRecordHeader fileHeader;
+  if (file.read((uint8_t*)&fileHeader, sizeof(fileHeader)) != sizeof(fileHeader) ||
+      fileHeader.magic != SESSION_RECORD_MAGIC) {
+    DEBUG_WARN("RECORDER", "会话记录 %lu 文件头无效", (unsigned long)id);
+    file.close();
+    return 0;
+  }
+  if (header) {
+    *header = fileHeader;
+  }
+
+  // 逐块解码
+  size_t total = 0;
+  uint8_t encoded[256];
+  while (file.available() && total < maxPoints) {
+    int count = file.read();
+    if (count <= 0) {
+      break;
+    }
+    encoded[0] = (uint8_t)count;
+    if (file.read(encoded + 1, count) != (size_t)count) {
+      break;
+    }
+    total += decodeBlock(encoded, count + 1, points + total, maxPoints - total);
+  }
+  file.close();
+
+  // 当前正在记录的会话还需加上RAM中尚未写入的部分
+  if (recording && id == sessionId) {
+    for (uint16_t i = 0; i < blockCount && total < maxPoints; i++) {
+      points[total++] = block[i];
+    }
+  }
+
+  return total;
+}
+
+File SessionRecorder::openRecord(uint32_t id) const {
+  if (!fsReady || !LittleFS.exists(pathForSession(id))) {
+    return File();
+  }
+  return LittleFS.open(pathForSession(id), FILE_READ);
+}
+
+size_t SessionRecorder::encodeBlock(const uint8_t* points, size_t count, uint8_t* out) {
+  if (count == 0) {
+    return 0;
+  }
+  if (count > 255) {
+    count = 255;
+  }
+
+  out[0] = (uint8_t)count;
+  out[1] = points[0];
+  for (size_t i = 1; i < count; i++) {
+    // 评分范围0-100，差分必然落在int8范围内
+    out[i + 1] = (uint8_t)(int8_t)((int)points[i] - (int)points[i - 1]);
+  }
+
+  return count + 1;
+}
+
+size_t SessionRecorder::decodeBlock(const uint8_t* in, size_t length, uint8_t* points, size_t maxPoints) {
+  if (length < 2 || maxPoints == 0) {
+    return 0;
+  }
+
+  size_t count = in[0];
+  if (count == 0 || length < count + 1) {
+    return 0;
+  }
+  if (count > maxPoints) {
+    count = maxPoints;
+  }
+
+  points[0] = in[1];
+  for (size_t i = 1; i < count; i++) {
+    points[i] = (uint8_t)((int)points[i - 1] + (int8_t)in[i + 1]);
+  }
+
+  return count;
+}
+
+void SessionRecorder::printRecorderInfo() const {
+  DEBUG_PRINTLN("=== 会话记录器信息 ===");
+  DEBUG_PRINTF("文件系统: %s\n", fsReady ? "就绪" : "不可用");
+  DEBUG_PRINTF("记录状态: %s\n", recording ? "记录中" : "空闲");
+  DEBUG_PRINTF("当前会话: %lu\n", (unsigned long)sessionId);
+  DEBUG_PRINTF("记录点数: %lu (缓冲%u点)\n", (unsigned long)totalPoints, blockCount);
+  DEBUG_PRINTF("已写入块: %lu\n", (unsigned long)flushedBlocks);
+}
@@ -0,0 +1,203 @@
+#include "stability_stats.h"
+
+static_assert(STABILITY_HISTOGRAM_FINE_START % STABILITY_HISTOGRAM_COARSE_WIDTH == 0,
+              "细分档起点必须落在粗分档边界上");
+
+// 粗分档数量，之后每档1分
+static const int COARSE_BINS = STABILITY_HISTOGRAM_FINE_START / STABILITY_HISTOGRAM_COARSE_WIDTH;
+
+static inline int binIndexOf(float score) {
+  if (score <= 0.0f) {
+    return 0;
+  }
+  if (score < STABILITY_HISTOGRAM_FINE_START) {
+    return (int)(score / STABILITY_HISTOGRAM_COARSE_WIDTH);
+  }
+  int index = COARSE_BINS + (int)(score - STABILITY_HISTOGRAM_FINE_START);
+  return index >= STABILITY_HISTOGRAM_BINS ? STABILITY_HISTOGRAM_BINS - 1 : index;
+}
+
+static inline float binLowerEdge(int index) {
+  if (index < COARSE_BINS) {
+    return (float)index * STABILITY_HISTOGRAM_COARSE_WIDTH;
+  }
+  return (float)(STABILITY_HISTOGRAM_FINE_START + index - COARSE_BINS);
+}
+
+static inline float binWidth(int index) {
+  return index < COARSE_BINS ? (float)STABILITY_HISTOGRAM_COARSE_WIDTH : 1.0f;
+}
+
+StabilityAggregator::StabilityAggregator() {
+  reset(STABILITY_THRESHOLD);
+}
+
+void StabilityAggregator::reset(float stabilityThreshold) {
+  clearHistogram(state.histogram);
+  state.weightedSum = 0;
+  state.sampledTime = 0;
+  state.stableTime = 0;
+  state.threshold = stabilityThreshold;
+  state.minScore = 0.0;
+  state.maxScore = 0.0;
+  state.lastScore = 0.0;
+  state.lastTimestamp = 0;
+  state.hasLast = false;
+  state.sampleCount = 0;
+}
+
+void StabilityAggregator::accumulate(uint32_t timestamp) {
+  if (!state.hasLast) {
+    return;
+  }
+
+  uint32_t dt = timestamp - state.lastTimestamp;
+  // 主循环异常卡顿时限制单点权重，避免一个点主导整个会话
+  if (dt > STABILITY_MAX_SAMPLE_GAP) {
+    dt = STABILITY_MAX_SAMPLE_GAP;
+  }
+  if (dt == 0) {
+    return;
+  }
+
+  uint32_t centiScore = (uint32_t)(state.lastScore * 100.0f + 0.5f);
+  state.weightedSum += (uint64_t)centiScore * dt;
+  state.sampledTime += dt;
+  state.histogram.bins[binIndexOf(state.lastScore)] += dt;
+
+  if (state.lastScore >= state.threshold) {
+    state.stableTime += dt;
+  }
+
+  state.lastTimestamp = timestamp;
+}
+
+void StabilityAggregator::addSample(float score, uint32_t timestamp) {
+  if (score < 0.0f) score = 0.0f;
+  if (score > 100.0f) score = 100.0f;
+
+  accumulate(timestamp);
+
+  if (state.sampleCount == 0) {
+    state.minScore = score;
+    state.maxScore = score;
+  } else {
+    if (score < state.minScore) state.minScore = score;
+    if (score > state.maxScore) state.maxScore = score;
+  }
+
+  state.lastScore = score;
+  state.lastTimestamp = timestamp;
+  state.hasLast = true;
+  state.sampleCount++;
+}
+
+void StabilityAggregator::pause(uint32_t timestamp) {
+  // 结算最后一个点，之后到下一次采样之间的时间不计入
+  accumulate(timestamp);
+  state.hasLast = false;
+}
+
+float StabilityAggregator::getMean() const {
+  if (state.sampledTime == 0) {
+    return state.hasLast ? state.lastScore : 0.0f;
+  }
+  return (float)((double)state.weightedSum / state.sampledTime / 100.0);
+}
+
+float StabilityAggregator::getMedian() const {
+  return getPercentile(0.5f);
+}
+
+float StabilityAggregator::getPercentile(float q) const {
+  if (state.sampledTime == 0) {
+    return state.hasLast ? state.lastScore : 0.0f;
+  }
+  // 档内插值可能越出实际出现过的评分 (如恒定99.9分插值为99.5)，限制在最低/最高分之间
+  float value = percentileOf(state.histogram, q);
+  if (value < state.minScore) value = state.minScore;
+  if (value > state.maxScore) value = state.maxScore;
+  return value;
+}
+
+float StabilityAggregator::getMinScore() const {
+  return state.minScore;
+}
+
+float StabilityAggregator::getMaxScore() const {
+  return state.maxScore;
+}
+
+uint32_t StabilityAggregator::getSampledTime() const {
+  return state.sampledTime;
+}
+
+uint32_t StabilityAggregator::getStableTime() const {
+  return state.stableTime;
+}
+
+uint32_t StabilityAggregator::getSampleCount() const {
+  return state.sampleCount;
+}
+
+const StabilityHistogram& StabilityAggregator::getHistogram() const {
+  return state.histogram;
+}
+
+const StabilityAggregatorState& StabilityAggregator::getState() const {
+  return state;
+}
+
+void StabilityAggregator::restoreState(const StabilityAggregatorState& saved) {
+  state = saved;
+}
+
+void StabilityAggregator::clearHistogram(StabilityHistogram& hist) {
+  for (int i = 0; i < STABILITY_HISTOGRAM_BINS; i++) {
+    hist.bins[i] = 0;
+  }
+}
+
+void StabilityAggregator::addToHistogram(StabilityHistogram& hist, float score, uint32_t duration) {
+  hist.bins[binIndexOf(score)] += duration;
+}
+
+void StabilityAggregator::mergeHistogram(StabilityHistogram& into, const StabilityHistogram& from) {
+  for (int i = 0; i < STABILITY_HISTOGRAM_BINS; i++) {
+    into.bins[i] += from.bins[i];
+  }
+}
+
+uint32_t StabilityAggregator::histogramTotal(const StabilityHistogram& hist) {
+  uint32_t total = 0;
+  for (int i = 0; i < STABILITY_HISTOGRAM_BINS; i++) {
+    total += hist.bins[i];
+  }
+  return total;
+}
+
+float StabilityAggregator::percentileOf(const StabilityHistogram& hist, float q) {
+  uint32_t total = histogramTotal(hist);
+  if (total == 0) {
+    return 0.0f;
+  }
+
+  if (q < 0.0f) q = 0.0f;
+  if (q > 1.0f) q = 1.0f;
+
+  // 找到累计时长越过目标的档位，在档内线性插值
+  float target = q * total;
+  float cumulative = 0.0f;
+  for (int i = 0; i < STABILITY_HISTOGRAM_BINS; i++) {
+    if (hist.bins[i] == 0) {
+      continue;
+    }
+    if (cumulative + hist.bins[i] >= target) {
+      float fraction = (target - cumulative) / hist.bins[i];
+      return binLowerEdge(i) + fraction * binWidth(i);
+    }
+    cumulative += hist.bins[i];
+  }
+
+  return 100.0f;
+}
@@ -0,0 +1,79 @@
+#include "state_machine.h"
+
+StateMachine::StateMachine(const StateDescriptor* stateTable, SystemState initial)
+  : table(stateTable), state(initial) {
+}
+
+void StateMachine::enter(SystemState to) {
+  state = to;
+  sensorTickCount = 0;
+  enteredMs = millis();
+  if (table[to].onEnter) {
+    table[to].onEnter();
+  }
+}
+
+bool StateMachine::change(SystemState to) {
+  if (!StateTable::canTransition(state, to)) {
+    rejectedCount++;
+    return false;
+  }
+
+  if (table[state].onExit) {
+    table[state].onExit();
+  }
+  transitionCount++;
+  enter(to);
+  return true;
+}
+
+void StateMachine::restore(SystemState to) {
+  if (to < SYSTEM_STATE_COUNT) {
+    enter(to);
+  }
+}
+
+void StateMachine::tick() {
+  if (table[state].onTick) {
+    table[state].onTick();
+  }
+}
+
+bool StateMachine::takeSensorTick() {
+  uint8_t divider = table[state].sensorDivider;
+  if (divider == 0) {
+    return false;
+  }
+  // 进入状态后的第一个节拍总是读取
+  bool read = sensorTickCount == 0;
+  sensorTickCount = (sensorTickCount + 1) % divider;
+  return read;
+}
+
+SystemState StateMachine::getState() const {
+  return state;
+}
+
+const StateDescriptor& StateMachine::getDescriptor() const {
+  return table[state];
+}
+
+bool StateMachine::hasPolicy(uint8_t policy) const {
+  return (table[state].policies & policy) != 0;
+}
+
+const char* StateMachine::getName(SystemState s) const {
+  return s < SYSTEM_STATE_COUNT ? table[s].name : "未知";
+}
+
+uint32_t StateMachine::getTimeInState(uint32_t nowMs) const {
+  return nowMs - enteredMs;
+}
+
+uint32_t StateMachine::getTransitionCount() const {
+  return transitionCount;
+}
+
+uint32_t StateMachine::getRejectedCount() const {
+  return rejectedCount;
+}
@@ -0,0 +1,148 @@
+#include "telemetry.h"
+#include "byte_codec.h"
+#include "data_exporter.h"
+
+#define TELEMETRY_HEADER_SIZE 7          // 类型 + 序号 + 时间戳
+
+bool Telemetry::enabled = false;
+uint16_t Telemetry::sequence = 0;
+uint32_t Telemetry::sentCount = 0;
+uint32_t Telemetry::droppedCount = 0;
+
+static uint8_t* putHeader(uint8_t* p, uint8_t type, uint16_t seq, uint32_t timestampMs) {
+  *p++ = type;
+  p = putU16(p, seq);
+  return putU32(p, timestampMs);
+}
+
+static size_t finishPacket(uint8_t* start, uint8_t* p) {
+  uint32_t crc = DataExporter::crc32Update(0, start, p - start);
+  p = putU32(p, crc);
+  return p - start;
+}
+
+// ==================== 包编码 ====================
+size_t Telemetry::encodeHello(uint16_t seq, uint32_t timestampMs, uint8_t* out) {
+  uint8_t* p = putHeader(out, TELEMETRY_PKT_HELLO, seq, timestampMs);
+  *p++ = TELEMETRY_VERSION;
+  p = putU16(p, SENSOR_READ_INTERVAL);
+  p = putF32(p, ACCEL_SCALE_FACTOR);
+  p = putF32(p, GYRO_SCALE_FACTOR);
+  return finishPacket(out, p);
+}
+
+size_t Telemetry::encodeSample(const TelemetrySample& sample, uint16_t seq, uint8_t* out) {
+  uint8_t* p = putHeader(out, TELEMETRY_PKT_SAMPLE, seq, sample.timestampMs);
+  for (int i = 0; i < 6; i++) {
+    p = putU16(p, (uint16_t)sample.raw[i]);
+  }
+  for (int i = 0; i < 6; i++) {
+    p = putF32(p, sample.filtered[i]);
+  }
+  p = putF32(p, sample.score);
+  p = putF32(p, sample.avgScore);
+  *p++ = sample.flags;
+  return finishPacket(out, p);
+}
+
+size_t Telemetry::cobsEncode(const uint8_t* in, size_t length, uint8_t* out) {
+  // 每段以"到下一个0的距离"开头，段内不含0；满254个非0字节时另起一段
+  size_t codeIndex = 0;
+  size_t n = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < length; i++) {
+    if (in[i] != 0) {
+      out[n++] = in[i];
+      code++;
+    }
+    if (in[i] == 0 || code == 0xFF) {
+      out[codeIndex] = code;
+      codeIndex = n++;
+      code = 1;
+    }
+  }
+  out[codeIndex] = code;
+  return n;
+}
+
+size_t Telemetry::cobsDecode(const uint8_t* in, size_t length, uint8_t* out) {
+  size_t n = 0;
+  size_t i = 0;
+  while (i < length) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > length) {
+      return 0;
+    }
+    for (uint8_t j = 1; j < code; j++) {
+      if (in[i] == 0) {
+        return 0;
+      }
+      out[n++] = in[i++];
+    }
+    if (code != 0xFF && i < length) {
+      out[n++] = 0;
+    }
+  }
+  return n;
+}
+
+// ==================== 输出 ====================
+bool Telemetry::sendPacket(const uint8_t* packet, size_t length) {
+  uint8_t frame[TELEMETRY_FRAME_MAX];
+  size_t n = 0;
+  frame[n++] = 0;                  // 前导分隔符：与之前未换行的文本断开
+  n += cobsEncode(packet, length, frame + n);
+  frame[n++] = 0;
+
+  if (Serial.availableForWrite() < (int)n) {
+    droppedCount++;
+    return false;
+  }
+  Serial.write(frame, n);
+  sentCount++;
+  return true;
+}
+
+void Telemetry::start() {
+  uint8_t packet[TELEMETRY_PACKET_MAX];
+  sequence = 0;
+  sentCount = 0;
+  droppedCount = 0;
+  enabled = true;
+  sendPacket(packet, encodeHello(sequence++, millis(), packet));
+  DEBUG_INFO("TELEMETRY", "遥测输出已开启");
+}
+
+void Telemetry::stop() {
+  if (!enabled) {
+    return;
+  }
+  enabled = false;
+  DEBUG_INFO("TELEMETRY", "遥测输出已关闭");
+  printStats();
+}
+
+bool Telemetry::isEnabled() {
+  return enabled;
+}
+
+void Telemetry::sendSample(const TelemetrySample& sample) {
+  if (!enabled) {
+    return;
+  }
+  uint8_t packet[TELEMETRY_PACKET_MAX];
+  sendPacket(packet, encodeSample(sample, sequence++, packet));
+}
+
+uint32_t Telemetry::getSentCount() {
+  return sentCount;
+}
+
+uint32_t Telemetry::getDroppedCount() {
+  return droppedCount;
+}
+
+void Telemetry::printStats() {
+  DEBUG_INFO("TELEMETRY", "遥测: %s, 已发送 %lu 包, 串口繁忙丢弃 %lu 包",
+             enabled ? "开启" : "关闭", (unsigned long)sentCount, (unsigned long)droppedCount);
+}
@@ -7,6 +7,30 @@
 #include "../include/input_manager.h"
 #include "../include/data_manager.h"
 #include "../include/power_manager.h"
+#include "../include/session_recorder.h"
+#include "../include/stability_stats.h"
+#include "../include/rolling_stats.h"
+#include "../include/data_exporter.h"
+#include "../include/rtc_state.h"
+#include "../include/boot_trace.h"
+#include "../include/frequency_governor.h"
+#include "../include/loop_scheduler.h"
+#include "../include/memory_monitor.h"
+#include "../include/telemetry.h"
+#include "../include/serial_console.h"
+#include "../include/state_machine.h"
+#include "../include/event_bus.h"
+#include "../include/battery_estimator.h"
+#include "../include/energy_profiler.h"
+#include "../include/audio_sequencer.h"
+#include "../include/button_capture.h"
+#include "../include/gesture_engine.h"
+#include "../include/motion_gesture.h"
+#include "../include/deferred_log.h"
+#include "../include/log_filter.h"
+#include "../include/perf_timer.h"
+#include "../include/loop_monitor.h"
+#include "../include/loop_scheduler.h"
 
 // 测试对象
 SensorManager testSensorManager;
@@ -145,6 +169,941 @@ void test_data_persistence() {
     SystemSettings updatedSettings = testDataManager.getSettings();
     TEST_ASSERT_EQUAL_FLOAT_MESSAGE(75.0, updatedSettings.stabilityThreshold, "稳定性阈值应该已更新");
     TEST_ASSERT_NOT_EQUAL_MESSAGE(originalSettings.soundEnabled, updatedSettings.soundEnabled, "声音设置应该已更新");
+    
+    // 保存只写入镜像并请求后台提交，flush后应该已落盘
+    testDataManager.saveData();
+    SystemSettings mirrored;
+    PersistenceWorker::get(EEPROM_SETTINGS_ADDR, mirrored);
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(75.0, mirrored.stabilityThreshold, "镜像中的设置应该已更新");
+    TEST_ASSERT_TRUE_MESSAGE(PersistenceWorker::flush(), "flush应该在超时前完成");
+    TEST_ASSERT_TRUE_MESSAGE(PersistenceWorker::isIdle(), "flush后不应有待提交数据");
+}
+
+// 测试会话曲线块编解码
+void test_session_record_codec() {
+    uint8_t points[SESSION_RECORD_BLOCK_SIZE];
+    for (int i = 0; i < SESSION_RECORD_BLOCK_SIZE; i++) {
+        points[i] = (i * 37) % 101;  // 覆盖0-100范围内的大幅跳变
+    }
+    
+    uint8_t encoded[SESSION_RECORD_BLOCK_SIZE + 1];
+    size_t length = SessionRecorder::encodeBlock(points, SESSION_RECORD_BLOCK_SIZE, encoded);
+    TEST_ASSERT_EQUAL_MESSAGE(SESSION_RECORD_BLOCK_SIZE + 1, length, "编码长度应该为点数+1");
+    
+    uint8_t decoded[SESSION_RECORD_BLOCK_SIZE];
+    size_t count = SessionRecorder::decodeBlock(encoded, length, decoded, SESSION_RECORD_BLOCK_SIZE);
+    TEST_ASSERT_EQUAL_MESSAGE(SESSION_RECORD_BLOCK_SIZE, count, "解码点数应该与编码一致");
+    for (int i = 0; i < SESSION_RECORD_BLOCK_SIZE; i++) {
+        TEST_ASSERT_EQUAL_MESSAGE(points[i], decoded[i], "解码结果应该与原始序列一致");
+    }
+}
+
+// 测试流式稳定性聚合
+void test_stability_aggregator() {
+    StabilityAggregator aggregator;
+    aggregator.reset(50.0);
+    
+    // 前3秒评分80，后1秒评分20，每100ms一个采样点
+    uint32_t t = 0;
+    for (; t < 3000; t += 100) {
+        aggregator.addSample(80.0, t);
+    }
+    for (; t < 4000; t += 100) {
+        aggregator.addSample(20.0, t);
+    }
+    aggregator.pause(t);
+    
+    TEST_ASSERT_EQUAL_MESSAGE(4000, aggregator.getSampledTime(), "采样时长应该覆盖整个会话");
+    TEST_ASSERT_EQUAL_MESSAGE(3000, aggregator.getStableTime(), "稳定时长应该只计入高于阈值的部分");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01, 65.0, aggregator.getMean(), "平均值应该按时间加权");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(5.0, 80.0, aggregator.getMedian(), "中位数应该落在主要评分档");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(5.0, 20.0, aggregator.getPercentile(0.1f), "P10应该落在低分档");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(20.0, aggregator.getMinScore(), "最低分应该正确");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(80.0, aggregator.getMaxScore(), "最高分应该正确");
+    
+    // 暂停期间不计入
+    aggregator.addSample(80.0, t + 60000);
+    aggregator.pause(t + 61000);
+    TEST_ASSERT_EQUAL_MESSAGE(5000, aggregator.getSampledTime(), "暂停期间不应计入采样时长");
+    
+    // 恒定高分: 分位数不应越出实际评分范围
+    aggregator.reset(50.0);
+    for (t = 0; t <= 10000; t += 100) {
+        aggregator.addSample(99.9, t);
+    }
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(99.9, aggregator.getMedian(), "恒定评分的中位数应该等于该评分");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(99.9, aggregator.getPercentile(0.1f), "恒定评分的P10应该等于该评分");
+    
+    // 高分段每档1分
+    aggregator.reset(50.0);
+    for (t = 0; t < 2000; t += 100) {
+        aggregator.addSample(91.0, t);
+    }
+    for (; t < 4000; t += 100) {
+        aggregator.addSample(96.0, t);
+    }
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1.0, 91.0, aggregator.getPercentile(0.25f), "高分段P25误差应该在1分以内");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1.0, 96.0, aggregator.getPercentile(0.75f), "高分段P75误差应该在1分以内");
+}
+
+// 测试滚动周/月统计
+void test_rolling_stats() {
+    RollingStats rolling;
+    DailyStats day = {};
+    
+    // 连续40天，每天练习1分钟，第i天平均分为i
+    for (int i = 1; i <= 40; i++) {
+        day.totalTime = 60000;
+        day.sessionCount = 1;
+        day.avgStability = i;
+        day.bestStability = i;
+        rolling.pushDay(RollingStats::summarize(day, day.totalTime));
+    }
+    
+    DailyStats today = {};
+    PeriodStats week = rolling.getWeekStats(today, 0);
+    PeriodStats month = rolling.getMonthStats(today, 0);
+    TEST_ASSERT_EQUAL_MESSAGE(ROLLING_MONTH_DAYS - 1, rolling.getDayCount(), "环形缓冲应该只保留月窗口");
+    TEST_ASSERT_EQUAL_MESSAGE((ROLLING_WEEK_DAYS - 1) * 60000, week.totalTime, "周窗口应该只包含最近6天");
+    TEST_ASSERT_EQUAL_MESSAGE(ROLLING_MONTH_DAYS - 1, month.sessionCount, "月窗口应该超出7天历史");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01, 37.5, week.avgStability, "周平均应该为最近6天的平均");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(40.0, month.bestStability, "最佳值应该来自窗口内");
+    
+    // 今日数据实时计入
+    today.totalTime = 60000;
+    today.sessionCount = 1;
+    today.avgStability = 100.0;
+    today.bestStability = 100.0;
+    week = rolling.getWeekStats(today, today.totalTime);
+    TEST_ASSERT_EQUAL_MESSAGE(ROLLING_WEEK_DAYS, week.activeDays, "今日应该计入活跃天数");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(100.0, week.bestStability, "今日最佳值应该计入");
+    
+    // 平均稳定性按有效采样时长加权：总时长相同但大部分时间暂停的一天权重更小
+    RollingStats weighted;
+    day.totalTime = 600000;
+    day.avgStability = 20.0;
+    weighted.pushDay(RollingStats::summarize(day, 60000));
+    day.avgStability = 80.0;
+    weighted.pushDay(RollingStats::summarize(day, 540000));
+    today = {};
+    today.totalTime = 600000;
+    today.sessionCount = 1;
+    today.avgStability = 50.0;
+    week = weighted.getWeekStats(today, 600000);
+    TEST_ASSERT_EQUAL_MESSAGE(1800000, week.totalTime, "总时长仍按练习时长累计");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01, 62.0, week.avgStability, "周平均应该按采样时长加权");
+}
+
+// 测试导出记录编解码
+void test_export_codec() {
+    // 标准CRC-32校验值
+    const char* check = "123456789";
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(0xCBF43926, DataExporter::crc32Update(0, (const uint8_t*)check, 9), "CRC32应该与标准实现一致");
+    
+    DailyStats stats = {};
+    stats.year = 2026;
+    stats.month = 10;
+    stats.day = 18;
+    stats.totalTime = 1234567;
+    stats.sessionCount = 3;
+    stats.avgStability = 72.5;
+    stats.p90Stability = 91.25;
+    
+    uint8_t buffer[64];
+    uint8_t length = DataExporter::encodeDay(2, stats, buffer);
+    
+    uint8_t slot = 0;
+    DailyStats decoded = {};
+    TEST_ASSERT_TRUE_MESSAGE(DataExporter::decodeDay(buffer, length, slot, decoded), "日统计记录应该可以解码");
+    TEST_ASSERT_EQUAL_MESSAGE(2, slot, "槽位应该一致");
+    TEST_ASSERT_EQUAL_MESSAGE(stats.totalTime, decoded.totalTime, "总时长应该一致");
+    TEST_ASSERT_EQUAL_MESSAGE(stats.day, decoded.day, "日期应该一致");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(stats.avgStability, decoded.avgStability, "平均分应该一致");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(stats.p90Stability, decoded.p90Stability, "P90应该一致");
+    TEST_ASSERT_FALSE_MESSAGE(DataExporter::decodeDay(buffer, length - 1, slot, decoded), "截断的记录应该被拒绝");
+}
+
+// 测试深度休眠状态快照
+void test_rtc_resume_state() {
+    testDataManager.initialize();
+    testDataManager.startSession();
+    delay(20);
+    
+    // 保存快照时进行中的会话应被暂停并结算时长
+    ResumeState state = {};
+    state.systemState = STATE_PRACTICING;
+    testDataManager.captureResumeState(state.data);
+    TEST_ASSERT_TRUE_MESSAGE(state.data.sessionActive, "快照应该包含进行中的会话");
+    TEST_ASSERT_TRUE_MESSAGE(testDataManager.isSessionPaused(), "保存快照后会话应该已暂停");
+    unsigned long duration = testDataManager.getSessionDuration();
+    
+    RtcStateStore::save(state);
+    ResumeState loaded = {};
+    TEST_ASSERT_TRUE_MESSAGE(RtcStateStore::load(loaded), "校验通过的快照应该可以读取");
+    TEST_ASSERT_EQUAL_MESSAGE(STATE_PRACTICING, loaded.systemState, "系统状态应该一致");
+    
+    // 恢复后会话保持暂停，已练习时长不变
+    testDataManager.stopSession();
+    testDataManager.restoreResumeState(loaded.data);
+    TEST_ASSERT_TRUE_MESSAGE(testDataManager.isSessionPaused(), "恢复的会话应该处于暂停状态");
+    TEST_ASSERT_EQUAL_MESSAGE(duration, testDataManager.getSessionDuration(), "已练习时长应该一致");
+    testDataManager.stopSession();
+    
+    // 作废后不应再被读取
+    RtcStateStore::invalidate();
+    TEST_ASSERT_FALSE_MESSAGE(RtcStateStore::load(loaded), "作废的快照不应该被读取");
+}
+
+// 测试启动阶段跟踪
+void test_boot_trace() {
+    uint8_t before = BootTrace::getStageCount();
+    BootTrace::mark("test_a");
+    delay(2);
+    BootTrace::mark("test_b");
+    TEST_ASSERT_EQUAL_MESSAGE(before + 2, BootTrace::getStageCount(), "应该记录两个阶段");
+    
+    const BootStage* a = BootTrace::getStage(before);
+    const BootStage* b = BootTrace::getStage(before + 1);
+    TEST_ASSERT_NOT_NULL_MESSAGE(a, "第一个阶段应该存在");
+    TEST_ASSERT_NOT_NULL_MESSAGE(b, "第二个阶段应该存在");
+    TEST_ASSERT_TRUE_MESSAGE(b->timestampUs >= a->timestampUs + 1000, "阶段时间戳应该单调递增");
+    TEST_ASSERT_NULL_MESSAGE(BootTrace::getStage(BOOT_TRACE_MAX_STAGES), "越界索引应该返回空");
+    
+    // 首个评分只记录一次
+    BootTrace::markFirstScore();
+    uint32_t first = BootTrace::getTimeToFirstScore();
+    TEST_ASSERT_FALSE_MESSAGE(BootTrace::markFirstScore(), "首个评分不应该重复记录");
+    TEST_ASSERT_EQUAL_MESSAGE(first, BootTrace::getTimeToFirstScore(), "首个评分时刻不应该改变");
+}
+
+// 测试动态调频策略
+void test_frequency_governor() {
+    FrequencyGovernor governor;
+    governor.begin(0);
+    TEST_ASSERT_EQUAL_MESSAGE(DFS_MAX_FREQ_MHZ, governor.getFrequency(), "启动时应该以最高频率运行");
+    
+    // 轻负载 (10%) 一个窗口后降到最低工作点
+    uint32_t now = 0;
+    for (int i = 0; i < 200; i++) {
+        now += 10;
+        governor.update(1000, 0, now);
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(DFS_MIN_FREQ_MHZ, governor.getFrequency(), "轻负载时应该降频");
+    
+    // 单次循环超出截止预算立即升频
+    now += 10;
+    TEST_ASSERT_TRUE_MESSAGE(governor.update(SENSOR_READ_INTERVAL * 1000 + 1000, 0, now), "超出预算时应该切换工作点");
+    TEST_ASSERT_EQUAL_MESSAGE(DFS_MAX_FREQ_MHZ, governor.getFrequency(), "超出预算时应该升到最高频率");
+    
+    // 低电量上限生效
+    governor.setCeiling(DFS_LOW_POWER_FREQ_MHZ);
+    now += 10;
+    governor.update(1000, 0, now);
+    TEST_ASSERT_TRUE_MESSAGE(governor.getFrequency() <= DFS_LOW_POWER_FREQ_MHZ, "频率不应该超过上限");
+    
+    // 驻留统计覆盖全部运行时间
+    GovernorStats stats = governor.getStats(now);
+    uint32_t total = 0;
+    for (int i = 0; i < DFS_LEVEL_COUNT; i++) {
+        total += stats.residencyMs[i];
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(now, total, "各工作点驻留时间之和应该等于运行时间");
+    TEST_ASSERT_EQUAL_MESSAGE(1, stats.deadlineMisses, "应该记录一次超时");
+    
+    // 显示帧的I2C传输不随CPU频率变化，不应该阻止降频
+    FrequencyGovernor displayBound;
+    displayBound.begin(0);
+    now = 0;
+    for (int i = 0; i < 40; i++) {
+        now += SENSOR_READ_INTERVAL;
+        bool frame = (i % 2) == 0;
+        uint32_t ioUs = frame ? 23500 : 300;
+        displayBound.update(ioUs + 500, ioUs, now);
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(DFS_MIN_FREQ_MHZ, displayBound.getFrequency(), "I2C传输为主的负载应该允许降频");
+}
+
+// 测试主循环事件调度
+void test_loop_scheduler() {
+    LoopScheduler::begin();
+    
+    // 投递的事件在下一次等待时立即返回
+    LoopScheduler::post(LOOP_EVENT_WAKE);
+    uint32_t events = LoopScheduler::waitForEvents(0);
+    TEST_ASSERT_TRUE_MESSAGE(events & LOOP_EVENT_WAKE, "投递的事件应该被取出");
+    
+    // 传感器节拍在一个周期内到达
+    uint32_t start = millis();
+    events = 0;
+    while (!(events & LOOP_EVENT_SENSOR) && millis() - start < SENSOR_READ_INTERVAL * 3) {
+        events |= LoopScheduler::waitForEvents(SENSOR_READ_INTERVAL * 2);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(events & LOOP_EVENT_SENSOR, "应该收到传感器节拍事件");
+    
+    // 没有待处理的按钮事件时，输入模块不要求提前唤醒
+    InputManager input;
+    TEST_ASSERT_EQUAL_MESSAGE(UINT32_MAX, input.getNextWakeDelay(), "空闲时不应该有输入截止时间");
+}
+
+// 测试非阻塞提示音序列
+void test_audio_sequencer() {
+    TEST_ASSERT_EQUAL_MESSAGE(450, AudioSequencer::getPatternDuration(SOUND_START), "开始音序时长错误");
+    TEST_ASSERT_EQUAL_MESSAGE(0, AudioSequencer::getPatternDuration(SOUND_PATTERN_COUNT), "无效音序时长应该为0");
+    
+    // play()立即返回，音序在后台播放
+    uint32_t start = millis();
+    TEST_ASSERT_TRUE_MESSAGE(AudioSequencer::play(SOUND_START), "应该开始播放");
+    TEST_ASSERT_TRUE_MESSAGE(millis() - start < 20, "播放不应该阻塞调用者");
+    delay(200);
+    TEST_ASSERT_TRUE_MESSAGE(AudioSequencer::isPlaying(), "音序中途应该仍在播放");
+    delay(AudioSequencer::getPatternDuration(SOUND_START));
+    TEST_ASSERT_FALSE_MESSAGE(AudioSequencer::isPlaying(), "音序结束后应该停止");
+    
+    // 新的声音打断正在播放的音序，stop()立即停止
+    AudioSequencer::play(SOUND_ERROR_ALERT);
+    AudioSequencer::playTone(BUZZER_FREQUENCY, BUZZER_DURATION);
+    TEST_ASSERT_TRUE_MESSAGE(AudioSequencer::isPlaying(), "打断后应该播放新的声音");
+    AudioSequencer::stop();
+    TEST_ASSERT_FALSE_MESSAGE(AudioSequencer::isPlaying(), "stop()后应该停止");
+}
+
+// 测试电池电量估算
+void test_battery_estimator() {
+    TEST_ASSERT_EQUAL_MESSAGE(100, (int)BatteryEstimator::socFromVoltage(4.25f), "满电以上应该为100%");
+    TEST_ASSERT_EQUAL_MESSAGE(0, (int)BatteryEstimator::socFromVoltage(3.0f), "截止电压以下应该为0%");
+    TEST_ASSERT_EQUAL_MESSAGE(50, (int)(BatteryEstimator::socFromVoltage(3.84f) + 0.5f), "3.84V应该约为50%");
+    TEST_ASSERT_TRUE_MESSAGE(BatteryEstimator::socFromVoltage(3.90f) > BatteryEstimator::socFromVoltage(3.80f),
+                             "放电曲线应该单调");
+    
+    // 负载压降补偿: 开路电压高于带负载电压
+    BatteryEstimator battery;
+    battery.begin(3.90f, STATE_PRACTICING, 0);
+    TEST_ASSERT_TRUE_MESSAGE(battery.getOpenCircuitVoltage() > battery.getLoadedVoltage(), "应该补偿负载压降");
+    float startMah = battery.getRemainingMah();
+    
+    // 电压不变运行1小时: 库仑计数扣除练习电流，电压校正只拉回一小部分
+    battery.addSample(3.90f, 3600000);
+    float used = startMah - battery.getRemainingMah();
+    TEST_ASSERT_TRUE_MESSAGE(used > 0 && used <= BATTERY_NOMINAL_CURRENT_MA, "应该按状态电流扣除电量");
+    TEST_ASSERT_EQUAL_MESSAGE(3600000, battery.getStateTime(STATE_PRACTICING), "应该累计练习状态时间");
+    
+    // 剩余练习时间 = 剩余电量 / 练习电流
+    uint32_t expected = (uint32_t)(battery.getRemainingMah() / battery.getStateCurrent(STATE_PRACTICING) * 60);
+    TEST_ASSERT_EQUAL_MESSAGE(expected, battery.getRemainingMinutes(STATE_PRACTICING), "剩余练习时间计算错误");
+    
+    // 休眠状态电流更低，压降更小
+    float practiceSag = battery.getSagVoltage();
+    battery.setState(STATE_SLEEP, 3600000);
+    TEST_ASSERT_TRUE_MESSAGE(battery.getSagVoltage() < practiceSag, "低负载状态压降应该更小");
+}
+
+// 测试功耗统计
+void test_energy_profiler() {
+    EnergyProfiler profiler;
+    profiler.begin(0);
+    profiler.setState(STATE_PRACTICING, 0);
+    profiler.setConsumer(ENERGY_DISPLAY, true, 255, 0);
+    profiler.setConsumer(ENERGY_IMU, true, 255, 0);
+    
+    // 1小时: CPU忙碌10%
+    for (uint32_t t = 0; t < 3600; t++) {
+        profiler.addCpuBusy(100000);
+    }
+    profiler.setConsumer(ENERGY_DISPLAY, false, 255, 3600000);
+    EnergyReport report = profiler.getReport(3600000);
+    
+    TEST_ASSERT_EQUAL_MESSAGE(3600000, report.totalMs, "统计时长错误");
+    TEST_ASSERT_EQUAL_MESSAGE(3600000, report.stateMs[STATE_PRACTICING], "练习状态时长错误");
+    TEST_ASSERT_EQUAL_MESSAGE(360000, report.consumerOnMs[ENERGY_CPU], "CPU占空比应该为10%");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, ENERGY_DISPLAY_FULL_MA, report.consumerMah[ENERGY_DISPLAY], "满亮度显示耗电错误");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, ENERGY_IMU_MA, report.consumerMah[ENERGY_IMU], "IMU耗电错误");
+    TEST_ASSERT_EQUAL_MESSAGE(0, report.consumerOnMs[ENERGY_BUZZER], "蜂鸣器未开启不应该计时");
+    
+    float cpuExpected = (ENERGY_CPU_BASE_MA + ENERGY_CPU_MA_PER_MHZ * DFS_MAX_FREQ_MHZ) * 0.1f + ENERGY_CPU_IDLE_MA * 0.9f;
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, cpuExpected, report.consumerMah[ENERGY_CPU], "CPU耗电应该按负载加权");
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.01f, report.totalMah, report.stateMah[STATE_PRACTICING], "状态耗电之和应该等于总耗电");
+    
+    // 显示关闭后只有常开部件、IMU和CPU空闲电流
+    report = profiler.getReport(7200000);
+    TEST_ASSERT_EQUAL_MESSAGE(3600000, report.consumerOnMs[ENERGY_DISPLAY], "显示关闭后不应该继续计时");
+}
+
+// 测试按钮边沿捕获与防抖
+void test_button_capture() {
+    ButtonCapture::reset();
+    const uint64_t base = 10000000ULL;
+    ButtonEdge edge;
+    
+    // 按下时的抖动: 第一个边沿立即生效，时间戳为第一个边沿的时刻
+    ButtonCapture::pushEdge(base + 1000, true);
+    ButtonCapture::pushEdge(base + 3000, false);
+    ButtonCapture::pushEdge(base + 5000, true);
+    TEST_ASSERT_TRUE_MESSAGE(ButtonCapture::poll(edge, base + 6000), "应该产生按下边沿");
+    TEST_ASSERT_TRUE_MESSAGE(edge.pressed, "第一个边沿应该是按下");
+    TEST_ASSERT_TRUE_MESSAGE(edge.timestampUs == base + 1000, "应该使用第一个边沿的时间戳");
+    TEST_ASSERT_FALSE_MESSAGE(ButtonCapture::poll(edge, base + 6000), "锁定期内的抖动应该被忽略");
+    TEST_ASSERT_EQUAL_MESSAGE(21, ButtonCapture::getNextDeadline(base + 6000), "锁定期剩余时间错误");
+    TEST_ASSERT_FALSE_MESSAGE(ButtonCapture::poll(edge, base + 30000), "锁定期结束后电平未变不应该产生边沿");
+    TEST_ASSERT_TRUE_MESSAGE(ButtonCapture::isPressed(), "防抖后应该处于按下状态");
+    
+    // 松开
+    ButtonCapture::pushEdge(base + 200000, false);
+    TEST_ASSERT_TRUE_MESSAGE(ButtonCapture::poll(edge, base + 200500), "应该产生松开边沿");
+    TEST_ASSERT_FALSE_MESSAGE(edge.pressed, "应该是松开边沿");
+    
+    // 锁定期内电平再次改变: 锁定期结束时按最后的电平补发边沿
+    ButtonCapture::pushEdge(base + 210000, true);
+    TEST_ASSERT_FALSE_MESSAGE(ButtonCapture::poll(edge, base + 215000), "锁定期内不应该产生边沿");
+    TEST_ASSERT_TRUE_MESSAGE(ButtonCapture::poll(edge, base + 230000), "锁定期结束后应该补发边沿");
+    TEST_ASSERT_TRUE_MESSAGE(edge.pressed && edge.timestampUs == base + 210000, "补发边沿的电平或时间戳错误");
+    
+    ButtonCapture::reset();
+}
+
+// 测试按钮手势识别
+void test_gesture_engine() {
+    GestureEngine gestures;
+    ButtonEvent event;
+    const unsigned long base = 10000;
+    
+    // 单击: 松开后等待连击窗口超时才产生
+    TEST_ASSERT_FALSE_MESSAGE(gestures.onEdge(true, base, event), "按下不应该产生事件");
+    TEST_ASSERT_FALSE_MESSAGE(gestures.onEdge(false, base + 100, event), "短按松开后应该等待可能的连击");
+    TEST_ASSERT_EQUAL_MESSAGE(GESTURE_MULTI_CLICK_WINDOW + 1, gestures.getNextDeadline(base + 100), "连击等待截止时间错误");
+    TEST_ASSERT_FALSE_MESSAGE(gestures.onTick(base + 300, event), "连击窗口内不应该产生事件");
+    TEST_ASSERT_TRUE_MESSAGE(gestures.onTick(base + 500, event), "连击窗口超时后应该产生单击");
+    TEST_ASSERT_EQUAL_MESSAGE(BUTTON_PRESSED, event.state, "应该是单击事件");
+    
+    // 三击: 第三次松开立即产生，不再等待
+    gestures.onEdge(true, base + 1000, event);
+    gestures.onEdge(false, base + 1080, event);
+    gestures.onEdge(true, base + 1200, event);
+    gestures.onEdge(false, base + 1280, event);
+    gestures.onEdge(true, base + 1400, event);
+    TEST_ASSERT_TRUE_MESSAGE(gestures.onEdge(false, base + 1480, event), "第三次松开应该立即产生事件");
+    TEST_ASSERT_EQUAL_MESSAGE(BUTTON_TRIPLE_PRESSED, event.state, "应该是三击事件");
+    TEST_ASSERT_EQUAL_MESSAGE(3, event.pressCount, "三击的按下次数错误");
+    
+    // 超时未处理时，下一次按下先补发上一个手势 (双击)
+    gestures.onEdge(true, base + 2000, event);
+    gestures.onEdge(false, base + 2080, event);
+    gestures.onEdge(true, base + 2200, event);
+    gestures.onEdge(false, base + 2280, event);
+    TEST_ASSERT_TRUE_MESSAGE(gestures.onEdge(true, base + 3000, event), "超时后的按下应该先产生上一个手势");
+    TEST_ASSERT_EQUAL_MESSAGE(BUTTON_DOUBLE_PRESSED, event.state, "应该是双击事件");
+    
+    // 长按在松开时判定，超长按在按住期间触发且松开后不再产生事件
+    TEST_ASSERT_TRUE_MESSAGE(gestures.onEdge(false, base + 3000 + GESTURE_LONG_PRESS_TIME, event), "长按松开应该产生事件");
+    TEST_ASSERT_EQUAL_MESSAGE(BUTTON_LONG_PRESSED, event.state, "应该是长按事件");
+    gestures.onEdge(true, base + 5000, event);
+    TEST_ASSERT_FALSE_MESSAGE(gestures.onTick(base + 5000 + GESTURE_LONG_PRESS_TIME, event), "按住到长按阈值不应该产生事件");
+    TEST_ASSERT_TRUE_MESSAGE(gestures.onTick(base + 5000 + GESTURE_LONG_LONG_PRESS_TIME, event), "按住到超长按阈值应该立即产生事件");
+    TEST_ASSERT_EQUAL_MESSAGE(BUTTON_LONG_LONG_PRESSED, event.state, "应该是超长按事件");
+    TEST_ASSERT_FALSE_MESSAGE(gestures.onEdge(false, base + 9000, event), "超长按松开后不应该再产生事件");
+    
+    // 开启自动重复: 双击后按住周期性产生重复事件，达到次数后加速
+    gestures.setRepeatEnabled(true);
+    unsigned long t = base + 20000;
+    gestures.onEdge(true, t, event);
+    gestures.onEdge(false, t + 80, event);
+    gestures.onEdge(true, t + 200, event);
+    TEST_ASSERT_FALSE_MESSAGE(gestures.onTick(t + 200 + GESTURE_REPEAT_DELAY - 1, event), "未到重复延迟不应该产生事件");
+    unsigned long now = t + 200 + GESTURE_REPEAT_DELAY;
+    for (int i = 1; i <= GESTURE_REPEAT_ACCEL_COUNT; i++) {
+        TEST_ASSERT_TRUE_MESSAGE(gestures.onTick(now, event), "按住期间应该自动重复");
+        TEST_ASSERT_EQUAL_MESSAGE(BUTTON_HOLD_REPEAT, event.state, "应该是自动重复事件");
+        TEST_ASSERT_EQUAL_MESSAGE(2, event.pressCount, "应该记录为双击后按住");
+        TEST_ASSERT_EQUAL_MESSAGE(i, event.repeatCount, "重复序号错误");
+        now += GESTURE_REPEAT_INTERVAL;
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(GESTURE_REPEAT_FAST_INTERVAL, gestures.getNextDeadline(now - GESTURE_REPEAT_INTERVAL), "加速后的重复间隔错误");
+    TEST_ASSERT_FALSE_MESSAGE(gestures.onEdge(false, now, event), "自动重复后松开不应该再产生事件");
+    
+    // 单次按住不自动重复，仍按长按处理
+    gestures.onEdge(true, base + 40000, event);
+    TEST_ASSERT_FALSE_MESSAGE(gestures.onTick(base + 40000 + GESTURE_REPEAT_DELAY, event), "单次按住不应该自动重复");
+    TEST_ASSERT_TRUE_MESSAGE(gestures.onEdge(false, base + 40000 + GESTURE_LONG_PRESS_TIME, event), "单次按住松开应该是长按");
+    TEST_ASSERT_EQUAL_MESSAGE(BUTTON_LONG_PRESSED, event.state, "应该是长按事件");
+}
+
+// 测试运动手势识别
+void test_motion_gesture() {
+    MotionGesture motion;
+    ButtonEvent event;
+    MotionSample sample = {0.0f, 0.0f, 1.0f, 0.0f, false, 1000};
+    
+    // 单次敲击: 短促冲击结束后等待双敲窗口超时
+    TEST_ASSERT_FALSE_MESSAGE(motion.update(sample, event), "静止不应该产生事件");
+    sample.timestamp = 1050; sample.hwMotion = true;
+    TEST_ASSERT_FALSE_MESSAGE(motion.update(sample, event), "冲击期间不应该产生事件");
+    sample.timestamp = 1100; sample.hwMotion = false;
+    TEST_ASSERT_FALSE_MESSAGE(motion.update(sample, event), "冲击结束后应该等待可能的第二次敲击");
+    TEST_ASSERT_TRUE_MESSAGE(motion.isTapPending(), "应该记录一次敲击");
+    sample.timestamp = 1050 + MOTION_DOUBLE_TAP_WINDOW + 50;
+    TEST_ASSERT_TRUE_MESSAGE(motion.update(sample, event), "窗口超时后应该产生单次敲击");
+    TEST_ASSERT_EQUAL_MESSAGE(BUTTON_PRESSED, event.state, "敲击应该映射为单击");
+    TEST_ASSERT_EQUAL_MESSAGE(INPUT_SOURCE_MOTION, event.source, "事件来源应该是运动手势");
+    
+    // 双敲: 软件判定的冲击 (未滤波加速度超过阈值) 同样有效
+    sample.timestamp = 3000; sample.shock = MOTION_TAP_THRESHOLD_G + 0.2f;
+    motion.update(sample, event);
+    sample.timestamp = 3050; sample.shock = 0.0f;
+    motion.update(sample, event);
+    sample.timestamp = 3250; sample.shock = MOTION_TAP_THRESHOLD_G + 0.2f;
+    motion.update(sample, event);
+    sample.timestamp = 3300; sample.shock = 0.0f;
+    TEST_ASSERT_TRUE_MESSAGE(motion.update(sample, event), "第二次敲击结束应该立即产生双敲");
+    TEST_ASSERT_EQUAL_MESSAGE(BUTTON_DOUBLE_PRESSED, event.state, "双敲应该映射为双击");
+    
+    // 持续晃动不是敲击
+    for (unsigned long t = 5000; t <= 5400; t += 50) {
+        sample.timestamp = t; sample.hwMotion = true;
+        motion.update(sample, event);
+    }
+    sample.timestamp = 5450; sample.hwMotion = false;
+    motion.update(sample, event);
+    TEST_ASSERT_FALSE_MESSAGE(motion.isTapPending(), "持续晃动不应该记录为敲击");
+    
+    // 按钮边沿附近的冲击 (按键本身的震动) 不是敲击
+    motion.noteButtonActivity(7000);
+    sample.timestamp = 7050; sample.hwMotion = true;
+    motion.update(sample, event);
+    sample.timestamp = 7100; sample.hwMotion = false;
+    motion.update(sample, event);
+    TEST_ASSERT_FALSE_MESSAGE(motion.isTapPending(), "按钮动作引起的冲击不应该记录为敲击");
+    
+    // 倾斜: 回正后保持右倾超过保持时间触发，不回正时周期性重复
+    sample.timestamp = 9000;
+    motion.update(sample, event);
+    sample.accelX = 0.7f; sample.accelZ = 0.7f;
+    TEST_ASSERT_FALSE_MESSAGE(motion.update(sample, event), "刚开始倾斜不应该产生事件");
+    sample.timestamp = 9000 + MOTION_TILT_HOLD_TIME;
+    TEST_ASSERT_TRUE_MESSAGE(motion.update(sample, event), "保持倾斜应该产生事件");
+    TEST_ASSERT_EQUAL_MESSAGE(BUTTON_TILT_RIGHT, event.state, "应该是右倾事件");
+    sample.timestamp += MOTION_TILT_REPEAT_INTERVAL;
+    TEST_ASSERT_TRUE_MESSAGE(motion.update(sample, event), "保持倾斜应该重复产生事件");
+    TEST_ASSERT_EQUAL_MESSAGE(2, event.repeatCount, "倾斜重复序号错误");
+    
+    // 开机时就斜放着: 没有回正过不触发
+    motion.reset();
+    sample.accelX = -0.7f;
+    sample.timestamp = 20000;
+    motion.update(sample, event);
+    sample.timestamp = 20000 + MOTION_TILT_HOLD_TIME * 2;
+    TEST_ASSERT_FALSE_MESSAGE(motion.update(sample, event), "未回正过的倾斜不应该触发");
+}
+
+// 测试延迟日志记录编码和环形缓冲
+void test_deferred_log() {
+    static const char module[] = "TEST";
+    static const char format[] = "%d %s %.1f";
+    LogRecord record(DEBUG_LEVEL_INFO, module, format, 1234);
+    record.add(-5);
+    record.add("abc");
+    record.add(1.5f);
+    
+    const uint8_t* bytes = record.bytes();
+    TEST_ASSERT_EQUAL_MESSAGE(LOG_RECORD_HEADER_SIZE + 5 + 5 + 9, record.size(), "记录长度错误");
+    TEST_ASSERT_EQUAL_MESSAGE(record.size(), bytes[0], "记录首字节应该是总长度");
+    TEST_ASSERT_EQUAL_MESSAGE(DEBUG_LEVEL_INFO, bytes[1], "级别错误");
+    TEST_ASSERT_EQUAL_MESSAGE(LOG_TAG_INT, bytes[LOG_RECORD_HEADER_SIZE], "整数参数类型标记错误");
+    TEST_ASSERT_EQUAL_MESSAGE(LOG_TAG_STRING, bytes[LOG_RECORD_HEADER_SIZE + 5], "字符串参数应该拷贝内容");
+    TEST_ASSERT_EQUAL_MESSAGE(3, bytes[LOG_RECORD_HEADER_SIZE + 6], "字符串长度错误");
+    TEST_ASSERT_EQUAL_MESSAGE(LOG_TAG_DOUBLE, bytes[LOG_RECORD_HEADER_SIZE + 10], "float应该按double编码");
+    
+    // 参数过多时截断并标记
+    LogRecord longRecord(DEBUG_LEVEL_DEBUG, module, format, 0);
+    for (int i = 0; i < 40; i++) {
+        longRecord.add(i);
+    }
+    TEST_ASSERT_TRUE_MESSAGE(longRecord.size() <= DEFERRED_LOG_MAX_RECORD, "记录不应该超过上限");
+    TEST_ASSERT_TRUE_MESSAGE(longRecord.isTruncated(), "超长记录应该标记截断");
+    
+    // 环形缓冲: 写满后丢弃并计数，跨越缓冲末尾的记录完整取出
+    static LogRing ring;
+    uint8_t out[DEFERRED_LOG_MAX_RECORD];
+    int pushed = 0;
+    while (ring.push(record.bytes(), record.size())) {
+        pushed++;
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(DEFERRED_LOG_BUFFER_SIZE / record.size(), pushed, "缓冲容量错误");
+    TEST_ASSERT_EQUAL_MESSAGE(1, ring.takeDropped(), "写满后应该计入丢弃");
+    TEST_ASSERT_EQUAL_MESSAGE(record.size(), ring.pop(out), "取出的记录长度错误");
+    TEST_ASSERT_TRUE_MESSAGE(ring.push(record.bytes(), record.size()), "取出后应该可以继续写入");
+    int popped = 0;
+    while (ring.pop(out) > 0) {
+        TEST_ASSERT_TRUE_MESSAGE(memcmp(out, record.bytes(), record.size()) == 0, "记录内容应该完整");
+        popped++;
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(pushed, popped, "取出数量错误");
+    TEST_ASSERT_EQUAL_MESSAGE(0, ring.getUsed(), "取空后占用应该为0");
+}
+
+// 测试编译期日志过滤
+void test_log_filter() {
+    static constexpr LogFilter::ModuleLevel table[] = {
+        { "SENSOR", DEBUG_LEVEL_WARN },
+        { "DISPLAY", DEBUG_LEVEL_NONE },
+        { nullptr, 0 }
+    };
+    
+    // 查表在编译期完成
+    static_assert(LogFilter::levelIn(table, "SENSOR", DEBUG_LEVEL_DEBUG) == DEBUG_LEVEL_WARN, "模块级别应该在编译期确定");
+    static_assert(LogFilter::Enabled<LogFilter::enabled(DEBUG_LEVEL_ERROR, "MAIN")>::value == (DEBUG_LEVEL >= DEBUG_LEVEL_ERROR), "过滤结果应该是编译期常量");
+    
+    TEST_ASSERT_EQUAL_MESSAGE(DEBUG_LEVEL_NONE, LogFilter::levelIn(table, "DISPLAY", DEBUG_LEVEL_DEBUG), "关闭的模块级别错误");
+    TEST_ASSERT_EQUAL_MESSAGE(DEBUG_LEVEL_DEBUG, LogFilter::levelIn(table, "SENSORS", DEBUG_LEVEL_DEBUG), "名称前缀相同不应该匹配");
+    TEST_ASSERT_EQUAL_MESSAGE(DEBUG_LEVEL_DEBUG, LogFilter::levelIn(table, "SENS", DEBUG_LEVEL_DEBUG), "名称较短不应该匹配");
+    TEST_ASSERT_EQUAL_MESSAGE(DEBUG_LEVEL_INFO, LogFilter::levelIn(table, "MAIN", DEBUG_LEVEL_INFO), "未列出的模块应该使用默认级别");
+    
+    // 运行时模块名 (DEBUG_LOG_DYNAMIC) 使用同一张表
+    char module[] = "MAIN";
+    TEST_ASSERT_EQUAL_MESSAGE(LogFilter::levelFor("MAIN"), LogFilter::levelFor(module), "运行时查表结果应该一致");
+}
+
+// 测试性能计时器
+void test_perf_timer() {
+    PerfTimers::reset();
+    
+    TEST_ASSERT_EQUAL_MESSAGE(0, PerfTimers::bucketFor(1), "1us应该在第0桶");
+    TEST_ASSERT_EQUAL_MESSAGE(3, PerfTimers::bucketFor(15), "15us应该在[8,16)桶");
+    TEST_ASSERT_EQUAL_MESSAGE(PERF_HISTOGRAM_BUCKETS - 1, PerfTimers::bucketFor(UINT32_MAX), "超长耗时应该在最后一桶");
+    
+    // 90次约100us、10次约5000us
+    PerfTimerStats* stats = PerfTimers::find(PERF_KEY("TEST_RECORD"), "TEST_RECORD");
+    TEST_ASSERT_NOT_NULL_MESSAGE(stats, "应该能创建计时器");
+    for (int i = 0; i < 90; i++) {
+        PerfTimers::record(stats, 100 + i % 10, 100);
+    }
+    for (int i = 0; i < 10; i++) {
+        PerfTimers::record(stats, 5000, 5000);
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(100, stats->count, "次数错误");
+    TEST_ASSERT_EQUAL_MESSAGE(100, stats->minUs, "最小值错误");
+    TEST_ASSERT_EQUAL_MESSAGE(5000, stats->maxUs, "最大值错误");
+    TEST_ASSERT_EQUAL_MESSAGE(127, PerfTimers::percentile(*stats, 50), "p50应该是[64,128)桶的上界");
+    TEST_ASSERT_EQUAL_MESSAGE(5000, PerfTimers::percentile(*stats, 99), "p99不应该超过最大值");
+    TEST_ASSERT_TRUE_MESSAGE(PerfTimers::get(PERF_KEY("TEST_RECORD")) == stats, "按键查找应该返回同一计时器");
+    
+    // 嵌套作用域: 内层耗时从外层的自身耗时中扣除
+    {
+        PERF_SCOPE("TEST_OUTER");
+        for (int i = 0; i < 3; i++) {
+            PERF_SCOPE("TEST_INNER");
+            delayMicroseconds(200);
+        }
+    }
+    const PerfTimerStats* outer = PerfTimers::get(PERF_KEY("TEST_OUTER"));
+    const PerfTimerStats* inner = PerfTimers::get(PERF_KEY("TEST_INNER"));
+    TEST_ASSERT_NOT_NULL_MESSAGE(outer, "外层计时器应该存在");
+    TEST_ASSERT_NOT_NULL_MESSAGE(inner, "内层计时器应该存在");
+    TEST_ASSERT_EQUAL_MESSAGE(1, outer->count, "外层次数错误");
+    TEST_ASSERT_EQUAL_MESSAGE(3, inner->count, "内层次数错误");
+    TEST_ASSERT_TRUE_MESSAGE(outer->totalUs >= inner->totalUs, "外层耗时应该包含内层");
+    TEST_ASSERT_TRUE_MESSAGE(outer->selfUs == outer->totalUs - inner->totalUs, "外层自身耗时应该扣除内层");
+    
+    // 槽位用完后返回空而不是覆盖已有计时器
+    for (int i = 0; i < PERF_TIMER_SLOTS; i++) {
+        PerfTimers::find(1000 + i, "TEST_FILL");
+    }
+    TEST_ASSERT_NULL_MESSAGE(PerfTimers::find(5000, "TEST_FULL"), "槽位已满时应该返回空");
+    TEST_ASSERT_TRUE_MESSAGE(PerfTimers::get(PERF_KEY("TEST_OUTER")) == outer, "已有计时器不应该被覆盖");
+    
+    PerfTimers::reset();
+}
+
+// 测试主循环时序监控
+void test_loop_monitor() {
+    static LoopMonitor monitor;
+    monitor.resetWindow();
+    
+    // 正常的一轮: 传感器节拍后200us开始处理
+    monitor.beginIteration(10000, LOOP_EVENT_SENSOR | LOOP_EVENT_DISPLAY);
+    monitor.recordSensorTick(9800, 1);
+    monitor.endStage(LOOP_STAGE_SENSOR, 11000);
+    monitor.endStage(LOOP_STAGE_DISPLAY, 15000);
+    TEST_ASSERT_EQUAL_MESSAGE(6000, monitor.endIteration(16000), "本轮耗时错误");
+    TEST_ASSERT_EQUAL_MESSAGE(200, monitor.getSensorLateStats().maxUs, "传感器读取延迟错误");
+    TEST_ASSERT_EQUAL_MESSAGE(1, monitor.getFrameStats().count, "有显示事件时应该记录一帧");
+    TEST_ASSERT_EQUAL_MESSAGE(4000, monitor.getFrameStats().maxUs, "帧耗时错误");
+    TEST_ASSERT_EQUAL_MESSAGE(0, monitor.getIterationMisses(), "正常的一轮不应该超时");
+    
+    // 保存阶段过长导致超时，应该归因于保存阶段
+    monitor.beginIteration(100000, 0);
+    monitor.endStage(LOOP_STAGE_SENSOR, 100010);
+    monitor.endStage(LOOP_STAGE_DISPLAY, 100020);
+    monitor.endStage(LOOP_STAGE_SAVE, 100020 + LOOP_DEADLINE_US);
+    monitor.endIteration(100030 + LOOP_DEADLINE_US);
+    TEST_ASSERT_EQUAL_MESSAGE(1, monitor.getIterationMisses(), "超过期限应该计为超时");
+    TEST_ASSERT_EQUAL_MESSAGE(LOOP_STAGE_SAVE, monitor.getLastMissStage(), "超时应该归因于最长的阶段");
+    TEST_ASSERT_EQUAL_MESSAGE(1, monitor.getFrameStats().count, "没有显示事件时不应该记录帧");
+    
+    // 下一轮的传感器读取因此延迟并漏掉一个节拍，归因于上一轮的保存阶段
+    uint32_t start = 200000;
+    monitor.beginIteration(start, LOOP_EVENT_SENSOR);
+    monitor.recordSensorTick(start - LOOP_SENSOR_LATE_DEADLINE_US - 1000, 3);
+    monitor.endIteration(start + 100);
+    TEST_ASSERT_EQUAL_MESSAGE(1, monitor.getSensorLateMisses(), "读取延迟超过期限应该计为超时");
+    TEST_ASSERT_EQUAL_MESSAGE(1, monitor.getMissedSensorTicks(), "跳过的节拍应该计为漏读");
+    TEST_ASSERT_EQUAL_MESSAGE(2, monitor.getStageMisses(LOOP_STAGE_SAVE), "读取延迟应该归因于上一轮最长的阶段");
+    
+    // 报告后窗口清零
+    monitor.printReport(millis());
+    TEST_ASSERT_EQUAL_MESSAGE(0, monitor.getIterationStats().count, "报告后统计应该清零");
+    TEST_ASSERT_EQUAL_MESSAGE(0, monitor.getIterationMisses(), "报告后超时计数应该清零");
+}
+
+// 测试按模块的堆分配统计
+void test_memory_monitor() {
+    static uint64_t fakeHeap[HEAP_TRACK_SLOTS];
+    MemoryMonitor::resetTagStats();
+    
+    // 未标记的分配不跟踪
+    MemoryMonitor::noteAlloc(&fakeHeap[0], 100);
+    TEST_ASSERT_EQUAL_MESSAGE(0, MemoryMonitor::getTagStats(HEAP_TAG_DISPLAY).allocCount, "未标记的分配不应该计入");
+    
+    // 标记范围内分配，范围外释放仍然扣回原模块
+    const int count = HEAP_TRACK_SLOTS * 3 / 4;
+    {
+        HEAP_TAG_SCOPE(HEAP_TAG_DISPLAY);
+        for (int i = 0; i < count; i++) {
+            MemoryMonitor::noteAlloc(&fakeHeap[i], 10);
+        }
+    }
+    const HeapTagStats& display = MemoryMonitor::getTagStats(HEAP_TAG_DISPLAY);
+    TEST_ASSERT_EQUAL_MESSAGE(count * 10, display.currentBytes, "模块占用错误");
+    TEST_ASSERT_EQUAL_MESSAGE(count, display.allocCount, "分配次数错误");
+    
+    // 先释放奇数块，再释放偶数块 (检验删除后探测链仍然完整)
+    for (int i = 1; i < count; i += 2) {
+        MemoryMonitor::noteFree(&fakeHeap[i]);
+    }
+    TEST_ASSERT_EQUAL_MESSAGE((count + 1) / 2 * 10, display.currentBytes, "释放一半后占用错误");
+    for (int i = 0; i < count; i += 2) {
+        MemoryMonitor::noteFree(&fakeHeap[i]);
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(0, display.currentBytes, "全部释放后占用应该为0");
+    TEST_ASSERT_EQUAL_MESSAGE(count * 10, display.peakBytes, "峰值错误");
+    
+    // realloc保持原来的归属
+    {
+        HEAP_TAG_SCOPE(HEAP_TAG_EXPORT);
+        MemoryMonitor::noteAlloc(&fakeHeap[0], 32);
+    }
+    {
+        HEAP_TAG_SCOPE(HEAP_TAG_LOG);
+        MemoryMonitor::noteRealloc(&fakeHeap[0], &fakeHeap[8], 64);
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(64, MemoryMonitor::getTagStats(HEAP_TAG_EXPORT).currentBytes, "realloc后应该保持原模块");
+    TEST_ASSERT_EQUAL_MESSAGE(0, MemoryMonitor::getTagStats(HEAP_TAG_LOG).currentBytes, "realloc不应该计入当前模块");
+    MemoryMonitor::noteFree(&fakeHeap[8]);
+    TEST_ASSERT_EQUAL_MESSAGE(0, MemoryMonitor::getTagStats(HEAP_TAG_EXPORT).currentBytes, "释放后占用应该为0");
+    
+    // 碎片率
+    MemorySample sample = {0, 40000, 10000, 30000};
+    TEST_ASSERT_EQUAL_MESSAGE(75, MemoryMonitor::fragmentationOf(sample), "碎片率错误");
+    
+#if HEAP_TRACKING
+    // 实际的String反复分配: 作用域结束后不应该残留
+    MemoryMonitor::resetTagStats();
+    {
+        HEAP_TAG_SCOPE(HEAP_TAG_DISPLAY);
+        for (int i = 0; i < 20; i++) {
+            String text = "评分 " + String(i * 3.5f, 1) + "%";
+            text += " 测试字符串拼接";
+        }
+    }
+    TEST_ASSERT_TRUE_MESSAGE(MemoryMonitor::getTagStats(HEAP_TAG_DISPLAY).allocCount > 0, "String分配应该被跟踪");
+    TEST_ASSERT_EQUAL_MESSAGE(0, MemoryMonitor::getTagStats(HEAP_TAG_DISPLAY).currentBytes, "String释放后不应该残留");
+#endif
+    
+    MemoryMonitor::resetTagStats();
+}
+
+// 测试遥测编码和串口命令
+void test_telemetry_console() {
+    // COBS: 编码结果不含0，解码还原；长串非0字节需要分段
+    uint8_t data[300];
+    for (int i = 0; i < (int)sizeof(data); i++) {
+        data[i] = (i % 7 == 0) ? 0 : (uint8_t)i;
+    }
+    data[299] = 0;
+    uint8_t encoded[sizeof(data) + sizeof(data) / 254 + 1];
+    uint8_t decoded[sizeof(data)];
+    size_t encodedLength = Telemetry::cobsEncode(data, sizeof(data), encoded);
+    TEST_ASSERT_TRUE_MESSAGE(encodedLength <= sizeof(encoded), "COBS编码长度超出上限");
+    TEST_ASSERT_NULL_MESSAGE(memchr(encoded, 0, encodedLength), "COBS编码结果不应该含0");
+    TEST_ASSERT_EQUAL_MESSAGE(sizeof(data), Telemetry::cobsDecode(encoded, encodedLength, decoded), "COBS解码长度错误");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data, decoded, sizeof(data), "COBS解码内容错误");
+    
+    memset(data, 0x5A, sizeof(data));
+    encodedLength = Telemetry::cobsEncode(data, sizeof(data), encoded);
+    TEST_ASSERT_EQUAL_MESSAGE(sizeof(data) + 2, encodedLength, "300个非0字节应该分为两段");
+    TEST_ASSERT_EQUAL_MESSAGE(sizeof(data), Telemetry::cobsDecode(encoded, encodedLength, decoded), "分段解码长度错误");
+    
+    // 样本包: CRC覆盖之前的全部字节，编码后放得下一帧
+    TelemetrySample sample = {};
+    sample.timestampMs = 123456;
+    sample.raw[2] = -16384;
+    sample.filtered[2] = -1.0f;
+    sample.score = 87.5f;
+    sample.flags = TELEMETRY_FLAG_STABLE;
+    uint8_t packet[TELEMETRY_PACKET_MAX];
+    size_t length = Telemetry::encodeSample(sample, 0x0102, packet);
+    TEST_ASSERT_TRUE_MESSAGE(length <= TELEMETRY_PACKET_MAX, "样本包超过最大长度");
+    TEST_ASSERT_EQUAL_MESSAGE(TELEMETRY_PKT_SAMPLE, packet[0], "包类型错误");
+    TEST_ASSERT_EQUAL_MESSAGE(0x02, packet[1], "序号应为小端");
+    uint32_t crc = DataExporter::crc32Update(0, packet, length - 4);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&crc, packet + length - 4, 4, "包尾CRC错误");
+    TEST_ASSERT_TRUE_MESSAGE(Telemetry::cobsEncode(packet, length, encoded) + 2 <= TELEMETRY_FRAME_MAX, "样本帧超过最大长度");
+    
+    // 设置命令: 有效值修改对应项，无效项或取值不修改
+    SystemSettings settings = {};
+    TEST_ASSERT_TRUE_MESSAGE(SerialConsole::applySetting(settings, "threshold 62.5"), "阈值设置失败");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(62.5f, settings.stabilityThreshold, "阈值未修改");
+    TEST_ASSERT_TRUE_MESSAGE(SerialConsole::applySetting(settings, "  practice 10 "), "练习时长设置失败");
+    TEST_ASSERT_EQUAL_MESSAGE(600000UL, settings.practiceTime, "练习时长应按分钟换算");
+    TEST_ASSERT_TRUE_MESSAGE(SerialConsole::applySetting(settings, "sound on"), "声音设置失败");
+    TEST_ASSERT_TRUE_MESSAGE(settings.soundEnabled, "声音未开启");
+    TEST_ASSERT_FALSE_MESSAGE(SerialConsole::applySetting(settings, "brightness 300"), "超出范围的亮度应该被拒绝");
+    TEST_ASSERT_FALSE_MESSAGE(SerialConsole::applySetting(settings, "threshold abc"), "非数字应该被拒绝");
+    TEST_ASSERT_FALSE_MESSAGE(SerialConsole::applySetting(settings, "sound on off"), "多余参数应该被拒绝");
+    TEST_ASSERT_FALSE_MESSAGE(SerialConsole::applySetting(settings, "volume 3"), "未知设置项应该被拒绝");
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(62.5f, settings.stabilityThreshold, "被拒绝的设置不应该修改");
+}
+
+// 测试表驱动状态机
+static StateMachine* testMachine = nullptr;
+static uint8_t testStateEnters[SYSTEM_STATE_COUNT];
+static uint8_t testStateExits[SYSTEM_STATE_COUNT];
+
+static void testStateEnter() {
+    testStateEnters[testMachine->getState()]++;
+}
+
+static void testStateExit() {
+    testStateExits[testMachine->getState()]++;
+}
+
+void test_state_machine() {
+    StateDescriptor table[SYSTEM_STATE_COUNT];
+    for (uint8_t i = 0; i < SYSTEM_STATE_COUNT; i++) {
+        table[i] = {(SystemState)i, "测试", STATE_PAGE_KEEP, (uint8_t)(i % 3), 0,
+                    testStateEnter, testStateExit, nullptr};
+    }
+    TEST_ASSERT_TRUE_MESSAGE(StateTable::ordered(table, SYSTEM_STATE_COUNT), "测试状态表顺序错误");
+    StateMachine machine(table, STATE_BOOT_ANIMATION);
+    testMachine = &machine;
+    
+    // 几条已知的规则
+    TEST_ASSERT_TRUE_MESSAGE(StateTable::canTransition(STATE_BOOT_ANIMATION, STATE_MAIN_MENU), "开机动画应该可以进入主菜单");
+    TEST_ASSERT_TRUE_MESSAGE(StateTable::canTransition(STATE_PRACTICING, STATE_PAUSED), "练习应该可以暂停");
+    TEST_ASSERT_FALSE_MESSAGE(StateTable::canTransition(STATE_PRACTICING, STATE_SETTINGS), "练习中不应该进入设置");
+    TEST_ASSERT_FALSE_MESSAGE(StateTable::canTransition(STATE_HISTORY, STATE_PRACTICING), "历史页面不应该直接开始练习");
+    
+    // 穷举所有状态对: 允许的转换依次调用退出和进入处理，不允许的转换不改变状态也不调用处理函数
+    for (uint8_t from = 0; from < SYSTEM_STATE_COUNT; from++) {
+        for (uint8_t to = 0; to < SYSTEM_STATE_COUNT; to++) {
+            machine.restore((SystemState)from);
+            memset(testStateEnters, 0, sizeof(testStateEnters));
+            memset(testStateExits, 0, sizeof(testStateExits));
+            bool allowed = StateTable::canTransition((SystemState)from, (SystemState)to);
+            
+            TEST_ASSERT_EQUAL_MESSAGE(allowed, machine.change((SystemState)to), "转换结果与矩阵不一致");
+            TEST_ASSERT_FALSE_MESSAGE(to == STATE_BOOT_ANIMATION && allowed, "不应该允许进入开机动画");
+            TEST_ASSERT_FALSE_MESSAGE(from == to && allowed, "不应该允许转换到自身");
+            TEST_ASSERT_EQUAL_MESSAGE(allowed ? to : from, machine.getState(), "转换后的状态错误");
+            TEST_ASSERT_EQUAL_MESSAGE(allowed ? 1 : 0, testStateExits[from], "退出处理调用次数错误");
+            TEST_ASSERT_EQUAL_MESSAGE(allowed ? 1 : 0, testStateEnters[to], "进入处理调用次数错误");
+        }
+        // 每个状态都可以离开 (开机动画之后不会卡在某个状态)
+        TEST_ASSERT_NOT_EQUAL_MESSAGE(0, StateTable::transitions[from], "存在无法离开的状态");
+    }
+    
+    // 传感器分频: 进入状态后的第一个节拍读取，之后每N个节拍读取一次，0为不读取
+    machine.restore((SystemState)2);                 // 分频2
+    TEST_ASSERT_TRUE_MESSAGE(machine.takeSensorTick(), "第一个节拍应该读取");
+    TEST_ASSERT_FALSE_MESSAGE(machine.takeSensorTick(), "分频2时第二个节拍不应该读取");
+    TEST_ASSERT_TRUE_MESSAGE(machine.takeSensorTick(), "分频2时第三个节拍应该读取");
+    machine.restore((SystemState)3);                 // 分频0
+    TEST_ASSERT_FALSE_MESSAGE(machine.takeSensorTick(), "分频0时不应该读取");
+    machine.restore((SystemState)1);                 // 分频1
+    TEST_ASSERT_TRUE_MESSAGE(machine.takeSensorTick() && machine.takeSensorTick(), "分频1时每个节拍都应该读取");
+    testMachine = nullptr;
+}
+
+// 测试事件总线
+struct TestBusLog {
+    uint8_t types[8];
+    const void* payloads[8];
+    uint8_t count;
+};
+
+static void testBusRecord(const BusEvent& event, void* context) {
+    TestBusLog* log = static_cast<TestBusLog*>(context);
+    if (log->count < 8) {
+        log->types[log->count] = event.type;
+        log->payloads[log->count] = event.payload;
+        log->count++;
+    }
+}
+
+static void testBusRepublish(const BusEvent& event, void* context) {
+    // 处理函数中发布的事件同步分发给其它订阅者
+    EventBus::publishStats();
+}
+
+void test_event_bus() {
+    EventBus::reset();
+    TestBusLog sensorLog = {};
+    TestBusLog statsLog = {};
+    TEST_ASSERT_FALSE_MESSAGE(EventBus::subscribe(0, testBusRecord, &sensorLog), "空掩码不应该订阅成功");
+    TEST_ASSERT_TRUE_MESSAGE(EventBus::subscribe(EventBus::mask(BUS_EVENT_SCORE) | EventBus::mask(BUS_EVENT_BREAK),
+                                                 testBusRecord, &sensorLog), "订阅失败");
+    TEST_ASSERT_TRUE_MESSAGE(EventBus::subscribe(EventBus::mask(BUS_EVENT_BREAK), testBusRepublish), "订阅失败");
+    TEST_ASSERT_TRUE_MESSAGE(EventBus::subscribe(EventBus::mask(BUS_EVENT_STATS) | EventBus::mask(BUS_EVENT_SETTINGS),
+                                                 testBusRecord, &statsLog), "订阅失败");
+    
+    // 只分发给订阅了该事件的处理函数，负载指向发布者的数据
+    StabilityData stability = {};
+    stability.score = 42.0f;
+    EventBus::publishScore(stability);
+    TEST_ASSERT_EQUAL_MESSAGE(1, sensorLog.count, "评分事件应该分发给传感器订阅者");
+    TEST_ASSERT_EQUAL_MESSAGE(BUS_EVENT_SCORE, sensorLog.types[0], "事件类型错误");
+    TEST_ASSERT_TRUE_MESSAGE(sensorLog.payloads[0] == &stability, "负载应该指向发布者的数据 (不复制)");
+    TEST_ASSERT_EQUAL_MESSAGE(0, statsLog.count, "未订阅的事件不应该分发");
+    
+    // 破定: 第二个订阅者在处理中发布统计事件，在破定事件分发完成前送达
+    EventBus::publishBreak(stability);
+    TEST_ASSERT_EQUAL_MESSAGE(2, sensorLog.count, "破定事件应该分发给传感器订阅者");
+    TEST_ASSERT_EQUAL_MESSAGE(BUS_EVENT_BREAK, sensorLog.types[1], "事件类型错误");
+    TEST_ASSERT_EQUAL_MESSAGE(1, statsLog.count, "嵌套发布的统计事件应该送达");
+    TEST_ASSERT_EQUAL_MESSAGE(BUS_EVENT_STATS, statsLog.types[0], "事件类型错误");
+    TEST_ASSERT_TRUE_MESSAGE(statsLog.payloads[0] == nullptr, "统计事件没有负载");
+    
+    SystemSettings settings = {};
+    EventBus::publishSettings(settings);
+    TEST_ASSERT_EQUAL_MESSAGE(2, statsLog.count, "设置事件应该分发");
+    TEST_ASSERT_TRUE_MESSAGE(statsLog.payloads[1] == &settings, "设置负载错误");
+    
+    // 计数: 每种事件的发布次数和总分发次数
+    TEST_ASSERT_EQUAL_MESSAGE(1, EventBus::getPublishCount(BUS_EVENT_SCORE), "评分发布次数错误");
+    TEST_ASSERT_EQUAL_MESSAGE(1, EventBus::getPublishCount(BUS_EVENT_STATS), "统计发布次数错误");
+    TEST_ASSERT_EQUAL_MESSAGE(0, EventBus::getPublishCount(BUS_EVENT_BATTERY), "电池发布次数错误");
+    TEST_ASSERT_EQUAL_MESSAGE(5, EventBus::getDeliveryCount(), "分发次数错误");
+    
+    // 取消订阅后不再收到事件
+    EventBus::unsubscribe(testBusRecord, &sensorLog);
+    EventBus::publishScore(stability);
+    TEST_ASSERT_EQUAL_MESSAGE(2, sensorLog.count, "取消订阅后不应该再收到事件");
+    
+    // 订阅表已满时返回false
+    EventBus::reset();
+    for (int i = 0; i < EVENT_BUS_MAX_SUBSCRIBERS; i++) {
+        TEST_ASSERT_TRUE_MESSAGE(EventBus::subscribe(EventBus::mask(BUS_EVENT_BATTERY), testBusRecord, &sensorLog), "订阅失败");
+    }
+    TEST_ASSERT_FALSE_MESSAGE(EventBus::subscribe(EventBus::mask(BUS_EVENT_BATTERY), testBusRecord, &sensorLog), "订阅表满时应该返回false");
+    EventBus::reset();
 }
 
 // 测试时间格式化
@@ -232,6 +1191,28 @@ void setup() {
     RUN_TEST(test_audio_functionality);
     RUN_TEST(test_power_monitoring);
     RUN_TEST(test_data_persistence);
+    RUN_TEST(test_session_record_codec);
+    RUN_TEST(test_stability_aggregator);
+    RUN_TEST(test_rolling_stats);
+    RUN_TEST(test_export_codec);
+    RUN_TEST(test_rtc_resume_state);
+    RUN_TEST(test_boot_trace);
+    RUN_TEST(test_frequency_governor);
+    RUN_TEST(test_loop_scheduler);
+    RUN_TEST(test_battery_estimator);
+    RUN_TEST(test_energy_profiler);
+    RUN_TEST(test_audio_sequencer);
+    RUN_TEST(test_button_capture);
+    RUN_TEST(test_gesture_engine);
+    RUN_TEST(test_motion_gesture);
+    RUN_TEST(test_deferred_log);
+    RUN_TEST(test_log_filter);
+    RUN_TEST(test_perf_timer);
+    RUN_TEST(test_loop_monitor);
+    RUN_TEST(test_memory_monitor);
+    RUN_TEST(test_telemetry_console);
+    RUN_TEST(test_state_machine);
+    RUN_TEST(test_event_bus);
     RUN_TEST(test_time_formatting);
     
     UNITY_END();